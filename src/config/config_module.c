@@ -489,18 +489,19 @@ int config_load_from_file(const char *filename) {
                 config_set_bool(k, 1);
             } else if (strcmp(v, "false") == 0 || strcmp(v, "0") == 0) {
                 config_set_bool(k, 0);
-            } else if (strchr(v, '.') != NULL) {
-                // 可能是浮点数
-                float fval = atof(v);
-                config_set_float(k, fval);
             } else {
-                // 可能是整数
-                int ival = atoi(v);
-                if (ival != 0 || strcmp(v, "0") == 0) {
-                    config_set_int(k, ival);
+                // 整个值是数字时按整数或浮点数保存，否则是字符串（例如带扩展名的文件路径）
+                char *number_end;
+                long ival = strtol(v, &number_end, 10);
+                if (*v != '\0' && *number_end == '\0') {
+                    config_set_int(k, (int) ival);
                 } else {
-                    // 可能是字符串
-                    config_set_string(k, v);
+                    float fval = strtof(v, &number_end);
+                    if (*v != '\0' && *number_end == '\0') {
+                        config_set_float(k, fval);
+                    } else {
+                        config_set_string(k, v);
+                    }
                 }
             }
         }
@@ -65,7 +65,7 @@ const database_module_t database_module = {
 };
 
 // 兼容的模块接口实例
-const struct module_interface database_module_interface = {
+struct module_interface database_module_interface = {
     .name = "database",
     .version = "1.0.0",
     .init = database_module_init,
@@ -146,7 +146,7 @@ int db_get_table_count(database_connection_t *conn, const char *table_name);
 extern const database_module_t database_module;
 
 // 兼容性声明
-extern const struct module_interface database_module_interface;
+extern struct module_interface database_module_interface;
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,465 @@
+#include "src/db/kv_store.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define KV_INITIAL_BUCKETS 64
+#define KV_MAX_SHARDS 1024
+
+// 时间轮的槽数（2的幂），超过一圈的过期时间留在槽中，每圈检查一次
+#define KV_WHEEL_SLOTS 1024
+
+// 64位整数的十进制表示最多20个字符（含负号）
+#define KV_MAX_INTEGER_LENGTH 20
+
+typedef struct kv_entry {
+    struct kv_entry *hash_next;
+    struct kv_entry *wheel_prev;            // 带过期时间时位于时间轮的槽中
+    struct kv_entry *wheel_next;
+    uint64_t hash;
+    uint64_t expire_at;                     // 过期时刻，0表示不过期
+    size_t slot;
+    char *value;                            // 以'\0'结尾（不计入长度），便于按整数解析
+    size_t value_length;
+    size_t key_length;
+    char key[];
+} kv_entry_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    kv_entry_t **buckets;
+    size_t bucket_count;
+    size_t count;
+    size_t expiring;
+    uint64_t tick;                          // 时间轮下一个待处理的刻度
+    uint64_t expired;
+    kv_entry_t *wheel[KV_WHEEL_SLOTS];
+} kv_shard_t;
+
+struct kv_store {
+    kv_shard_t *shards;
+    size_t shard_count;
+    uint64_t tick_ms;
+};
+
+// FNV-1a（64位），高32位选分片，低位选桶
+static uint64_t key_hash(const char *key, size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char) key[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static kv_shard_t* shard_for(const kv_store_t *store, uint64_t hash) {
+    return &store->shards[(hash >> 32) & (store->shard_count - 1)];
+}
+
+static kv_entry_t* find_entry(const kv_shard_t *shard, const char *key, size_t key_length, uint64_t hash) {
+    kv_entry_t *entry = shard->buckets[hash & (shard->bucket_count - 1)];
+    while (entry && (entry->hash != hash || entry->key_length != key_length ||
+                     memcmp(entry->key, key, key_length) != 0)) {
+        entry = entry->hash_next;
+    }
+    return entry;
+}
+
+// 扩大哈希表，失败时继续使用原表
+static void grow_buckets(kv_shard_t *shard) {
+    size_t count = shard->bucket_count * 2;
+    kv_entry_t **buckets = calloc(count, sizeof(kv_entry_t*));
+    if (!buckets) {
+        return;
+    }
+    for (size_t i = 0; i < shard->bucket_count; i++) {
+        kv_entry_t *entry = shard->buckets[i];
+        while (entry) {
+            kv_entry_t *next = entry->hash_next;
+            entry->hash_next = buckets[entry->hash & (count - 1)];
+            buckets[entry->hash & (count - 1)] = entry;
+            entry = next;
+        }
+    }
+    free(shard->buckets);
+    shard->buckets = buckets;
+    shard->bucket_count = count;
+}
+
+// 挂到过期时刻所在的槽：刻度向上取整，推进到该刻度时键一定已过期
+static void wheel_link(const kv_store_t *store, kv_shard_t *shard, kv_entry_t *entry) {
+    uint64_t tick = (entry->expire_at + store->tick_ms - 1) / store->tick_ms;
+    if (tick < shard->tick) {
+        tick = shard->tick;
+    }
+    entry->slot = (size_t) (tick & (KV_WHEEL_SLOTS - 1));
+    entry->wheel_prev = NULL;
+    entry->wheel_next = shard->wheel[entry->slot];
+    if (entry->wheel_next) {
+        entry->wheel_next->wheel_prev = entry;
+    }
+    shard->wheel[entry->slot] = entry;
+    shard->expiring++;
+}
+
+static void wheel_unlink(kv_shard_t *shard, kv_entry_t *entry) {
+    if (entry->wheel_prev) {
+        entry->wheel_prev->wheel_next = entry->wheel_next;
+    } else {
+        shard->wheel[entry->slot] = entry->wheel_next;
+    }
+    if (entry->wheel_next) {
+        entry->wheel_next->wheel_prev = entry->wheel_prev;
+    }
+    shard->expiring--;
+}
+
+// 设置或清除过期时间
+static void set_expire_at(const kv_store_t *store, kv_shard_t *shard, kv_entry_t *entry, uint64_t expire_at) {
+    if (entry->expire_at) {
+        wheel_unlink(shard, entry);
+    }
+    entry->expire_at = expire_at;
+    if (expire_at) {
+        wheel_link(store, shard, entry);
+    }
+}
+
+static void remove_entry(kv_shard_t *shard, kv_entry_t *entry) {
+    kv_entry_t **link = &shard->buckets[entry->hash & (shard->bucket_count - 1)];
+    while (*link != entry) {
+        link = &(*link)->hash_next;
+    }
+    *link = entry->hash_next;
+    if (entry->expire_at) {
+        wheel_unlink(shard, entry);
+    }
+    shard->count--;
+    free(entry->value);
+    free(entry);
+}
+
+// 查找未过期的键，遇到已过期的键顺便删除
+static kv_entry_t* find_live(kv_shard_t *shard, const char *key, size_t key_length, uint64_t hash, uint64_t now) {
+    kv_entry_t *entry = find_entry(shard, key, key_length, hash);
+    if (entry && entry->expire_at && entry->expire_at <= now) {
+        remove_entry(shard, entry);
+        shard->expired++;
+        return NULL;
+    }
+    return entry;
+}
+
+static kv_entry_t* insert_entry(kv_shard_t *shard, const char *key, size_t key_length, uint64_t hash) {
+    kv_entry_t *entry = calloc(1, sizeof(kv_entry_t) + key_length);
+    if (!entry) {
+        return NULL;
+    }
+    memcpy(entry->key, key, key_length);
+    entry->key_length = key_length;
+    entry->hash = hash;
+
+    if (shard->count >= shard->bucket_count) {
+        grow_buckets(shard);
+    }
+    size_t bucket = hash & (shard->bucket_count - 1);
+    entry->hash_next = shard->buckets[bucket];
+    shard->buckets[bucket] = entry;
+    shard->count++;
+    return entry;
+}
+
+// 复制值并以'\0'结尾
+static char* copy_value(const char *value, size_t length) {
+    char *copy = malloc(length + 1);
+    if (copy) {
+        memcpy(copy, value, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+// 按64位有符号整数解析值（与Redis一致：不允许空白、正号和前导零）
+static int parse_integer(const char *value, size_t length, int64_t *result) {
+    if (length == 0 || length > KV_MAX_INTEGER_LENGTH) {
+        return -1;
+    }
+    size_t i = value[0] == '-' ? 1 : 0;
+    if (i == length || (value[i] == '0' && length > i + 1) || (i == 1 && value[1] == '0')) {
+        return -1;
+    }
+
+    uint64_t magnitude = 0;
+    for (; i < length; i++) {
+        if (value[i] < '0' || value[i] > '9') {
+            return -1;
+        }
+        uint64_t digit = (uint64_t) (value[i] - '0');
+        if (magnitude > (UINT64_MAX - digit) / 10) {
+            return -1;
+        }
+        magnitude = magnitude * 10 + digit;
+    }
+
+    if (value[0] == '-') {
+        if (magnitude > (uint64_t) INT64_MAX + 1) {
+            return -1;
+        }
+        *result = magnitude == (uint64_t) INT64_MAX + 1 ? INT64_MIN : -(int64_t) magnitude;
+    } else {
+        if (magnitude > (uint64_t) INT64_MAX) {
+            return -1;
+        }
+        *result = (int64_t) magnitude;
+    }
+    return 0;
+}
+
+kv_store_t* kv_store_create(size_t shard_count, uint64_t tick_ms, uint64_t now) {
+    if (shard_count == 0 || shard_count > KV_MAX_SHARDS || tick_ms == 0) {
+        return NULL;
+    }
+    size_t count = 1;
+    while (count < shard_count) {
+        count <<= 1;
+    }
+
+    kv_store_t *store = calloc(1, sizeof(kv_store_t));
+    if (!store) {
+        return NULL;
+    }
+    store->shards = calloc(count, sizeof(kv_shard_t));
+    if (!store->shards) {
+        free(store);
+        return NULL;
+    }
+    store->shard_count = count;
+    store->tick_ms = tick_ms;
+
+    for (size_t i = 0; i < count; i++) {
+        kv_shard_t *shard = &store->shards[i];
+        shard->buckets = calloc(KV_INITIAL_BUCKETS, sizeof(kv_entry_t*));
+        if (!shard->buckets) {
+            kv_store_destroy(store);
+            return NULL;
+        }
+        shard->bucket_count = KV_INITIAL_BUCKETS;
+        shard->tick = now / tick_ms + 1;
+        pthread_mutex_init(&shard->lock, NULL);
+    }
+    return store;
+}
+
+void kv_store_destroy(kv_store_t *store) {
+    if (!store) {
+        return;
+    }
+    for (size_t i = 0; i < store->shard_count; i++) {
+        kv_shard_t *shard = &store->shards[i];
+        if (!shard->buckets) {
+            break;
+        }
+        for (size_t j = 0; j < shard->bucket_count; j++) {
+            kv_entry_t *entry = shard->buckets[j];
+            while (entry) {
+                kv_entry_t *next = entry->hash_next;
+                free(entry->value);
+                free(entry);
+                entry = next;
+            }
+        }
+        free(shard->buckets);
+        pthread_mutex_destroy(&shard->lock);
+    }
+    free(store->shards);
+    free(store);
+}
+
+int kv_store_get(kv_store_t *store, const char *key, size_t key_length, uint64_t now, kv_value_fn fn, void *arg) {
+    if (!store || !key) {
+        return 0;
+    }
+    uint64_t hash = key_hash(key, key_length);
+    kv_shard_t *shard = shard_for(store, hash);
+
+    pthread_mutex_lock(&shard->lock);
+    kv_entry_t *entry = find_live(shard, key, key_length, hash, now);
+    if (entry && fn) {
+        fn(entry->value, entry->value_length, arg);
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return entry != NULL;
+}
+
+int kv_store_set(kv_store_t *store, const char *key, size_t key_length, const char *value, size_t value_length,
+                 int64_t ttl_ms, int flags, uint64_t now) {
+    if (!store || !key || (!value && value_length > 0)) {
+        return KV_ERROR_NO_MEMORY;
+    }
+    uint64_t hash = key_hash(key, key_length);
+    kv_shard_t *shard = shard_for(store, hash);
+
+    // 在锁外复制值，缩短持锁时间
+    char *copy = copy_value(value, value_length);
+    if (!copy) {
+        return KV_ERROR_NO_MEMORY;
+    }
+
+    pthread_mutex_lock(&shard->lock);
+    kv_entry_t *entry = find_live(shard, key, key_length, hash, now);
+    if (((flags & KV_SET_NX) && entry) || ((flags & KV_SET_XX) && !entry)) {
+        pthread_mutex_unlock(&shard->lock);
+        free(copy);
+        return 0;
+    }
+    if (!entry) {
+        entry = insert_entry(shard, key, key_length, hash);
+        if (!entry) {
+            pthread_mutex_unlock(&shard->lock);
+            free(copy);
+            return KV_ERROR_NO_MEMORY;
+        }
+    }
+    free(entry->value);
+    entry->value = copy;
+    entry->value_length = value_length;
+    set_expire_at(store, shard, entry, ttl_ms > 0 ? now + (uint64_t) ttl_ms : 0);
+    pthread_mutex_unlock(&shard->lock);
+    return 1;
+}
+
+int kv_store_del(kv_store_t *store, const char *key, size_t key_length, uint64_t now) {
+    if (!store || !key) {
+        return 0;
+    }
+    uint64_t hash = key_hash(key, key_length);
+    kv_shard_t *shard = shard_for(store, hash);
+
+    pthread_mutex_lock(&shard->lock);
+    kv_entry_t *entry = find_live(shard, key, key_length, hash, now);
+    if (entry) {
+        remove_entry(shard, entry);
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return entry != NULL;
+}
+
+int kv_store_expire(kv_store_t *store, const char *key, size_t key_length, int64_t ttl_ms, uint64_t now) {
+    if (!store || !key) {
+        return 0;
+    }
+    uint64_t hash = key_hash(key, key_length);
+    kv_shard_t *shard = shard_for(store, hash);
+
+    pthread_mutex_lock(&shard->lock);
+    kv_entry_t *entry = find_live(shard, key, key_length, hash, now);
+    if (entry) {
+        if (ttl_ms > 0) {
+            set_expire_at(store, shard, entry, now + (uint64_t) ttl_ms);
+        } else {
+            remove_entry(shard, entry);
+        }
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return entry != NULL;
+}
+
+int64_t kv_store_ttl(kv_store_t *store, const char *key, size_t key_length, uint64_t now) {
+    if (!store || !key) {
+        return -2;
+    }
+    uint64_t hash = key_hash(key, key_length);
+    kv_shard_t *shard = shard_for(store, hash);
+
+    pthread_mutex_lock(&shard->lock);
+    kv_entry_t *entry = find_live(shard, key, key_length, hash, now);
+    int64_t ttl = !entry ? -2 : entry->expire_at ? (int64_t) (entry->expire_at - now) : -1;
+    pthread_mutex_unlock(&shard->lock);
+    return ttl;
+}
+
+int kv_store_incr(kv_store_t *store, const char *key, size_t key_length, int64_t delta, uint64_t now,
+                  int64_t *result) {
+    if (!store || !key || !result) {
+        return KV_ERROR_NO_MEMORY;
+    }
+    uint64_t hash = key_hash(key, key_length);
+    kv_shard_t *shard = shard_for(store, hash);
+
+    pthread_mutex_lock(&shard->lock);
+    kv_entry_t *entry = find_live(shard, key, key_length, hash, now);
+    int64_t value = 0;
+    int status = 0;
+    if (entry && parse_integer(entry->value, entry->value_length, &value) != 0) {
+        status = KV_ERROR_NOT_INTEGER;
+    } else if ((delta > 0 && value > INT64_MAX - delta) || (delta < 0 && value < INT64_MIN - delta)) {
+        status = KV_ERROR_OVERFLOW;
+    } else {
+        value += delta;
+        char text[KV_MAX_INTEGER_LENGTH + 1];
+        int length = snprintf(text, sizeof(text), "%lld", (long long) value);
+        char *copy = copy_value(text, (size_t) length);
+        if (!entry && copy) {
+            entry = insert_entry(shard, key, key_length, hash);
+        }
+        if (!copy || !entry) {
+            free(copy);
+            status = KV_ERROR_NO_MEMORY;
+        } else {
+            free(entry->value);
+            entry->value = copy;
+            entry->value_length = (size_t) length;
+            *result = value;
+        }
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return status;
+}
+
+size_t kv_store_advance(kv_store_t *store, uint64_t now) {
+    if (!store) {
+        return 0;
+    }
+
+    size_t removed = 0;
+    uint64_t target = now / store->tick_ms;
+    for (size_t i = 0; i < store->shard_count; i++) {
+        kv_shard_t *shard = &store->shards[i];
+        pthread_mutex_lock(&shard->lock);
+
+        // 槽中过期时刻不晚于now的键到期，其余属于以后的圈次；落后超过一圈时每个槽只需处理一次
+        for (size_t steps = 0; shard->tick <= target && steps < KV_WHEEL_SLOTS; steps++, shard->tick++) {
+            kv_entry_t *entry = shard->wheel[shard->tick & (KV_WHEEL_SLOTS - 1)];
+            while (entry) {
+                kv_entry_t *next = entry->wheel_next;
+                if (entry->expire_at <= now) {
+                    remove_entry(shard, entry);
+                    shard->expired++;
+                    removed++;
+                }
+                entry = next;
+            }
+        }
+        if (shard->tick <= target) {
+            shard->tick = target + 1;
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+    return removed;
+}
+
+void kv_store_get_stats(kv_store_t *store, kv_store_stats_t *stats) {
+    if (!store || !stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(kv_store_stats_t));
+    stats->shards = store->shard_count;
+    for (size_t i = 0; i < store->shard_count; i++) {
+        kv_shard_t *shard = &store->shards[i];
+        pthread_mutex_lock(&shard->lock);
+        stats->keys += shard->count;
+        stats->expiring_keys += shard->expiring;
+        stats->expired += shard->expired;
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
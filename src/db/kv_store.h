@@ -0,0 +1,77 @@
+#ifndef KV_STORE_H
+#define KV_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 内存键值存储
+// 键按哈希分到若干分片，每个分片有自己的哈希表和互斥锁，不同分片的操作互不阻塞，可以在任意线程调用。
+// 带过期时间的键同时挂在所在分片的时间轮上：kv_store_advance按刻度推进时间轮，删除到期的键；
+// 访问时也检查过期时间，已过期但时间轮尚未处理的键视为不存在。
+// 时间由调用者传入（单调时钟毫秒，例如uv_now），同一个存储的调用应使用同一时钟。
+
+// 错误码
+#define KV_ERROR_NO_MEMORY -1
+#define KV_ERROR_NOT_INTEGER -2     // 值不是64位有符号整数
+#define KV_ERROR_OVERFLOW -3        // 自增结果溢出
+
+// 写入条件
+#define KV_SET_NX 1                 // 仅在键不存在时写入
+#define KV_SET_XX 2                 // 仅在键已存在时写入
+
+// 统计
+typedef struct {
+    size_t shards;
+    size_t keys;                    // 当前键数（含已过期、尚未删除的键）
+    size_t expiring_keys;           // 带过期时间的键数
+    uint64_t expired;               // 因过期删除的键数
+} kv_store_stats_t;
+
+typedef struct kv_store kv_store_t;
+
+// 读取值的回调，在分片锁内调用，value只在回调期间有效
+typedef void (*kv_value_fn)(const char *value, size_t length, void *arg);
+
+// 创建存储，shard_count向上取整为2的幂，tick_ms为时间轮的刻度，now为当前时刻
+kv_store_t* kv_store_create(size_t shard_count, uint64_t tick_ms, uint64_t now);
+
+// 销毁存储
+void kv_store_destroy(kv_store_t *store);
+
+// 读取键，存在时以值调用fn并返回1，不存在返回0
+int kv_store_get(kv_store_t *store, const char *key, size_t key_length, uint64_t now, kv_value_fn fn, void *arg);
+
+// 写入键，ttl_ms大于0时设置过期时间，否则清除原有的过期时间
+// 写入返回1，不满足flags条件返回0，内存不足返回KV_ERROR_NO_MEMORY
+int kv_store_set(kv_store_t *store, const char *key, size_t key_length, const char *value, size_t value_length,
+                 int64_t ttl_ms, int flags, uint64_t now);
+
+// 删除键，删除返回1，不存在返回0
+int kv_store_del(kv_store_t *store, const char *key, size_t key_length, uint64_t now);
+
+// 设置过期时间，ttl_ms不大于0时立即删除。键存在返回1，不存在返回0
+int kv_store_expire(kv_store_t *store, const char *key, size_t key_length, int64_t ttl_ms, uint64_t now);
+
+// 剩余生存时间（毫秒），键不存在返回-2，没有过期时间返回-1
+int64_t kv_store_ttl(kv_store_t *store, const char *key, size_t key_length, uint64_t now);
+
+// 把值按整数加上delta，键不存在时视为0，保留原有的过期时间
+// 成功返回0并通过result给出新值，失败返回KV_ERROR_*
+int kv_store_incr(kv_store_t *store, const char *key, size_t key_length, int64_t delta, uint64_t now,
+                  int64_t *result);
+
+// 推进时间轮到now，删除到期的键，返回删除的键数
+size_t kv_store_advance(kv_store_t *store, uint64_t now);
+
+// 获取统计
+void kv_store_get_stats(kv_store_t *store, kv_store_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // KV_STORE_H
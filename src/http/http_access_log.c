@@ -0,0 +1,413 @@
+#include "src/http/http_access_log.h"
+#include "src/http/http_module.h"
+#include "src/log/logger_module.h"
+#include <uv.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+// 批量写入缓冲区大小，格式化后的文本攒满后一次write
+#define ACCESS_LOG_BATCH_SIZE (64 * 1024)
+
+// 单条格式化记录的最大长度
+#define ACCESS_LOG_LINE_MAX 512
+
+// 生产者和消费者各自修改的字段放在不同缓存行，避免伪共享
+#define ACCESS_LOG_CACHE_LINE 64
+
+// 单个事件循环的环形缓冲区
+struct http_access_log_ring {
+    http_access_log_record_t *records;
+    size_t mask;
+    http_access_log_t *log;
+    struct http_access_log_ring *next;
+
+    // 生产者（事件循环线程）
+    char pad0[ACCESS_LOG_CACHE_LINE];
+    size_t head;
+    uint64_t dropped;           // 原子读写，后台线程汇总
+    uint64_t sampled_out;       // 同上
+    uint64_t sample_second;     // 当前统计的秒
+    unsigned second_count;      // 当前秒内的请求数
+    unsigned sample_counter;
+
+    // 消费者（后台线程）
+    char pad1[ACCESS_LOG_CACHE_LINE];
+    size_t tail;
+    uint64_t reported_dropped;  // 已写入日志提示的丢弃数
+};
+
+// 访问日志
+struct http_access_log {
+    int fd;
+    size_t ring_capacity;
+    int flush_interval_ms;
+    unsigned sample_threshold;
+    unsigned sample_rate;
+    int64_t realtime_offset_ns; // 墙上时间与uv_hrtime的差值
+
+    uv_mutex_t mutex;           // 保护环列表、路由名称和running
+    uv_cond_t cond;
+    uv_thread_t thread;
+    int running;
+    http_access_log_ring_t *rings;
+    char **route_names;
+    size_t route_name_count;
+
+    uint64_t written;           // 仅后台线程修改，原子读取
+
+    // 后台线程使用的格式化状态
+    char *batch;                // 持锁填充
+    size_t batch_used;
+    char *writing;              // 与batch交换后在锁外写出
+    time_t cached_second;
+    char cached_time[32];       // cached_second格式化后的"YYYY-mm-ddTHH:MM:SS"
+    char cached_zone[8];        // "+0800"
+};
+
+// 写出已换出的批量缓冲区（不持有log->mutex）
+static void write_batch(http_access_log_t *log, const char *data, size_t length) {
+    size_t offset = 0;
+    while (offset < length) {
+        ssize_t n = write(log->fd, data + offset, length - offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            log_error_sync("写入访问日志失败: %s", strerror(errno));
+            break;
+        }
+        offset += (size_t) n;
+    }
+}
+
+// 追加格式化后的文本，调用者保证剩余空间足够
+static void append_text(http_access_log_t *log, const char *text, size_t length) {
+    memcpy(log->batch + log->batch_used, text, length);
+    log->batch_used += length;
+}
+
+// 剩余空间是否还能容纳一行
+static int batch_has_room(const http_access_log_t *log) {
+    return log->batch_used + ACCESS_LOG_LINE_MAX <= ACCESS_LOG_BATCH_SIZE;
+}
+
+// 格式化一条记录，同一秒内的时间前缀只格式化一次
+static void format_record(http_access_log_t *log, const http_access_log_record_t *record) {
+    int64_t wall_ns = (int64_t) record->start_ns + log->realtime_offset_ns;
+    time_t second = (time_t) (wall_ns / 1000000000);
+    int millis = (int) ((wall_ns / 1000000) % 1000);
+
+    if (second != log->cached_second) {
+        struct tm tm_info;
+        localtime_r(&second, &tm_info);
+        strftime(log->cached_time, sizeof(log->cached_time), "%Y-%m-%dT%H:%M:%S", &tm_info);
+        strftime(log->cached_zone, sizeof(log->cached_zone), "%z", &tm_info);
+        log->cached_second = second;
+    }
+
+    const char *route = "-";
+    if (record->route_id != HTTP_ACCESS_LOG_NO_ROUTE && record->route_id < log->route_name_count &&
+        log->route_names[record->route_id]) {
+        route = log->route_names[record->route_id];
+    }
+
+    char line[ACCESS_LOG_LINE_MAX];
+    int length = snprintf(line, sizeof(line), "%s.%03d%s %s %s %u conn=%u in=%u out=%u us=%u w=%u\n",
+                          log->cached_time, millis, log->cached_zone,
+                          http_method_to_string((http_method_t) record->method), route, record->status,
+                          record->connection_id, record->bytes_in, record->bytes_out,
+                          record->latency_us, record->weight);
+    if (length < 0) {
+        return;
+    }
+    if ((size_t) length >= sizeof(line)) {
+        length = (int) sizeof(line) - 1;
+        line[length - 1] = '\n';
+    }
+    append_text(log, line, (size_t) length);
+}
+
+// 取出环中的记录格式化到批量缓冲区（调用者持有log->mutex），
+// 缓冲区满时停止，返回1表示环中仍有记录
+static int drain_rings(http_access_log_t *log) {
+    int pending = 0;
+    for (http_access_log_ring_t *ring = log->rings; ring; ring = ring->next) {
+        size_t tail = ring->tail;
+        size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        size_t i = tail;
+        for (; i != head && batch_has_room(log); i++) {
+            format_record(log, &ring->records[i & ring->mask]);
+        }
+        if (i != head) {
+            pending = 1;
+        }
+        // 记录格式化后即可复用槽位，文本已复制到批量缓冲区
+        __atomic_store_n(&ring->tail, i, __ATOMIC_RELEASE);
+        __atomic_fetch_add(&log->written, (uint64_t) (i - tail), __ATOMIC_RELAXED);
+
+        uint64_t dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+        if (dropped != ring->reported_dropped && batch_has_room(log)) {
+            char line[96];
+            int length = snprintf(line, sizeof(line), "# dropped %llu records (ring full)\n",
+                                  (unsigned long long) (dropped - ring->reported_dropped));
+            append_text(log, line, (size_t) length);
+            ring->reported_dropped = dropped;
+        }
+        if (pending) {
+            break;
+        }
+    }
+    return pending;
+}
+
+// 后台写入线程：定期或在环过半时被唤醒。持锁格式化，
+// 交换两个批量缓冲区后解锁再write，慢磁盘不阻塞注册环和统计
+static void access_log_thread(void *arg) {
+    http_access_log_t *log = (http_access_log_t*) arg;
+    int pending = 0;
+
+    uv_mutex_lock(&log->mutex);
+    for (;;) {
+        int running = log->running;
+        if (running && !pending) {
+            uv_cond_timedwait(&log->cond, &log->mutex, (uint64_t) log->flush_interval_ms * 1000000ULL);
+        }
+        pending = drain_rings(log);
+
+        char *full = log->batch;
+        size_t length = log->batch_used;
+        log->batch = log->writing;
+        log->batch_used = 0;
+        log->writing = full;
+        uv_mutex_unlock(&log->mutex);
+
+        write_batch(log, full, length);
+        // 停止后写完停止前追加的全部记录再退出
+        if (!running && !pending) {
+            return;
+        }
+        uv_mutex_lock(&log->mutex);
+    }
+}
+
+// 向上取2的幂
+static size_t round_up_pow2(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+http_access_log_t* http_access_log_create(const http_access_log_config_t *config) {
+    if (!config || !config->file) {
+        return NULL;
+    }
+
+    http_access_log_t *log = calloc(1, sizeof(http_access_log_t));
+    if (!log) {
+        return NULL;
+    }
+    log->ring_capacity = round_up_pow2(config->ring_capacity > 0 ? config->ring_capacity : 1024);
+    log->flush_interval_ms = config->flush_interval_ms > 0 ? config->flush_interval_ms : 200;
+    log->sample_threshold = config->sample_threshold;
+    log->sample_rate = config->sample_rate > 1 ? config->sample_rate : 1;
+    log->cached_second = (time_t) -1;
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    log->realtime_offset_ns = (int64_t) now.tv_sec * 1000000000LL + now.tv_nsec - (int64_t) uv_hrtime();
+
+    log->batch = malloc(ACCESS_LOG_BATCH_SIZE);
+    log->writing = malloc(ACCESS_LOG_BATCH_SIZE);
+    log->fd = open(config->file, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (!log->batch || !log->writing || log->fd < 0) {
+        log_error("打开访问日志失败: %s", config->file);
+        if (log->fd >= 0) {
+            close(log->fd);
+        }
+        free(log->batch);
+        free(log->writing);
+        free(log);
+        return NULL;
+    }
+
+    if (uv_mutex_init(&log->mutex) != 0) {
+        close(log->fd);
+        free(log->batch);
+        free(log->writing);
+        free(log);
+        return NULL;
+    }
+    if (uv_cond_init(&log->cond) != 0) {
+        uv_mutex_destroy(&log->mutex);
+        close(log->fd);
+        free(log->batch);
+        free(log->writing);
+        free(log);
+        return NULL;
+    }
+
+    log->running = 1;
+    if (uv_thread_create(&log->thread, access_log_thread, log) != 0) {
+        uv_cond_destroy(&log->cond);
+        uv_mutex_destroy(&log->mutex);
+        close(log->fd);
+        free(log->batch);
+        free(log->writing);
+        free(log);
+        return NULL;
+    }
+    return log;
+}
+
+void http_access_log_destroy(http_access_log_t *log) {
+    if (!log) {
+        return;
+    }
+
+    uv_mutex_lock(&log->mutex);
+    log->running = 0;
+    uv_cond_signal(&log->cond);
+    uv_mutex_unlock(&log->mutex);
+    uv_thread_join(&log->thread);
+
+    http_access_log_ring_t *ring = log->rings;
+    while (ring) {
+        http_access_log_ring_t *next = ring->next;
+        free(ring->records);
+        free(ring);
+        ring = next;
+    }
+    for (size_t i = 0; i < log->route_name_count; i++) {
+        free(log->route_names[i]);
+    }
+    free(log->route_names);
+
+    uv_cond_destroy(&log->cond);
+    uv_mutex_destroy(&log->mutex);
+    close(log->fd);
+    free(log->batch);
+    free(log->writing);
+    free(log);
+}
+
+http_access_log_ring_t* http_access_log_ring_create(http_access_log_t *log) {
+    if (!log) {
+        return NULL;
+    }
+
+    http_access_log_ring_t *ring = calloc(1, sizeof(http_access_log_ring_t));
+    if (!ring) {
+        return NULL;
+    }
+    ring->records = malloc(log->ring_capacity * sizeof(http_access_log_record_t));
+    if (!ring->records) {
+        free(ring);
+        return NULL;
+    }
+    ring->mask = log->ring_capacity - 1;
+    ring->log = log;
+
+    uv_mutex_lock(&log->mutex);
+    ring->next = log->rings;
+    log->rings = ring;
+    uv_mutex_unlock(&log->mutex);
+    return ring;
+}
+
+int http_access_log_set_route_name(http_access_log_t *log, uint16_t route_id, const char *name) {
+    if (!log || !name || route_id == HTTP_ACCESS_LOG_NO_ROUTE) {
+        return -1;
+    }
+
+    char *copy = strdup(name);
+    if (!copy) {
+        return -1;
+    }
+
+    uv_mutex_lock(&log->mutex);
+    if (route_id >= log->route_name_count) {
+        size_t new_count = round_up_pow2((size_t) route_id + 1);
+        char **names = realloc(log->route_names, new_count * sizeof(char*));
+        if (!names) {
+            uv_mutex_unlock(&log->mutex);
+            free(copy);
+            return -1;
+        }
+        memset(names + log->route_name_count, 0, (new_count - log->route_name_count) * sizeof(char*));
+        log->route_names = names;
+        log->route_name_count = new_count;
+    }
+    free(log->route_names[route_id]);
+    log->route_names[route_id] = copy;
+    uv_mutex_unlock(&log->mutex);
+    return 0;
+}
+
+int http_access_log_append(http_access_log_ring_t *ring, const http_access_log_record_t *record) {
+    if (!ring || !record) {
+        return -1;
+    }
+
+    http_access_log_t *log = ring->log;
+    uint16_t weight = 1;
+
+    // 每秒请求数超过阈值后，非5xx请求每sample_rate个保留1个
+    if (log->sample_threshold > 0) {
+        uint64_t second = record->start_ns / 1000000000ULL;
+        if (second != ring->sample_second) {
+            ring->sample_second = second;
+            ring->second_count = 0;
+        }
+        if (++ring->second_count > log->sample_threshold && record->status < 500) {
+            if (++ring->sample_counter < log->sample_rate) {
+                __atomic_store_n(&ring->sampled_out, ring->sampled_out + 1, __ATOMIC_RELAXED);
+                return 1;
+            }
+            ring->sample_counter = 0;
+            weight = (uint16_t) (log->sample_rate > UINT16_MAX ? UINT16_MAX : log->sample_rate);
+        }
+    }
+
+    size_t head = ring->head;
+    size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    size_t used = head - tail;
+    if (used > ring->mask) {
+        __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+
+    http_access_log_record_t *slot = &ring->records[head & ring->mask];
+    *slot = *record;
+    slot->weight = weight;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+
+    // 环刚好过半时提前唤醒后台线程，其余情况等待定时写出
+    // 不加锁发信号：后台线程写文件时持有锁，事件循环不能等待；错过的唤醒由定时等待兜底
+    if (used + 1 == (ring->mask + 1) / 2) {
+        uv_cond_signal(&log->cond);
+    }
+    return 0;
+}
+
+void http_access_log_get_stats(http_access_log_t *log, http_access_log_stats_t *stats) {
+    if (!log || !stats) {
+        return;
+    }
+
+    memset(stats, 0, sizeof(http_access_log_stats_t));
+    stats->written = __atomic_load_n(&log->written, __ATOMIC_RELAXED);
+
+    uv_mutex_lock(&log->mutex);
+    for (http_access_log_ring_t *ring = log->rings; ring; ring = ring->next) {
+        stats->dropped += __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+        stats->sampled_out += __atomic_load_n(&ring->sampled_out, __ATOMIC_RELAXED);
+    }
+    uv_mutex_unlock(&log->mutex);
+}
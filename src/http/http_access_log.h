@@ -0,0 +1,74 @@
+#ifndef HTTP_ACCESS_LOG_H
+#define HTTP_ACCESS_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// HTTP访问日志
+// 请求路径上只向所在事件循环的环形缓冲区追加一条定长二进制记录（单生产者/单消费者，无锁），
+// 后台线程定期取出全部记录，格式化为文本后批量写入文件。环满时丢弃记录并计数，不阻塞事件循环。
+// 每秒记录数超过阈值后按比例采样，被保留的记录携带其代表的请求数；5xx响应始终记录。
+
+// 未匹配到路由的请求使用的路由ID
+#define HTTP_ACCESS_LOG_NO_ROUTE 0
+
+// 访问日志记录（32字节）
+typedef struct {
+    uint64_t start_ns;          // 请求开始时间（uv_hrtime，收到请求的第一个字节）
+    uint32_t latency_us;        // 从请求开始到响应交给I/O层的耗时
+    uint32_t connection_id;
+    uint32_t bytes_in;          // 请求字节数（头部+请求体）
+    uint32_t bytes_out;         // 响应字节数
+    uint16_t status;
+    uint16_t route_id;
+    uint8_t method;             // http_method_t
+    uint8_t reserved;
+    uint16_t weight;            // 本记录代表的请求数（采样时大于1）
+} http_access_log_record_t;
+
+// 访问日志配置
+typedef struct {
+    const char *file;
+    size_t ring_capacity;       // 每个环的记录数，向上取2的幂
+    int flush_interval_ms;      // 后台线程写出间隔
+    unsigned sample_threshold;  // 每秒超过该记录数后开始采样，0表示不采样
+    unsigned sample_rate;       // 采样时每N个请求保留1条记录
+} http_access_log_config_t;
+
+// 统计信息
+typedef struct {
+    uint64_t written;           // 已写入文件的记录数
+    uint64_t dropped;           // 环满丢弃的记录数
+    uint64_t sampled_out;       // 采样跳过的请求数
+} http_access_log_stats_t;
+
+typedef struct http_access_log http_access_log_t;
+typedef struct http_access_log_ring http_access_log_ring_t;
+
+// 创建访问日志并启动后台写入线程，失败返回NULL
+http_access_log_t* http_access_log_create(const http_access_log_config_t *config);
+
+// 停止后台线程（写出剩余记录）并释放全部环
+void http_access_log_destroy(http_access_log_t *log);
+
+// 为一个事件循环创建环，环只能由该循环所在线程追加记录
+http_access_log_ring_t* http_access_log_ring_create(http_access_log_t *log);
+
+// 设置路由ID对应的名称（路径），写入日志时使用
+int http_access_log_set_route_name(http_access_log_t *log, uint16_t route_id, const char *name);
+
+// 追加一条记录：返回0表示已记录，1表示被采样跳过，-1表示环已满被丢弃
+int http_access_log_append(http_access_log_ring_t *ring, const http_access_log_record_t *record);
+
+// 获取统计信息
+void http_access_log_get_stats(http_access_log_t *log, http_access_log_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_ACCESS_LOG_H
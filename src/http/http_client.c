@@ -0,0 +1,1029 @@
+#include "src/http/http_client.h"
+#include "src/http/http_parser.h"
+#include "src/log/logger_module.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <strings.h>
+
+// 超时检查间隔（毫秒），超时精度以此为准
+#define HTTP_CLIENT_SWEEP_INTERVAL_MS 100
+
+// 连接读取缓冲区的初始大小和每次读取的最小空闲空间
+#define HTTP_CLIENT_BUFFER_SIZE 8192
+#define HTTP_CLIENT_READ_MIN 4096
+
+// 连接断开时可重试请求的最大发送次数
+#define HTTP_CLIENT_MAX_ATTEMPTS 2
+
+// 默认配置
+static const http_client_config_t default_config = {
+    .max_connections_per_host = 8,
+    .max_pipeline_depth = 4,
+    .connect_timeout_ms = 5000,
+    .request_timeout_ms = 30000,
+    .idle_timeout_ms = 60000,
+    .max_response_size = 16 * 1024 * 1024
+};
+
+// 主机地址解析状态
+typedef enum {
+    HOST_UNRESOLVED,
+    HOST_RESOLVING,
+    HOST_RESOLVED
+} host_state_t;
+
+// 连接状态
+typedef enum {
+    CONN_CONNECTING,
+    CONN_READY,
+    CONN_CLOSING
+} conn_state_t;
+
+// 响应体的分帧方式
+typedef enum {
+    BODY_NONE,
+    BODY_LENGTH,
+    BODY_CHUNKED,
+    BODY_UNTIL_CLOSE
+} body_mode_t;
+
+struct http_client_host;
+
+// 请求
+typedef struct http_client_req {
+    uv_write_t write_req;
+    char *buffer;               // 序列化后的完整请求，重试时重新发送
+    size_t length;
+    http_method_t method;
+    uint64_t deadline;
+    int attempts;
+    int writing;                // 写入尚未完成，由写入回调负责释放
+    int finished;               // 已回调完成，等待写入回调释放
+    http_client_callback_t callback;
+    void *user_data;
+    struct http_client_req *next;
+} http_client_req_t;
+
+// 请求队列（FIFO）
+typedef struct {
+    http_client_req_t *head;
+    http_client_req_t *tail;
+    int count;
+} req_queue_t;
+
+// 连接
+typedef struct http_client_conn {
+    uv_tcp_t tcp;
+    uv_connect_t connect_req;
+    struct http_client_host *host;
+    conn_state_t state;
+    uint64_t connect_deadline;
+    uint64_t idle_since;
+    req_queue_t inflight;       // 已发送、等待响应的请求
+    int keep_alive;
+
+    // 读取缓冲区（结尾预留'\0'）
+    char *buffer;
+    size_t buffer_size;
+    size_t buffer_used;
+
+    // 当前响应的解析状态（头部解析完成后保留，等待响应体）
+    int head_parsed;
+    size_t head_length;
+    body_mode_t body_mode;
+    size_t content_length;
+    char *header_block;
+    char *reason;
+    http_client_response_t response;
+
+    struct http_client_conn *next;
+} http_client_conn_t;
+
+// 主机连接池
+typedef struct http_client_host {
+    http_client_t *client;
+    char *name;
+    int port;
+    char *host_header;          // "Host: name[:port]\r\n"
+    host_state_t state;
+    struct sockaddr_storage addr;
+    uv_getaddrinfo_t resolver;
+    req_queue_t pending;        // 等待空闲连接的请求
+    http_client_conn_t *connections;
+    int connection_count;
+    int connecting_count;
+    struct http_client_host *next;
+} http_client_host_t;
+
+// 客户端
+struct http_client {
+    uv_loop_t *loop;
+    http_client_config_t config;
+    http_client_host_t *hosts;
+    uv_timer_t sweep_timer;
+    int handle_count;           // 未关闭的句柄和未完成的地址解析数
+    int destroyed;
+};
+
+// 内部函数声明
+static void dispatch(http_client_host_t *host);
+
+// 队列操作
+static void queue_push(req_queue_t *queue, http_client_req_t *req) {
+    req->next = NULL;
+    if (queue->tail) {
+        queue->tail->next = req;
+    } else {
+        queue->head = req;
+    }
+    queue->tail = req;
+    queue->count++;
+}
+
+static http_client_req_t* queue_pop(req_queue_t *queue) {
+    http_client_req_t *req = queue->head;
+    if (req) {
+        queue->head = req->next;
+        if (!queue->head) {
+            queue->tail = NULL;
+        }
+        queue->count--;
+        req->next = NULL;
+    }
+    return req;
+}
+
+// 幂等请求可以流水线发送，连接断开时也可以安全重试
+static int is_idempotent(http_method_t method) {
+    return method == HTTP_METHOD_GET || method == HTTP_METHOD_HEAD ||
+           method == HTTP_METHOD_PUT || method == HTTP_METHOD_DELETE ||
+           method == HTTP_METHOD_OPTIONS;
+}
+
+// 释放请求（写入未完成时推迟到写入回调）
+static void release_request(http_client_req_t *req) {
+    if (req->writing) {
+        req->finished = 1;
+        return;
+    }
+    free(req->buffer);
+    free(req);
+}
+
+// 以错误状态完成请求
+static void fail_request(http_client_req_t *req, int status) {
+    if (req->callback) {
+        req->callback(status, NULL, req->user_data);
+    }
+    release_request(req);
+}
+
+// 以错误状态完成队列中的全部请求（先摘下队列，回调中可能提交新请求）
+static void fail_queue(req_queue_t *queue, int status) {
+    req_queue_t failed = *queue;
+    memset(queue, 0, sizeof(req_queue_t));
+
+    http_client_req_t *req;
+    while ((req = queue_pop(&failed)) != NULL) {
+        fail_request(req, status);
+    }
+}
+
+// 客户端的全部句柄关闭后释放内存
+static void maybe_free_client(http_client_t *client) {
+    if (!client->destroyed || client->handle_count > 0) {
+        return;
+    }
+
+    http_client_host_t *host = client->hosts;
+    while (host) {
+        http_client_host_t *next = host->next;
+        free(host->name);
+        free(host->host_header);
+        free(host);
+        host = next;
+    }
+    free(client);
+}
+
+// 释放当前响应的解析结果
+static void reset_response(http_client_conn_t *conn) {
+    free(conn->header_block);
+    free(conn->response.headers);
+    free(conn->reason);
+    conn->header_block = NULL;
+    conn->reason = NULL;
+    conn->head_parsed = 0;
+    conn->head_length = 0;
+    memset(&conn->response, 0, sizeof(http_client_response_t));
+}
+
+// 连接关闭回调
+static void on_conn_close(uv_handle_t *handle) {
+    http_client_conn_t *conn = (http_client_conn_t*) handle->data;
+    http_client_t *client = conn->host->client;
+
+    reset_response(conn);
+    free(conn->buffer);
+    free(conn);
+
+    client->handle_count--;
+    maybe_free_client(client);
+}
+
+// 从主机连接池中移除连接
+static void unlink_connection(http_client_conn_t *conn) {
+    http_client_host_t *host = conn->host;
+    http_client_conn_t **link = &host->connections;
+    while (*link && *link != conn) {
+        link = &(*link)->next;
+    }
+    if (*link) {
+        *link = conn->next;
+    }
+    host->connection_count--;
+    if (conn->state == CONN_CONNECTING) {
+        host->connecting_count--;
+    }
+}
+
+// 关闭连接：未完成的请求在允许重试时放回主机队列，否则以status完成（不重新分配连接）
+static void shutdown_connection(http_client_conn_t *conn, int status, int retry) {
+    if (conn->state == CONN_CLOSING) {
+        return;
+    }
+
+    http_client_host_t *host = conn->host;
+    unlink_connection(conn);
+    conn->state = CONN_CLOSING;
+    uv_close((uv_handle_t*) &conn->tcp, on_conn_close);
+
+    // 重试的请求按原顺序放回队列头部
+    req_queue_t inflight = conn->inflight;
+    memset(&conn->inflight, 0, sizeof(req_queue_t));
+
+    // 写入回调仍持有的请求不能重用uv_write_t，只能失败
+    req_queue_t retried = {0};
+    req_queue_t failed = {0};
+    http_client_req_t *req;
+    while ((req = queue_pop(&inflight)) != NULL) {
+        if (retry && !host->client->destroyed && !req->writing && is_idempotent(req->method) &&
+            req->attempts < HTTP_CLIENT_MAX_ATTEMPTS) {
+            queue_push(&retried, req);
+        } else {
+            queue_push(&failed, req);
+        }
+    }
+
+    if (retried.head) {
+        retried.tail->next = host->pending.head;
+        host->pending.head = retried.head;
+        if (!host->pending.tail) {
+            host->pending.tail = retried.tail;
+        }
+        host->pending.count += retried.count;
+    }
+
+    fail_queue(&failed, status);
+}
+
+// 关闭连接，并为重新排队的请求分配连接
+static void close_connection(http_client_conn_t *conn, int status, int retry) {
+    http_client_host_t *host = conn->host;
+
+    shutdown_connection(conn, status, retry);
+    if (!host->client->destroyed) {
+        dispatch(host);
+    }
+}
+
+// 连接建立失败：这是主机的最后一个连接时，排队的请求无法继续
+static void abandon_connect(http_client_conn_t *conn, int status) {
+    http_client_host_t *host = conn->host;
+
+    req_queue_t stranded = {0};
+    if (host->connection_count == 1) {
+        stranded = host->pending;
+        memset(&host->pending, 0, sizeof(req_queue_t));
+    }
+
+    shutdown_connection(conn, status, 0);
+    fail_queue(&stranded, status);
+}
+
+// 写入回调
+static void on_write(uv_write_t *write_req, int status) {
+    http_client_req_t *req = (http_client_req_t*) write_req;
+    http_client_conn_t *conn = (http_client_conn_t*) write_req->data;
+
+    req->writing = 0;
+    if (req->finished) {
+        release_request(req);
+        return;
+    }
+
+    if (status < 0 && status != UV_ECANCELED) {
+        log_warn("HTTP客户端写入错误: %s", uv_strerror(status));
+        close_connection(conn, status, 1);
+    }
+}
+
+// 在连接上发送请求
+static void send_request(http_client_conn_t *conn, http_client_req_t *req) {
+    if (conn->inflight.count == 0) {
+        uv_ref((uv_handle_t*) &conn->tcp);
+    }
+
+    queue_push(&conn->inflight, req);
+    req->attempts++;
+    req->writing = 1;
+    req->write_req.data = conn;
+
+    uv_buf_t buf = uv_buf_init(req->buffer, (unsigned int) req->length);
+    int result = uv_write(&req->write_req, (uv_stream_t*) &conn->tcp, &buf, 1, on_write);
+    if (result != 0) {
+        req->writing = 0;
+        log_warn("HTTP客户端发送请求失败: %s", uv_strerror(result));
+        close_connection(conn, result, 1);
+    }
+}
+
+// 读取缓冲区分配：直接读入连接缓冲区，避免额外复制
+static void on_alloc(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
+    http_client_conn_t *conn = (http_client_conn_t*) handle->data;
+    (void)suggested_size; // 避免未使用参数警告
+
+    if (conn->buffer_size - conn->buffer_used - 1 < HTTP_CLIENT_READ_MIN) {
+        size_t new_size = conn->buffer_size * 2;
+        char *new_buffer = realloc(conn->buffer, new_size);
+        if (!new_buffer) {
+            buf->base = NULL;
+            buf->len = 0;
+            return;
+        }
+        conn->buffer = new_buffer;
+        conn->buffer_size = new_size;
+    }
+
+    buf->base = conn->buffer + conn->buffer_used;
+    buf->len = conn->buffer_size - conn->buffer_used - 1;
+}
+
+// 解析状态行和头部，返回1表示完成，0表示数据不完整，-1表示格式错误
+static int parse_response_head(http_client_conn_t *conn) {
+    const char *data = conn->buffer;
+    const char *headers_end = http_find_header_end(data, conn->buffer_used);
+    if (!headers_end) {
+        return 0;
+    }
+
+    // 状态行：HTTP/1.x SSS Reason（按长度查找行尾，数据中可能有NUL）
+    const char *line_end = memmem(data, headers_end + 2 - data, "\r\n", 2);
+    if (line_end - data < 12 || memchr(data, '\0', line_end - data) ||
+        strncmp(data, "HTTP/1.", 7) != 0 || data[8] != ' ') {
+        return -1;
+    }
+    int status_code = 0;
+    for (int i = 9; i < 12; i++) {
+        if (data[i] < '0' || data[i] > '9') {
+            return -1;
+        }
+        status_code = status_code * 10 + (data[i] - '0');
+    }
+
+    const char *reason = data + 12;
+    while (reason < line_end && *reason == ' ') reason++;
+    conn->reason = strndup(reason, line_end - reason);
+    if (!conn->reason) {
+        return -1;
+    }
+    conn->response.status_code = status_code;
+    conn->response.reason = conn->reason;
+
+    // 解析头部（包含最后一个头部行的CRLF），含NUL或不跟LF的CR时按格式错误处理
+    const char *headers_start = line_end + 2;
+    if (http_parse_header_block(headers_start, headers_end + 2 - headers_start, &conn->header_block,
+                                &conn->response.headers, &conn->response.header_count,
+                                conn->response.known_headers) != 0) {
+        return -1;
+    }
+    conn->head_length = headers_end + 4 - data;
+    conn->head_parsed = 1;
+
+    // 长连接：HTTP/1.1默认保持，HTTP/1.0需要显式keep-alive
+    const char *connection = conn->response.known_headers[HTTP_HEADER_CONNECTION];
+    if (data[7] == '0') {
+        conn->keep_alive = connection && strcasecmp(connection, "keep-alive") == 0;
+    } else {
+        conn->keep_alive = !(connection && strcasecmp(connection, "close") == 0);
+    }
+
+    // 确定响应体的分帧方式
+    const char *content_length = conn->response.known_headers[HTTP_HEADER_CONTENT_LENGTH];
+    if (conn->inflight.head->method == HTTP_METHOD_HEAD || status_code == 204 ||
+        status_code == 304 || (status_code >= 100 && status_code < 200)) {
+        conn->body_mode = BODY_NONE;
+    } else if (http_is_chunked(conn->response.known_headers[HTTP_HEADER_TRANSFER_ENCODING])) {
+        conn->body_mode = BODY_CHUNKED;
+    } else if (content_length) {
+        char *end = NULL;
+        unsigned long long declared = strtoull(content_length, &end, 10);
+        if (end == content_length || declared > conn->host->client->config.max_response_size) {
+            return -1;
+        }
+        conn->body_mode = BODY_LENGTH;
+        conn->content_length = (size_t) declared;
+    } else {
+        conn->body_mode = BODY_UNTIL_CLOSE;
+        conn->keep_alive = 0;
+    }
+
+    return 1;
+}
+
+// 完成队首请求：回调期间响应体以'\0'结尾，回调后移出已消费的数据
+// 回调中可能销毁客户端，调用者需检查destroyed
+static void complete_request(http_client_conn_t *conn, size_t consumed, char *decoded_body) {
+    http_client_req_t *req = queue_pop(&conn->inflight);
+
+    char saved = conn->buffer[consumed];
+    if (!decoded_body && conn->response.body) {
+        conn->buffer[conn->head_length + conn->response.body_length] = '\0';
+    }
+
+    if (req->callback) {
+        req->callback(0, &conn->response, req->user_data);
+    }
+
+    conn->buffer[consumed] = saved;
+    free(decoded_body);
+    reset_response(conn);
+    release_request(req);
+
+    memmove(conn->buffer, conn->buffer + consumed, conn->buffer_used - consumed);
+    conn->buffer_used -= consumed;
+    conn->buffer[conn->buffer_used] = '\0';
+}
+
+// 从缓冲区中依次解析响应并完成对应的请求
+static void process_buffer(http_client_conn_t *conn) {
+    http_client_t *client = conn->host->client;
+
+    while (conn->state == CONN_READY && conn->buffer_used > 0) {
+        if (!conn->inflight.head) {
+            // 没有等待中的请求却收到数据
+            log_warn("HTTP客户端收到未请求的响应数据");
+            close_connection(conn, UV_EPROTO, 0);
+            return;
+        }
+
+        if (!conn->head_parsed) {
+            int result = parse_response_head(conn);
+            if (result == 0) {
+                break;
+            }
+            if (result < 0) {
+                close_connection(conn, UV_EPROTO, 0);
+                return;
+            }
+        }
+
+        size_t available = conn->buffer_used - conn->head_length;
+        const char *body = conn->buffer + conn->head_length;
+        int status_code = conn->response.status_code;
+
+        if (conn->body_mode == BODY_NONE) {
+            if (status_code >= 100 && status_code < 200) {
+                // 1xx中间响应，跳过后继续等待最终响应
+                size_t consumed = conn->head_length;
+                reset_response(conn);
+                memmove(conn->buffer, conn->buffer + consumed, conn->buffer_used - consumed);
+                conn->buffer_used -= consumed;
+                conn->buffer[conn->buffer_used] = '\0';
+                continue;
+            }
+            complete_request(conn, conn->head_length, NULL);
+        } else if (conn->body_mode == BODY_LENGTH) {
+            if (available < conn->content_length) {
+                break;
+            }
+            conn->response.body = body;
+            conn->response.body_length = conn->content_length;
+            complete_request(conn, conn->head_length + conn->content_length, NULL);
+        } else if (conn->body_mode == BODY_CHUNKED) {
+            char *decoded = NULL;
+            size_t decoded_length = 0;
+            size_t consumed = 0;
+            int result = http_decode_chunked(body, available, &decoded, &decoded_length, &consumed);
+            if (result == 0) {
+                break;
+            }
+            if (result < 0) {
+                close_connection(conn, UV_EPROTO, 0);
+                return;
+            }
+            conn->response.body = decoded;
+            conn->response.body_length = decoded_length;
+            complete_request(conn, conn->head_length + consumed, decoded);
+        } else {
+            // 响应体直到连接关闭，在读到EOF时完成
+            break;
+        }
+
+        if (client->destroyed) {
+            return;
+        }
+        if (!conn->keep_alive) {
+            close_connection(conn, UV_ECONNRESET, 1);
+            return;
+        }
+    }
+
+    if (conn->state != CONN_READY) {
+        return;
+    }
+
+    if (conn->buffer_used > client->config.max_response_size) {
+        log_warn("HTTP客户端响应超过最大长度");
+        close_connection(conn, UV_ENOBUFS, 0);
+        return;
+    }
+
+    // 空闲连接不阻止事件循环退出
+    if (conn->inflight.count == 0) {
+        conn->idle_since = uv_now(client->loop);
+        uv_unref((uv_handle_t*) &conn->tcp);
+    }
+    dispatch(conn->host);
+}
+
+// 读取回调
+static void on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+    http_client_conn_t *conn = (http_client_conn_t*) stream->data;
+    (void)buf; // 数据已直接读入连接缓冲区
+
+    if (nread > 0) {
+        conn->buffer_used += nread;
+        conn->buffer[conn->buffer_used] = '\0';
+        process_buffer(conn);
+        return;
+    }
+
+    if (nread == 0) {
+        return;
+    }
+
+    // 以连接关闭为结束的响应体在EOF时完成
+    if (nread == UV_EOF && conn->head_parsed && conn->body_mode == BODY_UNTIL_CLOSE) {
+        conn->response.body = conn->buffer + conn->head_length;
+        conn->response.body_length = conn->buffer_used - conn->head_length;
+        complete_request(conn, conn->buffer_used, NULL);
+        if (conn->host->client->destroyed) {
+            return;
+        }
+    } else if (nread != UV_EOF) {
+        log_warn("HTTP客户端读取错误: %s", uv_err_name(nread));
+    }
+
+    // 未收到任何响应数据的请求可以重试（服务端可能恰好关闭了空闲连接）
+    int retry = conn->buffer_used == 0;
+    close_connection(conn, nread == UV_EOF ? UV_ECONNRESET : (int) nread, retry);
+}
+
+// 连接建立回调
+static void on_connect(uv_connect_t *connect_req, int status) {
+    http_client_conn_t *conn = (http_client_conn_t*) connect_req->data;
+    http_client_host_t *host = conn->host;
+
+    if (conn->state != CONN_CONNECTING) {
+        return;
+    }
+
+    if (status < 0) {
+        log_warn("HTTP客户端连接 %s:%d 失败: %s", host->name, host->port, uv_strerror(status));
+        abandon_connect(conn, status);
+        return;
+    }
+
+    host->connecting_count--;
+    conn->state = CONN_READY;
+    uv_read_start((uv_stream_t*) &conn->tcp, on_alloc, on_read);
+    dispatch(host);
+}
+
+// 建立新连接
+static int open_connection(http_client_host_t *host) {
+    http_client_t *client = host->client;
+
+    http_client_conn_t *conn = calloc(1, sizeof(http_client_conn_t));
+    if (!conn) {
+        return -1;
+    }
+    conn->buffer_size = HTTP_CLIENT_BUFFER_SIZE;
+    conn->buffer = malloc(conn->buffer_size);
+    if (!conn->buffer) {
+        free(conn);
+        return -1;
+    }
+    conn->buffer[0] = '\0';
+    conn->host = host;
+    conn->state = CONN_CONNECTING;
+    conn->keep_alive = 1;
+    conn->connect_deadline = uv_now(client->loop) + (uint64_t) client->config.connect_timeout_ms;
+
+    uv_tcp_init(client->loop, &conn->tcp);
+    conn->tcp.data = conn;
+    conn->connect_req.data = conn;
+    client->handle_count++;
+
+    conn->next = host->connections;
+    host->connections = conn;
+    host->connection_count++;
+    host->connecting_count++;
+
+    uv_tcp_nodelay(&conn->tcp, 1);
+    int result = uv_tcp_connect(&conn->connect_req, &conn->tcp,
+                                (const struct sockaddr*) &host->addr, on_connect);
+    if (result != 0) {
+        log_warn("HTTP客户端连接 %s:%d 失败: %s", host->name, host->port, uv_strerror(result));
+        shutdown_connection(conn, result, 0);
+        return -1;
+    }
+    return 0;
+}
+
+// 选择可发送请求的连接：优先未完成请求最少的连接，非幂等请求只在空闲连接上发送
+static http_client_conn_t* pick_connection(http_client_host_t *host, const http_client_req_t *req) {
+    int max_depth = host->client->config.max_pipeline_depth;
+    http_client_conn_t *best = NULL;
+
+    for (http_client_conn_t *conn = host->connections; conn; conn = conn->next) {
+        if (conn->state != CONN_READY || !conn->keep_alive) {
+            continue;
+        }
+
+        int depth = conn->inflight.count;
+        if (depth > 0 && (!is_idempotent(req->method) ||
+                          !is_idempotent(conn->inflight.tail->method) || depth >= max_depth)) {
+            continue;
+        }
+        if (!best || depth < best->inflight.count) {
+            best = conn;
+            if (depth == 0) {
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+// 地址解析回调
+static void on_resolved(uv_getaddrinfo_t *resolver, int status, struct addrinfo *result) {
+    http_client_host_t *host = (http_client_host_t*) resolver->data;
+    http_client_t *client = host->client;
+
+    client->handle_count--;
+
+    if (client->destroyed) {
+        if (result) uv_freeaddrinfo(result);
+        maybe_free_client(client);
+        return;
+    }
+
+    if (status < 0 || !result) {
+        log_warn("HTTP客户端解析主机 %s 失败: %s", host->name, uv_strerror(status));
+        host->state = HOST_UNRESOLVED;
+        if (result) uv_freeaddrinfo(result);
+        fail_queue(&host->pending, status < 0 ? status : UV_EAI_NONAME);
+        return;
+    }
+
+    memcpy(&host->addr, result->ai_addr, result->ai_addrlen);
+    uv_freeaddrinfo(result);
+    host->state = HOST_RESOLVED;
+    dispatch(host);
+}
+
+// 解析主机地址：IP地址直接使用，主机名异步解析
+static void resolve_host(http_client_host_t *host) {
+    http_client_t *client = host->client;
+
+    if (uv_ip4_addr(host->name, host->port, (struct sockaddr_in*) &host->addr) == 0 ||
+        uv_ip6_addr(host->name, host->port, (struct sockaddr_in6*) &host->addr) == 0) {
+        host->state = HOST_RESOLVED;
+        return;
+    }
+
+    char service[16];
+    snprintf(service, sizeof(service), "%d", host->port);
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    host->resolver.data = host;
+    int result = uv_getaddrinfo(client->loop, &host->resolver, on_resolved, host->name, service, &hints);
+    if (result != 0) {
+        log_warn("HTTP客户端解析主机 %s 失败: %s", host->name, uv_strerror(result));
+        fail_queue(&host->pending, result);
+        return;
+    }
+    host->state = HOST_RESOLVING;
+    client->handle_count++;
+}
+
+// 为排队的请求分配连接，必要时建立新连接
+static void dispatch(http_client_host_t *host) {
+    http_client_t *client = host->client;
+
+    if (host->state == HOST_UNRESOLVED) {
+        resolve_host(host);
+    }
+    if (host->state != HOST_RESOLVED) {
+        return;
+    }
+
+    while (host->pending.head && !client->destroyed) {
+        http_client_conn_t *conn = pick_connection(host, host->pending.head);
+        if (conn) {
+            send_request(conn, queue_pop(&host->pending));
+            continue;
+        }
+
+        // 正在建立的连接足以承接排队的请求时不再新建
+        if (host->connection_count >= client->config.max_connections_per_host ||
+            host->connecting_count * client->config.max_pipeline_depth >= host->pending.count) {
+            break;
+        }
+        if (open_connection(host) != 0) {
+            if (host->connection_count == 0) {
+                fail_queue(&host->pending, UV_ENOMEM);
+            }
+            break;
+        }
+    }
+}
+
+// 定时检查超时：排队超时、连接超时、响应超时和空闲连接
+static void on_sweep_timer(uv_timer_t *handle) {
+    http_client_t *client = (http_client_t*) handle->data;
+    uint64_t now = uv_now(client->loop);
+    int active = 0;
+
+    for (http_client_host_t *host = client->hosts; host && !client->destroyed; host = host->next) {
+        // 排队中的请求（队列按提交顺序，截止时间递增）
+        while (host->pending.head && host->pending.head->deadline <= now && !client->destroyed) {
+            fail_request(queue_pop(&host->pending), UV_ETIMEDOUT);
+        }
+
+        http_client_conn_t *conn = host->connections;
+        while (conn && !client->destroyed) {
+            http_client_conn_t *next = conn->next;
+
+            if (conn->state == CONN_CONNECTING && now >= conn->connect_deadline) {
+                log_warn("HTTP客户端连接 %s:%d 超时", host->name, host->port);
+                abandon_connect(conn, UV_ETIMEDOUT);
+            } else if (conn->state == CONN_READY && conn->inflight.head &&
+                       conn->inflight.head->deadline <= now) {
+                // 队首请求超时，流水线中其后的请求按断开处理
+                fail_request(queue_pop(&conn->inflight), UV_ETIMEDOUT);
+                close_connection(conn, UV_ETIMEDOUT, 1);
+            } else if (conn->state == CONN_READY && conn->inflight.count == 0 &&
+                       now - conn->idle_since >= (uint64_t) client->config.idle_timeout_ms) {
+                close_connection(conn, UV_ECANCELED, 0);
+            }
+
+            conn = next;
+        }
+
+        if (host->pending.count > 0 || host->connection_count > 0 || host->state == HOST_RESOLVING) {
+            active = 1;
+        }
+    }
+
+    // 没有连接和请求时停止定时器，提交新请求时重新启动
+    if (!active && !client->destroyed) {
+        uv_timer_stop(handle);
+    }
+}
+
+// 定时器关闭回调
+static void on_timer_close(uv_handle_t *handle) {
+    http_client_t *client = (http_client_t*) handle->data;
+    client->handle_count--;
+    maybe_free_client(client);
+}
+
+// 查找或创建主机连接池
+static http_client_host_t* get_host(http_client_t *client, const char *name, int port) {
+    for (http_client_host_t *host = client->hosts; host; host = host->next) {
+        if (host->port == port && strcasecmp(host->name, name) == 0) {
+            return host;
+        }
+    }
+
+    http_client_host_t *host = calloc(1, sizeof(http_client_host_t));
+    if (!host) {
+        return NULL;
+    }
+
+    // IPv6地址在Host头部中需要加方括号，默认端口省略
+    int ipv6 = strchr(name, ':') != NULL;
+    char header[300];
+    int length;
+    if (port == 80) {
+        length = snprintf(header, sizeof(header), ipv6 ? "Host: [%s]\r\n" : "Host: %s\r\n", name);
+    } else {
+        length = snprintf(header, sizeof(header), ipv6 ? "Host: [%s]:%d\r\n" : "Host: %s:%d\r\n", name, port);
+    }
+    if (length < 0 || (size_t) length >= sizeof(header)) {
+        free(host);
+        return NULL;
+    }
+
+    host->client = client;
+    host->name = strdup(name);
+    host->host_header = strdup(header);
+    host->port = port;
+    host->state = HOST_UNRESOLVED;
+    if (!host->name || !host->host_header) {
+        free(host->name);
+        free(host->host_header);
+        free(host);
+        return NULL;
+    }
+
+    host->next = client->hosts;
+    client->hosts = host;
+    return host;
+}
+
+// 序列化请求
+static char* build_request(http_method_t method, const char *path, const char *host_header,
+                           const char *extra_headers, const char *body, size_t body_length,
+                           size_t *length) {
+    const char *method_str = http_method_to_string(method);
+    int has_body = body_length > 0 || method == HTTP_METHOD_POST ||
+                   method == HTTP_METHOD_PUT || method == HTTP_METHOD_PATCH;
+
+    char content_length[48] = "";
+    if (has_body) {
+        snprintf(content_length, sizeof(content_length), "Content-Length: %zu\r\n", body_length);
+    }
+
+    size_t method_length = strlen(method_str);
+    size_t path_length = strlen(path);
+    size_t host_length = strlen(host_header);
+    size_t content_length_length = strlen(content_length);
+    size_t extra_length = extra_headers ? strlen(extra_headers) : 0;
+    size_t total = method_length + 1 + path_length + 11 + host_length +
+                   content_length_length + extra_length + 2 + body_length;
+
+    char *buffer = malloc(total);
+    if (!buffer) {
+        return NULL;
+    }
+
+    char *p = buffer;
+    memcpy(p, method_str, method_length); p += method_length;
+    *p++ = ' ';
+    memcpy(p, path, path_length); p += path_length;
+    memcpy(p, " HTTP/1.1\r\n", 11); p += 11;
+    memcpy(p, host_header, host_length); p += host_length;
+    memcpy(p, content_length, content_length_length); p += content_length_length;
+    if (extra_length > 0) {
+        memcpy(p, extra_headers, extra_length); p += extra_length;
+    }
+    memcpy(p, "\r\n", 2); p += 2;
+    if (body_length > 0) {
+        memcpy(p, body, body_length); p += body_length;
+    }
+
+    *length = total;
+    return buffer;
+}
+
+// 创建客户端
+http_client_t* http_client_create(uv_loop_t *loop, const http_client_config_t *config) {
+    if (!loop) {
+        return NULL;
+    }
+
+    http_client_t *client = calloc(1, sizeof(http_client_t));
+    if (!client) {
+        log_error("HTTP客户端内存分配失败");
+        return NULL;
+    }
+
+    client->loop = loop;
+    client->config = config ? *config : default_config;
+    if (client->config.max_connections_per_host <= 0) {
+        client->config.max_connections_per_host = default_config.max_connections_per_host;
+    }
+    if (client->config.max_pipeline_depth <= 0) {
+        client->config.max_pipeline_depth = 1;
+    }
+    if (client->config.max_response_size == 0) {
+        client->config.max_response_size = default_config.max_response_size;
+    }
+
+    // 超时检查定时器不阻止事件循环退出
+    uv_timer_init(loop, &client->sweep_timer);
+    client->sweep_timer.data = client;
+    uv_unref((uv_handle_t*) &client->sweep_timer);
+    client->handle_count = 1;
+
+    return client;
+}
+
+// 销毁客户端
+void http_client_destroy(http_client_t *client) {
+    if (!client || client->destroyed) {
+        return;
+    }
+    client->destroyed = 1;
+
+    for (http_client_host_t *host = client->hosts; host; host = host->next) {
+        fail_queue(&host->pending, UV_ECANCELED);
+
+        if (host->state == HOST_RESOLVING) {
+            uv_cancel((uv_req_t*) &host->resolver);
+        }
+
+        while (host->connections) {
+            close_connection(host->connections, UV_ECANCELED, 0);
+        }
+    }
+
+    uv_close((uv_handle_t*) &client->sweep_timer, on_timer_close);
+}
+
+// 提交请求
+int http_client_request(http_client_t *client, http_method_t method,
+                        const char *host, int port, const char *path,
+                        const char *extra_headers, const char *body, size_t body_length,
+                        http_client_callback_t callback, void *user_data) {
+    if (!client || client->destroyed || !host || !path || port <= 0 || port > 65535 ||
+        method == HTTP_METHOD_UNKNOWN || (body_length > 0 && !body)) {
+        return -1;
+    }
+
+    http_client_host_t *pool = get_host(client, host, port);
+    if (!pool) {
+        return -1;
+    }
+
+    http_client_req_t *req = calloc(1, sizeof(http_client_req_t));
+    if (!req) {
+        return -1;
+    }
+
+    req->buffer = build_request(method, path, pool->host_header, extra_headers,
+                                body, body_length, &req->length);
+    if (!req->buffer) {
+        free(req);
+        return -1;
+    }
+    req->method = method;
+    req->callback = callback;
+    req->user_data = user_data;
+    req->deadline = uv_now(client->loop) + (uint64_t) client->config.request_timeout_ms;
+
+    queue_push(&pool->pending, req);
+
+    if (!uv_is_active((uv_handle_t*) &client->sweep_timer)) {
+        uv_timer_start(&client->sweep_timer, on_sweep_timer,
+                       HTTP_CLIENT_SWEEP_INTERVAL_MS, HTTP_CLIENT_SWEEP_INTERVAL_MS);
+    }
+
+    dispatch(pool);
+    return 0;
+}
+
+// GET请求
+int http_client_get(http_client_t *client, const char *host, int port, const char *path,
+                    http_client_callback_t callback, void *user_data) {
+    return http_client_request(client, HTTP_METHOD_GET, host, port, path,
+                               NULL, NULL, 0, callback, user_data);
+}
+
+// 获取响应头部
+const char* http_client_response_header(const http_client_response_t *response, const char *name) {
+    if (!response || !name) {
+        return NULL;
+    }
+
+    http_header_id_t id = http_header_lookup(name, strlen(name));
+    if (id != HTTP_HEADER_UNKNOWN) {
+        return response->known_headers[id];
+    }
+
+    for (int i = 0; i < response->header_count; i++) {
+        if (strcasecmp(response->headers[i].name, name) == 0) {
+            return response->headers[i].value;
+        }
+    }
+    return NULL;
+}
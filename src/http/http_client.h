@@ -0,0 +1,69 @@
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include "src/http/http_module.h"
+#include <uv.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 异步HTTP/1.1客户端
+// 客户端绑定到一个事件循环，所有函数必须在该循环所在线程调用，回调也在该循环上执行。
+// 按host:port维护连接池，连接默认保持长连接，同一连接上可以流水线发送多个请求。
+
+// 客户端配置
+typedef struct {
+    int max_connections_per_host;   // 每个主机的最大连接数
+    int max_pipeline_depth;         // 每个连接上已发送未响应的最大请求数，1表示不使用流水线
+    int connect_timeout_ms;         // 连接超时
+    int request_timeout_ms;         // 请求超时（从提交开始计算，包含排队和连接时间）
+    int idle_timeout_ms;            // 空闲长连接保留时间
+    size_t max_response_size;       // 响应（头部+响应体）的最大字节数
+} http_client_config_t;
+
+// HTTP响应（由客户端持有，仅在回调期间有效）
+typedef struct {
+    int status_code;
+    const char *reason;
+    http_header_t *headers;
+    int header_count;
+    const char *known_headers[HTTP_HEADER_KNOWN_COUNT];
+    const char *body;
+    size_t body_length;
+} http_client_response_t;
+
+// 完成回调：status为0表示成功收到响应，否则为libuv错误码
+// （UV_ETIMEDOUT超时，UV_ECANCELED客户端销毁，UV_EPROTO响应格式错误等），此时response为NULL
+typedef void (*http_client_callback_t)(int status, const http_client_response_t *response, void *user_data);
+
+// 客户端句柄
+typedef struct http_client http_client_t;
+
+// 创建客户端，config为NULL时使用默认配置
+http_client_t* http_client_create(uv_loop_t *loop, const http_client_config_t *config);
+
+// 销毁客户端：未完成的请求以UV_ECANCELED回调，连接在循环中异步关闭
+void http_client_destroy(http_client_t *client);
+
+// 提交请求
+// host为IP地址或主机名，extra_headers为附加的原始头部行（每行以CRLF结尾，可为NULL）
+// 成功返回0（结果通过回调通知），参数错误或内存不足返回-1（不会调用回调）
+int http_client_request(http_client_t *client, http_method_t method,
+                        const char *host, int port, const char *path,
+                        const char *extra_headers, const char *body, size_t body_length,
+                        http_client_callback_t callback, void *user_data);
+
+// GET请求的便捷函数
+int http_client_get(http_client_t *client, const char *host, int port, const char *path,
+                    http_client_callback_t callback, void *user_data);
+
+// 获取响应头部（名称大小写不敏感），不存在时返回NULL
+const char* http_client_response_header(const http_client_response_t *response, const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_CLIENT_H
@@ -0,0 +1,107 @@
+#include "src/http/http_headers.h"
+#include <ctype.h>
+
+// 完美哈希表大小（必须是2的幂）
+#define HTTP_HEADER_HASH_SIZE 64
+
+// 完美哈希函数：长度 + 首字符 + 末字符*26（均按小写计算）
+// 参数是对下表中全部头部名称离线搜索得到的，保证无冲突；
+// 新增已知头部时需要重新确认哈希值不冲突
+#define HTTP_HEADER_HASH(len, first, last) \
+    (((len) + (first) + (last) * 26) & (HTTP_HEADER_HASH_SIZE - 1))
+
+// 哈希槽
+typedef struct {
+    const char *lower_name;     // 小写名称，用于比较
+    size_t length;
+    http_header_id_t id;
+} http_header_slot_t;
+
+// 以哈希值为下标的静态表，空槽的lower_name为NULL
+static const http_header_slot_t header_slots[HTTP_HEADER_HASH_SIZE] = {
+    [ 1] = { "content-length", 14, HTTP_HEADER_CONTENT_LENGTH },
+    [ 6] = { "if-none-match", 13, HTTP_HEADER_IF_NONE_MATCH },
+    [ 7] = { "user-agent", 10, HTTP_HEADER_USER_AGENT },
+    [13] = { "referer", 7, HTTP_HEADER_REFERER },
+    [25] = { "connection", 10, HTTP_HEADER_CONNECTION },
+    [26] = { "authorization", 13, HTTP_HEADER_AUTHORIZATION },
+    [27] = { "x-forwarded-for", 15, HTTP_HEADER_X_FORWARDED_FOR },
+    [33] = { "origin", 6, HTTP_HEADER_ORIGIN },
+    [38] = { "accept-encoding", 15, HTTP_HEADER_ACCEPT_ENCODING },
+    [40] = { "cache-control", 13, HTTP_HEADER_CACHE_CONTROL },
+    [41] = { "content-encoding", 16, HTTP_HEADER_CONTENT_ENCODING },
+    [42] = { "date", 4, HTTP_HEADER_DATE },
+    [43] = { "cookie", 6, HTTP_HEADER_COOKIE },
+    [44] = { "x-request-id", 12, HTTP_HEADER_X_REQUEST_ID },
+    [47] = { "accept", 6, HTTP_HEADER_ACCEPT },
+    [49] = { "content-type", 12, HTTP_HEADER_CONTENT_TYPE },
+    [50] = { "accept-language", 15, HTTP_HEADER_ACCEPT_LANGUAGE },
+    [51] = { "expect", 6, HTTP_HEADER_EXPECT },
+    [52] = { "host", 4, HTTP_HEADER_HOST },
+    [55] = { "keep-alive", 10, HTTP_HEADER_KEEP_ALIVE },
+    [57] = { "range", 5, HTTP_HEADER_RANGE },
+    [59] = { "transfer-encoding", 17, HTTP_HEADER_TRANSFER_ENCODING },
+    [60] = { "if-modified-since", 17, HTTP_HEADER_IF_MODIFIED_SINCE },
+    [62] = { "upgrade", 7, HTTP_HEADER_UPGRADE },
+};
+
+// 规范名称（按ID索引）
+static const char *header_names[HTTP_HEADER_KNOWN_COUNT] = {
+    [HTTP_HEADER_UNKNOWN] = NULL,
+    [HTTP_HEADER_ACCEPT] = "Accept",
+    [HTTP_HEADER_ACCEPT_ENCODING] = "Accept-Encoding",
+    [HTTP_HEADER_ACCEPT_LANGUAGE] = "Accept-Language",
+    [HTTP_HEADER_AUTHORIZATION] = "Authorization",
+    [HTTP_HEADER_CACHE_CONTROL] = "Cache-Control",
+    [HTTP_HEADER_CONNECTION] = "Connection",
+    [HTTP_HEADER_CONTENT_ENCODING] = "Content-Encoding",
+    [HTTP_HEADER_CONTENT_LENGTH] = "Content-Length",
+    [HTTP_HEADER_CONTENT_TYPE] = "Content-Type",
+    [HTTP_HEADER_COOKIE] = "Cookie",
+    [HTTP_HEADER_DATE] = "Date",
+    [HTTP_HEADER_EXPECT] = "Expect",
+    [HTTP_HEADER_HOST] = "Host",
+    [HTTP_HEADER_IF_MODIFIED_SINCE] = "If-Modified-Since",
+    [HTTP_HEADER_IF_NONE_MATCH] = "If-None-Match",
+    [HTTP_HEADER_KEEP_ALIVE] = "Keep-Alive",
+    [HTTP_HEADER_ORIGIN] = "Origin",
+    [HTTP_HEADER_RANGE] = "Range",
+    [HTTP_HEADER_REFERER] = "Referer",
+    [HTTP_HEADER_TRANSFER_ENCODING] = "Transfer-Encoding",
+    [HTTP_HEADER_UPGRADE] = "Upgrade",
+    [HTTP_HEADER_USER_AGENT] = "User-Agent",
+    [HTTP_HEADER_X_FORWARDED_FOR] = "X-Forwarded-For",
+    [HTTP_HEADER_X_REQUEST_ID] = "X-Request-Id",
+};
+
+// 查找已知头部ID
+http_header_id_t http_header_lookup(const char *name, size_t length) {
+    if (!name || length == 0) {
+        return HTTP_HEADER_UNKNOWN;
+    }
+
+    unsigned int first = (unsigned int) tolower((unsigned char) name[0]);
+    unsigned int last = (unsigned int) tolower((unsigned char) name[length - 1]);
+    const http_header_slot_t *slot = &header_slots[HTTP_HEADER_HASH(length, first, last)];
+
+    if (!slot->lower_name || slot->length != length) {
+        return HTTP_HEADER_UNKNOWN;
+    }
+
+    // 哈希只用到了长度和首尾字符，仍需逐字节确认
+    for (size_t i = 0; i < length; i++) {
+        if (tolower((unsigned char) name[i]) != slot->lower_name[i]) {
+            return HTTP_HEADER_UNKNOWN;
+        }
+    }
+
+    return slot->id;
+}
+
+// 获取规范名称
+const char* http_header_name(http_header_id_t id) {
+    if (id <= HTTP_HEADER_UNKNOWN || id >= HTTP_HEADER_KNOWN_COUNT) {
+        return NULL;
+    }
+    return header_names[id];
+}
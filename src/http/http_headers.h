@@ -0,0 +1,50 @@
+#ifndef HTTP_HEADERS_H
+#define HTTP_HEADERS_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 已知HTTP头部ID（解析时通过完美哈希打上标签）
+typedef enum {
+    HTTP_HEADER_UNKNOWN = 0,
+    HTTP_HEADER_ACCEPT,
+    HTTP_HEADER_ACCEPT_ENCODING,
+    HTTP_HEADER_ACCEPT_LANGUAGE,
+    HTTP_HEADER_AUTHORIZATION,
+    HTTP_HEADER_CACHE_CONTROL,
+    HTTP_HEADER_CONNECTION,
+    HTTP_HEADER_CONTENT_ENCODING,
+    HTTP_HEADER_CONTENT_LENGTH,
+    HTTP_HEADER_CONTENT_TYPE,
+    HTTP_HEADER_COOKIE,
+    HTTP_HEADER_DATE,
+    HTTP_HEADER_EXPECT,
+    HTTP_HEADER_HOST,
+    HTTP_HEADER_IF_MODIFIED_SINCE,
+    HTTP_HEADER_IF_NONE_MATCH,
+    HTTP_HEADER_KEEP_ALIVE,
+    HTTP_HEADER_ORIGIN,
+    HTTP_HEADER_RANGE,
+    HTTP_HEADER_REFERER,
+    HTTP_HEADER_TRANSFER_ENCODING,
+    HTTP_HEADER_UPGRADE,
+    HTTP_HEADER_USER_AGENT,
+    HTTP_HEADER_X_FORWARDED_FOR,
+    HTTP_HEADER_X_REQUEST_ID,
+    HTTP_HEADER_KNOWN_COUNT
+} http_header_id_t;
+
+// 根据头部名称查找已知头部ID（大小写不敏感，O(1)），未知头部返回HTTP_HEADER_UNKNOWN
+http_header_id_t http_header_lookup(const char *name, size_t length);
+
+// 获取已知头部的规范名称（如 "Content-Length"），未知ID返回NULL
+const char* http_header_name(http_header_id_t id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_HEADERS_H
@@ -1,13 +1,50 @@
 #include "src/http/http_module.h"
+#include "src/http/http_parser.h"
+#include "src/http/http_access_log.h"
 #include "src/log/logger_module.h"
 #include "src/http/http_routes.h"
 #include "src/json/json_parser_module.h"
+#include "src/config/config_module.h"
+#include "src/net/uring_backend.h"
+#include "src/net/tls_transport.h"
+#include "src/net/read_buffer_pool.h"
+#include "src/net/unix_socket.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <errno.h>
+#include <time.h>
 #include <uv.h>
 
+// 读缓冲区：空闲长连接读入小缓冲区，请求超出后换成大缓冲区，请求处理完归还缓冲池
+#define HTTP_READ_BUFFER_SMALL 4096
+#define HTTP_READ_BUFFER_LARGE 65536
+#define HTTP_READ_BUFFER_CACHE 256
+// 可读空间少于此值时扩展缓冲区，避免读取被切成很小的片段
+#define HTTP_READ_MIN 1024
+
+// 请求行加头部、请求体的长度上限，超出时返回错误并关闭连接，读缓冲区不会无限增长
+#define HTTP_MAX_HEADER_SIZE (64 * 1024)
+#define HTTP_MAX_BODY_SIZE (8 * 1024 * 1024)
+
+// 编译期常量头部，长度在编译时确定
+#define HTTP_STATIC_HEADER(text) text, sizeof(text) - 1
+
+static const char server_header[] = "Server: NetServe/1.0.0\r\n";
+static const char connection_close_header[] = "Connection: close\r\n";
+
+// 常用Content-Type的预渲染头部
+static const struct {
+    const char *content_type;
+    const char *header;
+    size_t header_length;
+} content_type_headers[] = {
+    { "application/json", HTTP_STATIC_HEADER("Content-Type: application/json\r\n") },
+    { "text/plain", HTTP_STATIC_HEADER("Content-Type: text/plain; charset=utf-8\r\n") },
+    { "text/html", HTTP_STATIC_HEADER("Content-Type: text/html; charset=utf-8\r\n") },
+};
+
 // 默认配置
 static http_config_t default_config = {
     .port = 8080,
@@ -28,6 +65,8 @@ module_interface_t http_module = {
     .start = http_module_start,
     .stop = http_module_stop,
     .cleanup = http_module_cleanup,
+    .quiesce = http_module_quiesce,
+    .pending = http_module_pending,
     .state = MODULE_STATE_UNINITIALIZED,
     .private_data = NULL,
     .dependencies = NULL,
@@ -38,31 +77,77 @@ module_interface_t http_module = {
 static http_private_data_t *global_http_data = NULL;
 
 // 客户端连接结构
-typedef struct http_client {
-    uv_tcp_t tcp;
+typedef struct http_connection {
+    union {
+        uv_tcp_t tcp;
+        uv_pipe_t pipe;         // 从Unix域套接字接受的连接
+    } stream;
     uv_write_t write_req;
-    char *read_buffer;
+    uring_conn_t *uring;        // io_uring后端的连接，使用libuv时为NULL
+    tls_conn_t *tls;            // TLS连接，未启用TLS时为NULL
+    int closing;
+    uint32_t id;
+    uint64_t request_start;     // 当前请求第一个字节到达的时间（uv_hrtime）
+    char *read_buffer;          // 从读缓冲池取得，没有未处理的数据时为NULL
     size_t read_buffer_size;
     size_t read_buffer_used;
     http_request_t current_request;
     http_response_t current_response;
-    struct http_client *next;
-} http_client_t;
+    int pending_writes;
+    int close_after_write;      // 已回复请求格式错误，响应写完后关闭，不再处理收到的数据
+    struct http_connection *next;
+} http_connection_t;
+
+// 写入请求，持有待发送的响应缓冲区
+typedef struct {
+    uv_write_t req;
+    char *buffer;
+} http_write_req_t;
 
 // 客户端连接池
-static http_client_t *client_pool = NULL;
+static http_connection_t *client_pool = NULL;
 static int active_clients = 0;
 static uv_mutex_t client_pool_mutex;
 
+// 优雅关闭中：响应写完后关闭连接，不再保持长连接
+static int http_draining = 0;
+
 // 内部函数声明
 static void on_new_connection(uv_stream_t *server, int status);
 static void on_client_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf);
 static void on_client_write(uv_write_t *req, int status);
 static void on_client_close(uv_handle_t *handle);
+static void on_uring_connection(uring_listener_t *listener, uring_conn_t *conn);
+static void on_uring_data(uring_conn_t *conn, const char *data, size_t length);
+static void on_uring_write(uring_conn_t *conn, int status, void *arg);
+static void on_uring_close(uring_conn_t *conn);
+static void on_tls_data(tls_conn_t *conn, const char *data, size_t length);
+static void on_tls_write(tls_conn_t *conn, int status, void *arg);
+static void on_tls_close(tls_conn_t *conn);
+static int create_tls_context(http_private_data_t *data);
+static int start_unix_listener(http_private_data_t *data);
+static void handle_client_data(http_connection_t *client, const char *data, size_t length);
+static int reserve_read_buffer(http_connection_t *client, size_t length);
+static void release_read_buffer(http_connection_t *client);
+static void process_client_data(http_connection_t *client, size_t length);
+static void finish_client_write(http_connection_t *client, int status);
+static int connection_write(http_connection_t *client, char *buffer, size_t length);
+static void connection_close(http_connection_t *client);
+static void register_connection(http_connection_t *client);
+static void release_connection(http_connection_t *client);
 static void alloc_buffer(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf);
-static int parse_http_request(const char *data, size_t length, http_request_t *request);
-static int create_http_response(const http_request_t *request, http_response_t *response);
-static void send_response(http_client_t *client, const http_response_t *response);
+static ssize_t parse_http_request(const char *data, size_t length, http_request_t *request, int *error_status);
+static int parse_http_headers(const char *start, size_t length, http_request_t *request);
+static void free_http_request(http_request_t *request);
+static int create_http_response(const http_request_t *request, http_response_t *response, int *route_id);
+static size_t send_response(http_connection_t *client, const http_response_t *response);
+static int create_access_log(http_private_data_t *data);
+static void record_access(http_connection_t *client, const http_request_t *request,
+                          const http_response_t *response, int route_id, size_t bytes_in, size_t bytes_out);
+static void free_http_response(http_response_t *response);
+static int render_cors_headers(http_private_data_t *data);
+static void update_date_header(http_private_data_t *data);
+static void on_date_timer(uv_timer_t *handle);
 static http_route_t* find_matching_route(const http_request_t *request);
 static int parse_url(const char *url, char **path, char **query_string);
 static char* url_decode(const char *str);
@@ -70,9 +155,7 @@ static int add_header_to_response(http_response_t *response, const char *name, c
 
 // HTTP模块初始化
 int http_module_init(module_interface_t *self, uv_loop_t *loop) {
-    (void)loop; // 避免未使用参数警告
-    
-    if (!self) {
+    if (!self || !loop) {
         return -1;
     }
     
@@ -85,6 +168,7 @@ int http_module_init(module_interface_t *self, uv_loop_t *loop) {
     // 初始化私有数据
     memset(data, 0, sizeof(http_private_data_t));
     data->config = default_config;
+    data->loop = loop;
     data->routes = NULL;
     data->route_count = 0;
     data->json_parser = NULL;
@@ -103,6 +187,15 @@ int http_module_init(module_interface_t *self, uv_loop_t *loop) {
         return -1;
     }
     
+    data->read_buffers = read_buffer_pool_create(HTTP_READ_BUFFER_SMALL, HTTP_READ_BUFFER_LARGE,
+                                                 HTTP_READ_BUFFER_CACHE);
+    if (!data->read_buffers) {
+        uv_mutex_destroy(&client_pool_mutex);
+        uv_mutex_destroy(&data->routes_mutex);
+        free(data);
+        return -1;
+    }
+    
     self->private_data = data;
     global_http_data = data;
     
@@ -118,14 +211,67 @@ int http_module_start(module_interface_t *self) {
     
     http_private_data_t *data = (http_private_data_t*) self->private_data;
     
-    // 初始化TCP服务器
-    uv_tcp_init(uv_default_loop(), &data->server);
-    data->server.data = data;
+    // 预渲染常量头部，启动Date头部刷新定时器
+    if (render_cors_headers(data) != 0) {
+        log_error("HTTP预渲染CORS头部失败");
+        return -1;
+    }
+    update_date_header(data);
+    uv_timer_init(data->loop, &data->date_timer);
+    data->date_timer.data = data;
+    uv_timer_start(&data->date_timer, on_date_timer, 1000, 1000);
     
     // 绑定地址
     struct sockaddr_in addr;
     uv_ip4_addr(data->config.host, data->config.port, &addr);
     
+    // 访问日志打开失败不影响服务
+    data->config.enable_logging = config_get_bool("http_enable_logging", data->config.enable_logging);
+    if (data->config.enable_logging && create_access_log(data) != 0) {
+        log_warn("HTTP访问日志初始化失败，不记录访问日志");
+    }
+    
+    // 启用TLS时由TLS传输层读写套接字，只能使用libuv接受连接
+    if (config_get_bool("http_tls_enable", 0) && create_tls_context(data) != 0) {
+        return -1;
+    }
+    
+    // Unix域套接字监听，可以代替TCP监听
+    if (start_unix_listener(data) != 0) {
+        return -1;
+    }
+    if (data->unix_socket_path && config_get_bool("http_unix_socket_only", 0)) {
+        log_info("HTTP模块启动成功，只监听Unix域套接字 %s", data->unix_socket_path);
+        return 0;
+    }
+    
+    // 按配置选择I/O后端，内核不支持io_uring时回退到libuv
+    const char *backend = config_get_string("io_backend", "libuv");
+    if (strcmp(backend, "io_uring") == 0 && data->tls_context) {
+        log_warn("HTTP服务器启用TLS时不使用io_uring后端，回退到libuv");
+    } else if (strcmp(backend, "io_uring") == 0) {
+        if (!uring_backend_available()) {
+            log_warn("内核不支持io_uring后端所需特性，HTTP服务器回退到libuv");
+        } else {
+            static const uring_callbacks_t callbacks = {
+                .on_connection = on_uring_connection,
+                .on_data = on_uring_data,
+                .on_close = on_uring_close
+            };
+            data->uring_listener = uring_listener_start(data->loop, (const struct sockaddr*) &addr,
+                                                        data->config.max_connections, &callbacks, data);
+            if (data->uring_listener) {
+                log_info("HTTP模块启动成功（io_uring后端），监听 %s:%d", data->config.host, data->config.port);
+                return 0;
+            }
+            log_warn("HTTP服务器io_uring后端启动失败，回退到libuv");
+        }
+    }
+    
+    // 初始化TCP服务器
+    uv_tcp_init(data->loop, &data->server);
+    data->server.data = data;
+    
     int bind_result = uv_tcp_bind(&data->server, (const struct sockaddr*)&addr, 0);
     if (bind_result != 0) {
         log_error("HTTP服务器绑定地址失败: %s", uv_strerror(bind_result));
@@ -139,7 +285,86 @@ int http_module_start(module_interface_t *self) {
         return -1;
     }
     
-    log_info("HTTP模块启动成功，监听 %s:%d", data->config.host, data->config.port);
+    log_info("HTTP模块启动成功%s，监听 %s:%d", data->tls_context ? "（TLS）" : "",
+             data->config.host, data->config.port);
+    return 0;
+}
+
+// 按配置创建访问日志，并登记已添加的路由名称
+static int create_access_log(http_private_data_t *data) {
+    http_access_log_config_t log_config = {
+        .file = config_get_string("http_access_log_file", "access.log"),
+        .ring_capacity = (size_t) config_get_int("http_access_log_ring_size", 65536),
+        .flush_interval_ms = config_get_int("http_access_log_flush_ms", 200),
+        .sample_threshold = (unsigned) config_get_int("http_access_log_sample_threshold", 50000),
+        .sample_rate = (unsigned) config_get_int("http_access_log_sample_rate", 10)
+    };
+    data->access_log = http_access_log_create(&log_config);
+    if (!data->access_log) {
+        return -1;
+    }
+    data->access_log_ring = http_access_log_ring_create(data->access_log);
+    if (!data->access_log_ring) {
+        http_access_log_destroy(data->access_log);
+        data->access_log = NULL;
+        return -1;
+    }
+    
+    uv_mutex_lock(&data->routes_mutex);
+    for (http_route_t *route = data->routes; route; route = route->next) {
+        http_access_log_set_route_name(data->access_log, (uint16_t) route->id, route->path);
+    }
+    uv_mutex_unlock(&data->routes_mutex);
+    
+    log_info("HTTP访问日志: %s", log_config.file);
+    return 0;
+}
+
+// 按配置创建TLS上下文
+static int create_tls_context(http_private_data_t *data) {
+    if (!tls_available()) {
+        log_error("HTTP服务器配置了TLS，但程序编译时未启用OpenSSL");
+        return -1;
+    }
+    
+    tls_config_t tls_config = {
+        .cert_file = config_get_string("http_tls_cert_file", "config/server.crt"),
+        .key_file = config_get_string("http_tls_key_file", "config/server.key"),
+        .enable_session_tickets = config_get_bool("http_tls_session_tickets", 1),
+        .session_cache_size = config_get_int("http_tls_session_cache_size", 20480),
+        .enable_ktls = config_get_bool("http_tls_ktls", 1)
+    };
+    data->tls_context = tls_context_create(&tls_config);
+    if (!data->tls_context) {
+        log_error("HTTP服务器TLS初始化失败");
+        return -1;
+    }
+    return 0;
+}
+
+// 按配置监听Unix域套接字，本地连接不经过TLS，使用libuv读写（与TCP的I/O后端无关）
+static int start_unix_listener(http_private_data_t *data) {
+    const char *path = config_get_string("http_unix_socket_path", "");
+    if (path[0] == '\0') {
+        if (config_get_bool("http_unix_socket_only", 0)) {
+            log_error("HTTP服务器配置了只监听Unix域套接字，但没有设置http_unix_socket_path");
+            return -1;
+        }
+        return 0;
+    }
+    
+    data->unix_socket_path = strdup(path);
+    if (!data->unix_socket_path) {
+        log_error("内存分配失败");
+        return -1;
+    }
+    int result = unix_socket_listen(data->loop, &data->unix_server, path, data->config.max_connections,
+                                    on_new_connection, data);
+    if (result != 0) {
+        log_error("HTTP服务器监听Unix域套接字 %s 失败: %s", path, uv_strerror(result));
+        return -1;
+    }
+    log_info("HTTP服务器监听Unix域套接字 %s", path);
     return 0;
 }
 
@@ -151,13 +376,86 @@ int http_module_stop(module_interface_t *self) {
     
     http_private_data_t *data = (http_private_data_t*) self->private_data;
     
-    // 关闭服务器
-    uv_close((uv_handle_t*) &data->server, NULL);
+    // 停止Date头部刷新
+    uv_timer_stop(&data->date_timer);
+    uv_close((uv_handle_t*) &data->date_timer, NULL);
+    
+    // 关闭监听（优雅关闭时可能已在quiesce阶段关闭）
+    // io_uring后端：关闭监听器时一并关闭它的全部连接，连接池中只剩Unix域套接字连接
+    if (data->uring_listener) {
+        uring_listener_close(data->uring_listener);
+        data->uring_listener = NULL;
+    } else if (data->server.loop && !uv_is_closing((uv_handle_t*) &data->server)) {
+        uv_close((uv_handle_t*) &data->server, NULL);
+    }
+    unix_socket_close(&data->unix_server, data->unix_socket_path);
+    
+    // 关闭剩余的客户端连接（超过关闭期限仍未完成的请求）
+    uv_mutex_lock(&client_pool_mutex);
+    for (http_connection_t *client = client_pool; client; client = client->next) {
+        connection_close(client);
+    }
+    uv_mutex_unlock(&client_pool_mutex);
+    
+    // 上下文在最后一个TLS连接关闭后释放
+    if (data->tls_context) {
+        tls_stats_t stats;
+        tls_context_get_stats(data->tls_context, &stats);
+        log_info("TLS握手 %lu 次（会话恢复 %lu 次，失败 %lu 次），启用kTLS发送的连接 %lu 个",
+                 stats.handshakes, stats.resumed, stats.failed, stats.ktls_send);
+        tls_context_destroy(data->tls_context);
+        data->tls_context = NULL;
+    }
     
     log_info("HTTP模块已停止");
     return 0;
 }
 
+// HTTP模块停止接收新连接
+int http_module_quiesce(module_interface_t *self) {
+    if (!self || !self->private_data) {
+        return -1;
+    }
+    
+    http_private_data_t *data = (http_private_data_t*) self->private_data;
+    
+    http_draining = 1;
+    
+    // 关闭监听套接字
+    if (data->uring_listener) {
+        uring_listener_stop_accepting(data->uring_listener);
+    } else if (data->server.loop && !uv_is_closing((uv_handle_t*) &data->server)) {
+        uv_close((uv_handle_t*) &data->server, NULL);
+    }
+    unix_socket_close(&data->unix_server, data->unix_socket_path);
+    
+    // 关闭空闲的长连接，正在接收请求的连接在响应写完后关闭
+    uv_mutex_lock(&client_pool_mutex);
+    http_connection_t *client = client_pool;
+    while (client) {
+        http_connection_t *next = client->next;
+        if (client->read_buffer_used == 0 && client->pending_writes == 0) {
+            connection_close(client);
+        }
+        client = next;
+    }
+    uv_mutex_unlock(&client_pool_mutex);
+    
+    log_info("HTTP模块已停止接收新连接，剩余连接数: %d", active_clients);
+    return 0;
+}
+
+// 获取尚未关闭的连接数
+int http_module_pending(module_interface_t *self) {
+    (void)self; // 避免未使用参数警告
+    
+    uv_mutex_lock(&client_pool_mutex);
+    int count = active_clients;
+    uv_mutex_unlock(&client_pool_mutex);
+    
+    return count;
+}
+
 // HTTP模块清理
 int http_module_cleanup(module_interface_t *self) {
     if (!self || !self->private_data) {
@@ -166,6 +464,27 @@ int http_module_cleanup(module_interface_t *self) {
     
     http_private_data_t *data = (http_private_data_t*) self->private_data;
     
+    // 写出剩余的访问日志
+    if (data->access_log) {
+        http_access_log_stats_t stats;
+        http_access_log_get_stats(data->access_log, &stats);
+        http_access_log_destroy(data->access_log);
+        log_info("HTTP访问日志: 写入 %llu 条，丢弃 %llu 条，采样跳过 %llu 个请求",
+                 (unsigned long long) stats.written, (unsigned long long) stats.dropped,
+                 (unsigned long long) stats.sampled_out);
+        data->access_log = NULL;
+        data->access_log_ring = NULL;
+    }
+    
+    // 释放读缓冲池（连接均已释放）
+    read_buffer_pool_stats_t buffer_stats;
+    read_buffer_pool_get_stats(data->read_buffers, &buffer_stats);
+    log_info("HTTP读缓冲池: 复用 %llu 次，新分配 %llu 次，释放 %llu 次",
+             (unsigned long long) buffer_stats.reused, (unsigned long long) buffer_stats.allocated,
+             (unsigned long long) buffer_stats.released);
+    read_buffer_pool_destroy(data->read_buffers);
+    data->read_buffers = NULL;
+    
     // 清理路由
     http_clear_routes();
     
@@ -180,6 +499,8 @@ int http_module_cleanup(module_interface_t *self) {
     if (data->config.cors_origin != default_config.cors_origin) {
         free(data->config.cors_origin);
     }
+    free(data->unix_socket_path);
+    free(data->cors_headers);
     
     // 释放私有数据
     free(data);
@@ -197,122 +518,323 @@ static void on_new_connection(uv_stream_t *server, int status) {
         return;
     }
     
-    (void)server; // 避免未使用参数警告
+    http_private_data_t *data = (http_private_data_t*) server->data;
     
     // 创建新的客户端连接
-    http_client_t *client = malloc(sizeof(http_client_t));
+    http_connection_t *client = malloc(sizeof(http_connection_t));
     if (!client) {
         log_error("内存分配失败");
         return;
     }
     
-    // 初始化客户端
-    memset(client, 0, sizeof(http_client_t));
-    uv_tcp_init(server->loop, &client->tcp);
-    client->tcp.data = client;
-    client->read_buffer_size = 4096;
-    client->read_buffer = malloc(client->read_buffer_size);
-    
-    if (uv_accept(server, (uv_stream_t*) &client->tcp) == 0) {
-        // 添加到连接池
-        uv_mutex_lock(&client_pool_mutex);
-        client->next = client_pool;
-        client_pool = client;
-        active_clients++;
-        uv_mutex_unlock(&client_pool_mutex);
+    // 初始化客户端，读缓冲区在收到数据时从缓冲池取得
+    memset(client, 0, sizeof(http_connection_t));
+    
+    // TLS连接：套接字交给TLS传输层，握手完成后通过on_tls_data收到解密的请求
+    int is_unix = server == (uv_stream_t*) &data->unix_server;
+    if (data->tls_context && !is_unix) {
+        static const tls_callbacks_t callbacks = {
+            .on_data = on_tls_data,
+            .on_close = on_tls_close
+        };
+        client->tls = tls_conn_accept(data->tls_context, server, &callbacks, client);
+        if (!client->tls) {
+            log_error("接受TLS连接失败");
+            free(client);
+            return;
+        }
+        register_connection(client);
+        return;
+    }
+    
+    if (is_unix) {
+        uv_pipe_init(server->loop, &client->stream.pipe, 0);
+        client->stream.pipe.data = client;
+    } else {
+        uv_tcp_init(server->loop, &client->stream.tcp);
+        client->stream.tcp.data = client;
+    }
+    
+    if (uv_accept(server, (uv_stream_t*) &client->stream) == 0) {
+        register_connection(client);
         
         // 开始读取数据
-        uv_read_start((uv_stream_t*) &client->tcp, alloc_buffer, on_client_read);
-        log_info("新HTTP客户端连接，当前连接数: %d", active_clients);
+        uv_read_start((uv_stream_t*) &client->stream, alloc_buffer, on_client_read);
     } else {
-        free(client->read_buffer);
         free(client);
     }
 }
 
-// 分配缓冲区回调
+// 分配缓冲区回调：直接读入连接的读缓冲区，避免额外复制
 static void alloc_buffer(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
-    (void)handle; // 避免未使用参数警告
-    buf->base = malloc(suggested_size);
-    buf->len = suggested_size;
+    (void)suggested_size; // 避免未使用参数警告
+    http_connection_t *client = (http_connection_t*) handle->data;
+    
+    // 失败时返回空缓冲区，libuv以UV_ENOBUFS回调on_client_read
+    if (reserve_read_buffer(client, HTTP_READ_MIN) != 0) {
+        buf->base = NULL;
+        buf->len = 0;
+        return;
+    }
+    
+    // 预留结尾'\0'的位置，解析时按C字符串处理
+    buf->base = client->read_buffer + client->read_buffer_used;
+    buf->len = client->read_buffer_size - client->read_buffer_used - 1;
 }
 
 // 客户端读取回调
 static void on_client_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
-    http_client_t *client = (http_client_t*) stream->data;
+    (void)buf; // 数据已直接读入连接的读缓冲区
+    http_connection_t *client = (http_connection_t*) stream->data;
     
     if (nread > 0) {
-        // 扩展读取缓冲区
-        if (client->read_buffer_used + nread > client->read_buffer_size) {
-            size_t new_size = client->read_buffer_size * 2;
-            char *new_buffer = realloc(client->read_buffer, new_size);
-            if (!new_buffer) {
-                log_error("缓冲区扩展失败");
-                uv_close((uv_handle_t*) stream, on_client_close);
-                return;
-            }
-            client->read_buffer = new_buffer;
-            client->read_buffer_size = new_size;
-        }
-        
-        // 复制数据到缓冲区
-        memcpy(client->read_buffer + client->read_buffer_used, buf->base, nread);
-        client->read_buffer_used += nread;
-        
-        // 尝试解析HTTP请求
-        http_request_t request;
-        if (parse_http_request(client->read_buffer, client->read_buffer_used, &request) == 0) {
-            // 创建响应
-            http_response_t response;
-            if (create_http_response(&request, &response) == 0) {
-                send_response(client, &response);
-            }
-            
-            // 清理请求数据
-            if (request.path) free(request.path);
-            if (request.query_string) free(request.query_string);
-            if (request.body) free(request.body);
-            if (request.content_type) free(request.content_type);
-            if (request.user_agent) free(request.user_agent);
-            if (request.authorization) free(request.authorization);
-            if (request.headers) free(request.headers);
-            
-            // 重置读取缓冲区
+        if (!client->closing && !client->close_after_write) {
+            process_client_data(client, (size_t) nread);
+        } else {
             client->read_buffer_used = 0;
         }
-        
-        free(buf->base);
     } else if (nread < 0) {
         if (nread != UV_EOF) {
             log_error("HTTP读取错误: %s", uv_err_name(nread));
         }
-        uv_close((uv_handle_t*) stream, on_client_close);
-        free(buf->base);
-    } else {
-        free(buf->base);
+        connection_close(client);
+    }
+    
+    // 空闲的长连接不占用读缓冲区
+    if (client->read_buffer_used == 0) {
+        release_read_buffer(client);
+    }
+}
+
+// 确保读缓冲区在已有数据之后至少还有length字节可用（不含结尾'\0'）
+static int reserve_read_buffer(http_connection_t *client, size_t length) {
+    size_t needed = client->read_buffer_used + length + 1;
+    if (client->read_buffer && needed <= client->read_buffer_size) {
+        return 0;
+    }
+    
+    // 新请求先使用小缓冲区，数据超出后换成大缓冲区
+    char *buffer = read_buffer_pool_grow(global_http_data->read_buffers, client->read_buffer,
+                                         client->read_buffer_used, needed);
+    if (!buffer) {
+        log_error("缓冲区扩展失败");
+        return -1;
+    }
+    client->read_buffer = buffer;
+    client->read_buffer_size = read_buffer_capacity(buffer);
+    return 0;
+}
+
+// 把读缓冲区归还缓冲池
+static void release_read_buffer(http_connection_t *client) {
+    if (!client->read_buffer) {
+        return;
+    }
+    read_buffer_pool_put(global_http_data ? global_http_data->read_buffers : NULL, client->read_buffer);
+    client->read_buffer = NULL;
+    client->read_buffer_size = 0;
+    client->read_buffer_used = 0;
+}
+
+// 处理收到的数据（io_uring后端和TLS连接交付的数据需要复制到读缓冲区）
+static void handle_client_data(http_connection_t *client, const char *data, size_t length) {
+    if (client->closing || client->close_after_write) {
+        return;
+    }
+    
+    if (reserve_read_buffer(client, length) != 0) {
+        connection_close(client);
+        return;
+    }
+    memcpy(client->read_buffer + client->read_buffer_used, data, length);
+    process_client_data(client, length);
+    
+    if (client->read_buffer_used == 0) {
+        release_read_buffer(client);
+    }
+}
+
+// 回复请求格式错误或超出上限，响应写完后关闭连接
+static void reject_request(http_connection_t *client, int status) {
+    http_response_t response;
+    memset(&response, 0, sizeof(http_response_t));
+    http_send_error_response(&response, (http_status_t) status, http_status_to_string((http_status_t) status));
+    
+    client->close_after_write = 1;
+    client->read_buffer_used = 0;
+    send_response(client, &response);
+    free_http_response(&response);
+    
+    if (client->pending_writes == 0) {
+        connection_close(client);
+    }
+}
+
+// 处理读缓冲区末尾新到的length字节
+static void process_client_data(http_connection_t *client, size_t length) {
+    if (client->read_buffer_used == 0 && global_http_data && global_http_data->access_log_ring) {
+        client->request_start = uv_hrtime();
+    }
+    
+    client->read_buffer_used += length;
+    client->read_buffer[client->read_buffer_used] = '\0';
+    
+    // 依次处理缓冲区中完整的请求（客户端可以流水线发送多个请求），剩余的不完整请求移到缓冲区开头
+    size_t offset = 0;
+    while (!client->closing && !client->close_after_write) {
+        // 忽略请求之间多余的空行
+        while (offset < client->read_buffer_used &&
+               (client->read_buffer[offset] == '\r' || client->read_buffer[offset] == '\n')) {
+            offset++;
+        }
+        if (offset == client->read_buffer_used) {
+            break;
+        }
+        
+        http_request_t request;
+        int error_status = HTTP_STATUS_BAD_REQUEST;
+        ssize_t consumed = parse_http_request(client->read_buffer + offset, client->read_buffer_used - offset,
+                                              &request, &error_status);
+        if (consumed < 0) {
+            reject_request(client, error_status);
+            return;
+        }
+        if (consumed == 0) {
+            break;
+        }
+        
+        // 创建响应
+        http_response_t response;
+        int route_id = HTTP_ACCESS_LOG_NO_ROUTE;
+        size_t bytes_out = 0;
+        if (create_http_response(&request, &response, &route_id) == 0) {
+            bytes_out = send_response(client, &response);
+        }
+        record_access(client, &request, &response, route_id, (size_t) consumed, bytes_out);
+        free_http_response(&response);
+        
+        // 清理请求数据
+        free_http_request(&request);
+        
+        offset += (size_t) consumed;
+        if (client->request_start) {
+            client->request_start = uv_hrtime();
+        }
+    }
+    
+    if (offset > 0) {
+        client->read_buffer_used -= offset;
+        memmove(client->read_buffer, client->read_buffer + offset, client->read_buffer_used + 1);
     }
 }
 
 // 客户端写入回调
 static void on_client_write(uv_write_t *req, int status) {
-    if (status) {
+    http_write_req_t *write_req = (http_write_req_t*) req;
+    http_connection_t *client = (http_connection_t*) req->data;
+    
+    // 释放响应缓冲区和写入请求
+    free(write_req->buffer);
+    free(write_req);
+    
+    finish_client_write(client, status);
+}
+
+// 写入完成（各I/O后端和TLS连接共用）
+static void finish_client_write(http_connection_t *client, int status) {
+    if (status && status != UV_ECANCELED) {
         log_error("HTTP写入错误: %s", uv_strerror(status));
     }
     
-    // 释放写入请求
-    free(req);
+    client->pending_writes--;
+    
+    // 错误响应写完，或优雅关闭期间响应写完且没有未完成的请求时关闭连接
+    if (client->pending_writes == 0 &&
+        (client->close_after_write || (http_draining && client->read_buffer_used == 0))) {
+        connection_close(client);
+    }
+}
+
+// 发送数据，buffer的所有权转移给I/O后端
+static int connection_write(http_connection_t *client, char *buffer, size_t length) {
+    if (client->tls) {
+        if (tls_conn_write(client->tls, buffer, length, on_tls_write, client) != 0) {
+            return -1;
+        }
+        client->pending_writes++;
+        return 0;
+    }
+    
+    if (client->uring) {
+        if (uring_conn_write(client->uring, buffer, length, on_uring_write, client) != 0) {
+            return -1;
+        }
+        client->pending_writes++;
+        return 0;
+    }
+    
+    http_write_req_t *write_req = malloc(sizeof(http_write_req_t));
+    if (!write_req) {
+        free(buffer);
+        return -1;
+    }
+    
+    uv_buf_t write_buf = uv_buf_init(buffer, (unsigned int) length);
+    write_req->buffer = buffer;
+    write_req->req.data = client;
+    if (uv_write(&write_req->req, (uv_stream_t*) &client->stream, &write_buf, 1, on_client_write) != 0) {
+        free(buffer);
+        free(write_req);
+        return -1;
+    }
+    client->pending_writes++;
+    return 0;
+}
+
+// 关闭连接，资源在关闭完成后释放
+static void connection_close(http_connection_t *client) {
+    if (client->closing) {
+        return;
+    }
+    client->closing = 1;
+    
+    if (client->tls) {
+        tls_conn_close(client->tls);
+    } else if (client->uring) {
+        uring_conn_close(client->uring);
+    } else {
+        uv_close((uv_handle_t*) &client->stream, on_client_close);
+    }
 }
 
 // 客户端关闭回调
 static void on_client_close(uv_handle_t *handle) {
-    http_client_t *client = (http_client_t*) handle->data;
+    release_connection((http_connection_t*) handle->data);
+}
+
+// 分配连接ID并加入连接池
+static void register_connection(http_connection_t *client) {
+    static uint32_t next_connection_id = 0;
+    client->id = ++next_connection_id;
+    
+    uv_mutex_lock(&client_pool_mutex);
+    client->next = client_pool;
+    client_pool = client;
+    active_clients++;
+    uv_mutex_unlock(&client_pool_mutex);
     
+    // 逐请求的信息记录在访问日志中，连接事件只在调试级别输出
+    log_debug("新HTTP客户端连接 #%u，当前连接数: %d", client->id, active_clients);
+}
+
+// 从连接池移除并释放连接
+static void release_connection(http_connection_t *client) {
     // 从连接池移除
     uv_mutex_lock(&client_pool_mutex);
     if (client_pool == client) {
         client_pool = client->next;
     } else {
-        http_client_t *prev = client_pool;
+        http_connection_t *prev = client_pool;
         while (prev && prev->next != client) {
             prev = prev->next;
         }
@@ -324,30 +846,127 @@ static void on_client_close(uv_handle_t *handle) {
     uv_mutex_unlock(&client_pool_mutex);
     
     // 释放资源
-    if (client->read_buffer) {
-        free(client->read_buffer);
-    }
+    release_read_buffer(client);
     free(client);
     
-    log_info("HTTP客户端断开连接，当前连接数: %d", active_clients);
+    log_debug("HTTP客户端断开连接，当前连接数: %d", active_clients);
 }
 
-// 解析HTTP请求
-static int parse_http_request(const char *data, size_t length, http_request_t *request) {
-    if (!data || !request || length == 0) {
+// io_uring后端：新连接
+static void on_uring_connection(uring_listener_t *listener, uring_conn_t *conn) {
+    (void)listener; // 避免未使用参数警告
+    
+    http_connection_t *client = calloc(1, sizeof(http_connection_t));
+    if (!client) {
+        log_error("内存分配失败");
+        uring_conn_close(conn);
+        return;
+    }
+    
+    client->uring = conn;
+    uring_conn_set_data(conn, client);
+    register_connection(client);
+}
+
+// io_uring后端：收到数据
+static void on_uring_data(uring_conn_t *conn, const char *data, size_t length) {
+    http_connection_t *client = (http_connection_t*) uring_conn_get_data(conn);
+    if (client) {
+        handle_client_data(client, data, length);
+    }
+}
+
+// io_uring后端：写入完成
+static void on_uring_write(uring_conn_t *conn, int status, void *arg) {
+    (void)conn; // 避免未使用参数警告
+    finish_client_write((http_connection_t*) arg, status);
+}
+
+// io_uring后端：连接关闭
+static void on_uring_close(uring_conn_t *conn) {
+    http_connection_t *client = (http_connection_t*) uring_conn_get_data(conn);
+    if (client) {
+        release_connection(client);
+    }
+}
+
+// TLS连接：收到解密后的数据
+static void on_tls_data(tls_conn_t *conn, const char *data, size_t length) {
+    handle_client_data((http_connection_t*) tls_conn_get_data(conn), data, length);
+}
+
+// TLS连接：写入完成
+static void on_tls_write(tls_conn_t *conn, int status, void *arg) {
+    (void)conn; // 避免未使用参数警告
+    finish_client_write((http_connection_t*) arg, status);
+}
+
+// TLS连接：连接关闭
+static void on_tls_close(tls_conn_t *conn) {
+    release_connection((http_connection_t*) tls_conn_get_data(conn));
+}
+
+// 释放请求占用的内存
+static void free_http_request(http_request_t *request) {
+    if (request->path) free(request->path);
+    if (request->query_string) free(request->query_string);
+    if (request->body) free(request->body);
+    if (request->headers) free(request->headers);
+    if (request->header_block) free(request->header_block);
+    http_free_params(&request->query_params);
+    http_free_params(&request->form_params);
+    memset(request, 0, sizeof(http_request_t));
+}
+
+// 解析头部，并设置常用头部的别名
+static int parse_http_headers(const char *start, size_t length, http_request_t *request) {
+    if (http_parse_header_block(start, length, &request->header_block, &request->headers,
+                                &request->header_count, request->known_headers) != 0) {
         return -1;
     }
     
+    request->content_type = (char*) request->known_headers[HTTP_HEADER_CONTENT_TYPE];
+    request->user_agent = (char*) request->known_headers[HTTP_HEADER_USER_AGENT];
+    request->authorization = (char*) request->known_headers[HTTP_HEADER_AUTHORIZATION];
+    return 0;
+}
+
+// 解析HTTP请求，返回请求占用的字节数；请求不完整时返回0，等待更多数据；
+// 格式错误或超出长度上限时返回-1，*error_status为应答的状态码
+static ssize_t parse_http_request(const char *data, size_t length, http_request_t *request, int *error_status) {
+    if (!data || !request || length == 0) {
+        return 0;
+    }
+    
     memset(request, 0, sizeof(http_request_t));
+    *error_status = HTTP_STATUS_BAD_REQUEST;
+    
+    // 等待完整的头部
+    const char *headers_end = http_find_header_end(data, length);
+    if (!headers_end) {
+        if (length > HTTP_MAX_HEADER_SIZE) {
+            *error_status = HTTP_STATUS_REQUEST_HEADER_FIELDS_TOO_LARGE;
+            return -1;
+        }
+        return 0;
+    }
+    if ((size_t) (headers_end - data) > HTTP_MAX_HEADER_SIZE) {
+        *error_status = HTTP_STATUS_REQUEST_HEADER_FIELDS_TOO_LARGE;
+        return -1;
+    }
     
-    // 查找请求行结束
-    const char *line_end = strstr(data, "\r\n");
-    if (!line_end) {
+    // 请求行在头部结束之前
+    const char *line_end = memmem(data, (size_t) (headers_end + 2 - data), "\r\n", 2);
+    if (!line_end || line_end == data) {
         return -1;
     }
     
     // 解析请求行
     char *request_line = strndup(data, line_end - data);
+    if (!request_line) {
+        *error_status = HTTP_STATUS_INTERNAL_SERVER_ERROR;
+        return -1;
+    }
     char *method_str = strtok(request_line, " ");
     char *url = strtok(NULL, " ");
     char *version = strtok(NULL, " ");
@@ -363,54 +982,92 @@ static int parse_http_request(const char *data, size_t length, http_request_t *r
     // 解析URL
     if (parse_url(url, &request->path, &request->query_string) != 0) {
         free(request_line);
+        free_http_request(request);
         return -1;
     }
     
-    // 解析头部
+    free(request_line);
+    
+    // 解析头部（包含最后一个头部行的CRLF），没有头部时头部块为空
     const char *headers_start = line_end + 2;
-    const char *body_start = strstr(headers_start, "\r\n\r\n");
+    if (headers_start < headers_end + 2 &&
+        parse_http_headers(headers_start, headers_end + 2 - headers_start, request) != 0) {
+        free_http_request(request);
+        return -1;
+    }
     
-    if (body_start) {
-        // 解析头部
-        size_t headers_length = body_start - headers_start;
-        char *headers_str = strndup(headers_start, headers_length);
-        
-        // 简单的头部解析（这里可以扩展）
-        char *line = strtok(headers_str, "\r\n");
-        while (line) {
-            char *colon = strchr(line, ':');
-            if (colon) {
-                *colon = '\0';
-                char *name = line;
-                char *value = colon + 1;
-                
-                // 跳过前导空格
-                while (*value == ' ') value++;
-                
-                if (strcasecmp(name, "Content-Type") == 0) {
-                    request->content_type = strdup(value);
-                } else if (strcasecmp(name, "User-Agent") == 0) {
-                    request->user_agent = strdup(value);
-                } else if (strcasecmp(name, "Authorization") == 0) {
-                    request->authorization = strdup(value);
-                }
+    // 设置请求体，有Content-Length或chunked编码时等待请求体收齐，都没有时没有请求体
+    const char *body_start = headers_end + 4;
+    size_t available = length - (body_start - data);
+    size_t body_length = 0;
+    size_t request_length = (size_t) (body_start - data);
+    
+    const char *content_length = request->known_headers[HTTP_HEADER_CONTENT_LENGTH];
+    if (http_is_chunked(request->known_headers[HTTP_HEADER_TRANSFER_ENCODING])) {
+        size_t consumed = 0;
+        int result = http_decode_chunked(body_start, available, &request->body,
+                                         &request->body_length, &consumed);
+        if (result == 0) {
+            free_http_request(request);
+            if (available > HTTP_MAX_BODY_SIZE) {
+                *error_status = HTTP_STATUS_PAYLOAD_TOO_LARGE;
+                return -1;
             }
-            line = strtok(NULL, "\r\n");
+            return 0;
         }
-        
-        free(headers_str);
-        
-        // 设置请求体
-        request->body = strdup(body_start + 4);
-        request->body_length = length - (body_start + 4 - data);
+        if (result < 0 || request->body_length > HTTP_MAX_BODY_SIZE) {
+            if (result > 0) {
+                *error_status = HTTP_STATUS_PAYLOAD_TOO_LARGE;
+            }
+            free_http_request(request);
+            return -1;
+        }
+        request_length += consumed;
+    } else if (content_length) {
+        char *end = NULL;
+        errno = 0;
+        unsigned long long declared = strtoull(content_length, &end, 10);
+        if (end == content_length || *end != '\0' || content_length[0] == '-' || errno != 0) {
+            free_http_request(request);
+            return -1;
+        }
+        if (declared > HTTP_MAX_BODY_SIZE) {
+            free_http_request(request);
+            *error_status = HTTP_STATUS_PAYLOAD_TOO_LARGE;
+            return -1;
+        }
+        if (declared > available) {
+            free_http_request(request);
+            return 0;
+        }
+        body_length = (size_t) declared;
+        request_length += body_length;
     }
     
-    free(request_line);
-    return 0;
+    if (body_length > 0) {
+        request->body = strndup(body_start, body_length);
+        request->body_length = body_length;
+    }
+    
+    // 切分查询参数和表单参数（只记录位置，值在访问时解码）
+    if (request->query_string &&
+        http_parse_params(request->query_string, strlen(request->query_string), &request->query_params) != 0) {
+        free_http_request(request);
+        return -1;
+    }
+    
+    if (request->body && request->content_type &&
+        strncasecmp(request->content_type, "application/x-www-form-urlencoded", 33) == 0 &&
+        http_parse_params(request->body, request->body_length, &request->form_params) != 0) {
+        free_http_request(request);
+        return -1;
+    }
+    
+    return (ssize_t) request_length;
 }
 
 // 创建HTTP响应
-static int create_http_response(const http_request_t *request, http_response_t *response) {
+static int create_http_response(const http_request_t *request, http_response_t *response, int *route_id) {
     if (!request || !response) {
         return -1;
     }
@@ -420,6 +1077,7 @@ static int create_http_response(const http_request_t *request, http_response_t *
     // 查找匹配的路由
     http_route_t *route = find_matching_route(request);
     if (route) {
+        *route_id = route->id;
         // 调用路由处理函数
         if (route->handler(request, response, route->user_data) != 0) {
             http_send_error_response(response, HTTP_STATUS_INTERNAL_SERVER_ERROR, "Internal Server Error");
@@ -429,92 +1087,202 @@ static int create_http_response(const http_request_t *request, http_response_t *
         http_send_not_found_response(response);
     }
     
-    // 添加CORS头部
-    if (global_http_data && global_http_data->config.enable_cors) {
-        http_add_header(response, "Access-Control-Allow-Origin", global_http_data->config.cors_origin);
-        http_add_header(response, "Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-        http_add_header(response, "Access-Control-Allow-Headers", "Content-Type, Authorization");
-    }
-    
+    // CORS/Server/Date等公共头部在send_response中以预渲染块写入
     return 0;
 }
 
-// 发送响应
-static void send_response(http_client_t *client, const http_response_t *response) {
-    if (!client || !response) {
+// 向当前事件循环的访问日志环追加一条记录
+static void record_access(http_connection_t *client, const http_request_t *request,
+                          const http_response_t *response, int route_id, size_t bytes_in, size_t bytes_out) {
+    if (!global_http_data || !global_http_data->access_log_ring) {
         return;
     }
     
-    // 构建HTTP响应
-    char status_line[256];
-    snprintf(status_line, sizeof(status_line), "HTTP/1.1 %d %s\r\n", 
-             response->status, http_status_to_string(response->status));
+    http_access_log_record_t record;
+    record.start_ns = client->request_start;
+    record.latency_us = (uint32_t) ((uv_hrtime() - client->request_start) / 1000);
+    record.connection_id = client->id;
+    record.bytes_in = (uint32_t) bytes_in;
+    record.bytes_out = (uint32_t) bytes_out;
+    record.status = (uint16_t) response->status;
+    record.route_id = (uint16_t) route_id;
+    record.method = (uint8_t) request->method;
+    record.reserved = 0;
+    record.weight = 1;
+    http_access_log_append(global_http_data->access_log_ring, &record);
+}
+
+// 释放响应占用的内存
+static void free_http_response(http_response_t *response) {
+    for (int i = 0; i < response->header_count; i++) {
+        free(response->headers[i].name);
+        free(response->headers[i].value);
+    }
+    free(response->headers);
+    free(response->content_type);
+    free(response->body);
+    memset(response, 0, sizeof(http_response_t));
+}
+
+// 预渲染CORS头部块
+static int render_cors_headers(http_private_data_t *data) {
+    free(data->cors_headers);
+    data->cors_headers = NULL;
+    data->cors_headers_length = 0;
+    
+    if (!data->config.enable_cors) {
+        return 0;
+    }
     
-    // 计算响应总长度
-    size_t response_length = strlen(status_line);
+    const char *format = "Access-Control-Allow-Origin: %s\r\n"
+                         "Access-Control-Allow-Methods: GET, POST, PUT, DELETE, OPTIONS\r\n"
+                         "Access-Control-Allow-Headers: Content-Type, Authorization\r\n";
+    int length = snprintf(NULL, 0, format, data->config.cors_origin);
+    if (length < 0) {
+        return -1;
+    }
     
-    // 添加头部
-    char headers_buffer[1024] = "";
-    if (response->content_type) {
-        char content_type_header[256];
-        snprintf(content_type_header, sizeof(content_type_header), "Content-Type: %s\r\n", response->content_type);
-        strcat(headers_buffer, content_type_header);
-        response_length += strlen(content_type_header);
+    data->cors_headers = malloc(length + 1);
+    if (!data->cors_headers) {
+        return -1;
     }
+    snprintf(data->cors_headers, length + 1, format, data->config.cors_origin);
+    data->cors_headers_length = (size_t) length;
+    return 0;
+}
+
+// 刷新缓存的Date头部（RFC 7231 IMF-fixdate格式）
+static void update_date_header(http_private_data_t *data) {
+    static const char *week_days[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+    static const char *months[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                    "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+    
+    time_t now = time(NULL);
+    struct tm tm_info;
+#ifdef _WIN32
+    gmtime_s(&tm_info, &now);
+#else
+    gmtime_r(&now, &tm_info);
+#endif
+    
+    int length = snprintf(data->date_header, sizeof(data->date_header),
+                          "Date: %s, %02d %s %04d %02d:%02d:%02d GMT\r\n",
+                          week_days[tm_info.tm_wday], tm_info.tm_mday, months[tm_info.tm_mon],
+                          tm_info.tm_year + 1900, tm_info.tm_hour, tm_info.tm_min, tm_info.tm_sec);
+    data->date_header_length = length > 0 ? (size_t) length : 0;
+}
+
+// Date头部刷新定时器回调
+static void on_date_timer(uv_timer_t *handle) {
+    update_date_header((http_private_data_t*) handle->data);
+}
+
+// 查找预渲染的Content-Type头部
+static int find_content_type_header(const char *content_type) {
+    for (size_t i = 0; i < sizeof(content_type_headers) / sizeof(content_type_headers[0]); i++) {
+        if (strcmp(content_type, content_type_headers[i].content_type) == 0) {
+            return (int) i;
+        }
+    }
+    return -1;
+}
+
+// 追加一段数据到响应缓冲区
+#define APPEND_BYTES(ptr, src, len) do { memcpy((ptr), (src), (len)); (ptr) += (len); } while (0)
+
+// 发送响应，返回交给I/O层的字节数，失败返回0
+static size_t send_response(http_connection_t *client, const http_response_t *response) {
+    if (!client || !response || !global_http_data) {
+        return 0;
+    }
+    
+    http_private_data_t *data = global_http_data;
     
+    // 状态行和Content-Length需要按响应格式化，其余公共头部使用预渲染块
+    char status_line[64];
+    int status_length = snprintf(status_line, sizeof(status_line), "HTTP/1.1 %d %s\r\n",
+                                 response->status, http_status_to_string(response->status));
+    
+    char content_length_header[48] = "";
+    int content_length_length = 0;
     if (response->body) {
-        char content_length_header[256];
-        snprintf(content_length_header, sizeof(content_length_header), "Content-Length: %zu\r\n", response->body_length);
-        strcat(headers_buffer, content_length_header);
-        response_length += strlen(content_length_header);
+        content_length_length = snprintf(content_length_header, sizeof(content_length_header),
+                                         "Content-Length: %zu\r\n", response->body_length);
     }
     
-    // 添加自定义头部
-    for (int i = 0; i < response->header_count; i++) {
-        char custom_header[256];
-        snprintf(custom_header, sizeof(custom_header), "%s: %s\r\n", 
-                 response->headers[i].name, response->headers[i].value);
-        strcat(headers_buffer, custom_header);
-        response_length += strlen(custom_header);
+    int content_type_index = -1;
+    size_t content_type_length = 0;
+    if (response->content_type) {
+        content_type_index = find_content_type_header(response->content_type);
+        content_type_length = content_type_index >= 0
+            ? content_type_headers[content_type_index].header_length
+            : strlen("Content-Type: \r\n") + strlen(response->content_type);
     }
     
-    // 添加头部结束标记
-    strcat(headers_buffer, "\r\n");
-    response_length += 2;
-    
-    // 添加响应体
+    // 计算响应总长度，一次分配
+    size_t response_length = (size_t) status_length + (sizeof(server_header) - 1) +
+                             data->date_header_length + content_type_length +
+                             (size_t) content_length_length + data->cors_headers_length + 2;
+    if (http_draining || client->close_after_write) {
+        response_length += sizeof(connection_close_header) - 1;
+    }
+    for (int i = 0; i < response->header_count; i++) {
+        response_length += strlen(response->headers[i].name) + strlen(response->headers[i].value) + 4;
+    }
     if (response->body) {
         response_length += response->body_length;
     }
     
-    // 分配响应缓冲区
-    char *response_buffer = malloc(response_length + 1);
+    char *response_buffer = malloc(response_length);
     if (!response_buffer) {
         log_error("响应缓冲区分配失败");
-        return;
+        return 0;
     }
     
     // 组装响应
     char *ptr = response_buffer;
-    strcpy(ptr, status_line);
-    ptr += strlen(status_line);
-    strcpy(ptr, headers_buffer);
-    ptr += strlen(headers_buffer);
+    APPEND_BYTES(ptr, status_line, (size_t) status_length);
+    APPEND_BYTES(ptr, server_header, sizeof(server_header) - 1);
+    APPEND_BYTES(ptr, data->date_header, data->date_header_length);
+    
+    if (content_type_index >= 0) {
+        APPEND_BYTES(ptr, content_type_headers[content_type_index].header, content_type_length);
+    } else if (response->content_type) {
+        APPEND_BYTES(ptr, "Content-Type: ", 14);
+        APPEND_BYTES(ptr, response->content_type, strlen(response->content_type));
+        APPEND_BYTES(ptr, "\r\n", 2);
+    }
     
-    if (response->body) {
-        memcpy(ptr, response->body, response->body_length);
-        ptr += response->body_length;
+    APPEND_BYTES(ptr, content_length_header, (size_t) content_length_length);
+    APPEND_BYTES(ptr, data->cors_headers, data->cors_headers_length);
+    
+    // 优雅关闭期间或请求格式错误时通知客户端本连接即将关闭
+    if (http_draining || client->close_after_write) {
+        APPEND_BYTES(ptr, connection_close_header, sizeof(connection_close_header) - 1);
+    }
+    
+    // 添加自定义头部
+    for (int i = 0; i < response->header_count; i++) {
+        APPEND_BYTES(ptr, response->headers[i].name, strlen(response->headers[i].name));
+        APPEND_BYTES(ptr, ": ", 2);
+        APPEND_BYTES(ptr, response->headers[i].value, strlen(response->headers[i].value));
+        APPEND_BYTES(ptr, "\r\n", 2);
     }
     
-    *ptr = '\0';
+    // 头部结束标记
+    APPEND_BYTES(ptr, "\r\n", 2);
+    
+    if (response->body) {
+        APPEND_BYTES(ptr, response->body, response->body_length);
+    }
     
     // 发送响应
-    uv_buf_t write_buf = uv_buf_init(response_buffer, response_length);
-    uv_write_t *write_req = malloc(sizeof(uv_write_t));
-    if (write_req) {
-        write_req->data = client;
-        uv_write(write_req, (uv_stream_t*) &client->tcp, &write_buf, 1, on_client_write);
+    if (connection_write(client, response_buffer, response_length) != 0) {
+        log_error("HTTP发送响应失败");
+        connection_close(client);
+        return 0;
     }
+    return response_length;
 }
 
 // 查找匹配的路由
@@ -560,12 +1328,7 @@ static int parse_url(const char *url, char **path, char **query_string) {
         *path = decoded_path;
     }
     
-    if (*query_string) {
-        char *decoded_query = url_decode(*query_string);
-        free(*query_string);
-        *query_string = decoded_query;
-    }
-    
+    // 查询字符串保持原样，先按'&'和'='切分再逐个解码，避免编码后的分隔符被误切
     return 0;
 }
 
@@ -582,23 +1345,10 @@ static char* url_decode(const char *str) {
     
     char *dst = result;
     const char *src = str;
+    const char *end = str + strlen(str);
     
-    while (*src) {
-        if (*src == '%' && src[1] && src[2]) {
-            char hex[3] = {src[1], src[2], 0};
-            int value;
-            if (sscanf(hex, "%x", &value) == 1) {
-                *dst++ = (char)value;
-                src += 3;
-            } else {
-                *dst++ = *src++;
-            }
-        } else if (*src == '+') {
-            *dst++ = ' ';
-            src++;
-        } else {
-            *dst++ = *src++;
-        }
+    while (src < end) {
+        src += http_decode_char(src, end, dst++);
     }
     
     *dst = '\0';
@@ -623,6 +1373,7 @@ static int add_header_to_response(http_response_t *response, const char *name, c
     
     response->headers[index].name = strdup(name);
     response->headers[index].value = strdup(value);
+    response->headers[index].id = http_header_lookup(name, strlen(name));
     response->header_count++;
     
     return 0;
@@ -648,12 +1399,17 @@ int http_add_route(http_method_t method, const char *path, http_route_handler_t
     
     uv_mutex_lock(&global_http_data->routes_mutex);
     
+    route->id = ++global_http_data->next_route_id;
     route->next = global_http_data->routes;
     global_http_data->routes = route;
     global_http_data->route_count++;
     
     uv_mutex_unlock(&global_http_data->routes_mutex);
     
+    if (global_http_data->access_log) {
+        http_access_log_set_route_name(global_http_data->access_log, (uint16_t) route->id, path);
+    }
+    
     log_info("添加HTTP路由: %s %s", http_method_to_string(method), path);
     return 0;
 }
@@ -799,6 +1555,8 @@ const char* http_status_to_string(http_status_t status) {
         case HTTP_STATUS_FORBIDDEN: return "Forbidden";
         case HTTP_STATUS_NOT_FOUND: return "Not Found";
         case HTTP_STATUS_METHOD_NOT_ALLOWED: return "Method Not Allowed";
+        case HTTP_STATUS_PAYLOAD_TOO_LARGE: return "Payload Too Large";
+        case HTTP_STATUS_REQUEST_HEADER_FIELDS_TOO_LARGE: return "Request Header Fields Too Large";
         case HTTP_STATUS_INTERNAL_SERVER_ERROR: return "Internal Server Error";
         case HTTP_STATUS_NOT_IMPLEMENTED: return "Not Implemented";
         case HTTP_STATUS_SERVICE_UNAVAILABLE: return "Service Unavailable";
@@ -815,16 +1573,54 @@ int http_get_header(const http_request_t *request, const char *name, char **valu
         return -1;
     }
     
+    // 已知头部直接按ID取值
+    http_header_id_t id = http_header_lookup(name, strlen(name));
+    if (id != HTTP_HEADER_UNKNOWN) {
+        if (!request->known_headers[id]) {
+            return -1;
+        }
+        *value = strdup(request->known_headers[id]);
+        return *value ? 0 : -1;
+    }
+    
+    // 未知头部回退到线性查找
     for (int i = 0; i < request->header_count; i++) {
-        if (strcasecmp(request->headers[i].name, name) == 0) {
+        if (request->headers[i].id == HTTP_HEADER_UNKNOWN &&
+            strcasecmp(request->headers[i].name, name) == 0) {
             *value = strdup(request->headers[i].value);
-            return 0;
+            return *value ? 0 : -1;
         }
     }
     
     return -1;
 }
 
+// 获取查询参数（解码结果缓存在请求中，请求对象本身在模块内是可写的）
+const char* http_get_query_param(const http_request_t *request, const char *name) {
+    if (!request || !name) {
+        return NULL;
+    }
+    
+    return http_find_param((http_param_list_t*) &request->query_params, name);
+}
+
+// 获取表单参数
+const char* http_get_form_param(const http_request_t *request, const char *name) {
+    if (!request || !name) {
+        return NULL;
+    }
+    
+    return http_find_param((http_param_list_t*) &request->form_params, name);
+}
+
+const char* http_get_known_header(const http_request_t *request, http_header_id_t id) {
+    if (!request || id <= HTTP_HEADER_UNKNOWN || id >= HTTP_HEADER_KNOWN_COUNT) {
+        return NULL;
+    }
+    
+    return request->known_headers[id];
+}
+
 // 预定义响应函数实现
 
 int http_send_ok_response(http_response_t *response, const char *json_data) {
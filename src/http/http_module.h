@@ -2,6 +2,7 @@
 #define HTTP_MODULE_H
 
 #include "src/modules/module_manager.h"
+#include "src/http/http_headers.h"
 #include <uv.h>
 #include <stddef.h>
 
@@ -27,23 +28,49 @@ typedef enum {
     HTTP_STATUS_FORBIDDEN = 403,
     HTTP_STATUS_NOT_FOUND = 404,
     HTTP_STATUS_METHOD_NOT_ALLOWED = 405,
+    HTTP_STATUS_PAYLOAD_TOO_LARGE = 413,
+    HTTP_STATUS_REQUEST_HEADER_FIELDS_TOO_LARGE = 431,
     HTTP_STATUS_INTERNAL_SERVER_ERROR = 500,
     HTTP_STATUS_NOT_IMPLEMENTED = 501,
     HTTP_STATUS_SERVICE_UNAVAILABLE = 503
 } http_status_t;
 
+// 请求参数内联存储的数量，超出后转为堆上数组
+#define HTTP_INLINE_PARAMS 16
+
+// 请求参数（名称/值指向请求持有的原始数据，值在首次访问时解码）
+typedef struct {
+    const char *name;
+    size_t name_length;
+    const char *value;
+    size_t value_length;
+    char *decoded_value;
+} http_param_t;
+
+// 请求参数列表
+typedef struct {
+    http_param_t inline_params[HTTP_INLINE_PARAMS];
+    http_param_t *overflow;     // 超过内联数量后的堆上数组（包含全部参数），未溢出时为NULL
+    int count;
+    int capacity;
+} http_param_list_t;
+
 // HTTP请求结构
 typedef struct http_request {
     http_method_t method;
     char *path;
-    char *query_string;
+    char *query_string;         // 未解码的原始查询字符串，按参数访问请用http_get_query_param
     char *body;
     size_t body_length;
-    char *content_type;
-    char *user_agent;
-    char *authorization;
+    char *content_type;         // 指向headers中的值，不单独释放
+    char *user_agent;           // 同上
+    char *authorization;        // 同上
     struct http_header *headers;
     int header_count;
+    char *header_block;         // 头部原文副本，headers中的name/value指向其中
+    const char *known_headers[HTTP_HEADER_KNOWN_COUNT]; // 按已知头部ID索引的值
+    http_param_list_t query_params;
+    http_param_list_t form_params;  // application/x-www-form-urlencoded请求体
 } http_request_t;
 
 // HTTP响应结构
@@ -60,6 +87,7 @@ typedef struct http_response {
 typedef struct http_header {
     char *name;
     char *value;
+    http_header_id_t id;        // 已知头部ID，未知头部为HTTP_HEADER_UNKNOWN
 } http_header_t;
 
 // JSON解析回调函数类型
@@ -82,6 +110,7 @@ typedef struct {
 
 // HTTP路由项
 typedef struct http_route {
+    int id;                     // 路由ID，访问日志中使用
     http_method_t method;
     char *path;
     http_route_handler_t handler;
@@ -92,12 +121,30 @@ typedef struct http_route {
 // HTTP模块私有数据
 typedef struct {
     http_config_t config;
+    uv_loop_t *loop;
     uv_tcp_t server;
+    uv_pipe_t unix_server;                  // Unix域套接字监听，未配置时不初始化
+    char *unix_socket_path;                 // 未配置Unix域套接字时为NULL
+    struct uring_listener *uring_listener;  // io_uring后端的监听器，使用libuv时为NULL
+    struct tls_context *tls_context;        // 启用TLS时的上下文，否则为NULL
+    struct read_buffer_pool *read_buffers;  // 连接读缓冲池（事件循环线程独占）
     http_route_t *routes;
     int route_count;
+    int next_route_id;
     uv_mutex_t routes_mutex;
     json_parser_callback_t json_parser;
     void *json_parser_user_data;
+    
+    // 预渲染的响应头部（启动时生成，发送时直接memcpy）
+    char *cors_headers;
+    size_t cors_headers_length;
+    char date_header[64];       // "Date: ...\r\n"，由定时器每秒刷新
+    size_t date_header_length;
+    uv_timer_t date_timer;
+    
+    // 访问日志（enable_logging关闭或打开失败时为NULL）
+    struct http_access_log *access_log;
+    struct http_access_log_ring *access_log_ring;
 } http_private_data_t;
 
 // HTTP模块接口
@@ -108,6 +155,8 @@ int http_module_init(module_interface_t *self, uv_loop_t *loop);
 int http_module_start(module_interface_t *self);
 int http_module_stop(module_interface_t *self);
 int http_module_cleanup(module_interface_t *self);
+int http_module_quiesce(module_interface_t *self);
+int http_module_pending(module_interface_t *self);
 
 // 路由管理函数
 int http_add_route(http_method_t method, const char *path, http_route_handler_t handler, void *user_data);
@@ -125,6 +174,11 @@ http_method_t http_string_to_method(const char *method_str);
 const char* http_status_to_string(http_status_t status);
 int http_add_header(http_response_t *response, const char *name, const char *value);
 int http_get_header(const http_request_t *request, const char *name, char **value);
+const char* http_get_known_header(const http_request_t *request, http_header_id_t id);
+
+// 请求参数函数（返回解码后的值，由请求持有，不存在时返回NULL）
+const char* http_get_query_param(const http_request_t *request, const char *name);
+const char* http_get_form_param(const http_request_t *request, const char *name);
 
 // 预定义响应函数
 int http_send_ok_response(http_response_t *response, const char *json_data);
@@ -0,0 +1,336 @@
+#include "src/http/http_parser.h"
+#include <string.h>
+#include <stdlib.h>
+#include <strings.h>
+
+// chunk大小行允许的最大十六进制位数（避免溢出）
+#define HTTP_CHUNK_SIZE_MAX_DIGITS 15
+
+// 查找头部结束位置
+const char* http_find_header_end(const char *data, size_t length) {
+    if (!data || length < 4) {
+        return NULL;
+    }
+    return memmem(data, length, "\r\n\r\n", 4);
+}
+
+// 解析头部块：复制一次头部原文，在副本上原地切分，并为每个头部打上已知头部ID
+int http_parse_header_block(const char *start, size_t length, char **block,
+                            http_header_t **headers, int *header_count,
+                            const char **known_headers) {
+    if (length == 0) {
+        return 0;
+    }
+
+    // 头部中不允许NUL和不跟LF的CR，统计行数（每行以CRLF结尾）用于预分配头部数组
+    int capacity = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (start[i] == '\0') {
+            return -1;
+        }
+        if (start[i] == '\r') {
+            if (i + 1 >= length || start[i + 1] != '\n') {
+                return -1;
+            }
+            capacity++;
+        }
+    }
+    if (start[length - 1] != '\n') {
+        capacity++;             // 最后一行没有CRLF
+    }
+
+    *block = malloc(length + 1);
+    if (!*block) {
+        return -1;
+    }
+    memcpy(*block, start, length);
+    (*block)[length] = '\0';
+
+    *headers = malloc(sizeof(http_header_t) * (capacity > 0 ? capacity : 1));
+    if (!*headers) {
+        return -1;
+    }
+
+    char *line = *block;
+    char *block_end = *block + length;
+    while (line < block_end && *header_count < capacity) {
+        char *line_end = memmem(line, block_end - line, "\r\n", 2);
+        if (!line_end) {
+            line_end = block_end;
+        }
+        *line_end = '\0';
+
+        char *colon = strchr(line, ':');
+        if (colon && colon > line) {
+            size_t name_length = colon - line;
+            *colon = '\0';
+
+            // 去除值两端的空白
+            char *value = colon + 1;
+            while (*value == ' ' || *value == '\t') value++;
+            char *value_end = line_end;
+            while (value_end > value && (value_end[-1] == ' ' || value_end[-1] == '\t')) value_end--;
+            *value_end = '\0';
+
+            http_header_t *header = &(*headers)[(*header_count)++];
+            header->name = line;
+            header->value = value;
+            header->id = http_header_lookup(line, name_length);
+
+            // 重复的已知头部以第一次出现的为准
+            if (header->id != HTTP_HEADER_UNKNOWN && !known_headers[header->id]) {
+                known_headers[header->id] = value;
+            }
+        }
+
+        line = line_end + 2;
+    }
+
+    return 0;
+}
+
+// 判断Transfer-Encoding是否为chunked（chunked必须是最后一个编码）
+int http_is_chunked(const char *transfer_encoding) {
+    if (!transfer_encoding) {
+        return 0;
+    }
+
+    size_t length = strlen(transfer_encoding);
+    return length >= 7 && strcasecmp(transfer_encoding + length - 7, "chunked") == 0;
+}
+
+// 解析十六进制chunk大小，遇到扩展参数(';')或行尾停止
+static int parse_chunk_size(const char *start, const char *end, size_t *size) {
+    size_t value = 0;
+    int digits = 0;
+
+    for (const char *p = start; p < end && *p != ';' && *p != ' ' && *p != '\t'; p++) {
+        int digit;
+        if (*p >= '0' && *p <= '9') digit = *p - '0';
+        else if (*p >= 'a' && *p <= 'f') digit = *p - 'a' + 10;
+        else if (*p >= 'A' && *p <= 'F') digit = *p - 'A' + 10;
+        else return -1;
+
+        if (++digits > HTTP_CHUNK_SIZE_MAX_DIGITS) {
+            return -1;
+        }
+        value = value * 16 + digit;
+    }
+
+    if (digits == 0) {
+        return -1;
+    }
+    *size = value;
+    return 0;
+}
+
+// 遍历chunked数据：out为NULL时只校验并统计长度，否则同时复制数据
+static int walk_chunks(const char *data, size_t length, char *out,
+                       size_t *body_length, size_t *consumed) {
+    const char *p = data;
+    const char *end = data + length;
+    size_t total = 0;
+
+    for (;;) {
+        const char *line_end = memmem(p, end - p, "\r\n", 2);
+        if (!line_end) {
+            return 0;
+        }
+
+        size_t size;
+        if (parse_chunk_size(p, line_end, &size) != 0) {
+            return -1;
+        }
+        p = line_end + 2;
+
+        if (size == 0) {
+            // 跳过尾部头部，直到空行
+            for (;;) {
+                line_end = memmem(p, end - p, "\r\n", 2);
+                if (!line_end) {
+                    return 0;
+                }
+                if (line_end == p) {
+                    *body_length = total;
+                    *consumed = line_end + 2 - data;
+                    return 1;
+                }
+                p = line_end + 2;
+            }
+        }
+
+        if ((size_t) (end - p) < size + 2) {
+            return 0;
+        }
+        if (p[size] != '\r' || p[size + 1] != '\n') {
+            return -1;
+        }
+
+        if (out) {
+            memcpy(out + total, p, size);
+        }
+        total += size;
+        p += size + 2;
+    }
+}
+
+// 解码chunked请求体：先校验并统计长度，完整时再一次性复制
+int http_decode_chunked(const char *data, size_t length, char **body,
+                        size_t *body_length, size_t *consumed) {
+    size_t total = 0;
+    size_t used = 0;
+
+    int result = walk_chunks(data, length, NULL, &total, &used);
+    if (result != 1) {
+        return result;
+    }
+
+    char *out = malloc(total + 1);
+    if (!out) {
+        return -1;
+    }
+    walk_chunks(data, length, out, &total, &used);
+    out[total] = '\0';
+
+    *body = out;
+    *body_length = total;
+    *consumed = used;
+    return 1;
+}
+
+// 解析十六进制字符，非法字符返回-1
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 解码一个URL编码的字符，返回消耗的源字节数
+size_t http_decode_char(const char *src, const char *end, char *out) {
+    if (*src == '%' && end - src >= 3) {
+        int high = hex_value(src[1]);
+        int low = hex_value(src[2]);
+        if (high >= 0 && low >= 0) {
+            *out = (char) (high * 16 + low);
+            return 3;
+        }
+    }
+    *out = (*src == '+') ? ' ' : *src;
+    return 1;
+}
+
+// 获取参数数组（未溢出时使用内联存储）
+static http_param_t* param_array(http_param_list_t *list) {
+    return list->overflow ? list->overflow : list->inline_params;
+}
+
+// 切分 name=value&name=value 形式的参数
+int http_parse_params(const char *data, size_t length, http_param_list_t *list) {
+    const char *end = data + length;
+    const char *pos = data;
+
+    while (pos < end) {
+        const char *item_end = memchr(pos, '&', end - pos);
+        if (!item_end) {
+            item_end = end;
+        }
+
+        if (item_end > pos) {
+            if (list->capacity == 0) {
+                list->capacity = HTTP_INLINE_PARAMS;
+            }
+
+            // 内联空间用完后转移到堆上数组
+            if (list->count >= list->capacity) {
+                int new_capacity = list->capacity * 2;
+                http_param_t *new_params;
+                if (!list->overflow) {
+                    new_params = malloc(sizeof(http_param_t) * new_capacity);
+                    if (new_params) {
+                        memcpy(new_params, list->inline_params, sizeof(list->inline_params));
+                    }
+                } else {
+                    new_params = realloc(list->overflow, sizeof(http_param_t) * new_capacity);
+                }
+                if (!new_params) {
+                    return -1;
+                }
+                list->overflow = new_params;
+                list->capacity = new_capacity;
+            }
+
+            const char *equals = memchr(pos, '=', item_end - pos);
+            http_param_t *param = &param_array(list)[list->count++];
+            param->name = pos;
+            param->name_length = (equals ? equals : item_end) - pos;
+            param->value = equals ? equals + 1 : item_end;
+            param->value_length = item_end - param->value;
+            param->decoded_value = NULL;
+        }
+
+        pos = item_end + 1;
+    }
+
+    return 0;
+}
+
+// 释放参数列表
+void http_free_params(http_param_list_t *list) {
+    http_param_t *params = param_array(list);
+    for (int i = 0; i < list->count; i++) {
+        free(params[i].decoded_value);
+    }
+    free(list->overflow);
+    list->overflow = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+
+// 比较编码后的参数名与给定名称（边解码边比较，不分配内存）
+static int param_name_equals(const http_param_t *param, const char *name) {
+    const char *src = param->name;
+    const char *end = param->name + param->name_length;
+
+    while (src < end) {
+        char c;
+        src += http_decode_char(src, end, &c);
+        if (*name == '\0' || c != *name) {
+            return 0;
+        }
+        name++;
+    }
+
+    return *name == '\0';
+}
+
+// 查找参数并在首次访问时解码其值
+const char* http_find_param(http_param_list_t *list, const char *name) {
+    http_param_t *params = param_array(list);
+    for (int i = 0; i < list->count; i++) {
+        http_param_t *param = &params[i];
+        if (!param_name_equals(param, name)) {
+            continue;
+        }
+
+        if (!param->decoded_value) {
+            char *decoded = malloc(param->value_length + 1);
+            if (!decoded) {
+                return NULL;
+            }
+
+            const char *src = param->value;
+            const char *end = param->value + param->value_length;
+            char *dst = decoded;
+            while (src < end) {
+                src += http_decode_char(src, end, dst++);
+            }
+            *dst = '\0';
+            param->decoded_value = decoded;
+        }
+
+        return param->decoded_value;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,50 @@
+#ifndef HTTP_PARSER_H
+#define HTTP_PARSER_H
+
+#include "src/http/http_module.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 请求/响应共用的HTTP/1.1报文解析函数
+
+// 查找头部结束标记"\r\n\r\n"，返回其起始位置，未找到返回NULL
+const char* http_find_header_end(const char *data, size_t length);
+
+// 解析头部块（不含起始行，包含最后一行的CRLF）
+// 复制一次原文到*block并原地切分，为每个头部打上已知头部ID，known_headers按ID索引
+// 含NUL或不跟LF的CR时视为格式错误
+// 成功返回0，失败返回-1（已分配的内存仍由调用者释放）
+int http_parse_header_block(const char *start, size_t length, char **block,
+                            http_header_t **headers, int *header_count,
+                            const char **known_headers);
+
+// 判断Transfer-Encoding是否为chunked
+int http_is_chunked(const char *transfer_encoding);
+
+// 解码chunked请求体
+// 返回1表示完整（*body/*body_length为解码结果，*consumed为消耗的字节数），
+// 返回0表示数据不完整，返回-1表示格式错误
+int http_decode_chunked(const char *data, size_t length, char **body,
+                        size_t *body_length, size_t *consumed);
+
+// 解码一个URL编码的字符（%XX或'+'），非法的%转义按原样保留，返回消耗的源字节数
+size_t http_decode_char(const char *src, const char *end, char *out);
+
+// 切分 name=value&name=value 形式的参数，只记录位置不解码，名称和值指向data
+// 前HTTP_INLINE_PARAMS个参数内联存储，超出后转为堆上数组。成功返回0，内存不足返回-1
+int http_parse_params(const char *data, size_t length, http_param_list_t *list);
+
+// 按解码后的名称查找参数，首次访问时解码并缓存值，不存在时返回NULL
+const char* http_find_param(http_param_list_t *list, const char *name);
+
+// 释放参数列表的解码缓存和堆上数组
+void http_free_params(http_param_list_t *list);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_PARSER_H
@@ -21,13 +21,14 @@ static user_t users[] = {
 };
 static int user_count = 3;
 
-// GET /api/users - 获取所有用户
+// GET /api/users - 获取所有用户（可用 ?name= 按姓名过滤）
 int handle_get_users(const http_request_t *request, http_response_t *response, void *user_data) {
-    (void)request;
     (void)user_data;
     
     log_info("处理GET /api/users请求");
     
+    const char *name_filter = http_get_query_param(request, "name");
+    
     // 创建JSON响应
     json_value_t *users_array = json_create_array();
     if (!users_array) {
@@ -36,6 +37,8 @@ int handle_get_users(const http_request_t *request, http_response_t *response, v
     
     // 添加用户到数组
     for (int i = 0; i < user_count; i++) {
+        if (name_filter && strcmp(users[i].name, name_filter) != 0) continue;
+        
         json_value_t *user_obj = json_create_object();
         if (!user_obj) continue;
         
@@ -36,6 +36,7 @@ static int parse_null(json_parser_t *parser);
 static char* unescape_string(const char *str);
 static int expand_array_capacity(json_array_t *array);
 static int expand_object_capacity(json_object_t *object);
+static void json_free_data(json_value_t *value);
 
 // 全局错误状态
 static json_error_t global_last_error = JSON_ERROR_NONE;
@@ -398,7 +399,7 @@ int json_array_set(json_value_t *array, size_t index, const json_value_t *value)
     }
     
     // 释放旧值
-    json_free(&arr->values[index]);
+    json_free_data(&arr->values[index]);
     
     // 设置新值
     json_value_t *cloned_value = json_clone(value);
@@ -432,7 +433,7 @@ int json_object_set(json_value_t *object, const char *key, const json_value_t *v
     for (size_t i = 0; i < obj->count; i++) {
         if (strcmp(obj->pairs[i].key, key) == 0) {
             // 更新现有值
-            json_free(&obj->pairs[i].value);
+            json_free_data(&obj->pairs[i].value);
             json_value_t *cloned_value = json_clone(value);
             if (!cloned_value) return -1;
             obj->pairs[i].value = *cloned_value;
@@ -493,7 +494,7 @@ int json_object_remove(json_value_t *object, const char *key) {
         if (strcmp(obj->pairs[i].key, key) == 0) {
             // 释放键值对
             free(obj->pairs[i].key);
-            json_free(&obj->pairs[i].value);
+            json_free_data(&obj->pairs[i].value);
             
             // 移动后面的元素
             for (size_t j = i; j < obj->count - 1; j++) {
@@ -568,9 +569,8 @@ const char* json_get_string(const json_value_t *value) {
 
 // JSON内存管理函数
 
-void json_free(json_value_t *value) {
-    if (!value) return;
-    
+// 释放值内部持有的数据（不释放值本身，数组/对象中的元素是内联存储的）
+static void json_free_data(json_value_t *value) {
     switch (value->type) {
         case JSON_TYPE_STRING:
             if (value->data.string_value) {
@@ -593,7 +593,12 @@ void json_free(json_value_t *value) {
         default:
             break;
     }
+}
+
+void json_free(json_value_t *value) {
+    if (!value) return;
     
+    json_free_data(value);
     free(value);
 }
 
@@ -601,7 +606,7 @@ void json_free_array(json_array_t *array) {
     if (!array) return;
     
     for (size_t i = 0; i < array->count; i++) {
-        json_free(&array->values[i]);
+        json_free_data(&array->values[i]);
     }
     
     if (array->values) {
@@ -616,7 +621,7 @@ void json_free_object(json_object_t *object) {
     
     for (size_t i = 0; i < object->count; i++) {
         free(object->pairs[i].key);
-        json_free(&object->pairs[i].value);
+        json_free_data(&object->pairs[i].value);
     }
     
     if (object->pairs) {
@@ -139,6 +139,7 @@ log_message_t* log_queue_pop(void) {
         message = queue->head;
         queue->head = message->next;
         queue->size--;
+        queue->writing = 1;
         
         if (queue->size == 0) {
             queue->tail = NULL;
@@ -232,13 +233,33 @@ static void write_log_to_console(log_level_t level, const char *message) {
     fflush(stdout);
 }
 
+// 标记已取出的消息写出完毕，队列已空时唤醒logger_flush
+static void log_queue_mark_written(int stopping) {
+    log_queue_t *queue = &global_logger_data->message_queue;
+    
+    uv_mutex_lock(&queue->queue_mutex);
+    queue->writing = 0;
+    if (queue->size == 0 || stopping) {
+        uv_cond_broadcast(&queue->drained_cond);
+    }
+    uv_mutex_unlock(&queue->queue_mutex);
+}
+
 // 工作线程函数
 static void logger_worker_thread(void *arg) {
     logger_private_data_t *data = (logger_private_data_t*) arg;
     
-    while (data->worker_running) {
+    // 停止标志置位后继续消费，直到队列被完全写出
+    while (1) {
         log_message_t *msg = log_queue_pop();
-        if (!msg) continue;
+        if (!msg) {
+            if (!data->worker_running) {
+                // 唤醒还在等待的logger_flush
+                log_queue_mark_written(1);
+                break;
+            }
+            continue;
+        }
         
         // 格式化完整消息
         char full_message[1024];
@@ -262,6 +283,7 @@ static void logger_worker_thread(void *arg) {
         
         // 释放消息
         free_log_message(msg);
+        log_queue_mark_written(0);
     }
 }
 
@@ -312,8 +334,16 @@ static void log_internal_async(log_level_t level, const char *format, va_list ar
         return;
     }
     
+    // 工作线程未运行（未启动或已停止）时直接同步写出，避免消息滞留在队列中
+    if (!global_logger_data->worker_running) {
+        log_internal_sync(level, format, args);
+        return;
+    }
+    
     // 格式化消息
     char message[1024];
+    va_list args_copy;
+    va_copy(args_copy, args);
     vsnprintf(message, sizeof(message), format, args);
     
     // 创建日志消息并加入队列
@@ -322,9 +352,10 @@ static void log_internal_async(log_level_t level, const char *format, va_list ar
         if (log_queue_push(msg) != 0) {
             // 队列已满，直接写入（同步方式）
             free_log_message(msg);
-            log_internal_sync(level, format, args);
+            log_internal_sync(level, format, args_copy);
         }
     }
+    va_end(args_copy);
 }
 
 // 异步日志记录函数实现
@@ -439,6 +470,14 @@ int logger_module_init(module_interface_t *self, uv_loop_t *loop) {
         return -1;
     }
     
+    if (uv_cond_init(&data->message_queue.drained_cond) != 0) {
+        uv_cond_destroy(&data->message_queue.queue_cond);
+        uv_mutex_destroy(&data->message_queue.queue_mutex);
+        uv_mutex_destroy(&data->log_mutex);
+        free(data);
+        return -1;
+    }
+    
     data->message_queue.max_size = default_config.max_queue_size;
     
     // 初始化刷新定时器
@@ -499,10 +538,12 @@ int logger_module_stop(module_interface_t *self) {
     // 停止刷新定时器
     uv_timer_stop(&data->flush_timer);
     
-    // 停止工作线程
+    // 停止工作线程（工作线程会先写完队列中剩余的消息）
     if (data->worker_running) {
+        uv_mutex_lock(&data->message_queue.queue_mutex);
         data->worker_running = 0;
         uv_cond_signal(&data->message_queue.queue_cond);
+        uv_mutex_unlock(&data->message_queue.queue_mutex);
         uv_thread_join(&data->worker_thread);
         log_info_sync("日志工作线程已停止");
     }
@@ -533,6 +574,7 @@ int logger_module_cleanup(module_interface_t *self) {
     
     // 销毁条件变量
     uv_cond_destroy(&data->message_queue.queue_cond);
+    uv_cond_destroy(&data->message_queue.drained_cond);
     
     // 销毁互斥锁
     uv_mutex_destroy(&data->message_queue.queue_mutex);
@@ -619,6 +661,14 @@ int logger_flush(void) {
     
     logger_private_data_t *data = global_logger_data;
     
+    // 等待工作线程写完队列中的消息（只有工作线程在运行时队列才会被消费）
+    log_queue_t *queue = &data->message_queue;
+    uv_mutex_lock(&queue->queue_mutex);
+    while (data->worker_running && (queue->size > 0 || queue->writing)) {
+        uv_cond_wait(&queue->drained_cond, &queue->queue_mutex);
+    }
+    uv_mutex_unlock(&queue->queue_mutex);
+    
     // 刷新文件缓冲区
     if (data->config.enable_file && data->log_fp) {
         uv_mutex_lock(&data->log_mutex);
@@ -626,10 +676,5 @@ int logger_flush(void) {
         uv_mutex_unlock(&data->log_mutex);
     }
     
-    // 等待队列清空
-    while (log_queue_size() > 0) {
-        uv_sleep(1); // 等待1ms
-    }
-    
     return 0;
 }
@@ -30,6 +30,8 @@ typedef struct {
     size_t max_size;
     uv_mutex_t queue_mutex;
     uv_cond_t queue_cond;
+    uv_cond_t drained_cond;     // 队列写空时通知logger_flush
+    int writing;                // 工作线程正在写出已取出的消息
 } log_queue_t;
 
 // 日志模块配置
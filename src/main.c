@@ -24,18 +24,44 @@
 #include "src/http/http_routes.h"
 
 
+// 优雅关闭参数
+#define DEFAULT_SHUTDOWN_TIMEOUT_MS 10000
+#define SHUTDOWN_POLL_INTERVAL_MS 100
+
 // 全局变量
 uv_loop_t *main_loop;
 module_manager_t *module_mgr;
 
+// 信号与优雅关闭状态
+static uv_signal_t sigint_handle;
+static uv_signal_t sigterm_handle;
+static uv_timer_t shutdown_timer;
+static int shutdown_requested = 0;
+static uint64_t shutdown_deadline = 0;
+
+// 关闭事件循环中剩余的句柄
+static void close_walk_cb(uv_handle_t *handle, void *arg) {
+    (void)arg; // 避免未使用参数警告
+    if (!uv_is_closing(handle)) {
+        uv_close(handle, NULL);
+    }
+}
+
 // 程序退出处理
 void cleanup_and_exit(int exit_code) {
     log_info("正在关闭程序...");
     
+    // 先关闭并回收事件循环中剩余的句柄，再释放持有这些句柄的模块数据
+    if (main_loop) {
+        uv_walk(main_loop, close_walk_cb, NULL);
+        uv_run(main_loop, UV_RUN_DEFAULT);
+    }
+    
     // 关闭所有模块
     if (module_mgr) {
         module_manager_shutdown(module_mgr);
         module_manager_destroy(module_mgr);
+        module_mgr = NULL;
     }
     
     // 关闭事件循环
@@ -47,11 +73,54 @@ void cleanup_and_exit(int exit_code) {
     exit(exit_code);
 }
 
+// 完成优雅关闭：停止所有模块并释放信号句柄，使事件循环自然退出
+static void finish_shutdown(void) {
+    uv_timer_stop(&shutdown_timer);
+    uv_close((uv_handle_t*) &shutdown_timer, NULL);
+    
+    // 写出异步日志队列中的剩余消息
+    logger_flush();
+    
+    // 逆序停止模块：HTTP/网络 -> 线程池（执行完剩余工作） -> 日志
+    module_manager_stop(module_mgr);
+    
+    uv_close((uv_handle_t*) &sigint_handle, NULL);
+    uv_close((uv_handle_t*) &sigterm_handle, NULL);
+}
+
+// 关闭期间定期检查未完成的请求
+static void on_shutdown_timer(uv_timer_t *handle) {
+    int pending = module_manager_pending_count(module_mgr);
+    
+    if (pending == 0) {
+        log_info("所有进行中的请求已完成");
+        finish_shutdown();
+    } else if (uv_now(handle->loop) >= shutdown_deadline) {
+        log_warn("关闭超时，仍有 %d 个请求未完成，强制关闭", pending);
+        finish_shutdown();
+    }
+}
+
 // 信号处理
 void signal_handler(uv_signal_t *handle, int signum) {
-    (void)handle; // 避免未使用参数警告
-    log_info("收到信号 %d，正在退出...", signum);
-    cleanup_and_exit(0);
+    // 关闭过程中再次收到信号，立即退出
+    if (shutdown_requested) {
+        log_warn_sync("再次收到信号 %d，立即退出", signum);
+        _exit(1);
+    }
+    
+    shutdown_requested = 1;
+    
+    int timeout_ms = config_get_int("shutdown_timeout_ms", DEFAULT_SHUTDOWN_TIMEOUT_MS);
+    log_info("收到信号 %d，开始优雅关闭（最长等待 %d ms，再次发送信号可立即退出）...", signum, timeout_ms);
+    
+    // 停止接收新的连接，已建立的连接继续完成进行中的请求
+    module_manager_quiesce(module_mgr);
+    
+    shutdown_deadline = uv_now(handle->loop) + (uint64_t) timeout_ms;
+    uv_timer_init(handle->loop, &shutdown_timer);
+    // 首次检查延后一个周期，让已到达内核缓冲区的数据先被读取处理
+    uv_timer_start(&shutdown_timer, on_shutdown_timer, SHUTDOWN_POLL_INTERVAL_MS, SHUTDOWN_POLL_INTERVAL_MS);
 }
 
 // 初始化配置文件系统
@@ -126,16 +195,21 @@ int initialize_program() {
         return -1;
     }
     
-    if (module_manager_register_module(module_mgr, (struct module_interface*)&database_module_interface) != 0) {
+    if (module_manager_register_module(module_mgr, &database_module_interface) != 0) {
         log_error("注册数据库模块失败");
         return -1;
     }
     
-    // 注册信号处理
-    uv_signal_t *signal_handle = malloc(sizeof(uv_signal_t));
-    uv_signal_init(main_loop, signal_handle);
-    uv_signal_start(signal_handle, signal_handler, SIGINT);
-    uv_signal_start(signal_handle, signal_handler, SIGTERM);
+#ifndef _WIN32
+    // 对端关闭后写套接字返回EPIPE而不是终止进程（TLS连接直接write套接字）
+    signal(SIGPIPE, SIG_IGN);
+#endif
+    
+    // 注册信号处理（每个信号使用独立的句柄）
+    uv_signal_init(main_loop, &sigint_handle);
+    uv_signal_start(&sigint_handle, signal_handler, SIGINT);
+    uv_signal_init(main_loop, &sigterm_handle);
+    uv_signal_start(&sigterm_handle, signal_handler, SIGTERM);
     
     log_info("程序初始化完成");
     return 0;
@@ -194,7 +194,8 @@ int module_manager_stop(module_manager_t *mgr) {
     
     log_info("正在停止所有模块...");
     
-    for (size_t i = 0; i < mgr->module_count; i++) {
+    // 按注册的逆序停止，保证上层模块（网络、HTTP）先于其依赖（线程池、日志）停止
+    for (size_t i = mgr->module_count; i-- > 0; ) {
         module_interface_t *module = mgr->modules[i];
         
         if (module->state == MODULE_STATE_STARTED) {
@@ -221,8 +222,8 @@ int module_manager_shutdown(module_manager_t *mgr) {
     // 先停止所有模块
     module_manager_stop(mgr);
     
-    // 然后清理所有模块
-    for (size_t i = 0; i < mgr->module_count; i++) {
+    // 然后按逆序清理所有模块
+    for (size_t i = mgr->module_count; i-- > 0; ) {
         module_interface_t *module = mgr->modules[i];
         
         if (module->state > MODULE_STATE_UNINITIALIZED) {
@@ -238,6 +239,48 @@ int module_manager_shutdown(module_manager_t *mgr) {
     return 0;
 }
 
+// 通知所有运行中的模块停止接收新的工作
+int module_manager_quiesce(module_manager_t *mgr) {
+    if (!mgr) {
+        return -1;
+    }
+    
+    log_info("正在停止接收新的连接和任务...");
+    
+    for (size_t i = mgr->module_count; i-- > 0; ) {
+        module_interface_t *module = mgr->modules[i];
+        
+        if (module->state == MODULE_STATE_STARTED && module->quiesce) {
+            if (module->quiesce(module) != 0) {
+                log_error("模块 %s 停止接收失败", module->name);
+            }
+        }
+    }
+    
+    return 0;
+}
+
+// 统计所有运行中的模块尚未完成的工作数
+int module_manager_pending_count(module_manager_t *mgr) {
+    if (!mgr) {
+        return 0;
+    }
+    
+    int total = 0;
+    for (size_t i = 0; i < mgr->module_count; i++) {
+        module_interface_t *module = mgr->modules[i];
+        
+        if (module->state == MODULE_STATE_STARTED && module->pending) {
+            int count = module->pending(module);
+            if (count > 0) {
+                total += count;
+            }
+        }
+    }
+    
+    return total;
+}
+
 // 获取模块状态
 module_state_t module_manager_get_module_state(module_manager_t *mgr, const char *module_name) {
     module_interface_t *module = module_manager_get_module(mgr, module_name);
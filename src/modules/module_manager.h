@@ -24,6 +24,10 @@ typedef struct module_interface {
     int (*stop)(struct module_interface *self);
     int (*cleanup)(struct module_interface *self);
     
+    // 优雅关闭钩子（可选，为NULL时跳过）
+    int (*quiesce)(struct module_interface *self);   // 停止接收新的连接/任务
+    int (*pending)(struct module_interface *self);   // 返回尚未完成的请求/任务数
+    
     // 模块状态
     module_state_t state;
     
@@ -57,6 +61,10 @@ int module_manager_start(module_manager_t *mgr);
 int module_manager_stop(module_manager_t *mgr);
 int module_manager_shutdown(module_manager_t *mgr);
 
+// 优雅关闭支持
+int module_manager_quiesce(module_manager_t *mgr);
+int module_manager_pending_count(module_manager_t *mgr);
+
 // 模块状态查询
 module_state_t module_manager_get_module_state(module_manager_t *mgr, const char *module_name);
 void module_manager_list_modules(module_manager_t *mgr);
@@ -0,0 +1,186 @@
+#include "src/net/conn_registry.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_SLOTS_PER_CHUNK 256
+
+// 槽位头部，对象紧跟其后（16字节，保持对象按16字节对齐）
+typedef struct {
+    uint32_t generation;
+    uint32_t index;
+    uint32_t next_free;         // 空闲时：下一个空闲槽位的下标+1，0表示没有
+    uint32_t in_use;
+} slot_header_t;
+
+struct conn_registry {
+    size_t object_size;
+    size_t slot_size;           // 头部+对象，16字节对齐
+    size_t slots_per_chunk;
+    char **chunks;
+    size_t chunk_count;
+    size_t chunk_capacity;
+    uint32_t free_head;         // 空闲链表头（下标+1），0表示没有空闲槽位
+    size_t count;
+};
+
+// 下标对应的槽位头部
+static slot_header_t* slot_at(const conn_registry_t *registry, uint32_t index) {
+    size_t chunk = index / registry->slots_per_chunk;
+    size_t offset = index % registry->slots_per_chunk;
+    return (slot_header_t*) (registry->chunks[chunk] + offset * registry->slot_size);
+}
+
+static conn_handle_t make_handle(const slot_header_t *slot) {
+    return ((conn_handle_t) slot->generation << 32) | slot->index;
+}
+
+// 增加一块槽位并加入空闲链表（低下标在前）
+static int add_chunk(conn_registry_t *registry) {
+    size_t total = (registry->chunk_count + 1) * registry->slots_per_chunk;
+    if (total > UINT32_MAX) {
+        return -1;
+    }
+
+    if (registry->chunk_count == registry->chunk_capacity) {
+        size_t capacity = registry->chunk_capacity ? registry->chunk_capacity * 2 : 4;
+        char **chunks = realloc(registry->chunks, capacity * sizeof(char*));
+        if (!chunks) {
+            return -1;
+        }
+        registry->chunks = chunks;
+        registry->chunk_capacity = capacity;
+    }
+
+    char *chunk = malloc(registry->slots_per_chunk * registry->slot_size);
+    if (!chunk) {
+        return -1;
+    }
+    registry->chunks[registry->chunk_count] = chunk;
+
+    uint32_t first = (uint32_t) (registry->chunk_count * registry->slots_per_chunk);
+    registry->chunk_count++;
+    for (size_t i = registry->slots_per_chunk; i > 0; i--) {
+        uint32_t index = first + (uint32_t) (i - 1);
+        slot_header_t *slot = slot_at(registry, index);
+        slot->generation = 1;
+        slot->index = index;
+        slot->in_use = 0;
+        slot->next_free = registry->free_head;
+        registry->free_head = index + 1;
+    }
+    return 0;
+}
+
+conn_registry_t* conn_registry_create(size_t object_size, size_t slots_per_chunk) {
+    if (object_size == 0) {
+        return NULL;
+    }
+
+    conn_registry_t *registry = calloc(1, sizeof(conn_registry_t));
+    if (!registry) {
+        return NULL;
+    }
+    registry->object_size = object_size;
+    registry->slot_size = (sizeof(slot_header_t) + object_size + 15) & ~(size_t) 15;
+    registry->slots_per_chunk = slots_per_chunk ? slots_per_chunk : DEFAULT_SLOTS_PER_CHUNK;
+    return registry;
+}
+
+void conn_registry_destroy(conn_registry_t *registry) {
+    if (!registry) {
+        return;
+    }
+    for (size_t i = 0; i < registry->chunk_count; i++) {
+        free(registry->chunks[i]);
+    }
+    free(registry->chunks);
+    free(registry);
+}
+
+void* conn_registry_alloc(conn_registry_t *registry, conn_handle_t *handle) {
+    if (!registry) {
+        return NULL;
+    }
+    if (registry->free_head == 0 && add_chunk(registry) != 0) {
+        return NULL;
+    }
+
+    slot_header_t *slot = slot_at(registry, registry->free_head - 1);
+    registry->free_head = slot->next_free;
+    slot->next_free = 0;
+    slot->in_use = 1;
+    registry->count++;
+
+    void *object = slot + 1;
+    memset(object, 0, registry->object_size);
+    if (handle) {
+        *handle = make_handle(slot);
+    }
+    return object;
+}
+
+void conn_registry_free(conn_registry_t *registry, void *object) {
+    if (!registry || !object) {
+        return;
+    }
+
+    slot_header_t *slot = (slot_header_t*) object - 1;
+    if (!slot->in_use) {
+        return;
+    }
+    slot->in_use = 0;
+
+    // 代号回绕时跳过0，保证句柄永远不等于CONN_HANDLE_INVALID
+    slot->generation++;
+    if (slot->generation == 0) {
+        slot->generation = 1;
+    }
+
+    // 最近释放的槽位最先复用，其内存更可能仍在缓存中
+    slot->next_free = registry->free_head;
+    registry->free_head = slot->index + 1;
+    registry->count--;
+}
+
+void* conn_registry_get(const conn_registry_t *registry, conn_handle_t handle) {
+    if (!registry || handle == CONN_HANDLE_INVALID) {
+        return NULL;
+    }
+
+    uint32_t index = (uint32_t) handle;
+    if (index >= registry->chunk_count * registry->slots_per_chunk) {
+        return NULL;
+    }
+    slot_header_t *slot = slot_at(registry, index);
+    if (!slot->in_use || slot->generation != (uint32_t) (handle >> 32)) {
+        return NULL;
+    }
+    return slot + 1;
+}
+
+conn_handle_t conn_registry_handle(const void *object) {
+    if (!object) {
+        return CONN_HANDLE_INVALID;
+    }
+    return make_handle((const slot_header_t*) object - 1);
+}
+
+size_t conn_registry_count(const conn_registry_t *registry) {
+    return registry ? registry->count : 0;
+}
+
+void conn_registry_foreach(conn_registry_t *registry, conn_registry_visit_cb cb, void *arg) {
+    if (!registry || !cb) {
+        return;
+    }
+
+    // 回调中可能分配新槽位，每次重新读取块数
+    for (size_t chunk = 0; chunk < registry->chunk_count; chunk++) {
+        for (size_t i = 0; i < registry->slots_per_chunk; i++) {
+            slot_header_t *slot = slot_at(registry, (uint32_t) (chunk * registry->slots_per_chunk + i));
+            if (slot->in_use) {
+                cb(slot + 1, make_handle(slot), arg);
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef CONN_REGISTRY_H
+#define CONN_REGISTRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 连接注册表
+// 连接对象分配在按块增长的槽位中（块不移动，对象地址在释放前保持不变，可直接嵌入libuv句柄），
+// 空闲槽位组成链表，分配、释放和按句柄查找都是O(1)。
+// 句柄 = 槽位代号（高32位）| 槽位下标（低32位），槽位每次释放代号加1，
+// 持有旧句柄的一方（例如线程池的处理结果）查找时得到NULL，不会访问到复用该槽位的新连接。
+
+typedef uint64_t conn_handle_t;
+
+// 无效句柄，有效句柄的代号从1开始，不会等于0
+#define CONN_HANDLE_INVALID ((conn_handle_t) 0)
+
+typedef struct conn_registry conn_registry_t;
+
+// 遍历回调，可以在回调中释放当前对象
+typedef void (*conn_registry_visit_cb)(void *object, conn_handle_t handle, void *arg);
+
+// 创建注册表，object_size为连接对象大小，slots_per_chunk为每块槽位数（0使用默认值）
+conn_registry_t* conn_registry_create(size_t object_size, size_t slots_per_chunk);
+
+// 释放注册表及全部槽位，调用前所有对象必须已不再使用
+void conn_registry_destroy(conn_registry_t *registry);
+
+// 分配一个清零的对象，通过handle返回其句柄（可为NULL），失败返回NULL
+void* conn_registry_alloc(conn_registry_t *registry, conn_handle_t *handle);
+
+// 释放对象，该对象的句柄随即失效
+void conn_registry_free(conn_registry_t *registry, void *object);
+
+// 按句柄查找对象，句柄已失效返回NULL
+void* conn_registry_get(const conn_registry_t *registry, conn_handle_t handle);
+
+// 获取对象的句柄
+conn_handle_t conn_registry_handle(const void *object);
+
+// 当前对象数
+size_t conn_registry_count(const conn_registry_t *registry);
+
+// 按槽位顺序遍历全部对象
+void conn_registry_foreach(conn_registry_t *registry, conn_registry_visit_cb cb, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONN_REGISTRY_H
@@ -2,12 +2,83 @@
 #include "src/log/logger_module.h"
 #include "src/thread/threadpool_module.h"
 #include "src/config/config_module.h"
+#include "src/net/uring_backend.h"
+#include "src/net/unix_socket.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
-#define INITIAL_CLIENT_CAPACITY 16
+// 分帧默认值
+#define DEFAULT_MAX_FRAME_SIZE (1024 * 1024)
+#define DEFAULT_FRAME_BUFFER_SIZE (64 * 1024)
+
+// 一个连接缓存的响应达到该数量时立即写出（与IOV_MAX一致）
+#define MAX_CORKED_WRITES 1024
+
+// 没有截止时间的请求排在处理中链表末尾
+#define NO_DEADLINE UINT64_MAX
+
+// UDP默认值
+#define DEFAULT_UDP_BATCH_SIZE 32
+#define DEFAULT_UDP_MAX_DATAGRAM_SIZE 2048
+#define DEFAULT_UDP_SEND_QUEUE 4096
+#define DEFAULT_UDP_SOCKET_BUFFER (4 * 1024 * 1024)
+
+// UDP模式的响应在内部按4字节长度前缀编码（与RPC帧相同），发送时去掉长度头
+#define UDP_FRAME_HEADER_SIZE 4
+
+// 键值存储默认值
+#define DEFAULT_KV_SHARDS 16
+#define DEFAULT_KV_EXPIRE_TICK_MS 100
+
+// 发布订阅默认值
+#define DEFAULT_PUBSUB_MAX_PENDING 64
+#define MAX_TOPIC_LENGTH 255
+
+// 客户端连接（libuv和io_uring两种后端共用）
+typedef struct enhanced_connection {
+    union {
+        uv_tcp_t tcp;
+        uv_pipe_t pipe;                     // 从Unix域套接字接受的连接
+    } stream;                               // 仅libuv后端使用
+    uring_conn_t *uring;                    // 仅io_uring后端使用
+    udp_endpoint_t *udp;                    // 仅UDP模式使用，整个端点作为一个连接
+    enhanced_network_private_data_t *module;
+    frame_decoder_t *decoder;
+    int inflight;                           // 已提交、尚未应答的请求数（超时应答后不再计入）
+    request_context_t *waiting_head;        // 超过并发上限、等待提交的请求
+    request_context_t *waiting_tail;
+    struct enhanced_connection *blocked_prev;   // 因全局上限等待时位于模块的等待链表中
+    struct enhanced_connection *blocked_next;
+    int blocked;
+    int read_paused;
+    pubsub_subscriber_t *subscriber;        // 第一次订阅时创建
+    uv_buf_t *output;                       // 本轮产生、尚未写出的响应（libuv后端）
+    size_t output_count;
+    size_t output_capacity;
+    struct enhanced_connection *flush_prev; // 有待写出的响应时位于模块的写出链表中
+    struct enhanced_connection *flush_next;
+    int flush_pending;
+} enhanced_connection_t;
+
+// 一批同步响应合并为一次写入
+typedef struct {
+    uv_write_t req;
+    size_t count;
+    char *buffers[];
+} batch_write_t;
+
+// 写给一个订阅者的共享消息，写入期间持有消息的引用
+typedef struct {
+    uv_write_t req;
+    pubsub_message_t *message;
+    enhanced_connection_t *conn;
+} pubsub_write_t;
+
+// 原始消息协议的发布订阅命令
+static const char *pubsub_command_names[] = { "SUBSCRIBE ", "UNSUBSCRIBE ", "PUBLISH " };
+enum { PUBSUB_COMMAND_SUBSCRIBE, PUBSUB_COMMAND_UNSUBSCRIBE, PUBSUB_COMMAND_PUBLISH };
 
 // 增强网络模块接口定义
 module_interface_t enhanced_network_module = {
@@ -17,6 +88,8 @@ module_interface_t enhanced_network_module = {
     .start = enhanced_network_module_start,
     .stop = enhanced_network_module_stop,
     .cleanup = enhanced_network_module_cleanup,
+    .quiesce = enhanced_network_module_quiesce,
+    .pending = enhanced_network_module_pending,
     .state = MODULE_STATE_UNINITIALIZED,
     .private_data = NULL,
     .dependencies = NULL,
@@ -31,212 +104,1348 @@ static enhanced_network_config_t default_config = {
     .max_connections = 1000,
     .enable_threadpool = 1,
     .max_concurrent_requests = 100,
-    .request_timeout_ms = 30000
+    .max_inflight_per_connection = 16,
+    .request_timeout_ms = 30000,
+    .protocol = ENHANCED_PROTOCOL_RAW,
+    .transport = ENHANCED_TRANSPORT_TCP
 };
 
-// 扩展客户端数组容量
-static int expand_client_capacity(enhanced_network_private_data_t *data) {
-    size_t new_capacity = data->client_capacity * 2;
-    uv_tcp_t **new_clients = realloc(data->clients, 
-                                     sizeof(uv_tcp_t*) * new_capacity);
-    if (!new_clients) {
-        return -1;
+// 暂停后恢复读取和分发时使用
+static void on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf);
+static int on_frames(const frame_t *frames, size_t count, void *arg);
+static int on_uring_frames(const frame_t *frames, size_t count, void *arg);
+static void alloc_buffer(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf);
+static void on_deadline_timer(uv_timer_t *handle);
+static void on_flush_check(uv_check_t *handle);
+
+// 释放请求上下文
+static void free_request(request_context_t *ctx) {
+    free(ctx->request_data);
+    free(ctx->response);
+    free(ctx);
+}
+
+// 请求链表（等待队列和处理中链表共用prev/next，请求同一时刻只在其中一个链表中）
+static void request_list_append(request_context_t **head, request_context_t **tail, request_context_t *ctx) {
+    ctx->prev = *tail;
+    ctx->next = NULL;
+    if (*tail) {
+        (*tail)->next = ctx;
+    } else {
+        *head = ctx;
+    }
+    *tail = ctx;
+}
+
+static void request_list_remove(request_context_t **head, request_context_t **tail, request_context_t *ctx) {
+    if (ctx->prev) {
+        ctx->prev->next = ctx->next;
+    } else {
+        *head = ctx->next;
+    }
+    if (ctx->next) {
+        ctx->next->prev = ctx->prev;
+    } else {
+        *tail = ctx->prev;
+    }
+    ctx->prev = NULL;
+    ctx->next = NULL;
+}
+
+// 按截止时刻插入处理中链表，截止时刻相同的请求保持提交顺序。
+// 截止时刻通常随提交顺序递增，从末尾向前查找一般只比较一次
+static void inflight_insert(enhanced_network_private_data_t *data, request_context_t *ctx) {
+    request_context_t *after = data->inflight_tail;
+    while (after && after->deadline > ctx->deadline) {
+        after = after->prev;
+    }
+    
+    ctx->prev = after;
+    ctx->next = after ? after->next : data->inflight_head;
+    if (ctx->next) {
+        ctx->next->prev = ctx;
+    } else {
+        data->inflight_tail = ctx;
+    }
+    if (after) {
+        after->next = ctx;
+    } else {
+        data->inflight_head = ctx;
+    }
+}
+
+// 连接加入/离开因全局上限而等待的链表
+static void block_connection(enhanced_network_private_data_t *data, enhanced_connection_t *conn) {
+    if (conn->blocked) {
+        return;
+    }
+    conn->blocked = 1;
+    conn->blocked_prev = data->blocked_tail;
+    conn->blocked_next = NULL;
+    if (data->blocked_tail) {
+        data->blocked_tail->blocked_next = conn;
+    } else {
+        data->blocked_head = conn;
+    }
+    data->blocked_tail = conn;
+}
+
+static void unblock_connection(enhanced_network_private_data_t *data, enhanced_connection_t *conn) {
+    if (!conn->blocked) {
+        return;
+    }
+    if (conn->blocked_prev) {
+        conn->blocked_prev->blocked_next = conn->blocked_next;
+    } else {
+        data->blocked_head = conn->blocked_next;
+    }
+    if (conn->blocked_next) {
+        conn->blocked_next->blocked_prev = conn->blocked_prev;
+    } else {
+        data->blocked_tail = conn->blocked_prev;
+    }
+    conn->blocked = 0;
+    conn->blocked_prev = NULL;
+    conn->blocked_next = NULL;
+}
+
+// 连接加入/离开待写出链表，链表非空时启动check句柄
+static void schedule_flush(enhanced_network_private_data_t *data, enhanced_connection_t *conn) {
+    if (conn->flush_pending) {
+        return;
+    }
+    if (!data->flush_head) {
+        uv_check_start(&data->flush_check, on_flush_check);
+    }
+    conn->flush_pending = 1;
+    conn->flush_prev = NULL;
+    conn->flush_next = data->flush_head;
+    if (data->flush_head) {
+        data->flush_head->flush_prev = conn;
+    }
+    data->flush_head = conn;
+}
+
+static void unschedule_flush(enhanced_network_private_data_t *data, enhanced_connection_t *conn) {
+    if (!conn->flush_pending) {
+        return;
+    }
+    conn->flush_pending = 0;
+    if (conn->flush_prev) {
+        conn->flush_prev->flush_next = conn->flush_next;
+    } else {
+        data->flush_head = conn->flush_next;
+    }
+    if (conn->flush_next) {
+        conn->flush_next->flush_prev = conn->flush_prev;
+    }
+    conn->flush_prev = NULL;
+    conn->flush_next = NULL;
+}
+
+// 连接关闭后释放资源，连接的句柄随即失效，线程池中该连接的请求完成时查找不到连接
+static void release_connection(enhanced_connection_t *conn) {
+    enhanced_network_private_data_t *data = conn->module;
+    
+    // 尚未提交的请求直接丢弃
+    while (conn->waiting_head) {
+        request_context_t *ctx = conn->waiting_head;
+        request_list_remove(&conn->waiting_head, &conn->waiting_tail, ctx);
+        data->queued_requests--;
+        free_request(ctx);
+    }
+    unblock_connection(data, conn);
+    
+    // 连接关闭前未写出的响应丢弃
+    unschedule_flush(data, conn);
+    for (size_t i = 0; i < conn->output_count; i++) {
+        free(conn->output[i].base);
+    }
+    free(conn->output);
+    
+    pubsub_subscriber_destroy(data->pubsub, conn->subscriber);
+    frame_decoder_destroy(conn->decoder);
+    conn_registry_free(data->connections, conn);
+    log_info("客户端断开连接，当前连接数: %zu", conn_registry_count(data->connections));
+}
+
+// 客户端关闭回调
+static void on_client_close(uv_handle_t *handle) {
+    release_connection((enhanced_connection_t*) handle->data);
+}
+
+// 连接是否正在关闭
+static int connection_is_closing(enhanced_connection_t *conn) {
+    if (conn->udp) {
+        return udp_endpoint_is_closing(conn->udp);
+    }
+    return conn->uring ? uring_conn_is_closing(conn->uring) : uv_is_closing((uv_handle_t*) &conn->stream);
+}
+
+// 暂停读取，未读的数据留在内核缓冲区中，由TCP流量控制限制客户端的发送速度
+static void pause_reading(enhanced_connection_t *conn) {
+    if (conn->read_paused || connection_is_closing(conn)) {
+        return;
+    }
+    conn->read_paused = 1;
+    if (conn->udp) {
+        udp_endpoint_pause(conn->udp);
+    } else if (conn->uring) {
+        uring_conn_pause_reading(conn->uring);
+    } else {
+        uv_read_stop((uv_stream_t*) &conn->stream);
+    }
+}
+
+// 恢复读取
+static void resume_reading(enhanced_connection_t *conn) {
+    if (!conn->read_paused || connection_is_closing(conn)) {
+        return;
+    }
+    conn->read_paused = 0;
+    if (conn->udp) {
+        udp_endpoint_resume(conn->udp);
+    } else if (conn->uring) {
+        uring_conn_resume_reading(conn->uring);
+    } else {
+        uv_read_start((uv_stream_t*) &conn->stream, alloc_buffer, on_read);
+    }
+}
+
+// 批量写入完成回调
+static void on_batch_write_complete(uv_write_t *req, int status) {
+    batch_write_t *batch = (batch_write_t*) req;
+    if (status) {
+        log_error("写入错误: %s", uv_strerror(status));
+    }
+    
+    for (size_t i = 0; i < batch->count; i++) {
+        free(batch->buffers[i]);
+    }
+    free(batch);
+}
+
+// 把连接缓存的响应作为一次uv_write写出
+static void flush_output(enhanced_connection_t *conn) {
+    unschedule_flush(conn->module, conn);
+    size_t count = conn->output_count;
+    if (count == 0) {
+        return;
+    }
+    conn->output_count = 0;
+    
+    batch_write_t *batch = malloc(sizeof(batch_write_t) + count * sizeof(char*));
+    if (batch) {
+        batch->count = count;
+        for (size_t i = 0; i < count; i++) {
+            batch->buffers[i] = conn->output[i].base;
+        }
+        if (uv_write(&batch->req, (uv_stream_t*) &conn->stream, conn->output, (unsigned int) count,
+                     on_batch_write_complete) == 0) {
+            return;
+        }
+        free(batch);
+    }
+    
+    log_error("写入响应失败");
+    for (size_t i = 0; i < count; i++) {
+        free(conn->output[i].base);
+    }
+}
+
+// check回调：写出本轮各连接缓存的响应
+static void on_flush_check(uv_check_t *handle) {
+    enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) handle->data;
+    while (data->flush_head) {
+        flush_output(data->flush_head);
+    }
+    uv_check_stop(handle);
+}
+
+// 写入一个已编码的帧，frame的所有权转移给本函数，失败时释放
+// libuv后端先缓存在连接中，本轮事件循环结束时与其他响应合并为一次写入；io_uring后端自行合并
+static int connection_write(enhanced_connection_t *conn, char *frame, size_t length) {
+    if (conn->uring) {
+        return uring_conn_write(conn->uring, frame, length, NULL, NULL);
+    }
+    if (uv_is_closing((uv_handle_t*) &conn->stream)) {
+        free(frame);
+        return -1;
+    }
+    
+    if (conn->output_count == conn->output_capacity) {
+        size_t capacity = conn->output_capacity ? conn->output_capacity * 2 : 16;
+        uv_buf_t *output = realloc(conn->output, capacity * sizeof(uv_buf_t));
+        if (!output) {
+            free(frame);
+            return -1;
+        }
+        conn->output = output;
+        conn->output_capacity = capacity;
+    }
+    conn->output[conn->output_count++] = uv_buf_init(frame, (unsigned int) length);
+    
+    if (conn->output_count >= MAX_CORKED_WRITES) {
+        flush_output(conn);
+    } else {
+        schedule_flush(conn->module, conn);
+    }
+    return 0;
+}
+
+// UDP模式：去掉响应帧的长度头，作为一个数据报发回请求的来源地址，frame的所有权转移给本函数
+static int udp_reply(enhanced_connection_t *conn, const udp_peer_t *peer, char *frame, size_t length) {
+    memmove(frame, frame + UDP_FRAME_HEADER_SIZE, length - UDP_FRAME_HEADER_SIZE);
+    return udp_endpoint_send(conn->udp, peer, frame, length - UDP_FRAME_HEADER_SIZE);
+}
+
+// 向请求的发送方写入一个已编码的帧，frame的所有权转移给本函数
+static int reply_frame(enhanced_connection_t *conn, const request_context_t *ctx, char *frame, size_t length) {
+    return conn->udp ? udp_reply(conn, &ctx->peer, frame, length) : connection_write(conn, frame, length);
+}
+
+// 按分帧格式编码并向请求的发送方发送一条消息
+static int reply_message(enhanced_connection_t *conn, const request_context_t *ctx, const char *message, size_t length) {
+    size_t frame_length;
+    char *frame = frame_encode(&conn->module->codec, message, length, &frame_length);
+    if (!frame) {
+        return -1;
+    }
+    return reply_frame(conn, ctx, frame, frame_length);
+}
+
+// 共享消息写入完成回调（连接关闭时以UV_ECANCELED完成，在关闭回调之前）
+static void on_pubsub_write_complete(uv_write_t *req, int status) {
+    pubsub_write_t *write = (pubsub_write_t*) req;
+    enhanced_connection_t *conn = write->conn;
+    if (status && status != UV_ECANCELED) {
+        log_error("写入错误: %s", uv_strerror(status));
+    }
+    pubsub_message_release(write->message);
+    free(write);
+    pubsub_write_complete(conn->module->pubsub, conn->subscriber);
+}
+
+// io_uring后端：消息副本写入完成
+static void on_pubsub_uring_write(uring_conn_t *uring, int status, void *arg) {
+    enhanced_connection_t *conn = (enhanced_connection_t*) arg;
+    (void)uring; // 避免未使用参数警告
+    (void)status; // 避免未使用参数警告
+    pubsub_write_complete(conn->module->pubsub, conn->subscriber);
+}
+
+// 发布订阅：向订阅者写入共享消息，libuv后端直接写出消息的缓冲区
+static int pubsub_connection_write(void *owner, pubsub_message_t *message) {
+    enhanced_connection_t *conn = (enhanced_connection_t*) owner;
+    if (connection_is_closing(conn)) {
+        return -1;
+    }
+    
+    // io_uring后端在写入后释放缓冲区，每个订阅者写入一份副本
+    if (conn->uring) {
+        char *copy = malloc(message->length);
+        if (!copy) {
+            return -1;
+        }
+        memcpy(copy, message->data, message->length);
+        return uring_conn_write(conn->uring, copy, message->length, on_pubsub_uring_write, conn);
+    }
+    
+    // 先写出缓存的响应，保持写入顺序
+    flush_output(conn);
+    
+    pubsub_write_t *write = malloc(sizeof(pubsub_write_t));
+    if (!write) {
+        return -1;
+    }
+    write->message = message;
+    write->conn = conn;
+    pubsub_message_retain(message);
+    
+    uv_buf_t buf = uv_buf_init(message->data, (unsigned int) message->length);
+    if (uv_write(&write->req, (uv_stream_t*) &conn->stream, &buf, 1, on_pubsub_write_complete) != 0) {
+        pubsub_message_release(message);
+        free(write);
+        return -1;
+    }
+    return 0;
+}
+
+// 发布订阅：断开过慢的订阅者
+static void pubsub_connection_disconnect(void *owner) {
+    enhanced_connection_t *conn = (enhanced_connection_t*) owner;
+    log_warn("订阅者未完成的写入超过上限，断开连接");
+    if (conn->uring) {
+        uring_conn_close(conn->uring);
+    } else if (!uv_is_closing((uv_handle_t*) &conn->stream)) {
+        uv_close((uv_handle_t*) &conn->stream, on_client_close);
+    }
+}
+
+// 连接订阅主题
+static int subscribe_connection(enhanced_connection_t *conn, const char *topic) {
+    enhanced_network_private_data_t *data = conn->module;
+    if (!data->pubsub || conn->udp || connection_is_closing(conn)) {
+        return -1;
+    }
+    if (!conn->subscriber) {
+        conn->subscriber = pubsub_subscriber_create(data->pubsub, conn);
+        if (!conn->subscriber) {
+            return -1;
+        }
+    }
+    return pubsub_subscribe(data->pubsub, conn->subscriber, topic);
+}
+
+// 连接取消订阅主题
+static int unsubscribe_connection(enhanced_connection_t *conn, const char *topic) {
+    if (!conn->subscriber) {
+        return -1;
+    }
+    return pubsub_unsubscribe(conn->module->pubsub, conn->subscriber, topic);
+}
+
+// 按分帧格式编码一次，发布给主题的全部订阅者
+static int publish_message(enhanced_network_private_data_t *data, const char *topic,
+                           const char *payload, size_t length) {
+    if (!data->pubsub) {
+        return -1;
+    }
+    size_t frame_length;
+    char *frame = frame_encode(&data->codec, payload, length, &frame_length);
+    if (!frame) {
+        return -1;
+    }
+    pubsub_message_t *message = pubsub_message_create(frame, frame_length);
+    if (!message) {
+        return -1;
+    }
+    int written = pubsub_publish(data->pubsub, topic, message);
+    pubsub_message_release(message);
+    return written;
+}
+
+// 向客户端返回超时错误
+static void send_timeout(enhanced_connection_t *conn, const request_context_t *ctx) {
+    if (ctx->method.handler) {
+        size_t length;
+        char *frame = rpc_error_response(ctx->method.id, ctx->request_id, RPC_STATUS_DEADLINE_EXCEEDED, &length);
+        if (frame) {
+            reply_frame(conn, ctx, frame, length);
+        }
+        return;
+    }
+    
+    static const char timeout_message[] = "请求处理超时";
+    reply_message(conn, ctx, timeout_message, sizeof(timeout_message) - 1);
+}
+
+// 向客户端返回过载错误
+static void send_overloaded(enhanced_connection_t *conn, const request_context_t *ctx) {
+    if (ctx->method.handler) {
+        size_t length;
+        char *frame = rpc_error_response(ctx->method.id, ctx->request_id, RPC_STATUS_RESOURCE_EXHAUSTED, &length);
+        if (frame) {
+            reply_frame(conn, ctx, frame, length);
+        }
+        return;
+    }
+    
+    static const char overloaded_message[] = "服务器繁忙，请稍后重试";
+    reply_message(conn, ctx, overloaded_message, sizeof(overloaded_message) - 1);
+}
+
+// 在工作线程执行RPC方法，响应直接编码成帧
+static void process_rpc_request(request_context_t *ctx) {
+    rpc_call_t call = {
+        .method = ctx->method.id,
+        .request_id = ctx->request_id,
+        .body = ctx->request_data,
+        .body_length = ctx->request_size,
+        .deadline = ctx->deadline == NO_DEADLINE ? 0 : ctx->deadline
+    };
+    
+    // 排队期间已超时的请求不再执行；已过截止时刻但超时检查尚未触发时直接返回超时错误
+    if (__atomic_load_n(&ctx->timed_out, __ATOMIC_RELAXED)) {
+        return;
+    }
+    if (rpc_call_remaining_ms(&call) == 0) {
+        ctx->response = rpc_error_response(call.method, call.request_id, RPC_STATUS_DEADLINE_EXCEEDED,
+                                           &ctx->response_length);
+        return;
+    }
+    ctx->response = rpc_invoke(&ctx->method, &call, &ctx->response_length);
+}
+
+// 在线程池中处理请求（工作线程）
+void process_request_in_threadpool(void *ctx) {
+    if (!ctx) return;
+    
+    // 类型转换
+    request_context_t *request_ctx = (request_context_t*) ctx;
+    
+    if (request_ctx->method.handler) {
+        process_rpc_request(request_ctx);
+        loop_queue_post(request_ctx->module->completions, &request_ctx->node);
+        return;
+    }
+    
+    // 模拟处理时间（在实际应用中这里会进行真正的业务逻辑处理）
+    int processing_time = rand() % 100 + 10; // 10-110ms
+#ifdef _WIN32
+    Sleep(processing_time); // Windows下使用毫秒
+#else
+    usleep(processing_time * 1000); // Unix下使用微秒
+#endif
+    
+    // 排队期间已按超时应答的请求不再处理
+    if (__atomic_load_n(&request_ctx->timed_out, __ATOMIC_RELAXED)) {
+        loop_queue_post(request_ctx->module->completions, &request_ctx->node);
+        return;
+    }
+    
+    // 构造响应消息
+    char response[512];
+    int length = snprintf(response, sizeof(response), 
+                          "线程池处理完成，请求大小: %zu 字节，处理时间: %d ms", 
+                          request_ctx->request_size, processing_time);
+    if (length > 0 && (size_t) length < sizeof(response)) {
+        request_ctx->response = malloc((size_t) length);
+        if (request_ctx->response) {
+            memcpy(request_ctx->response, response, (size_t) length);
+            request_ctx->response_length = (size_t) length;
+        }
+    }
+    
+    // 结果交回事件循环线程写出，工作线程不接触连接和libuv句柄
+    loop_queue_post(request_ctx->module->completions, &request_ctx->node);
+}
+
+// 线程池按drop_oldest策略丢弃的请求（提交者线程）：交回事件循环返回过载错误
+static void on_request_discarded(work_function_t func, void *arg) {
+    if (func != process_request_in_threadpool) {
+        return;
+    }
+    request_context_t *ctx = (request_context_t*) arg;
+    ctx->rejected = 1;
+    loop_queue_post(ctx->module->completions, &ctx->node);
+}
+
+// 是否还有全局并发名额（上限不大于0表示不限制）
+static int has_global_capacity(enhanced_network_private_data_t *data) {
+    return data->config.max_concurrent_requests <= 0 ||
+           data->active_requests < data->config.max_concurrent_requests;
+}
+
+// 提交到线程池处理
+static void dispatch_request(enhanced_connection_t *conn, request_context_t *ctx) {
+    enhanced_network_private_data_t *data = conn->module;
+    uint64_t now = uv_now(data->deadline_timer.loop);
+    
+    // 截止时刻取模块的请求超时和RPC客户端的超时预算中较早的一个
+    uint64_t deadline = data->config.request_timeout_ms > 0
+        ? now + (uint64_t) data->config.request_timeout_ms : NO_DEADLINE;
+    if (ctx->deadline != 0 && ctx->deadline < deadline) {
+        deadline = ctx->deadline;
+    }
+    ctx->deadline = deadline;
+    
+    // 在等待队列中已超过客户端截止时间的请求不再提交
+    if (deadline <= now) {
+        data->timed_out_requests++;
+        send_timeout(conn, ctx);
+        free_request(ctx);
+        return;
+    }
+    
+    // 不等待线程池的队列空间，队列已满时按线程池的拒绝策略处理，被拒绝的请求立即返回过载错误。
+    // 请求不能在事件循环线程执行，caller_runs按reject处理
+    int policy = threadpool_get_rejection_policy();
+    if (policy == THREADPOOL_CALLER_RUNS) {
+        policy = THREADPOOL_REJECT;
+    }
+    if (threadpool_try_submit_with_policy(process_request_in_threadpool, ctx, policy) != 0) {
+        log_warn("线程池已满，拒绝请求");
+        data->rejected_requests++;
+        send_overloaded(conn, ctx);
+        free_request(ctx);
+        return;
+    }
+    
+    // 工作线程只访问响应字段和完成队列节点，链表字段仍归事件循环线程所有
+    inflight_insert(data, ctx);
+    conn->inflight++;
+    data->active_requests++;
+    data->total_requests++;
+    log_debug("请求已提交到线程池处理");
+    
+    // 链表按超时时刻排列，定时器只需要跟踪链表头
+    if (data->inflight_head == ctx && deadline != NO_DEADLINE) {
+        uv_timer_start(&data->deadline_timer, on_deadline_timer, deadline - now, 0);
+    }
+}
+
+// 在并发上限内按顺序提交连接等待中的请求
+static void pump_waiting(enhanced_connection_t *conn) {
+    enhanced_network_private_data_t *data = conn->module;
+    // UDP端点汇集了全部客户端的请求，只受全局上限限制
+    int window = conn->udp ? 0 : data->config.max_inflight_per_connection;
+    
+    while (conn->waiting_head && (window <= 0 || conn->inflight < window) && has_global_capacity(data)) {
+        request_context_t *ctx = conn->waiting_head;
+        request_list_remove(&conn->waiting_head, &conn->waiting_tail, ctx);
+        data->queued_requests--;
+        dispatch_request(conn, ctx);
+    }
+}
+
+// 一批帧提交后仍有请求等待时暂停读取，返回非0让解码器停止分发，剩余的帧留在解码器中
+static int throttle_connection(enhanced_connection_t *conn) {
+    enhanced_network_private_data_t *data = conn->module;
+    if (!conn->waiting_head) {
+        return 0;
+    }
+    
+    pause_reading(conn);
+    // 受全局上限限制时排队，等其他请求应答后按连接顺序提交；受连接上限限制时由本连接的应答触发
+    if (!has_global_capacity(data)) {
+        block_connection(data, conn);
+    }
+    return 1;
+}
+
+// 有名额释放后继续处理连接：提交等待的请求，分发解码器中剩余的帧，全部提交后恢复读取
+static void admit_waiting(enhanced_connection_t *conn) {
+    enhanced_network_private_data_t *data = conn->module;
+    
+    if (connection_is_closing(conn)) {
+        unblock_connection(data, conn);
+        return;
+    }
+    
+    pump_waiting(conn);
+    if (throttle_connection(conn)) {
+        return;
+    }
+    unblock_connection(data, conn);
+    
+    if (conn->decoder && frame_decoder_is_stopped(conn->decoder)) {
+        frame_batch_cb cb = conn->uring ? on_uring_frames : on_frames;
+        if (frame_decoder_resume(conn->decoder, cb, conn) < 0) {
+            log_error("消息格式错误或超过最大长度，关闭连接");
+            if (conn->uring) {
+                uring_conn_close(conn->uring);
+            } else {
+                uv_close((uv_handle_t*) &conn->stream, on_client_close);
+            }
+            return;
+        }
+        if (frame_decoder_is_stopped(conn->decoder)) {
+            return;
+        }
+    }
+    resume_reading(conn);
+}
+
+// 请求应答后释放名额：先让因全局上限等待的连接按顺序提交，再处理应答所属的连接
+static void release_slot(enhanced_network_private_data_t *data, enhanced_connection_t *conn) {
+    while (data->blocked_head && has_global_capacity(data)) {
+        enhanced_connection_t *blocked = data->blocked_head;
+        unblock_connection(data, blocked);
+        admit_waiting(blocked);
+    }
+    if (conn && (conn->waiting_head || conn->read_paused)) {
+        admit_waiting(conn);
+    }
+}
+
+// 处理响应（事件循环线程）
+void handle_response(request_context_t *ctx) {
+    if (!ctx) return;
+    
+    enhanced_network_private_data_t *data = ctx->module;
+    enhanced_connection_t *conn = conn_registry_get(data->connections, ctx->connection);
+    int timed_out = ctx->timed_out;
+    
+    if (!timed_out) {
+        request_list_remove(&data->inflight_head, &data->inflight_tail, ctx);
+        data->active_requests--;
+        if (conn) {
+            conn->inflight--;
+        }
+    }
+    
+    if (timed_out || !conn || connection_is_closing(conn)) {
+        // 已按超时应答，或连接在请求处理期间已关闭，丢弃响应
+        data->dropped_responses++;
+        log_debug("请求已超时或连接已关闭，丢弃线程池响应");
+    } else if (ctx->rejected) {
+        data->rejected_requests++;
+        send_overloaded(conn, ctx);
+    } else if (!ctx->response) {
+        log_error("线程池处理请求失败");
+    } else if (ctx->method.handler) {
+        // RPC响应已编码成帧，所有权交给写入
+        char *frame = ctx->response;
+        ctx->response = NULL;
+        if (reply_frame(conn, ctx, frame, ctx->response_length) != 0) {
+            log_error("写入响应失败");
+        }
+    } else if (reply_message(conn, ctx, ctx->response, ctx->response_length) != 0) {
+        log_error("写入响应失败");
+    }
+    free_request(ctx);
+    
+    if (!timed_out) {
+        release_slot(data, conn);
+    }
+}
+
+// 完成队列回调
+static void on_completion(loop_queue_node_t *node, void *arg) {
+    (void)arg; // 避免未使用参数警告
+    handle_response((request_context_t*) node);
+}
+
+// 请求超时检查：处理中链表按超时时刻排列
+static void on_deadline_timer(uv_timer_t *handle) {
+    enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) handle->data;
+    uint64_t now = uv_now(handle->loop);
+    
+    while (data->inflight_head && data->inflight_head->deadline <= now) {
+        request_context_t *ctx = data->inflight_head;
+        enhanced_connection_t *conn = conn_registry_get(data->connections, ctx->connection);
+        
+        // 工作线程无法中断，结果回到事件循环时丢弃；名额立即归还，连接可以继续处理后续请求
+        request_list_remove(&data->inflight_head, &data->inflight_tail, ctx);
+        __atomic_store_n(&ctx->timed_out, 1, __ATOMIC_RELAXED);
+        data->active_requests--;
+        data->timed_out_requests++;
+        log_warn("请求处理超过截止时间，返回超时错误");
+        
+        if (conn) {
+            conn->inflight--;
+        }
+        if (conn && !connection_is_closing(conn)) {
+            send_timeout(conn, ctx);
+        }
+        release_slot(data, conn);
+    }
+    
+    if (data->inflight_head && data->inflight_head->deadline != NO_DEADLINE) {
+        uv_timer_start(handle, on_deadline_timer, data->inflight_head->deadline - now, 0);
+    }
+}
+
+// 一帧的解析结果
+typedef struct {
+    int pubsub_command;                 // 发布订阅命令编号，不是命令为-1
+    int rpc_status;                     // RPC协议：parse_rpc_request的结果
+    rpc_header_t header;
+    const rpc_method_t *method;         // rpc_status为RPC_STATUS_OK时有效
+} frame_info_t;
+
+// 解析RPC请求头并查找方法，返回RPC_STATUS_OK、RPC_STATUS_BAD_REQUEST或RPC_STATUS_UNKNOWN_METHOD
+static int parse_rpc_request(const frame_t *frame, rpc_header_t *header, const rpc_method_t **method) {
+    memset(header, 0, sizeof(rpc_header_t));
+    *method = NULL;
+    if (rpc_header_decode(frame->data, frame->length, header) != 0 || header->type != RPC_TYPE_REQUEST) {
+        return RPC_STATUS_BAD_REQUEST;
+    }
+    *method = rpc_find_method(header->method);
+    return *method ? RPC_STATUS_OK : RPC_STATUS_UNKNOWN_METHOD;
+}
+
+// 原始消息是否为发布订阅命令，返回命令编号，不是命令返回-1
+static int parse_pubsub_command(const enhanced_network_private_data_t *data, const frame_t *frame) {
+    if (!data->pubsub_commands || data->config.protocol != ENHANCED_PROTOCOL_RAW) {
+        return -1;
+    }
+    for (size_t i = 0; i < sizeof(pubsub_command_names) / sizeof(pubsub_command_names[0]); i++) {
+        size_t name_length = strlen(pubsub_command_names[i]);
+        if (frame->length > name_length && memcmp(frame->data, pubsub_command_names[i], name_length) == 0) {
+            return (int) i;
+        }
+    }
+    return -1;
+}
+
+// 解析一帧并决定在哪里处理，返回是否在事件循环线程直接处理：同步模式下的全部帧，发布订阅命令，
+// RESP命令，RPC协议下的内联方法和无法执行的请求。解析结果交给submit_frame或process_frame_sync，不再重复解析
+static int classify_frame(enhanced_network_private_data_t *data, const frame_t *frame, frame_info_t *info) {
+    info->pubsub_command = -1;
+    info->rpc_status = RPC_STATUS_OK;
+    info->method = NULL;
+    if (data->config.protocol == ENHANCED_PROTOCOL_RPC) {
+        info->rpc_status = parse_rpc_request(frame, &info->header, &info->method);
+    } else if (data->config.protocol != ENHANCED_PROTOCOL_RESP) {
+        info->pubsub_command = parse_pubsub_command(data, frame);
+    }
+    
+    if (!data->config.enable_threadpool || data->config.protocol == ENHANCED_PROTOCOL_RESP) {
+        return 1;
+    }
+    if (data->config.protocol != ENHANCED_PROTOCOL_RPC) {
+        return info->pubsub_command >= 0;
+    }
+    return info->rpc_status != RPC_STATUS_OK || info->method->mode == RPC_EXEC_INLINE;
+}
+
+// 收到一帧，加入连接的等待队列后在并发上限内提交到线程池，peer为UDP请求的来源地址（TCP为NULL）
+static void submit_frame(enhanced_connection_t *conn, const frame_t *frame, const frame_info_t *info,
+                         const udp_peer_t *peer) {
+    enhanced_network_private_data_t *data = conn->module;
+    
+    // 创建请求上下文（帧数据只在回调期间有效，需要复制）
+    request_context_t *ctx = calloc(1, sizeof(request_context_t));
+    if (!ctx) {
+        return;
+    }
+    ctx->module = data;
+    ctx->connection = conn_registry_handle(conn);
+    if (peer) {
+        ctx->peer = *peer;
+    }
+    
+    // RPC请求只复制请求体，客户端的超时预算从收到请求时开始计算
+    const char *body = frame->data;
+    size_t body_length = frame->length;
+    if (data->config.protocol == ENHANCED_PROTOCOL_RPC) {
+        ctx->method = *info->method;
+        ctx->request_id = info->header.request_id;
+        if (info->header.value > 0) {
+            ctx->deadline = uv_now(data->deadline_timer.loop) + info->header.value;
+        }
+        body += RPC_HEADER_SIZE;
+        body_length -= RPC_HEADER_SIZE;
+    }
+    
+    ctx->request_data = malloc(body_length + 1);
+    if (!ctx->request_data) {
+        free(ctx);
+        return;
+    }
+    memcpy(ctx->request_data, body, body_length);
+    ctx->request_data[body_length] = '\0';
+    ctx->request_size = body_length;
+    
+    // 经过等待队列保证同一连接的请求按到达顺序提交
+    request_list_append(&conn->waiting_head, &conn->waiting_tail, ctx);
+    data->queued_requests++;
+    pump_waiting(conn);
+}
+
+// 在事件循环线程执行RPC请求，返回编码后的响应帧
+static char* process_rpc_sync(enhanced_network_private_data_t *data, const frame_t *frame, const frame_info_t *info,
+                              size_t *length) {
+    const rpc_header_t *header = &info->header;
+    data->total_requests++;
+    if (info->rpc_status != RPC_STATUS_OK) {
+        return rpc_error_response(header->method, header->request_id, info->rpc_status, length);
+    }
+    
+    rpc_call_t call = {
+        .method = header->method,
+        .request_id = header->request_id,
+        .body = frame->data + RPC_HEADER_SIZE,
+        .body_length = frame->length - RPC_HEADER_SIZE,
+        .deadline = header->value > 0 ? uv_now(data->deadline_timer.loop) + header->value : 0
+    };
+    return rpc_invoke(info->method, &call, length);
+}
+
+// 执行发布订阅命令，返回编码后的响应帧："OK"、"PUBLISHED <立即写入的订阅者数>"或"ERR <原因>"
+static char* process_pubsub_command(enhanced_connection_t *conn, int command, const frame_t *frame, size_t *length) {
+    enhanced_network_private_data_t *data = conn->module;
+    const char *args = frame->data + strlen(pubsub_command_names[command]);
+    size_t args_length = frame->length - (size_t) (args - frame->data);
+    
+    // 主题到第一个空格为止，PUBLISH命令其后为消息内容
+    const char *space = command == PUBSUB_COMMAND_PUBLISH ? memchr(args, ' ', args_length) : NULL;
+    size_t topic_length = space ? (size_t) (space - args) : args_length;
+    
+    char topic[MAX_TOPIC_LENGTH + 1];
+    char response[64];
+    if (topic_length == 0 || topic_length > MAX_TOPIC_LENGTH || memchr(args, '\0', topic_length)) {
+        snprintf(response, sizeof(response), "ERR 主题无效");
+    } else if (command == PUBSUB_COMMAND_PUBLISH && !space) {
+        snprintf(response, sizeof(response), "ERR 缺少消息内容");
+    } else {
+        memcpy(topic, args, topic_length);
+        topic[topic_length] = '\0';
+        int result;
+        switch (command) {
+            case PUBSUB_COMMAND_SUBSCRIBE:
+                result = subscribe_connection(conn, topic);
+                snprintf(response, sizeof(response), "%s",
+                         result == 0 ? "OK" : conn->udp ? "ERR UDP不支持订阅" : "ERR 订阅失败");
+                break;
+            case PUBSUB_COMMAND_UNSUBSCRIBE:
+                result = unsubscribe_connection(conn, topic);
+                snprintf(response, sizeof(response), "%s", result == 0 ? "OK" : "ERR 未订阅");
+                break;
+            default:
+                result = publish_message(data, topic, space + 1, args_length - topic_length - 1);
+                if (result < 0) {
+                    snprintf(response, sizeof(response), "ERR 发布失败");
+                } else {
+                    snprintf(response, sizeof(response), "PUBLISHED %d", result);
+                }
+                break;
+        }
+    }
+    return frame_encode(&data->codec, response, strlen(response), length);
+}
+
+// 同步处理一帧，返回编码后的响应帧
+static char* process_frame_sync(enhanced_connection_t *conn, const frame_t *frame, const frame_info_t *info,
+                                size_t *length) {
+    enhanced_network_private_data_t *data = conn->module;
+    if (data->config.protocol == ENHANCED_PROTOCOL_RPC) {
+        return process_rpc_sync(data, frame, info, length);
+    }
+    if (data->config.protocol == ENHANCED_PROTOCOL_RESP) {
+        data->total_requests++;
+        return resp_execute(data->kv_store, frame->data, frame->length, uv_now(data->expire_timer.loop), length);
+    }
+    if (info->pubsub_command >= 0) {
+        return process_pubsub_command(conn, info->pubsub_command, frame, length);
+    }
+    
+    char response[256];
+    int response_length = snprintf(response, sizeof(response), "同步处理完成，消息: %.*s",
+                                   (int) frame->length, frame->data);
+    if (response_length < 0) {
+        return NULL;
+    }
+    if ((size_t) response_length >= sizeof(response)) {
+        response_length = (int) sizeof(response) - 1;
+    }
+    data->total_requests++;
+    return frame_encode(&data->codec, response, (size_t) response_length, length);
+}
+
+// libuv后端：一批完整帧
+static int on_frames(const frame_t *frames, size_t count, void *arg) {
+    enhanced_connection_t *conn = (enhanced_connection_t*) arg;
+    enhanced_network_private_data_t *data = conn->module;
+    
+    log_debug("收到 %zu 个消息", count);
+    
+    // 线程池处理的帧各作为一个工作提交，其余帧同步处理，响应缓存到本轮结束时与其他响应一起写出
+    for (size_t i = 0; i < count; i++) {
+        frame_info_t info;
+        if (!classify_frame(data, &frames[i], &info)) {
+            submit_frame(conn, &frames[i], &info, NULL);
+            continue;
+        }
+        size_t length;
+        char *response = process_frame_sync(conn, &frames[i], &info, &length);
+        if (!response || connection_write(conn, response, length) != 0) {
+            log_error("写入响应失败");
+        }
+    }
+    return uv_is_closing((uv_handle_t*) &conn->stream) || (data->config.enable_threadpool && throttle_connection(conn));
+}
+
+// 读取回调：数据直接读入连接的分帧缓冲区
+static void on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+    enhanced_connection_t *conn = (enhanced_connection_t*) stream->data;
+    (void)buf; // 避免未使用参数警告，数据位于解码器缓冲区中
+    
+    if (nread > 0) {
+        if (frame_decoder_commit(conn->decoder, (size_t) nread, on_frames, conn) < 0) {
+            log_error("消息格式错误或超过最大长度，关闭连接");
+            uv_close((uv_handle_t*) stream, on_client_close);
+        }
+    } else if (nread < 0) {
+        if (nread != UV_EOF) {
+            log_error("读取错误: %s", uv_err_name(nread));
+        }
+        uv_close((uv_handle_t*) stream, on_client_close);
+    }
+}
+
+// 分配缓冲区回调：返回分帧缓冲区的空闲区域
+static void alloc_buffer(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
+    (void)suggested_size; // 抑制未使用参数警告
+    enhanced_connection_t *conn = (enhanced_connection_t*) handle->data;
+    size_t length;
+    frame_decoder_get_write_buffer(conn->decoder, &buf->base, &length);
+    buf->len = length;
+}
+
+// 在注册表中创建连接及其解码器
+static enhanced_connection_t* create_connection(enhanced_network_private_data_t *data) {
+    enhanced_connection_t *conn = conn_registry_alloc(data->connections, NULL);
+    if (!conn) {
+        return NULL;
+    }
+    conn->module = data;
+    conn->decoder = frame_decoder_create(&data->codec, data->frame_buffer_size);
+    if (!conn->decoder) {
+        conn_registry_free(data->connections, conn);
+        return NULL;
+    }
+    return conn;
+}
+
+// 新连接回调
+static void on_new_connection(uv_stream_t *server, int status) {
+    if (status < 0) {
+        log_error("新连接错误: %s", uv_strerror(status));
+        return;
     }
     
-    data->clients = new_clients;
-    data->client_capacity = new_capacity;
-    return 0;
+    enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) server->data;
+    
+    // 创建新的客户端连接
+    enhanced_connection_t *conn = create_connection(data);
+    if (!conn) {
+        log_error("内存分配失败");
+        return;
+    }
+    
+    if (server == (uv_stream_t*) &data->unix_server) {
+        uv_pipe_init(server->loop, &conn->stream.pipe, 0);
+        conn->stream.pipe.data = conn;
+    } else {
+        uv_tcp_init(server->loop, &conn->stream.tcp);
+        conn->stream.tcp.data = conn;
+    }
+    
+    uv_stream_t *client = (uv_stream_t*) &conn->stream;
+    if (uv_accept(server, client) == 0) {
+        uv_read_start(client, alloc_buffer, on_read);
+        log_info("新客户端连接，当前连接数: %zu", conn_registry_count(data->connections));
+    } else {
+        uv_close((uv_handle_t*) client, on_client_close);
+    }
 }
 
-// 添加客户端连接
-static int add_client(enhanced_network_private_data_t *data, uv_tcp_t *client) {
-    if (data->client_count >= data->client_capacity) {
-        if (expand_client_capacity(data) != 0) {
-            return -1;
-        }
+// io_uring后端：新连接
+static void on_uring_connection(uring_listener_t *listener, uring_conn_t *uring) {
+    enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) uring_listener_get_data(listener);
+    enhanced_connection_t *conn = create_connection(data);
+    if (!conn) {
+        log_error("内存分配失败");
+        uring_conn_close(uring);
+        return;
     }
+    conn->uring = uring;
+    uring_conn_set_data(uring, conn);
+    log_info("新客户端连接，当前连接数: %zu", conn_registry_count(data->connections));
+}
+
+// io_uring后端：一批完整帧
+static int on_uring_frames(const frame_t *frames, size_t count, void *arg) {
+    enhanced_connection_t *conn = (enhanced_connection_t*) arg;
     
-    data->clients[data->client_count] = client;
-    data->client_count++;
+    log_debug("收到 %zu 个消息", count);
     
-            log_info("新客户端连接，当前连接数: %zu", data->client_count);
-    return 0;
+    enhanced_network_private_data_t *data = conn->module;
+    
+    // 线程池处理的帧各作为一个工作提交，其余帧同步处理并写回响应
+    for (size_t i = 0; i < count; i++) {
+        frame_info_t info;
+        if (!classify_frame(data, &frames[i], &info)) {
+            submit_frame(conn, &frames[i], &info, NULL);
+            continue;
+        }
+        size_t length;
+        char *response = process_frame_sync(conn, &frames[i], &info, &length);
+        if (!response || uring_conn_write(conn->uring, response, length, NULL, NULL) != 0) {
+            log_error("写入响应失败");
+        }
+    }
+    return uring_conn_is_closing(conn->uring) || (data->config.enable_threadpool && throttle_connection(conn));
 }
 
-// 移除客户端连接
-static int remove_client(enhanced_network_private_data_t *data, uv_tcp_t *client) {
-    for (size_t i = 0; i < data->client_count; i++) {
-        if (data->clients[i] == client) {
-            // 移动后面的客户端
-            for (size_t j = i; j < data->client_count - 1; j++) {
-                data->clients[j] = data->clients[j + 1];
-            }
-            data->client_count--;
-            log_info("客户端断开连接，当前连接数: %zu", data->client_count);
-            return 0;
-        }
+// io_uring后端：收到数据（位于后端的接收缓冲区，复制到解码器后分帧）
+static void on_uring_data(uring_conn_t *uring, const char *message, size_t length) {
+    enhanced_connection_t *conn = (enhanced_connection_t*) uring_conn_get_data(uring);
+    if (!conn || uring_conn_is_closing(uring)) {
+        return;
+    }
+    if (frame_decoder_feed(conn->decoder, message, length, on_uring_frames, conn) < 0) {
+        log_error("消息格式错误或超过最大长度，关闭连接");
+        uring_conn_close(uring);
     }
-    return -1;
 }
 
-// 客户端关闭回调
-static void on_client_close(uv_handle_t *handle) {
-    enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) handle->data;
-    remove_client(data, (uv_tcp_t*) handle);
-    free(handle);
+// io_uring后端：连接关闭
+static void on_uring_close(uring_conn_t *uring) {
+    enhanced_connection_t *conn = (enhanced_connection_t*) uring_conn_get_data(uring);
+    if (conn) {
+        release_connection(conn);
+    }
 }
 
-// 写入完成回调
-static void on_write_complete(uv_write_t *req, int status) {
-    if (status) {
-        log_error("写入错误: %s", uv_strerror(status));
+// 按配置启动io_uring监听器，成功返回0，调用者在失败时回退到libuv
+static int start_uring_listener(enhanced_network_private_data_t *data, const struct sockaddr *addr) {
+    const char *backend = config_get_string("io_backend", "libuv");
+    if (strcmp(backend, "io_uring") != 0) {
+        return -1;
+    }
+    
+    if (!uring_backend_available()) {
+        log_warn("内核不支持io_uring后端所需特性，增强网络模块回退到libuv");
+        return -1;
     }
     
-    // 释放写入请求
-    free(req);
+    static const uring_callbacks_t callbacks = {
+        .on_connection = on_uring_connection,
+        .on_data = on_uring_data,
+        .on_close = on_uring_close
+    };
+    data->uring_listener = uring_listener_start(data->server.loop, addr, data->config.backlog, &callbacks, data);
+    if (!data->uring_listener) {
+        log_warn("增强网络模块io_uring后端启动失败，回退到libuv");
+        return -1;
+    }
+    return 0;
 }
 
-// 在线程池中处理请求
-void process_request_in_threadpool(void *ctx) {
-    if (!ctx) return;
+// UDP模式：一批数据报，每个数据报是一条消息
+static void on_udp_datagrams(udp_endpoint_t *endpoint, const udp_datagram_t *datagrams, size_t count, void *arg) {
+    enhanced_connection_t *conn = (enhanced_connection_t*) arg;
+    enhanced_network_private_data_t *data = conn->module;
+    (void)endpoint; // 避免未使用参数警告
     
-    // 类型转换
-    request_context_t *request_ctx = (request_context_t*) ctx;
+    log_debug("收到 %zu 个数据报", count);
     
-    // 模拟处理时间（在实际应用中这里会进行真正的业务逻辑处理）
-    int processing_time = rand() % 100 + 10; // 10-110ms
-#ifdef _WIN32
-    Sleep(processing_time); // Windows下使用毫秒
-#else
-    usleep(processing_time * 1000); // Unix下使用微秒
-#endif
+    // 线程池处理的消息各作为一个工作提交，其余同步处理，本批响应由端点用sendmmsg一起发出
+    for (size_t i = 0; i < count; i++) {
+        frame_t frame = { datagrams[i].data, datagrams[i].length };
+        frame_info_t info;
+        if (!classify_frame(data, &frame, &info)) {
+            submit_frame(conn, &frame, &info, datagrams[i].peer);
+            continue;
+        }
+        size_t length;
+        char *response = process_frame_sync(conn, &frame, &info, &length);
+        if (!response || udp_reply(conn, datagrams[i].peer, response, length) != 0) {
+            data->dropped_responses++;
+        }
+    }
     
-    // 构造响应消息
-    char response[512];
-    snprintf(response, sizeof(response), 
-             "线程池处理完成，请求大小: %zu 字节，处理时间: %d ms", 
-             request_ctx->request_size, processing_time);
+    // 受全局上限限制时暂停接收，本批中未提交的消息留在等待队列
+    if (data->config.enable_threadpool) {
+        throttle_connection(conn);
+    }
+}
+
+// UDP端点关闭
+static void on_udp_close(udp_endpoint_t *endpoint, void *arg) {
+    enhanced_connection_t *conn = (enhanced_connection_t*) arg;
+    (void)endpoint; // 避免未使用参数警告
+    conn->module->udp_endpoint = NULL;
+    release_connection(conn);
+}
+
+// 启动UDP端点，端点在连接注册表中占一个连接，线程池中的请求完成时按句柄找回
+static int start_udp_endpoint(enhanced_network_private_data_t *data, const struct sockaddr *addr) {
+    enhanced_connection_t *conn = conn_registry_alloc(data->connections, NULL);
+    if (!conn) {
+        return -1;
+    }
+    conn->module = data;
+    conn->udp = udp_endpoint_start(data->server.loop, addr, &data->udp_config, on_udp_datagrams, conn);
+    if (!conn->udp) {
+        conn_registry_free(data->connections, conn);
+        return -1;
+    }
+    data->udp_endpoint = conn->udp;
+    return 0;
+}
+
+// 从配置文件读取传输层设置
+static int load_transport_config(enhanced_network_private_data_t *data) {
+    const char *transport = config_get_string("enhanced_network_transport", "tcp");
+    if (strcmp(transport, "udp") == 0) {
+        data->config.transport = ENHANCED_TRANSPORT_UDP;
+    } else if (strcmp(transport, "tcp") == 0) {
+        data->config.transport = ENHANCED_TRANSPORT_TCP;
+        return 0;
+    } else {
+        log_error("未知的传输层: %s（可选 tcp、udp）", transport);
+        return -1;
+    }
+    if (data->config.protocol == ENHANCED_PROTOCOL_RESP) {
+        log_error("RESP协议只支持TCP传输");
+        return -1;
+    }
     
-    // 调用响应回调
-    if (request_ctx->response_callback) {
-        request_ctx->response_callback(request_ctx->client, response);
+    data->udp_config.batch_size = (size_t) config_get_int("enhanced_network_udp_batch_size", DEFAULT_UDP_BATCH_SIZE);
+    data->udp_config.max_datagram_size = (size_t) config_get_int("enhanced_network_udp_max_datagram_size",
+                                                                 DEFAULT_UDP_MAX_DATAGRAM_SIZE);
+    data->udp_config.max_queued = (size_t) config_get_int("enhanced_network_udp_send_queue", DEFAULT_UDP_SEND_QUEUE);
+    data->udp_config.socket_buffer_size = config_get_int("enhanced_network_udp_socket_buffer", DEFAULT_UDP_SOCKET_BUFFER);
+    data->udp_config.offload = config_get_bool("enhanced_network_udp_offload", 1);
+    if (data->udp_config.batch_size == 0 || data->udp_config.batch_size > 1024 ||
+        data->udp_config.max_datagram_size == 0 || data->udp_config.max_datagram_size > 65507 ||
+        data->udp_config.max_queued == 0) {
+        log_error("UDP配置无效：批量大小1-1024，数据报大小1-65507，发送队列大于0");
+        return -1;
     }
     
-    // 释放请求上下文
-    free(request_ctx->request_data);
-    free(request_ctx);
+    // 数据报本身就是消息边界，原始消息的响应也按4字节长度前缀编码，发送时去掉长度头
+    if (data->config.protocol == ENHANCED_PROTOCOL_RAW) {
+        if (data->codec_overridden) {
+            log_warn("UDP模式不使用分帧格式，忽略自定义分帧格式");
+        }
+        data->codec.type = FRAME_CODEC_LENGTH_PREFIXED;
+        data->codec.length_field_size = UDP_FRAME_HEADER_SIZE;
+        data->codec.decode = NULL;
+        data->codec.encode = NULL;
+    }
+    return 0;
 }
 
-// 处理响应
-void handle_response(uv_tcp_t *client, const char *response) {
-    if (!client || !response) return;
-    
-    // 创建写入请求
-    uv_write_t *write_req = malloc(sizeof(uv_write_t));
-    if (!write_req) return;
+// 按配置监听Unix域套接字，本地连接使用libuv读写（与TCP的I/O后端无关）
+static int start_unix_listener(enhanced_network_private_data_t *data, int unix_only) {
+    const char *path = config_get_string("enhanced_network_unix_socket_path", "");
+    if (path[0] == '\0') {
+        if (unix_only) {
+            log_error("配置了只监听Unix域套接字，但没有设置enhanced_network_unix_socket_path");
+            return -1;
+        }
+        return 0;
+    }
+    if (data->config.transport == ENHANCED_TRANSPORT_UDP) {
+        log_error("Unix域套接字只支持TCP传输");
+        return -1;
+    }
     
-    // 创建响应缓冲区
-    char *response_copy = strdup(response);
-    if (!response_copy) {
-        free(write_req);
-        return;
+    data->unix_socket_path = strdup(path);
+    if (!data->unix_socket_path) {
+        log_error("内存分配失败");
+        return -1;
+    }
+    int result = unix_socket_listen(data->server.loop, &data->unix_server, path, data->config.backlog,
+                                    on_new_connection, data);
+    if (result != 0) {
+        log_error("监听Unix域套接字 %s 失败: %s", path, uv_strerror(result));
+        return -1;
     }
+    log_info("增强网络模块监听Unix域套接字 %s", path);
+    return 0;
+}
+
+// 从配置文件读取发布订阅设置并创建主题表
+static int load_pubsub_config(enhanced_network_private_data_t *data) {
+    static const pubsub_ops_t ops = {
+        .write = pubsub_connection_write,
+        .disconnect = pubsub_connection_disconnect
+    };
     
-    uv_buf_t response_buf = uv_buf_init(response_copy, strlen(response_copy));
+    const char *name = config_get_string("enhanced_network_pubsub_policy", "coalesce");
+    pubsub_policy_t policy;
+    if (pubsub_parse_policy(name, &policy) != 0) {
+        log_error("未知的慢订阅者策略: %s（可选 drop、coalesce、disconnect）", name);
+        return -1;
+    }
+    int max_pending = config_get_int("enhanced_network_pubsub_max_pending", DEFAULT_PUBSUB_MAX_PENDING);
+    if (max_pending <= 0) {
+        log_error("enhanced_network_pubsub_max_pending必须大于0");
+        return -1;
+    }
+    data->pubsub_commands = config_get_bool("enhanced_network_pubsub_commands", 0);
     
-    // 异步写入响应
-    uv_write(write_req, (uv_stream_t*) client, &response_buf, 1, on_write_complete);
+    if (!data->pubsub) {
+        data->pubsub = pubsub_create(&ops, policy, max_pending);
+    }
+    return data->pubsub ? 0 : -1;
 }
 
-// 读取回调
-static void on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
-    if (nread > 0) {
-        enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) stream->data;
-        
-        // 显示接收到的消息
-        log_info("收到消息: %.*s", (int)nread, buf->base);
-        
-        // 如果启用了线程池，在线程池中处理请求
-        if (data->config.enable_threadpool) {
-            // 创建请求上下文
-            request_context_t *ctx = malloc(sizeof(request_context_t));
-            if (ctx) {
-                ctx->client = (uv_tcp_t*) stream;
-                ctx->request_data = malloc(nread + 1);
-                if (ctx->request_data) {
-                    memcpy(ctx->request_data, buf->base, nread);
-                    ctx->request_data[nread] = '\0';
-                    ctx->request_size = nread;
-                    ctx->response_callback = handle_response;
-                    
-                    // 提交到线程池处理
-                    if (threadpool_submit_work(process_request_in_threadpool, ctx) == 0) {
-                        data->total_requests++;
-                        data->active_requests++;
-                        log_info("请求已提交到线程池处理");
-                    } else {
-                        log_error("提交请求到线程池失败");
-                        free(ctx->request_data);
-                        free(ctx);
-                    }
-                } else {
-                    free(ctx);
-                }
-            }
-        } else {
-            // 直接处理请求（同步方式）
-            char response[256];
-            snprintf(response, sizeof(response), "同步处理完成，消息: %.*s", (int)nread, buf->base);
-            handle_response((uv_tcp_t*) stream, response);
-        }
-        
-        free(buf->base);
-    } else if (nread < 0) {
-        if (nread != UV_EOF) {
-            log_error("读取错误: %s", uv_err_name(nread));
-        }
-        uv_close((uv_handle_t*) stream, on_client_close);
-    } else {
-        free(buf->base);
+// 时间轮刻度定时器：删除到期的键
+static void on_expire_timer(uv_timer_t *handle) {
+    enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) handle->data;
+    size_t removed = kv_store_advance(data->kv_store, uv_now(handle->loop));
+    if (removed > 0) {
+        log_debug("删除 %zu 个过期的键", removed);
     }
 }
 
-// 分配缓冲区回调
-static void alloc_buffer(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
-    (void)handle; // 抑制未使用参数警告
-    buf->base = malloc(suggested_size);
-    buf->len = suggested_size;
+// RESP协议：按配置创建键值存储并启动过期定时器
+static int start_kv_store(enhanced_network_private_data_t *data) {
+    int shards = config_get_int("enhanced_network_kv_shards", DEFAULT_KV_SHARDS);
+    int tick_ms = config_get_int("enhanced_network_kv_expire_tick_ms", DEFAULT_KV_EXPIRE_TICK_MS);
+    if (shards <= 0 || shards > 1024 || tick_ms <= 0) {
+        log_error("键值存储配置无效：分片数1-1024，过期检查刻度大于0");
+        return -1;
+    }
+    
+    if (!data->kv_store) {
+        data->kv_store = kv_store_create((size_t) shards, (uint64_t) tick_ms, uv_now(data->expire_timer.loop));
+        if (!data->kv_store) {
+            log_error("创建键值存储失败");
+            return -1;
+        }
+    }
+    uv_timer_start(&data->expire_timer, on_expire_timer, (uint64_t) tick_ms, (uint64_t) tick_ms);
+    return 0;
 }
 
-// 新连接回调
-static void on_new_connection(uv_stream_t *server, int status) {
-    if (status < 0) {
-        log_error("新连接错误: %s", uv_strerror(status));
-        return;
+// 从配置文件读取协议和分帧格式（已通过接口设置自定义格式时只读取缓冲区大小）
+static int load_codec_config(enhanced_network_private_data_t *data) {
+    data->frame_buffer_size = (size_t) config_get_int("enhanced_network_frame_buffer_size", DEFAULT_FRAME_BUFFER_SIZE);
+    
+    const char *protocol = config_get_string("enhanced_network_protocol", "raw");
+    if (strcmp(protocol, "rpc") == 0) {
+        data->config.protocol = ENHANCED_PROTOCOL_RPC;
+    } else if (strcmp(protocol, "resp") == 0) {
+        data->config.protocol = ENHANCED_PROTOCOL_RESP;
+    } else if (strcmp(protocol, "raw") == 0) {
+        data->config.protocol = ENHANCED_PROTOCOL_RAW;
+    } else {
+        log_error("未知的消息协议: %s（可选 raw、rpc、resp）", protocol);
+        return -1;
     }
     
-    enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) server->data;
+    // RESP协议按命令分帧，回复由命令执行时编码
+    if (data->config.protocol == ENHANCED_PROTOCOL_RESP) {
+        if (data->codec_overridden) {
+            log_warn("RESP协议使用固定的分帧格式，忽略自定义分帧格式");
+        }
+        data->codec.type = FRAME_CODEC_CUSTOM;
+        data->codec.max_frame_size = (size_t) config_get_int("enhanced_network_max_frame_size", DEFAULT_MAX_FRAME_SIZE);
+        data->codec.decode = resp_decode_command;
+        data->codec.encode = NULL;
+        data->codec.user_data = &data->codec.max_frame_size;
+        return 0;
+    }
     
-    // 创建新的客户端连接
-    uv_tcp_t *client = malloc(sizeof(uv_tcp_t));
-    if (!client) {
-        log_error("内存分配失败");
-        return;
+    // RPC协议固定使用4字节长度前缀
+    if (data->config.protocol == ENHANCED_PROTOCOL_RPC) {
+        if (data->codec_overridden) {
+            log_warn("RPC协议使用固定的长度前缀分帧，忽略自定义分帧格式");
+        }
+        data->codec.type = FRAME_CODEC_LENGTH_PREFIXED;
+        data->codec.length_field_size = RPC_LENGTH_FIELD_SIZE;
+        data->codec.max_frame_size = (size_t) config_get_int("enhanced_network_max_frame_size", DEFAULT_MAX_FRAME_SIZE);
+        data->codec.decode = NULL;
+        data->codec.encode = NULL;
+        return 0;
     }
     
-    uv_tcp_init(server->loop, client);
-    client->data = data;
+    if (data->codec_overridden) {
+        return 0;
+    }
     
-    if (uv_accept(server, (uv_stream_t*) client) == 0) {
-        if (add_client(data, client) == 0) {
-            uv_read_start((uv_stream_t*) client, alloc_buffer, on_read);
-            log_info("新客户端连接");
-        } else {
-            uv_close((uv_handle_t*) client, on_client_close);
-        }
-    } else {
-        uv_close((uv_handle_t*) client, on_client_close);
+    const char *codec_name = config_get_string("enhanced_network_codec", "line");
+    if (frame_codec_parse_type(codec_name, &data->codec.type) != 0) {
+        log_error("未知的分帧格式: %s（可选 line、length）", codec_name);
+        return -1;
     }
+    data->codec.length_field_size = config_get_int("enhanced_network_length_field_size", 4);
+    data->codec.max_frame_size = (size_t) config_get_int("enhanced_network_max_frame_size", DEFAULT_MAX_FRAME_SIZE);
+    if (data->codec.type == FRAME_CODEC_LENGTH_PREFIXED &&
+        data->codec.length_field_size != 2 && data->codec.length_field_size != 4) {
+        log_error("长度头字节数只能是2或4: %d", data->codec.length_field_size);
+        return -1;
+    }
+    return 0;
 }
 
 // 统计定时器回调
@@ -244,11 +1453,42 @@ static void on_stats_timer(uv_timer_t *handle) {
     enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) handle->data;
     
     log_info("\n=== 网络模块统计 ===");
-    log_info("当前连接数: %zu", data->client_count);
+    log_info("当前连接数: %zu", conn_registry_count(data->connections));
     log_info("总请求数: %d", data->total_requests);
     log_info("活跃请求数: %d", data->active_requests);
     
+    if (data->udp_endpoint) {
+        udp_endpoint_stats_t udp_stats;
+        udp_endpoint_get_stats(data->udp_endpoint, &udp_stats);
+        log_info("UDP接收: %llu 个数据报，recvmmsg %llu 次，GRO合并 %llu 次",
+                 (unsigned long long) udp_stats.datagrams_received, (unsigned long long) udp_stats.receive_calls,
+                 (unsigned long long) udp_stats.gro_messages);
+        log_info("UDP发送: %llu 个数据报，sendmmsg %llu 次，GSO合并 %llu 次，丢弃: %llu",
+                 (unsigned long long) udp_stats.datagrams_sent, (unsigned long long) udp_stats.send_calls,
+                 (unsigned long long) udp_stats.gso_messages, (unsigned long long) udp_stats.dropped);
+    }
+    
+    if (data->kv_store) {
+        kv_store_stats_t kv_stats;
+        kv_store_get_stats(data->kv_store, &kv_stats);
+        log_info("键值存储: %zu 个键，%zu 个带过期时间，已过期删除 %llu 个",
+                 kv_stats.keys, kv_stats.expiring_keys, (unsigned long long) kv_stats.expired);
+    }
+    
+    pubsub_stats_t pubsub_stats;
+    pubsub_get_stats(data->pubsub, &pubsub_stats);
+    if (data->pubsub && (pubsub_stats.subscriptions > 0 || pubsub_stats.published > 0)) {
+        log_info("发布订阅: %zu 个主题，%zu 个订阅，发布 %llu 次，写入 %llu，丢弃 %llu，合并 %llu，断开 %llu",
+                 pubsub_stats.topics, pubsub_stats.subscriptions, (unsigned long long) pubsub_stats.published,
+                 (unsigned long long) pubsub_stats.delivered, (unsigned long long) pubsub_stats.dropped,
+                 (unsigned long long) pubsub_stats.coalesced, (unsigned long long) pubsub_stats.disconnected);
+    }
+    
     if (data->config.enable_threadpool) {
+        log_info("等待提交的请求数: %d", data->queued_requests);
+        log_info("超时请求数: %d", data->timed_out_requests);
+        log_info("拒绝请求数: %d", data->rejected_requests);
+        log_info("丢弃的响应数: %d", data->dropped_responses);
         log_info("线程池状态:");
         log_info("  活跃线程数: %d", threadpool_get_active_thread_count());
         log_info("  队列中工作数: %d", threadpool_get_queued_work_count());
@@ -271,18 +1511,28 @@ int enhanced_network_module_init(module_interface_t *self, uv_loop_t *loop) {
     // 初始化私有数据
     memset(data, 0, sizeof(enhanced_network_private_data_t));
     data->config = default_config;
+    data->codec.type = FRAME_CODEC_LINE;
+    data->codec.length_field_size = 4;
+    data->codec.max_frame_size = DEFAULT_MAX_FRAME_SIZE;
+    data->frame_buffer_size = DEFAULT_FRAME_BUFFER_SIZE;
     
-    data->clients = malloc(sizeof(uv_tcp_t*) * INITIAL_CLIENT_CAPACITY);
-    if (!data->clients) {
+    data->connections = conn_registry_create(sizeof(enhanced_connection_t), 0);
+    if (!data->connections) {
         free(data);
         return -1;
     }
     
-    data->client_capacity = INITIAL_CLIENT_CAPACITY;
-    data->client_count = 0;
     data->total_requests = 0;
     data->active_requests = 0;
     
+    // 线程池处理结果的完成队列
+    data->completions = loop_queue_create(loop, on_completion, data);
+    if (!data->completions) {
+        conn_registry_destroy(data->connections);
+        free(data);
+        return -1;
+    }
+    
     // 初始化TCP服务器
     uv_tcp_init(loop, &data->server);
     data->server.data = data;
@@ -291,6 +1541,18 @@ int enhanced_network_module_init(module_interface_t *self, uv_loop_t *loop) {
     uv_timer_init(loop, &data->stats_timer);
     data->stats_timer.data = data;
     
+    // 初始化请求超时定时器
+    uv_timer_init(loop, &data->deadline_timer);
+    data->deadline_timer.data = data;
+    
+    // 初始化键值过期定时器（RESP协议启动时启动）
+    uv_timer_init(loop, &data->expire_timer);
+    data->expire_timer.data = data;
+    
+    // 初始化响应写出句柄（有缓存的响应时才启动）
+    uv_check_init(loop, &data->flush_check);
+    data->flush_check.data = data;
+    
     self->private_data = data;
     
     log_info("增强网络模块初始化成功");
@@ -309,32 +1571,103 @@ int enhanced_network_module_start(module_interface_t *self) {
     int config_port = config_get_int("enhanced_network_port", data->config.port);
     data->config.port = config_port;
     log_info("增强网络模块配置端口: %d (默认: %d)", config_port, data->config.port);
+    data->config.enable_threadpool = config_get_bool("enhanced_network_enable_threadpool",
+                                                     data->config.enable_threadpool);
+    data->config.max_concurrent_requests = config_get_int("enhanced_network_max_concurrent_requests",
+                                                          data->config.max_concurrent_requests);
+    data->config.max_inflight_per_connection = config_get_int("enhanced_network_max_inflight_per_connection",
+                                                              data->config.max_inflight_per_connection);
+    data->config.request_timeout_ms = config_get_int("enhanced_network_request_timeout_ms",
+                                                     data->config.request_timeout_ms);
+    if (load_codec_config(data) != 0 || load_transport_config(data) != 0 || load_pubsub_config(data) != 0) {
+        return -1;
+    }
+    if (data->config.protocol == ENHANCED_PROTOCOL_RPC) {
+        rpc_register_builtin_methods();
+    }
+    if (data->config.protocol == ENHANCED_PROTOCOL_RESP && start_kv_store(data) != 0) {
+        return -1;
+    }
+    
+    // Unix域套接字监听，可以代替TCP监听
+    int unix_only = config_get_bool("enhanced_network_unix_socket_only", 0);
+    if (start_unix_listener(data, unix_only) != 0) {
+        return -1;
+    }
     
     // 绑定地址
     struct sockaddr_in addr;
     uv_ip4_addr(data->config.host, data->config.port, &addr);
     
-    int bind_result = uv_tcp_bind(&data->server, (const struct sockaddr*)&addr, 0);
-    if (bind_result != 0) {
-        log_error("绑定地址失败: %s", uv_strerror(bind_result));
-        return -1;
-    }
-    
-    // 开始监听
-    int listen_result = uv_listen((uv_stream_t*) &data->server, data->config.backlog, on_new_connection);
-    if (listen_result != 0) {
-        log_error("监听失败: %s", uv_strerror(listen_result));
-        return -1;
+    if (unix_only) {
+        // 只监听Unix域套接字
+    } else if (data->config.transport == ENHANCED_TRANSPORT_UDP) {
+        if (start_udp_endpoint(data, (const struct sockaddr*) &addr) != 0) {
+            log_error("UDP端点启动失败");
+            return -1;
+        }
+        udp_endpoint_stats_t udp_stats;
+        udp_endpoint_get_stats(data->udp_endpoint, &udp_stats);
+        log_info("增强网络模块使用UDP传输，每批最多 %zu 个数据报，GRO: %s，GSO: %s",
+                 data->udp_config.batch_size, udp_stats.gro ? "启用" : "不可用",
+                 udp_stats.gso ? "启用" : "不可用");
+    } else if (start_uring_listener(data, (const struct sockaddr*) &addr) == 0) {
+        log_info("增强网络模块使用io_uring后端");
+    } else {
+        int bind_result = uv_tcp_bind(&data->server, (const struct sockaddr*)&addr, 0);
+        if (bind_result != 0) {
+            log_error("绑定地址失败: %s", uv_strerror(bind_result));
+            return -1;
+        }
+        
+        // 开始监听
+        int listen_result = uv_listen((uv_stream_t*) &data->server, data->config.backlog, on_new_connection);
+        if (listen_result != 0) {
+            log_error("监听失败: %s", uv_strerror(listen_result));
+            return -1;
+        }
     }
     
     // 启动统计定时器（每5秒打印一次统计信息）
     uv_timer_start(&data->stats_timer, on_stats_timer, 5000, 5000);
     
-    log_info("增强网络模块启动成功，监听 %s:%d", data->config.host, data->config.port);
-    log_info("线程池处理: %s", data->config.enable_threadpool ? "启用" : "禁用");
+    if (unix_only) {
+        log_info("增强网络模块启动成功，监听 %s", data->unix_socket_path);
+    } else {
+        log_info("增强网络模块启动成功，监听 %s:%d", data->config.host, data->config.port);
+    }
+    log_info("线程池处理: %s，分帧格式: %s", data->config.enable_threadpool ? "启用" : "禁用",
+             data->codec.type == FRAME_CODEC_LINE ? "line" :
+             data->codec.type == FRAME_CODEC_LENGTH_PREFIXED ? "length" : "custom");
+    if (data->config.protocol == ENHANCED_PROTOCOL_RPC) {
+        log_info("消息协议: RPC，已注册 %zu 个方法", rpc_method_count());
+    } else if (data->kv_store) {
+        kv_store_stats_t kv_stats;
+        kv_store_get_stats(data->kv_store, &kv_stats);
+        log_info("消息协议: RESP，键值存储 %zu 个分片", kv_stats.shards);
+    } else if (data->pubsub_commands) {
+        log_info("已启用发布订阅命令（SUBSCRIBE、UNSUBSCRIBE、PUBLISH）");
+    }
+    if (data->config.enable_threadpool) {
+        threadpool_set_discard_handler(on_request_discarded);
+        log_info("并发上限: 全局 %d，每连接 %d，请求超时: %d ms", data->config.max_concurrent_requests,
+                 data->config.max_inflight_per_connection, data->config.request_timeout_ms);
+    }
     return 0;
 }
 
+// 关闭一个libuv连接或UDP端点（io_uring连接随监听器一起关闭）
+static void close_connection(void *object, conn_handle_t handle, void *arg) {
+    (void)handle; // 避免未使用参数警告
+    (void)arg; // 避免未使用参数警告
+    enhanced_connection_t *conn = (enhanced_connection_t*) object;
+    if (conn->udp) {
+        udp_endpoint_close(conn->udp, on_udp_close);
+    } else if (!conn->uring && !uv_is_closing((uv_handle_t*) &conn->stream)) {
+        uv_close((uv_handle_t*) &conn->stream, on_client_close);
+    }
+}
+
 // 增强网络模块停止
 int enhanced_network_module_stop(module_interface_t *self) {
     if (!self || !self->private_data) {
@@ -343,21 +1676,69 @@ int enhanced_network_module_stop(module_interface_t *self) {
     
     enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) self->private_data;
     
-    // 停止统计定时器
+    // 停止统计、请求超时和键值过期定时器
     uv_timer_stop(&data->stats_timer);
+    uv_timer_stop(&data->deadline_timer);
+    uv_timer_stop(&data->expire_timer);
+    
+    // io_uring后端：关闭监听器时一并关闭全部连接
+    if (data->uring_listener) {
+        uring_listener_close(data->uring_listener);
+        data->uring_listener = NULL;
+    }
+    
+    unix_socket_close(&data->unix_server, data->unix_socket_path);
     
-    // 关闭所有客户端连接
-    for (size_t i = 0; i < data->client_count; i++) {
-        uv_close((uv_handle_t*) data->clients[i], on_client_close);
+    // 写出缓存的响应后关闭所有客户端连接
+    while (data->flush_head) {
+        flush_output(data->flush_head);
     }
+    uv_check_stop(&data->flush_check);
+    conn_registry_foreach(data->connections, close_connection, NULL);
     
-    // 关闭服务器
-    uv_close((uv_handle_t*) &data->server, NULL);
+    // 关闭服务器（优雅关闭时可能已在quiesce阶段关闭）
+    if (!uv_is_closing((uv_handle_t*) &data->server)) {
+        uv_close((uv_handle_t*) &data->server, NULL);
+    }
     
     log_info("增强网络模块已停止");
     return 0;
 }
 
+// 增强网络模块停止接收新连接
+int enhanced_network_module_quiesce(module_interface_t *self) {
+    if (!self || !self->private_data) {
+        return -1;
+    }
+    
+    enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) self->private_data;
+    
+    // 关闭监听套接字，已建立的连接继续处理未完成的请求；UDP端点停止接收，处理中的请求照常应答
+    if (data->uring_listener) {
+        uring_listener_stop_accepting(data->uring_listener);
+    }
+    if (data->udp_endpoint) {
+        udp_endpoint_stop_receiving(data->udp_endpoint);
+    }
+    unix_socket_close(&data->unix_server, data->unix_socket_path);
+    if (!uv_is_closing((uv_handle_t*) &data->server)) {
+        uv_close((uv_handle_t*) &data->server, NULL);
+    }
+    
+    log_info("增强网络模块已停止接收新连接，活跃请求数: %d", enhanced_network_module_pending(self));
+    return 0;
+}
+
+// 获取正在处理的请求数
+int enhanced_network_module_pending(module_interface_t *self) {
+    if (!self || !self->private_data) {
+        return 0;
+    }
+    
+    enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) self->private_data;
+    return data->active_requests + data->queued_requests;
+}
+
 // 增强网络模块清理
 int enhanced_network_module_cleanup(module_interface_t *self) {
     if (!self || !self->private_data) {
@@ -366,15 +1747,28 @@ int enhanced_network_module_cleanup(module_interface_t *self) {
     
     enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) self->private_data;
     
-    // 释放客户端数组
-    if (data->clients) {
-        free(data->clients);
+    // 线程池已停止，处理完成队列中剩余的结果（连接均已关闭，只释放上下文）
+    if (data->config.enable_threadpool) {
+        threadpool_set_discard_handler(NULL);
     }
+    loop_queue_destroy(data->completions);
+    data->completions = NULL;
+    
+    // 释放连接注册表（连接均已关闭）
+    conn_registry_destroy(data->connections);
+    
+    // 释放主题表（订阅者随连接释放）和键值存储
+    pubsub_destroy(data->pubsub);
+    kv_store_destroy(data->kv_store);
+    
+    // 清空RPC方法注册表
+    rpc_clear_methods();
     
     // 释放配置
     if (data->config.host != default_config.host) {
         free(data->config.host);
     }
+    free(data->unix_socket_path);
     
     // 释放私有数据
     free(data);
@@ -409,6 +1803,21 @@ enhanced_network_config_t* enhanced_network_module_get_config(module_interface_t
     return &data->config;
 }
 
+// 设置分帧格式（在模块启动前调用，之后配置文件中的分帧设置不再生效）
+int enhanced_network_module_set_codec(module_interface_t *self, const frame_codec_t *codec) {
+    if (!self || !self->private_data || !codec || codec->max_frame_size == 0) {
+        return -1;
+    }
+    if (codec->type == FRAME_CODEC_CUSTOM && !codec->decode) {
+        return -1;
+    }
+    
+    enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) self->private_data;
+    data->codec = *codec;
+    data->codec_overridden = 1;
+    return 0;
+}
+
 // 打印增强网络模块统计信息
 void enhanced_network_module_print_stats(module_interface_t *self) {
     if (!self || !self->private_data) {
@@ -419,11 +1828,56 @@ void enhanced_network_module_print_stats(module_interface_t *self) {
     enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) self->private_data;
     
     log_info("\n=== 增强网络模块统计 ===");
-    log_info("当前连接数: %zu", data->client_count);
+    log_info("当前连接数: %zu", conn_registry_count(data->connections));
     log_info("总请求数: %d", data->total_requests);
     log_info("活跃请求数: %d", data->active_requests);
+    log_info("丢弃的响应数: %d", data->dropped_responses);
     log_info("线程池处理: %s", data->config.enable_threadpool ? "启用" : "禁用");
+    log_info("等待提交的请求数: %d", data->queued_requests);
+    log_info("超时请求数: %d", data->timed_out_requests);
+    log_info("拒绝请求数: %d", data->rejected_requests);
     log_info("最大并发请求数: %d", data->config.max_concurrent_requests);
+    log_info("每连接最大并发请求数: %d", data->config.max_inflight_per_connection);
     log_info("请求超时时间: %d ms", data->config.request_timeout_ms);
     log_info("========================\n\n");
 }
+
+// 连接订阅主题
+int enhanced_network_module_subscribe(module_interface_t *self, conn_handle_t connection, const char *topic) {
+    if (!self || !self->private_data || !topic) {
+        return -1;
+    }
+    
+    enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) self->private_data;
+    enhanced_connection_t *conn = conn_registry_get(data->connections, connection);
+    return conn ? subscribe_connection(conn, topic) : -1;
+}
+
+// 连接取消订阅主题
+int enhanced_network_module_unsubscribe(module_interface_t *self, conn_handle_t connection, const char *topic) {
+    if (!self || !self->private_data || !topic) {
+        return -1;
+    }
+    
+    enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) self->private_data;
+    enhanced_connection_t *conn = conn_registry_get(data->connections, connection);
+    return conn ? unsubscribe_connection(conn, topic) : -1;
+}
+
+// 向主题发布消息
+int enhanced_network_module_publish(module_interface_t *self, const char *topic, const char *payload, size_t length) {
+    if (!self || !self->private_data || !topic || (!payload && length > 0)) {
+        return -1;
+    }
+    
+    enhanced_network_private_data_t *data = (enhanced_network_private_data_t*) self->private_data;
+    return publish_message(data, topic, payload, length);
+}
+
+// 获取RESP协议的键值存储
+kv_store_t* enhanced_network_module_get_kv_store(module_interface_t *self) {
+    if (!self || !self->private_data) {
+        return NULL;
+    }
+    return ((enhanced_network_private_data_t*) self->private_data)->kv_store;
+}
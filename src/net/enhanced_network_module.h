@@ -3,8 +3,29 @@
 
 #include "module_manager.h"
 #include "threadpool_module.h"
+#include "src/net/frame_codec.h"
+#include "src/net/conn_registry.h"
+#include "src/net/rpc_server.h"
+#include "src/net/resp_server.h"
+#include "src/net/udp_transport.h"
+#include "src/net/pubsub.h"
+#include "src/thread/loop_queue.h"
+#include <stdint.h>
 #include <uv.h>
 
+// 消息协议
+typedef enum {
+    ENHANCED_PROTOCOL_RAW = 0,              // 按分帧格式收发原始消息
+    ENHANCED_PROTOCOL_RPC,                  // 二进制RPC（见rpc_protocol.h），固定使用4字节长度前缀分帧
+    ENHANCED_PROTOCOL_RESP                  // Redis协议（见resp_server.h），命令在事件循环线程对内置键值存储执行
+} enhanced_network_protocol_t;
+
+// 传输层
+typedef enum {
+    ENHANCED_TRANSPORT_TCP = 0,
+    ENHANCED_TRANSPORT_UDP                  // 每个数据报是一条消息，不使用分帧格式
+} enhanced_network_transport_t;
+
 // 增强网络模块配置
 typedef struct {
     int port;
@@ -12,28 +33,69 @@ typedef struct {
     int backlog;
     int max_connections;
     int enable_threadpool;
-    int max_concurrent_requests;
-    int request_timeout_ms;
+    int max_concurrent_requests;            // 全部连接同时在线程池中处理的请求上限
+    int max_inflight_per_connection;        // 单个连接同时处理的请求上限，超过时暂停读取该连接
+    int request_timeout_ms;                 // 请求处理超时，超时后向客户端返回错误
+    enhanced_network_protocol_t protocol;
+    enhanced_network_transport_t transport;
 } enhanced_network_config_t;
 
+struct enhanced_connection;
+struct enhanced_network_private_data;
+
 // 请求处理上下文
-typedef struct {
-    uv_tcp_t *client;
-    char *request_data;
+// 在事件循环线程创建并提交到线程池，工作线程填写响应后通过完成队列交回事件循环，
+// 工作线程不访问连接本身
+typedef struct request_context {
+    loop_queue_node_t node;                 // 完成队列节点
+    struct enhanced_network_private_data *module;
+    conn_handle_t connection;               // 所属连接，在事件循环线程查找，连接已关闭时查找失败
+    struct request_context *prev;           // 等待队列或处理中链表（事件循环线程）
+    struct request_context *next;
+    uint64_t deadline;                      // 超时时刻（uv_now，毫秒），收到RPC请求时按客户端的超时预算设置
+    int timed_out;                          // 已按超时应答，工作线程的结果丢弃
+    int rejected;                           // 被线程池丢弃（拒绝策略为drop_oldest），返回过载错误
+    rpc_method_t method;                    // RPC请求调用的方法，原始消息的handler为NULL
+    uint32_t request_id;                    // RPC请求ID，原样带回响应
+    udp_peer_t peer;                        // UDP请求的来源地址，响应发回该地址
+    char *request_data;                     // 原始消息或RPC请求体
     size_t request_size;
-    void (*response_callback)(uv_tcp_t *client, const char *response);
+    char *response;                         // 工作线程生成的响应（原始消息未分帧，RPC响应已编码成帧）
+    size_t response_length;
 } request_context_t;
 
 // 增强网络模块私有数据
-typedef struct {
+typedef struct enhanced_network_private_data {
     uv_tcp_t server;
-    uv_tcp_t **clients;
-    size_t client_count;
-    size_t client_capacity;
+    uv_pipe_t unix_server;                  // Unix域套接字监听，未配置时不初始化
+    char *unix_socket_path;                 // 未配置Unix域套接字时为NULL
+    struct uring_listener *uring_listener;  // io_uring后端的监听器，使用libuv时为NULL
+    udp_endpoint_t *udp_endpoint;           // UDP模式的端点，TCP模式为NULL
+    udp_endpoint_config_t udp_config;
+    pubsub_t *pubsub;                       // 主题订阅，连接按需创建订阅者
+    int pubsub_commands;                    // 原始消息协议下处理SUBSCRIBE/UNSUBSCRIBE/PUBLISH命令
+    kv_store_t *kv_store;                   // RESP协议的键值存储，其他协议为NULL
+    uv_timer_t expire_timer;                // 按时间轮刻度删除过期的键
+    conn_registry_t *connections;           // 全部客户端连接（libuv和io_uring后端共用）
     enhanced_network_config_t config;
+    frame_codec_t codec;                    // 请求和响应的分帧格式
+    int codec_overridden;                   // 已通过enhanced_network_module_set_codec设置，不再读取配置
+    size_t frame_buffer_size;               // 每个连接的初始接收缓冲区大小
     uv_timer_t stats_timer;
+    loop_queue_t *completions;              // 线程池处理结果的完成队列
+    request_context_t *inflight_head;       // 处理中的请求，按提交顺序（即超时顺序）排列
+    request_context_t *inflight_tail;
+    struct enhanced_connection *blocked_head;   // 因全局上限而等待的连接
+    struct enhanced_connection *blocked_tail;
+    uv_timer_t deadline_timer;              // 请求超时检查
+    uv_check_t flush_check;                 // 本轮事件循环结束时写出各连接缓存的响应
+    struct enhanced_connection *flush_head; // 有待写出响应的libuv连接
     int total_requests;
-    int active_requests;
+    int active_requests;                    // 已提交、尚未应答的请求数
+    int queued_requests;                    // 已收到、等待提交的请求数
+    int timed_out_requests;                 // 超时应答的请求数
+    int rejected_requests;                  // 线程池已满、被拒绝或丢弃的请求数
+    int dropped_responses;                  // 连接已关闭或已超时应答、被丢弃的响应数
 } enhanced_network_private_data_t;
 
 // 增强网络模块接口
@@ -44,14 +106,27 @@ int enhanced_network_module_init(module_interface_t *self, uv_loop_t *loop);
 int enhanced_network_module_start(module_interface_t *self);
 int enhanced_network_module_stop(module_interface_t *self);
 int enhanced_network_module_cleanup(module_interface_t *self);
+int enhanced_network_module_quiesce(module_interface_t *self);
+int enhanced_network_module_pending(module_interface_t *self);
 
 // 请求处理函数
-void process_request_in_threadpool(void *ctx);
-void handle_response(uv_tcp_t *client, const char *response);
+void process_request_in_threadpool(void *ctx);      // 在工作线程执行
+void handle_response(request_context_t *ctx);       // 在事件循环线程执行，写回响应并释放上下文
 
 // 配置和统计函数
 int enhanced_network_module_set_config(module_interface_t *self, enhanced_network_config_t *config);
 enhanced_network_config_t* enhanced_network_module_get_config(module_interface_t *self);
+int enhanced_network_module_set_codec(module_interface_t *self, const frame_codec_t *codec);
 void enhanced_network_module_print_stats(module_interface_t *self);
 
+// 发布订阅函数（在事件循环线程调用，模块启动后可用）
+// 连接订阅/取消订阅主题，UDP模式不支持订阅，成功返回0
+int enhanced_network_module_subscribe(module_interface_t *self, conn_handle_t connection, const char *topic);
+int enhanced_network_module_unsubscribe(module_interface_t *self, conn_handle_t connection, const char *topic);
+// 按分帧格式编码一次后写给主题的全部订阅者，返回立即写入的订阅者数，失败返回-1
+int enhanced_network_module_publish(module_interface_t *self, const char *topic, const char *payload, size_t length);
+
+// 获取RESP协议的键值存储（可以在任意线程访问），未以RESP协议启动时返回NULL
+kv_store_t* enhanced_network_module_get_kv_store(module_interface_t *self);
+
 #endif // ENHANCED_NETWORK_MODULE_H
@@ -0,0 +1,415 @@
+#include "src/net/frame_codec.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// 一次回调最多分发的帧数
+#define FRAME_BATCH_MAX 64
+
+// 同时存在的镜像缓冲区上限：每个占用两个内存映射，超过后新的解码器使用线性缓冲区，
+// 避免大量连接时达到vm.max_map_count
+#define FRAME_MIRRORED_MAX 8192
+
+// 停止分发期间最多缓存的数据量（单帧上限的倍数），超过时视为错误
+#define FRAME_STOPPED_LIMIT_FRAMES 4
+
+// 当前的镜像缓冲区数
+static int mirrored_buffers = 0;
+
+// 解码器
+struct frame_decoder {
+    frame_codec_t codec;
+    char *base;                 // 镜像映射的起始地址，[base, base + 2 * capacity)；线性缓冲区为malloc分配
+    size_t capacity;            // 页大小的整数倍
+    int mirrored;               // 是否为镜像映射。线性缓冲区中的数据写到结尾后搬回开头
+    size_t head;                // 下一帧的起始位置（镜像映射中单调递增，取模后为偏移；线性缓冲区中为偏移）
+    size_t tail;                // 已写入数据的结束位置
+    size_t needed;              // 完成下一帧至少需要的字节数
+    size_t line_scanned;        // 行格式：当前帧已扫描过、不含'\n'的字节数
+    int stopped;                // 回调要求停止分发，恢复前只缓存数据
+    frame_t batch[FRAME_BATCH_MAX];
+};
+
+// 按页大小向上取整
+static size_t round_to_page(size_t size) {
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    if (size == 0) {
+        size = page;
+    }
+    return (size + page - 1) / page * page;
+}
+
+#ifdef __linux__
+// 创建镜像映射：同一块共享内存连续映射两次，跨越结尾的数据在虚拟地址上仍然连续
+static char* map_mirrored(size_t size) {
+    int fd = memfd_create("frame_ring", MFD_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (ftruncate(fd, (off_t) size) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    // 先保留2倍大小的地址空间，再把共享内存固定映射到前后两半
+    char *base = mmap(NULL, size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+    if (mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(base, size * 2);
+        close(fd);
+        return NULL;
+    }
+
+    // 映射建立后不再需要文件描述符
+    close(fd);
+    return base;
+}
+#else
+// 其他平台没有memfd_create，使用线性缓冲区
+static char* map_mirrored(size_t size) {
+    (void)size; // 避免未使用参数警告
+    return NULL;
+}
+#endif
+
+// 分配缓冲区：优先使用镜像映射，达到数量上限或映射失败时使用线性缓冲区
+static char* alloc_buffer(size_t size, int *mirrored) {
+    if (__atomic_add_fetch(&mirrored_buffers, 1, __ATOMIC_RELAXED) <= FRAME_MIRRORED_MAX) {
+        char *base = map_mirrored(size);
+        if (base) {
+            *mirrored = 1;
+            return base;
+        }
+    }
+    __atomic_sub_fetch(&mirrored_buffers, 1, __ATOMIC_RELAXED);
+    *mirrored = 0;
+    return malloc(size);
+}
+
+static void free_buffer(char *base, size_t size, int mirrored) {
+    if (mirrored) {
+        munmap(base, size * 2);
+        __atomic_sub_fetch(&mirrored_buffers, 1, __ATOMIC_RELAXED);
+    } else {
+        free(base);
+    }
+}
+
+// 位置position处的数据
+static char* data_at(const frame_decoder_t *decoder, size_t position) {
+    return decoder->base + (decoder->mirrored ? position % decoder->capacity : position);
+}
+
+int frame_codec_parse_type(const char *name, frame_codec_type_t *type) {
+    if (!name || !type) {
+        return -1;
+    }
+    if (strcasecmp(name, "line") == 0) {
+        *type = FRAME_CODEC_LINE;
+    } else if (strcasecmp(name, "length") == 0) {
+        *type = FRAME_CODEC_LENGTH_PREFIXED;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+frame_decoder_t* frame_decoder_create(const frame_codec_t *codec, size_t buffer_size) {
+    if (!codec || codec->max_frame_size == 0) {
+        return NULL;
+    }
+    if (codec->type == FRAME_CODEC_LENGTH_PREFIXED &&
+        codec->length_field_size != 2 && codec->length_field_size != 4) {
+        return NULL;
+    }
+    if (codec->type == FRAME_CODEC_CUSTOM && !codec->decode) {
+        return NULL;
+    }
+
+    frame_decoder_t *decoder = calloc(1, sizeof(frame_decoder_t));
+    if (!decoder) {
+        return NULL;
+    }
+    decoder->codec = *codec;
+    decoder->capacity = round_to_page(buffer_size);
+    decoder->base = alloc_buffer(decoder->capacity, &decoder->mirrored);
+    if (!decoder->base) {
+        free(decoder);
+        return NULL;
+    }
+    return decoder;
+}
+
+void frame_decoder_destroy(frame_decoder_t *decoder) {
+    if (!decoder) {
+        return;
+    }
+    free_buffer(decoder->base, decoder->capacity, decoder->mirrored);
+    free(decoder);
+}
+
+void frame_decoder_get_write_buffer(frame_decoder_t *decoder, char **base, size_t *length) {
+    // 线性缓冲区写到结尾时把未处理的数据搬回开头（分发的帧只在回调期间有效，此时没有引用）
+    if (!decoder->mirrored && decoder->tail == decoder->capacity && decoder->head > 0) {
+        size_t used = decoder->tail - decoder->head;
+        memmove(decoder->base, decoder->base + decoder->head, used);
+        decoder->head = 0;
+        decoder->tail = used;
+    }
+    *base = data_at(decoder, decoder->tail);
+    *length = decoder->mirrored ? decoder->capacity - (decoder->tail - decoder->head)
+                                : decoder->capacity - decoder->tail;
+}
+
+// 扩大缓冲区以容纳至少needed字节（不超过limit），未处理的数据复制到新缓冲区开头
+static int grow_buffer(frame_decoder_t *decoder, size_t needed, size_t limit) {
+    if (decoder->capacity >= limit) {
+        return -1;
+    }
+
+    size_t capacity = decoder->capacity * 2;
+    if (capacity < needed) {
+        capacity = needed;
+    }
+    capacity = round_to_page(capacity);
+    if (capacity > limit) {
+        capacity = limit;
+    }
+
+    int mirrored;
+    char *base = alloc_buffer(capacity, &mirrored);
+    if (!base) {
+        return -1;
+    }
+    size_t used = decoder->tail - decoder->head;
+    memcpy(base, data_at(decoder, decoder->head), used);
+    free_buffer(decoder->base, decoder->capacity, decoder->mirrored);
+
+    decoder->base = base;
+    decoder->capacity = capacity;
+    decoder->mirrored = mirrored;
+    decoder->head = 0;
+    decoder->tail = used;
+    return 0;
+}
+
+// 从data开始解码一帧：返回占用的字节数，数据不完整返回0，协议错误返回-1
+static ssize_t decode_one(frame_decoder_t *decoder, const char *data, size_t length, frame_t *frame) {
+    const frame_codec_t *codec = &decoder->codec;
+
+    switch (codec->type) {
+        case FRAME_CODEC_LINE: {
+            // 从上次扫描结束的位置继续查找，半行数据不重复扫描
+            const char *newline = memchr(data + decoder->line_scanned, '\n', length - decoder->line_scanned);
+            if (!newline) {
+                decoder->line_scanned = length;
+                decoder->needed = length + 1;
+                return length >= codec->max_frame_size ? -1 : 0;
+            }
+            size_t consumed = (size_t) (newline - data) + 1;
+            decoder->line_scanned = 0;
+            if (consumed > codec->max_frame_size) {
+                return -1;
+            }
+            size_t payload_length = consumed - 1;
+            if (payload_length > 0 && data[payload_length - 1] == '\r') {
+                payload_length--;
+            }
+            frame->data = data;
+            frame->length = payload_length;
+            return (ssize_t) consumed;
+        }
+
+        case FRAME_CODEC_LENGTH_PREFIXED: {
+            size_t header = (size_t) codec->length_field_size;
+            if (length < header) {
+                decoder->needed = header;
+                return 0;
+            }
+            const unsigned char *bytes = (const unsigned char*) data;
+            size_t payload_length = header == 2
+                ? ((size_t) bytes[0] << 8) | bytes[1]
+                : ((size_t) bytes[0] << 24) | ((size_t) bytes[1] << 16) | ((size_t) bytes[2] << 8) | bytes[3];
+            size_t total = header + payload_length;
+            if (total > codec->max_frame_size) {
+                return -1;
+            }
+            if (length < total) {
+                decoder->needed = total;
+                return 0;
+            }
+            frame->data = data + header;
+            frame->length = payload_length;
+            return (ssize_t) total;
+        }
+
+        case FRAME_CODEC_CUSTOM: {
+            const char *payload = NULL;
+            size_t payload_length = 0;
+            ssize_t consumed = codec->decode(data, length, &payload, &payload_length, codec->user_data);
+            if (consumed < 0 || (size_t) consumed > length || (size_t) consumed > codec->max_frame_size) {
+                return -1;
+            }
+            if (consumed == 0) {
+                decoder->needed = length + 1;
+                return length >= codec->max_frame_size ? -1 : 0;
+            }
+            frame->data = payload;
+            frame->length = payload_length;
+            return consumed;
+        }
+    }
+    return -1;
+}
+
+int frame_decoder_commit(frame_decoder_t *decoder, size_t nread, frame_batch_cb cb, void *arg) {
+    decoder->tail += nread;
+    int dispatched = 0;
+    if (decoder->stopped) {
+        return 0;
+    }
+
+    for (;;) {
+        size_t position = decoder->head;
+        size_t count = 0;
+
+        while (count < FRAME_BATCH_MAX && position != decoder->tail) {
+            // 镜像映射保证从任意偏移开始的未处理数据都是连续的，线性缓冲区中的数据本身连续
+            const char *data = data_at(decoder, position);
+            ssize_t consumed = decode_one(decoder, data, decoder->tail - position, &decoder->batch[count]);
+            if (consumed < 0) {
+                return -1;
+            }
+            if (consumed == 0) {
+                break;
+            }
+            position += (size_t) consumed;
+            count++;
+        }
+        if (count == 0) {
+            break;
+        }
+
+        dispatched += (int) count;
+        int stop = cb(decoder->batch, count, arg);
+        decoder->head = position;
+        if (stop) {
+            decoder->stopped = 1;
+            return dispatched;
+        }
+        if (count < FRAME_BATCH_MAX) {
+            break;
+        }
+    }
+
+    // 缓冲区已满或下一帧超过缓冲区大小时扩大缓冲区
+    size_t used = decoder->tail - decoder->head;
+    if (used == 0) {
+        decoder->needed = 0;
+    } else if (used == decoder->capacity || decoder->needed > decoder->capacity) {
+        if (grow_buffer(decoder, decoder->needed > used ? decoder->needed : used + 1,
+                        round_to_page(decoder->codec.max_frame_size)) != 0) {
+            return -1;
+        }
+    }
+    return dispatched;
+}
+
+int frame_decoder_resume(frame_decoder_t *decoder, frame_batch_cb cb, void *arg) {
+    decoder->stopped = 0;
+    return frame_decoder_commit(decoder, 0, cb, arg);
+}
+
+int frame_decoder_is_stopped(const frame_decoder_t *decoder) {
+    return decoder->stopped;
+}
+
+int frame_decoder_feed(frame_decoder_t *decoder, const char *data, size_t length, frame_batch_cb cb, void *arg) {
+    int dispatched = 0;
+
+    while (length > 0) {
+        char *buffer;
+        size_t available;
+        frame_decoder_get_write_buffer(decoder, &buffer, &available);
+        if (available == 0) {
+            // 暂停分发期间缓冲区已满，扩大后继续缓存。缓存的是多个完整帧，上限为单帧上限的若干倍，
+            // 调用者暂停读取后仍持续收到数据时视为错误
+            size_t limit = round_to_page(decoder->codec.max_frame_size) * FRAME_STOPPED_LIMIT_FRAMES;
+            if (grow_buffer(decoder, decoder->capacity + length, limit) != 0) {
+                return -1;
+            }
+            continue;
+        }
+        size_t chunk = length < available ? length : available;
+        memcpy(buffer, data, chunk);
+
+        int result = frame_decoder_commit(decoder, chunk, cb, arg);
+        if (result < 0) {
+            return -1;
+        }
+        dispatched += result;
+        data += chunk;
+        length -= chunk;
+    }
+    return dispatched;
+}
+
+char* frame_encode(const frame_codec_t *codec, const char *payload, size_t length, size_t *frame_length) {
+    if (!codec || (!payload && length > 0) || !frame_length) {
+        return NULL;
+    }
+
+    char *frame = NULL;
+    switch (codec->type) {
+        case FRAME_CODEC_LINE:
+            frame = malloc(length + 1);
+            if (frame) {
+                memcpy(frame, payload, length);
+                frame[length] = '\n';
+                *frame_length = length + 1;
+            }
+            break;
+
+        case FRAME_CODEC_LENGTH_PREFIXED: {
+            size_t header = (size_t) codec->length_field_size;
+            if (header == 2 && length > 0xFFFF) {
+                return NULL;
+            }
+            frame = malloc(header + length);
+            if (frame) {
+                unsigned char *bytes = (unsigned char*) frame;
+                if (header == 2) {
+                    bytes[0] = (unsigned char) (length >> 8);
+                    bytes[1] = (unsigned char) length;
+                } else {
+                    bytes[0] = (unsigned char) (length >> 24);
+                    bytes[1] = (unsigned char) (length >> 16);
+                    bytes[2] = (unsigned char) (length >> 8);
+                    bytes[3] = (unsigned char) length;
+                }
+                memcpy(frame + header, payload, length);
+                *frame_length = header + length;
+            }
+            break;
+        }
+
+        case FRAME_CODEC_CUSTOM:
+            if (codec->encode) {
+                return codec->encode(payload, length, frame_length, codec->user_data);
+            }
+            frame = malloc(length > 0 ? length : 1);
+            if (frame) {
+                memcpy(frame, payload, length);
+                *frame_length = length;
+            }
+            break;
+    }
+    return frame;
+}
@@ -0,0 +1,85 @@
+#ifndef FRAME_CODEC_H
+#define FRAME_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 消息分帧编解码
+// 每个连接持有一个解码器，接收缓冲区是虚拟内存镜像的环形缓冲区（同一物理页映射两次），
+// 任意位置开始的帧在内存中都是连续的：libuv直接读入环的空闲区域，完整的帧以指针形式分批交给回调，
+// 不需要把半帧数据搬回缓冲区开头。一次读取中的多个帧（流水线请求）在同一批中分发。
+// 非Linux平台、镜像缓冲区数达到上限或映射失败时改用普通的线性缓冲区，写到结尾时把半帧数据搬回开头。
+
+// 帧格式
+typedef enum {
+    FRAME_CODEC_LINE = 0,           // 以'\n'结尾的文本行（去掉结尾的"\r\n"或"\n"）
+    FRAME_CODEC_LENGTH_PREFIXED,    // 大端长度头 + 内容，长度不含头部
+    FRAME_CODEC_CUSTOM              // 自定义解码/编码回调
+} frame_codec_type_t;
+
+// 自定义解码：在data中查找第一个完整帧
+// 返回该帧占用的总字节数并通过payload/payload_length给出帧内容，数据不完整返回0，协议错误返回-1
+typedef ssize_t (*frame_decode_fn)(const char *data, size_t length,
+                                   const char **payload, size_t *payload_length, void *user_data);
+
+// 自定义编码：返回malloc分配的完整帧，失败返回NULL
+typedef char* (*frame_encode_fn)(const char *payload, size_t length, size_t *frame_length, void *user_data);
+
+// 编解码配置
+typedef struct {
+    frame_codec_type_t type;
+    int length_field_size;          // FRAME_CODEC_LENGTH_PREFIXED的长度头字节数：2或4
+    size_t max_frame_size;          // 单帧最大字节数（含帧头和行结尾），超过时视为协议错误
+    frame_decode_fn decode;         // FRAME_CODEC_CUSTOM使用
+    frame_encode_fn encode;         // FRAME_CODEC_CUSTOM使用，为NULL时按原样发送
+    void *user_data;
+} frame_codec_t;
+
+// 解码出的帧，指向解码器缓冲区，只在回调期间有效
+typedef struct {
+    const char *data;
+    size_t length;
+} frame_t;
+
+// 一批完整帧的回调，返回非0时停止分发（例如连接已关闭或需要背压），剩余的帧留在缓冲区中直到恢复
+typedef int (*frame_batch_cb)(const frame_t *frames, size_t count, void *arg);
+
+typedef struct frame_decoder frame_decoder_t;
+
+// 从字符串解析帧格式（"line"、"length"），无法识别返回-1
+int frame_codec_parse_type(const char *name, frame_codec_type_t *type);
+
+// 创建解码器，buffer_size按页大小向上取整，帧超过缓冲区时自动扩大到max_frame_size
+frame_decoder_t* frame_decoder_create(const frame_codec_t *codec, size_t buffer_size);
+void frame_decoder_destroy(frame_decoder_t *decoder);
+
+// 获取可写入的连续空闲区域（用于libuv的alloc_cb），未停止分发时长度总是大于0
+void frame_decoder_get_write_buffer(frame_decoder_t *decoder, char **base, size_t *length);
+
+// 提交写入空闲区域的字节数，分批分发全部完整帧
+// 成功返回分发的帧数，协议错误或帧超过上限返回-1
+int frame_decoder_commit(frame_decoder_t *decoder, size_t nread, frame_batch_cb cb, void *arg);
+
+// 恢复分发并分发缓冲区中已完整的帧，返回值同frame_decoder_commit
+int frame_decoder_resume(frame_decoder_t *decoder, frame_batch_cb cb, void *arg);
+
+// 是否处于停止分发状态
+int frame_decoder_is_stopped(const frame_decoder_t *decoder);
+
+// 复制外部数据到解码器并分发完整帧（数据不在解码器缓冲区中时使用），返回值同frame_decoder_commit
+// 停止分发期间继续缓存数据，必要时扩大缓冲区，缓存超过单帧上限的4倍时返回-1
+int frame_decoder_feed(frame_decoder_t *decoder, const char *data, size_t length, frame_batch_cb cb, void *arg);
+
+// 编码一帧，返回malloc分配的缓冲区，失败返回NULL
+char* frame_encode(const frame_codec_t *codec, const char *payload, size_t length, size_t *frame_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_CODEC_H
@@ -6,7 +6,10 @@
 #include <string.h>
 #include <uv.h>
 
-#define INITIAL_CLIENT_CAPACITY 16
+// 读缓冲区：每次读取后立即处理并归还，只使用大缓冲区一档
+#define READ_BUFFER_SMALL_SIZE 4096
+#define READ_BUFFER_LARGE_SIZE 65536
+#define READ_BUFFER_CACHE 64
 
 // 网络模块接口定义
 module_interface_t network_module = {
@@ -30,56 +33,11 @@ static network_config_t default_config = {
     .max_connections = 1000
 };
 
-// 扩展客户端数组容量
-static int expand_client_capacity(network_private_data_t *data) {
-    size_t new_capacity = data->client_capacity * 2;
-    uv_tcp_t **new_clients = realloc(data->clients, 
-                                     sizeof(uv_tcp_t*) * new_capacity);
-    if (!new_clients) {
-        return -1;
-    }
-    
-    data->clients = new_clients;
-    data->client_capacity = new_capacity;
-    return 0;
-}
-
-// 添加客户端连接
-static int add_client(network_private_data_t *data, uv_tcp_t *client) {
-    if (data->client_count >= data->client_capacity) {
-        if (expand_client_capacity(data) != 0) {
-            return -1;
-        }
-    }
-    
-    data->clients[data->client_count] = client;
-    data->client_count++;
-    
-            log_info("新客户端连接，当前连接数: %zu", data->client_count);
-    return 0;
-}
-
-// 移除客户端连接
-static int remove_client(network_private_data_t *data, uv_tcp_t *client) {
-    for (size_t i = 0; i < data->client_count; i++) {
-        if (data->clients[i] == client) {
-            // 移动后面的客户端
-            for (size_t j = i; j < data->client_count - 1; j++) {
-                data->clients[j] = data->clients[j + 1];
-            }
-            data->client_count--;
-            log_info("客户端断开连接，当前连接数: %zu", data->client_count);
-            return 0;
-        }
-    }
-    return -1;
-}
-
 // 客户端关闭回调
 static void on_client_close(uv_handle_t *handle) {
     network_private_data_t *data = (network_private_data_t*) handle->data;
-    remove_client(data, (uv_tcp_t*) handle);
-    free(handle);
+    conn_registry_free(data->clients, handle);
+    log_info("客户端断开连接，当前连接数: %zu", conn_registry_count(data->clients));
 }
 
 // 写入完成回调
@@ -94,6 +52,8 @@ static void on_write_complete(uv_write_t *req, int status) {
 
 // 读取回调
 static void on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+    network_private_data_t *data = (network_private_data_t*) stream->data;
+    
     if (nread > 0) {
         // 显示接收到的消息
         log_info("收到消息: %.*s", (int)nread, buf->base);
@@ -108,23 +68,23 @@ static void on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
             uv_buf_t reply_buf = uv_buf_init(strdup(reply), strlen(reply));
             uv_write(write_req, stream, &reply_buf, 1, on_write_complete);
         }
-        
-        free(buf->base);
     } else if (nread < 0) {
         if (nread != UV_EOF) {
             log_error("读取错误: %s", uv_err_name(nread));
         }
         uv_close((uv_handle_t*) stream, on_client_close);
-    } else {
-        free(buf->base);
     }
+    
+    // 归还读缓冲区（libuv在出错时也可能交回已分配的缓冲区）
+    read_buffer_pool_put(data->read_buffers, buf->base);
 }
 
 // 分配缓冲区回调
 static void alloc_buffer(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
-    (void)handle; // 避免未使用参数警告
-    buf->base = malloc(suggested_size);
-    buf->len = suggested_size;
+    (void)suggested_size; // 避免未使用参数警告
+    network_private_data_t *data = (network_private_data_t*) handle->data;
+    buf->base = read_buffer_pool_get(data->read_buffers, READ_BUFFER_LARGE);
+    buf->len = buf->base ? READ_BUFFER_LARGE_SIZE : 0;
 }
 
 // 新连接回调
@@ -137,7 +97,7 @@ static void on_new_connection(uv_stream_t *server, int status) {
     network_private_data_t *data = (network_private_data_t*) server->data;
     
     // 创建新的客户端连接
-    uv_tcp_t *client = malloc(sizeof(uv_tcp_t));
+    uv_tcp_t *client = conn_registry_alloc(data->clients, NULL);
     if (!client) {
         log_error("内存分配失败");
         return;
@@ -147,12 +107,8 @@ static void on_new_connection(uv_stream_t *server, int status) {
     client->data = data;
     
     if (uv_accept(server, (uv_stream_t*) client) == 0) {
-        if (add_client(data, client) == 0) {
-            uv_read_start((uv_stream_t*) client, alloc_buffer, on_read);
-            log_info("新客户端连接");
-        } else {
-            uv_close((uv_handle_t*) client, on_client_close);
-        }
+        uv_read_start((uv_stream_t*) client, alloc_buffer, on_read);
+        log_info("新客户端连接，当前连接数: %zu", conn_registry_count(data->clients));
     } else {
         uv_close((uv_handle_t*) client, on_client_close);
     }
@@ -174,14 +130,19 @@ int network_module_init(module_interface_t *self, uv_loop_t *loop) {
     memset(data, 0, sizeof(network_private_data_t));
     data->config = default_config;
     
-    data->clients = malloc(sizeof(uv_tcp_t*) * INITIAL_CLIENT_CAPACITY);
+    data->clients = conn_registry_create(sizeof(uv_tcp_t), 0);
     if (!data->clients) {
         free(data);
         return -1;
     }
     
-    data->client_capacity = INITIAL_CLIENT_CAPACITY;
-    data->client_count = 0;
+    data->read_buffers = read_buffer_pool_create(READ_BUFFER_SMALL_SIZE, READ_BUFFER_LARGE_SIZE,
+                                                 READ_BUFFER_CACHE);
+    if (!data->read_buffers) {
+        conn_registry_destroy(data->clients);
+        free(data);
+        return -1;
+    }
     
     // 初始化TCP服务器
     uv_tcp_init(loop, &data->server);
@@ -227,6 +188,15 @@ int network_module_start(module_interface_t *self) {
     return 0;
 }
 
+// 关闭一个客户端连接
+static void close_client(void *object, conn_handle_t handle, void *arg) {
+    (void)handle; // 避免未使用参数警告
+    (void)arg; // 避免未使用参数警告
+    if (!uv_is_closing((uv_handle_t*) object)) {
+        uv_close((uv_handle_t*) object, on_client_close);
+    }
+}
+
 // 网络模块停止
 int network_module_stop(module_interface_t *self) {
     if (!self || !self->private_data) {
@@ -236,9 +206,7 @@ int network_module_stop(module_interface_t *self) {
     network_private_data_t *data = (network_private_data_t*) self->private_data;
     
     // 关闭所有客户端连接
-    for (size_t i = 0; i < data->client_count; i++) {
-        uv_close((uv_handle_t*) data->clients[i], on_client_close);
-    }
+    conn_registry_foreach(data->clients, close_client, NULL);
     
     // 关闭服务器
     uv_close((uv_handle_t*) &data->server, NULL);
@@ -255,10 +223,9 @@ int network_module_cleanup(module_interface_t *self) {
     
     network_private_data_t *data = (network_private_data_t*) self->private_data;
     
-    // 释放客户端数组
-    if (data->clients) {
-        free(data->clients);
-    }
+    // 释放连接注册表和读缓冲池
+    conn_registry_destroy(data->clients);
+    read_buffer_pool_destroy(data->read_buffers);
     
     // 释放配置
     if (data->config.host != default_config.host) {
@@ -313,7 +280,13 @@ size_t network_module_get_client_count(module_interface_t *self) {
     }
     
     network_private_data_t *data = (network_private_data_t*) self->private_data;
-    return data->client_count;
+    return conn_registry_count(data->clients);
+}
+
+// 输出一个客户端
+static void log_client(void *object, conn_handle_t handle, void *arg) {
+    (void)arg; // 避免未使用参数警告
+    log_info("  客户端 %llu: %p", (unsigned long long) handle, object);
 }
 
 // 列出所有客户端
@@ -324,8 +297,6 @@ void network_module_list_clients(module_interface_t *self) {
     
     network_private_data_t *data = (network_private_data_t*) self->private_data;
     
-    log_info("当前客户端连接数: %zu", data->client_count);
-    for (size_t i = 0; i < data->client_count; i++) {
-        log_info("  客户端 %zu: %p", i, data->clients[i]);
-    }
+    log_info("当前客户端连接数: %zu", conn_registry_count(data->clients));
+    conn_registry_foreach(data->clients, log_client, NULL);
 }
@@ -2,6 +2,8 @@
 #define NETWORK_MODULE_H
 
 #include "module_manager.h"
+#include "src/net/conn_registry.h"
+#include "src/net/read_buffer_pool.h"
 #include <uv.h>
 
 // 网络模块配置
@@ -15,9 +17,8 @@ typedef struct {
 // 网络模块私有数据
 typedef struct {
     uv_tcp_t server;
-    uv_tcp_t **clients;
-    size_t client_count;
-    size_t client_capacity;
+    conn_registry_t *clients;   // 客户端连接（uv_tcp_t）
+    read_buffer_pool_t *read_buffers;
     network_config_t config;
 } network_private_data_t;
 
@@ -0,0 +1,431 @@
+#include "src/net/pubsub.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define PUBSUB_INITIAL_BUCKETS 64
+
+typedef struct pubsub_topic pubsub_topic_t;
+
+// 一个订阅者对一个主题的订阅，同时位于主题的订阅链表和订阅者的订阅链表中
+typedef struct pubsub_subscription {
+    pubsub_topic_t *topic;
+    pubsub_subscriber_t *subscriber;
+    struct pubsub_subscription *topic_prev;
+    struct pubsub_subscription *topic_next;
+    struct pubsub_subscription *subscriber_next;
+    pubsub_message_t *latest;               // 合并策略下等待补发的最新消息
+} pubsub_subscription_t;
+
+struct pubsub_topic {
+    pubsub_topic_t *hash_next;
+    uint32_t hash;
+    pubsub_subscription_t *subscriptions;
+    size_t count;
+    int release_pending;                    // 已在empty_topics中
+    pubsub_topic_t *release_next;
+    char name[];
+};
+
+struct pubsub_subscriber {
+    void *owner;
+    int pending;                            // 未完成的写入数
+    int disconnected;                       // 已因过慢断开，等待所有者销毁
+    pubsub_subscription_t *subscriptions;
+    pubsub_subscriber_t *prev;
+    pubsub_subscriber_t *next;
+};
+
+struct pubsub {
+    pubsub_ops_t ops;
+    pubsub_policy_t policy;
+    int max_pending;
+    pubsub_topic_t **buckets;
+    size_t bucket_count;
+    pubsub_subscriber_t *subscribers;
+    int publishing;                         // 发布过程中不释放空主题，遍历中的主题保持有效
+    pubsub_topic_t *empty_topics;           // 发布过程中变空的主题，发布结束后释放
+    pubsub_stats_t stats;
+};
+
+// FNV-1a
+static uint32_t topic_hash(const char *name) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char*) name; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+
+static pubsub_topic_t* find_topic(const pubsub_t *pubsub, const char *name, uint32_t hash) {
+    pubsub_topic_t *topic = pubsub->buckets[hash & (pubsub->bucket_count - 1)];
+    while (topic && (topic->hash != hash || strcmp(topic->name, name) != 0)) {
+        topic = topic->hash_next;
+    }
+    return topic;
+}
+
+// 扩大哈希表，失败时继续使用原表
+static void grow_buckets(pubsub_t *pubsub) {
+    size_t count = pubsub->bucket_count * 2;
+    pubsub_topic_t **buckets = calloc(count, sizeof(pubsub_topic_t*));
+    if (!buckets) {
+        return;
+    }
+    for (size_t i = 0; i < pubsub->bucket_count; i++) {
+        pubsub_topic_t *topic = pubsub->buckets[i];
+        while (topic) {
+            pubsub_topic_t *next = topic->hash_next;
+            topic->hash_next = buckets[topic->hash & (count - 1)];
+            buckets[topic->hash & (count - 1)] = topic;
+            topic = next;
+        }
+    }
+    free(pubsub->buckets);
+    pubsub->buckets = buckets;
+    pubsub->bucket_count = count;
+}
+
+static pubsub_topic_t* get_or_create_topic(pubsub_t *pubsub, const char *name) {
+    uint32_t hash = topic_hash(name);
+    pubsub_topic_t *topic = find_topic(pubsub, name, hash);
+    if (topic) {
+        return topic;
+    }
+
+    size_t length = strlen(name);
+    topic = calloc(1, sizeof(pubsub_topic_t) + length + 1);
+    if (!topic) {
+        return NULL;
+    }
+    memcpy(topic->name, name, length + 1);
+    topic->hash = hash;
+
+    if (pubsub->stats.topics >= pubsub->bucket_count * 2) {
+        grow_buckets(pubsub);
+    }
+    size_t bucket = hash & (pubsub->bucket_count - 1);
+    topic->hash_next = pubsub->buckets[bucket];
+    pubsub->buckets[bucket] = topic;
+    pubsub->stats.topics++;
+    return topic;
+}
+
+// 没有订阅者的主题随即释放，发布过程中加入empty_topics，延后到发布结束
+static void release_topic_if_empty(pubsub_t *pubsub, pubsub_topic_t *topic) {
+    if (topic->count > 0) {
+        return;
+    }
+    if (pubsub->publishing) {
+        if (!topic->release_pending) {
+            topic->release_pending = 1;
+            topic->release_next = pubsub->empty_topics;
+            pubsub->empty_topics = topic;
+        }
+        return;
+    }
+    pubsub_topic_t **link = &pubsub->buckets[topic->hash & (pubsub->bucket_count - 1)];
+    while (*link != topic) {
+        link = &(*link)->hash_next;
+    }
+    *link = topic->hash_next;
+    pubsub->stats.topics--;
+    free(topic);
+}
+
+// 发布结束后释放期间变空、之后没有重新订阅的主题
+static void release_empty_topics(pubsub_t *pubsub) {
+    while (pubsub->empty_topics) {
+        pubsub_topic_t *topic = pubsub->empty_topics;
+        pubsub->empty_topics = topic->release_next;
+        topic->release_pending = 0;
+        release_topic_if_empty(pubsub, topic);
+    }
+}
+
+static pubsub_subscription_t* find_subscription(const pubsub_subscriber_t *subscriber, const char *topic) {
+    pubsub_subscription_t *subscription = subscriber->subscriptions;
+    while (subscription && strcmp(subscription->topic->name, topic) != 0) {
+        subscription = subscription->subscriber_next;
+    }
+    return subscription;
+}
+
+static void remove_subscription(pubsub_t *pubsub, pubsub_subscription_t *subscription) {
+    pubsub_topic_t *topic = subscription->topic;
+    pubsub_subscriber_t *subscriber = subscription->subscriber;
+
+    if (subscription->topic_prev) {
+        subscription->topic_prev->topic_next = subscription->topic_next;
+    } else {
+        topic->subscriptions = subscription->topic_next;
+    }
+    if (subscription->topic_next) {
+        subscription->topic_next->topic_prev = subscription->topic_prev;
+    }
+
+    pubsub_subscription_t **link = &subscriber->subscriptions;
+    while (*link != subscription) {
+        link = &(*link)->subscriber_next;
+    }
+    *link = subscription->subscriber_next;
+
+    if (subscription->latest) {
+        pubsub_message_release(subscription->latest);
+    }
+    free(subscription);
+    topic->count--;
+    pubsub->stats.subscriptions--;
+    release_topic_if_empty(pubsub, topic);
+}
+
+// 写入一条消息
+static int deliver(pubsub_t *pubsub, pubsub_subscriber_t *subscriber, pubsub_message_t *message) {
+    subscriber->pending++;
+    if (pubsub->ops.write(subscriber->owner, message) != 0) {
+        subscriber->pending--;
+        pubsub->stats.dropped++;
+        return -1;
+    }
+    pubsub->stats.delivered++;
+    return 0;
+}
+
+pubsub_message_t* pubsub_message_create(char *data, size_t length) {
+    pubsub_message_t *message = malloc(sizeof(pubsub_message_t));
+    if (!message) {
+        free(data);
+        return NULL;
+    }
+    message->refcount = 1;
+    message->length = length;
+    message->data = data;
+    return message;
+}
+
+void pubsub_message_retain(pubsub_message_t *message) {
+    __atomic_fetch_add(&message->refcount, 1, __ATOMIC_RELAXED);
+}
+
+void pubsub_message_release(pubsub_message_t *message) {
+    if (message && __atomic_sub_fetch(&message->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(message->data);
+        free(message);
+    }
+}
+
+pubsub_t* pubsub_create(const pubsub_ops_t *ops, pubsub_policy_t policy, int max_pending) {
+    if (!ops || !ops->write || max_pending <= 0 ||
+        (policy == PUBSUB_POLICY_DISCONNECT && !ops->disconnect)) {
+        return NULL;
+    }
+
+    pubsub_t *pubsub = calloc(1, sizeof(pubsub_t));
+    if (!pubsub) {
+        return NULL;
+    }
+    pubsub->buckets = calloc(PUBSUB_INITIAL_BUCKETS, sizeof(pubsub_topic_t*));
+    if (!pubsub->buckets) {
+        free(pubsub);
+        return NULL;
+    }
+    pubsub->bucket_count = PUBSUB_INITIAL_BUCKETS;
+    pubsub->ops = *ops;
+    pubsub->policy = policy;
+    pubsub->max_pending = max_pending;
+    return pubsub;
+}
+
+void pubsub_destroy(pubsub_t *pubsub) {
+    if (!pubsub) {
+        return;
+    }
+    while (pubsub->subscribers) {
+        pubsub_subscriber_destroy(pubsub, pubsub->subscribers);
+    }
+    // 订阅者销毁后主题通常已释放，剩余的（例如在发布过程中销毁）一并释放
+    for (size_t i = 0; i < pubsub->bucket_count; i++) {
+        pubsub_topic_t *topic = pubsub->buckets[i];
+        while (topic) {
+            pubsub_topic_t *next = topic->hash_next;
+            free(topic);
+            topic = next;
+        }
+    }
+    free(pubsub->buckets);
+    free(pubsub);
+}
+
+pubsub_subscriber_t* pubsub_subscriber_create(pubsub_t *pubsub, void *owner) {
+    if (!pubsub) {
+        return NULL;
+    }
+    pubsub_subscriber_t *subscriber = calloc(1, sizeof(pubsub_subscriber_t));
+    if (!subscriber) {
+        return NULL;
+    }
+    subscriber->owner = owner;
+    subscriber->next = pubsub->subscribers;
+    if (pubsub->subscribers) {
+        pubsub->subscribers->prev = subscriber;
+    }
+    pubsub->subscribers = subscriber;
+    return subscriber;
+}
+
+void pubsub_subscriber_destroy(pubsub_t *pubsub, pubsub_subscriber_t *subscriber) {
+    if (!pubsub || !subscriber) {
+        return;
+    }
+    while (subscriber->subscriptions) {
+        remove_subscription(pubsub, subscriber->subscriptions);
+    }
+    if (subscriber->prev) {
+        subscriber->prev->next = subscriber->next;
+    } else {
+        pubsub->subscribers = subscriber->next;
+    }
+    if (subscriber->next) {
+        subscriber->next->prev = subscriber->prev;
+    }
+    free(subscriber);
+}
+
+int pubsub_subscribe(pubsub_t *pubsub, pubsub_subscriber_t *subscriber, const char *topic) {
+    if (!pubsub || !subscriber || !topic || !*topic) {
+        return -1;
+    }
+    if (find_subscription(subscriber, topic)) {
+        return 0;
+    }
+
+    pubsub_topic_t *entry = get_or_create_topic(pubsub, topic);
+    if (!entry) {
+        return -1;
+    }
+    pubsub_subscription_t *subscription = calloc(1, sizeof(pubsub_subscription_t));
+    if (!subscription) {
+        release_topic_if_empty(pubsub, entry);
+        return -1;
+    }
+
+    subscription->topic = entry;
+    subscription->subscriber = subscriber;
+    subscription->topic_next = entry->subscriptions;
+    if (entry->subscriptions) {
+        entry->subscriptions->topic_prev = subscription;
+    }
+    entry->subscriptions = subscription;
+    entry->count++;
+    subscription->subscriber_next = subscriber->subscriptions;
+    subscriber->subscriptions = subscription;
+    pubsub->stats.subscriptions++;
+    return 0;
+}
+
+int pubsub_unsubscribe(pubsub_t *pubsub, pubsub_subscriber_t *subscriber, const char *topic) {
+    if (!pubsub || !subscriber || !topic) {
+        return -1;
+    }
+    pubsub_subscription_t *subscription = find_subscription(subscriber, topic);
+    if (!subscription) {
+        return -1;
+    }
+    remove_subscription(pubsub, subscription);
+    return 0;
+}
+
+int pubsub_publish(pubsub_t *pubsub, const char *topic, pubsub_message_t *message) {
+    if (!pubsub || !topic || !message) {
+        return -1;
+    }
+    pubsub->stats.published++;
+
+    pubsub_topic_t *entry = find_topic(pubsub, topic, topic_hash(topic));
+    if (!entry) {
+        return 0;
+    }
+
+    // 断开慢订阅者时所有者可能立即销毁订阅者，先取下一个订阅
+    int written = 0;
+    pubsub->publishing++;
+    for (pubsub_subscription_t *subscription = entry->subscriptions, *next; subscription; subscription = next) {
+        next = subscription->topic_next;
+        pubsub_subscriber_t *subscriber = subscription->subscriber;
+        if (subscriber->disconnected) {
+            continue;
+        }
+
+        if (subscriber->pending < pubsub->max_pending) {
+            written += deliver(pubsub, subscriber, message) == 0;
+            continue;
+        }
+
+        switch (pubsub->policy) {
+            case PUBSUB_POLICY_DROP:
+                pubsub->stats.dropped++;
+                break;
+            case PUBSUB_POLICY_COALESCE:
+                if (subscription->latest) {
+                    pubsub_message_release(subscription->latest);
+                    pubsub->stats.coalesced++;
+                }
+                pubsub_message_retain(message);
+                subscription->latest = message;
+                break;
+            case PUBSUB_POLICY_DISCONNECT:
+                subscriber->disconnected = 1;
+                pubsub->stats.disconnected++;
+                pubsub->ops.disconnect(subscriber->owner);
+                break;
+        }
+    }
+    // entry在发布过程中变空时已在empty_topics中
+    if (--pubsub->publishing == 0) {
+        release_empty_topics(pubsub);
+    }
+    return written;
+}
+
+void pubsub_write_complete(pubsub_t *pubsub, pubsub_subscriber_t *subscriber) {
+    if (!pubsub || !subscriber) {
+        return;
+    }
+    subscriber->pending--;
+    if (pubsub->policy != PUBSUB_POLICY_COALESCE || subscriber->disconnected) {
+        return;
+    }
+
+    // 补发合并保留的最新消息
+    for (pubsub_subscription_t *subscription = subscriber->subscriptions;
+         subscription && subscriber->pending < pubsub->max_pending;
+         subscription = subscription->subscriber_next) {
+        if (subscription->latest) {
+            pubsub_message_t *message = subscription->latest;
+            subscription->latest = NULL;
+            deliver(pubsub, subscriber, message);
+            pubsub_message_release(message);
+        }
+    }
+}
+
+int pubsub_parse_policy(const char *name, pubsub_policy_t *policy) {
+    if (!name || !policy) {
+        return -1;
+    }
+    if (strcmp(name, "drop") == 0) {
+        *policy = PUBSUB_POLICY_DROP;
+    } else if (strcmp(name, "coalesce") == 0) {
+        *policy = PUBSUB_POLICY_COALESCE;
+    } else if (strcmp(name, "disconnect") == 0) {
+        *policy = PUBSUB_POLICY_DISCONNECT;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+void pubsub_get_stats(const pubsub_t *pubsub, pubsub_stats_t *stats) {
+    if (pubsub && stats) {
+        *stats = pubsub->stats;
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef PUBSUB_H
+#define PUBSUB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 发布订阅
+// 维护主题到订阅者的映射并处理慢订阅者，与传输层无关：所有者（增强网络模块）为每个连接创建一个订阅者，
+// 通过pubsub_ops_t提供写入和断开操作。发布的消息只编码一次，按引用计数由全部订阅者共享。
+// 除消息的引用计数外，所有函数都在事件循环线程调用。
+
+// 订阅者未完成的写入达到上限时的处理方式
+typedef enum {
+    PUBSUB_POLICY_DROP = 0,         // 丢弃新消息
+    PUBSUB_POLICY_COALESCE,         // 每个主题只保留最新的一条，写入完成后补发
+    PUBSUB_POLICY_DISCONNECT        // 断开订阅者的连接
+} pubsub_policy_t;
+
+// 共享消息（已按连接的分帧格式编码）
+typedef struct {
+    int refcount;
+    size_t length;
+    char *data;
+} pubsub_message_t;
+
+// 所有者提供的操作，owner为创建订阅者时传入的指针
+typedef struct {
+    // 写入消息，写入期间由所有者持有消息的引用。成功返回0，写入结束（包括出错）后调用pubsub_write_complete；
+    // 返回-1表示没有发出，不调用pubsub_write_complete
+    int (*write)(void *owner, pubsub_message_t *message);
+    // 断开连接，订阅者在所有者释放连接时销毁
+    void (*disconnect)(void *owner);
+} pubsub_ops_t;
+
+// 统计
+typedef struct {
+    size_t topics;
+    size_t subscriptions;
+    uint64_t published;             // 发布次数
+    uint64_t delivered;             // 写入订阅者的消息数
+    uint64_t dropped;               // 因订阅者过慢或写入失败丢弃的消息数
+    uint64_t coalesced;             // 被更新的消息替换、未发出的消息数
+    uint64_t disconnected;          // 因过慢被断开的订阅者数
+} pubsub_stats_t;
+
+typedef struct pubsub pubsub_t;
+typedef struct pubsub_subscriber pubsub_subscriber_t;
+
+// 创建消息，data的所有权转移给消息，引用计数为1；失败时释放data并返回NULL
+pubsub_message_t* pubsub_message_create(char *data, size_t length);
+
+// 增加/减少引用，可以在任意线程调用，最后一个引用释放时释放消息
+void pubsub_message_retain(pubsub_message_t *message);
+void pubsub_message_release(pubsub_message_t *message);
+
+// 创建发布订阅，max_pending为每个订阅者未完成写入的上限
+pubsub_t* pubsub_create(const pubsub_ops_t *ops, pubsub_policy_t policy, int max_pending);
+
+// 销毁发布订阅及剩余的订阅者
+void pubsub_destroy(pubsub_t *pubsub);
+
+// 为连接创建订阅者
+pubsub_subscriber_t* pubsub_subscriber_create(pubsub_t *pubsub, void *owner);
+
+// 销毁订阅者，取消其全部订阅
+void pubsub_subscriber_destroy(pubsub_t *pubsub, pubsub_subscriber_t *subscriber);
+
+// 订阅主题，已订阅时也返回0，失败返回-1
+int pubsub_subscribe(pubsub_t *pubsub, pubsub_subscriber_t *subscriber, const char *topic);
+
+// 取消订阅，未订阅返回-1
+int pubsub_unsubscribe(pubsub_t *pubsub, pubsub_subscriber_t *subscriber, const char *topic);
+
+// 向主题发布消息，返回立即写入的订阅者数。调用者保留自己的引用
+int pubsub_publish(pubsub_t *pubsub, const char *topic, pubsub_message_t *message);
+
+// 订阅者的一次写入完成，未完成写入低于上限时补发合并保留的最新消息
+void pubsub_write_complete(pubsub_t *pubsub, pubsub_subscriber_t *subscriber);
+
+// 解析策略名称（drop、coalesce、disconnect），成功返回0
+int pubsub_parse_policy(const char *name, pubsub_policy_t *policy);
+
+// 获取统计
+void pubsub_get_stats(const pubsub_t *pubsub, pubsub_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PUBSUB_H
@@ -0,0 +1,172 @@
+#include "src/net/read_buffer_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define READ_BUFFER_TIERS 2
+
+// 缓冲区头部，数据紧跟其后（16字节，保持数据按16字节对齐）
+typedef struct buffer_header {
+    struct buffer_header *next; // 缓存在空闲链表中时的下一个缓冲区
+    size_t capacity;
+} buffer_header_t;
+
+struct read_buffer_pool {
+    size_t sizes[READ_BUFFER_TIERS];
+    buffer_header_t *free_lists[READ_BUFFER_TIERS];
+    size_t cached[READ_BUFFER_TIERS];
+    size_t max_cached;
+    read_buffer_pool_stats_t stats;
+};
+
+static buffer_header_t* header_of(const char *buffer) {
+    return (buffer_header_t*) buffer - 1;
+}
+
+static char* allocate_buffer(size_t capacity) {
+    buffer_header_t *header = malloc(sizeof(buffer_header_t) + capacity);
+    if (!header) {
+        return NULL;
+    }
+    header->next = NULL;
+    header->capacity = capacity;
+    return (char*) (header + 1);
+}
+
+// 容量对应的档位，不属于任何档位（超大缓冲区）返回-1
+static int tier_of(const read_buffer_pool_t *pool, size_t capacity) {
+    for (int tier = 0; tier < READ_BUFFER_TIERS; tier++) {
+        if (pool->sizes[tier] == capacity) {
+            return tier;
+        }
+    }
+    return -1;
+}
+
+read_buffer_pool_t* read_buffer_pool_create(size_t small_size, size_t large_size, size_t max_cached) {
+    if (small_size == 0 || small_size >= large_size) {
+        return NULL;
+    }
+
+    read_buffer_pool_t *pool = calloc(1, sizeof(read_buffer_pool_t));
+    if (!pool) {
+        return NULL;
+    }
+    pool->sizes[READ_BUFFER_SMALL] = small_size;
+    pool->sizes[READ_BUFFER_LARGE] = large_size;
+    pool->max_cached = max_cached;
+    return pool;
+}
+
+void read_buffer_pool_destroy(read_buffer_pool_t *pool) {
+    if (!pool) {
+        return;
+    }
+    for (int tier = 0; tier < READ_BUFFER_TIERS; tier++) {
+        buffer_header_t *header = pool->free_lists[tier];
+        while (header) {
+            buffer_header_t *next = header->next;
+            free(header);
+            header = next;
+        }
+    }
+    free(pool);
+}
+
+char* read_buffer_pool_get(read_buffer_pool_t *pool, read_buffer_tier_t tier) {
+    if (!pool || (unsigned) tier >= READ_BUFFER_TIERS) {
+        return NULL;
+    }
+
+    buffer_header_t *header = pool->free_lists[tier];
+    if (header) {
+        pool->free_lists[tier] = header->next;
+        pool->cached[tier]--;
+        pool->stats.cached--;
+        pool->stats.reused++;
+        header->next = NULL;
+        return (char*) (header + 1);
+    }
+
+    char *buffer = allocate_buffer(pool->sizes[tier]);
+    if (buffer) {
+        pool->stats.allocated++;
+    }
+    return buffer;
+}
+
+char* read_buffer_pool_grow(read_buffer_pool_t *pool, char *buffer, size_t used, size_t min_capacity) {
+    if (!pool) {
+        return NULL;
+    }
+
+    size_t capacity = buffer ? read_buffer_capacity(buffer) : 0;
+    if (buffer && capacity >= min_capacity) {
+        return buffer;
+    }
+
+    // 优先使用池中的档位，超过大缓冲区后按倍数增长
+    char *grown;
+    if (min_capacity <= pool->sizes[READ_BUFFER_SMALL]) {
+        grown = read_buffer_pool_get(pool, READ_BUFFER_SMALL);
+    } else if (min_capacity <= pool->sizes[READ_BUFFER_LARGE]) {
+        grown = read_buffer_pool_get(pool, READ_BUFFER_LARGE);
+    } else {
+        size_t new_capacity = capacity > pool->sizes[READ_BUFFER_LARGE] ? capacity : pool->sizes[READ_BUFFER_LARGE];
+        while (new_capacity < min_capacity) {
+            new_capacity *= 2;
+        }
+        grown = allocate_buffer(new_capacity);
+        if (grown) {
+            pool->stats.allocated++;
+        }
+    }
+    if (!grown) {
+        return NULL;
+    }
+
+    if (buffer) {
+        memcpy(grown, buffer, used);
+        read_buffer_pool_put(pool, buffer);
+    }
+    return grown;
+}
+
+void read_buffer_pool_put(read_buffer_pool_t *pool, char *buffer) {
+    if (!buffer) {
+        return;
+    }
+
+    buffer_header_t *header = header_of(buffer);
+    if (!pool) {
+        free(header);
+        return;
+    }
+
+    int tier = tier_of(pool, header->capacity);
+    if (tier < 0 || pool->cached[tier] >= pool->max_cached) {
+        free(header);
+        pool->stats.released++;
+        return;
+    }
+
+    // 最近归还的缓冲区最先复用，其内存更可能仍在缓存中
+    header->next = pool->free_lists[tier];
+    pool->free_lists[tier] = header;
+    pool->cached[tier]++;
+    pool->stats.cached++;
+}
+
+size_t read_buffer_capacity(const char *buffer) {
+    return buffer ? header_of(buffer)->capacity : 0;
+}
+
+void read_buffer_pool_get_stats(const read_buffer_pool_t *pool, read_buffer_pool_stats_t *stats) {
+    if (!stats) {
+        return;
+    }
+    if (!pool) {
+        memset(stats, 0, sizeof(read_buffer_pool_stats_t));
+        return;
+    }
+    *stats = pool->stats;
+}
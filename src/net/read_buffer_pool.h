@@ -0,0 +1,57 @@
+#ifndef READ_BUFFER_POOL_H
+#define READ_BUFFER_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 读缓冲池
+// 事件循环线程独占，不加锁。缓冲区分为两档：小缓冲区给空闲长连接读取下一个请求的开头，
+// 大缓冲区给正在接收较大请求的连接。释放的缓冲区按档缓存在空闲链表中复用，
+// 每档缓存数量有上限，超出的直接释放。超过大缓冲区尺寸的请求使用普通堆内存，归还时释放。
+
+typedef enum {
+    READ_BUFFER_SMALL = 0,
+    READ_BUFFER_LARGE = 1
+} read_buffer_tier_t;
+
+// 读缓冲池统计
+typedef struct {
+    uint64_t reused;            // 从空闲链表取得的次数
+    uint64_t allocated;         // 新分配的次数
+    uint64_t released;          // 超出缓存上限或超大而释放的次数
+    size_t cached;              // 当前缓存的缓冲区数
+} read_buffer_pool_stats_t;
+
+typedef struct read_buffer_pool read_buffer_pool_t;
+
+// 创建读缓冲池，small_size须小于large_size，max_cached为每档最多缓存的空闲缓冲区数
+read_buffer_pool_t* read_buffer_pool_create(size_t small_size, size_t large_size, size_t max_cached);
+
+// 释放缓冲池及其缓存的缓冲区，仍在使用中的缓冲区之后归还时需传入NULL
+void read_buffer_pool_destroy(read_buffer_pool_t *pool);
+
+// 取得一个指定档位的缓冲区，失败返回NULL
+char* read_buffer_pool_get(read_buffer_pool_t *pool, read_buffer_tier_t tier);
+
+// 把缓冲区扩展到至少min_capacity字节，保留前used字节的内容。
+// buffer为NULL时相当于取得新缓冲区。失败返回NULL，原缓冲区保持不变
+char* read_buffer_pool_grow(read_buffer_pool_t *pool, char *buffer, size_t used, size_t min_capacity);
+
+// 归还缓冲区（可为NULL）。pool为NULL时直接释放
+void read_buffer_pool_put(read_buffer_pool_t *pool, char *buffer);
+
+// 缓冲区的容量
+size_t read_buffer_capacity(const char *buffer);
+
+// 获取统计信息
+void read_buffer_pool_get_stats(const read_buffer_pool_t *pool, read_buffer_pool_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // READ_BUFFER_POOL_H
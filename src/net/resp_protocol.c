@@ -0,0 +1,297 @@
+#include "src/net/resp_protocol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RESP_INITIAL_BUFFER 64
+
+// 长度和参数数最多18位十进制数，避免溢出
+#define RESP_MAX_DIGITS 18
+
+// 一个参数至少占用的字节数（"$0\r\n\r\n"）
+#define RESP_MIN_ARG_SIZE 6
+
+// 解析以"\r\n"结尾的十进制整数，*next指向"\r\n"之后
+// 成功返回1，数据不完整返回0，格式错误返回-1
+static int parse_number(const char *p, const char *end, long long *value, const char **next) {
+    int negative = 0;
+    if (p < end && *p == '-') {
+        negative = 1;
+        p++;
+    }
+
+    long long number = 0;
+    int digits = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (++digits > RESP_MAX_DIGITS) {
+            return -1;
+        }
+        number = number * 10 + (*p - '0');
+        p++;
+    }
+    if (p == end) {
+        return 0;
+    }
+    if (digits == 0 || *p != '\r') {
+        return -1;
+    }
+    if (p + 1 == end) {
+        return 0;
+    }
+    if (p[1] != '\n') {
+        return -1;
+    }
+
+    *value = negative ? -number : number;
+    *next = p + 2;
+    return 1;
+}
+
+static int is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+ssize_t resp_decode_command(const char *data, size_t length, const char **payload, size_t *payload_length,
+                            void *user_data) {
+    size_t limit = user_data ? *(const size_t*) user_data : 0;
+    const char *end = data + length;
+    const char *start = data;
+
+    for (;;) {
+        while (start < end && (*start == '\r' || *start == '\n')) {
+            start++;
+        }
+        if (start == end) {
+            return 0;
+        }
+        if (*start == '*') {
+            break;
+        }
+
+        // 内联命令到换行为止，只有空白的行跳过
+        const char *newline = memchr(start, '\n', (size_t) (end - start));
+        if (!newline) {
+            return 0;
+        }
+        const char *p = start;
+        while (p < newline && is_space(*p)) {
+            p++;
+        }
+        if (p < newline) {
+            *payload = start;
+            *payload_length = (size_t) (newline + 1 - start);
+            return newline + 1 - data;
+        }
+        start = newline + 1;
+    }
+
+    // 批量字符串数组
+    long long count;
+    const char *p;
+    int result = parse_number(start + 1, end, &count, &p);
+    if (result <= 0) {
+        return result;
+    }
+    if (count < 1 || count > RESP_MAX_ARGS) {
+        return -1;
+    }
+    if (limit && (size_t) count > limit / RESP_MIN_ARG_SIZE) {
+        return -1;
+    }
+
+    for (long long i = 0; i < count; i++) {
+        if (p == end) {
+            return 0;
+        }
+        if (*p != '$') {
+            return -1;
+        }
+        long long arg_length;
+        result = parse_number(p + 1, end, &arg_length, &p);
+        if (result <= 0) {
+            return result;
+        }
+        if (arg_length < 0) {
+            return -1;
+        }
+        // 声明的长度超过单帧上限时不再缓存后续数据
+        if (limit && ((size_t) (p - data) > limit || (size_t) arg_length + 2 > limit - (size_t) (p - data))) {
+            return -1;
+        }
+        if ((size_t) (end - p) < (size_t) arg_length + 2) {
+            return 0;
+        }
+        if (p[arg_length] != '\r' || p[arg_length + 1] != '\n') {
+            return -1;
+        }
+        p += arg_length + 2;
+    }
+
+    *payload = start;
+    *payload_length = (size_t) (p - start);
+    return p - data;
+}
+
+// 追加一个参数，超过内嵌数组时改用堆上的数组
+static int push_arg(resp_command_t *command, size_t *capacity, const char *data, size_t length) {
+    if (command->argc == *capacity) {
+        size_t new_capacity = *capacity * 2;
+        resp_arg_t *argv = malloc(new_capacity * sizeof(resp_arg_t));
+        if (!argv) {
+            return -1;
+        }
+        memcpy(argv, command->argv, command->argc * sizeof(resp_arg_t));
+        if (command->argv != command->inline_args) {
+            free(command->argv);
+        }
+        command->argv = argv;
+        *capacity = new_capacity;
+    }
+    command->argv[command->argc].data = data;
+    command->argv[command->argc].length = length;
+    command->argc++;
+    return 0;
+}
+
+int resp_command_parse(resp_command_t *command, const char *data, size_t length) {
+    command->argc = 0;
+    command->argv = command->inline_args;
+    size_t capacity = RESP_INLINE_ARGS;
+    const char *end = data + length;
+
+    if (length > 0 && data[0] == '*') {
+        // 格式已由resp_decode_command检查
+        long long count;
+        const char *p;
+        if (parse_number(data + 1, end, &count, &p) != 1 || count < 1) {
+            return -1;
+        }
+        if ((size_t) count > capacity) {
+            command->argv = malloc((size_t) count * sizeof(resp_arg_t));
+            if (!command->argv) {
+                command->argv = command->inline_args;
+                return -1;
+            }
+            capacity = (size_t) count;
+        }
+        for (long long i = 0; i < count; i++) {
+            long long arg_length;
+            if (p == end || *p != '$' || parse_number(p + 1, end, &arg_length, &p) != 1 ||
+                arg_length < 0 || (size_t) (end - p) < (size_t) arg_length + 2) {
+                resp_command_free(command);
+                return -1;
+            }
+            push_arg(command, &capacity, p, (size_t) arg_length);
+            p += arg_length + 2;
+        }
+        return 0;
+    }
+
+    // 内联命令按空白拆分
+    const char *p = data;
+    while (p < end) {
+        while (p < end && is_space(*p)) {
+            p++;
+        }
+        const char *arg = p;
+        while (p < end && !is_space(*p)) {
+            p++;
+        }
+        if (p > arg && push_arg(command, &capacity, arg, (size_t) (p - arg)) != 0) {
+            resp_command_free(command);
+            return -1;
+        }
+    }
+    return command->argc > 0 ? 0 : -1;
+}
+
+void resp_command_free(resp_command_t *command) {
+    if (command->argv != command->inline_args) {
+        free(command->argv);
+    }
+    command->argv = command->inline_args;
+    command->argc = 0;
+}
+
+void resp_buffer_init(resp_buffer_t *buffer) {
+    memset(buffer, 0, sizeof(resp_buffer_t));
+}
+
+// 预留空间，失败时置failed
+static int reserve(resp_buffer_t *buffer, size_t extra) {
+    if (buffer->failed) {
+        return -1;
+    }
+    if (buffer->length + extra <= buffer->capacity) {
+        return 0;
+    }
+
+    size_t capacity = buffer->capacity ? buffer->capacity * 2 : RESP_INITIAL_BUFFER;
+    while (capacity < buffer->length + extra) {
+        capacity *= 2;
+    }
+    char *data = realloc(buffer->data, capacity);
+    if (!data) {
+        buffer->failed = 1;
+        return -1;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+static void append_raw(resp_buffer_t *buffer, const char *data, size_t length) {
+    if (reserve(buffer, length) == 0) {
+        memcpy(buffer->data + buffer->length, data, length);
+        buffer->length += length;
+    }
+}
+
+// 追加"<prefix><number>\r\n"
+static void append_header(resp_buffer_t *buffer, char prefix, long long number) {
+    char header[32];
+    int length = snprintf(header, sizeof(header), "%c%lld\r\n", prefix, number);
+    append_raw(buffer, header, (size_t) length);
+}
+
+void resp_append_simple(resp_buffer_t *buffer, const char *text) {
+    append_raw(buffer, "+", 1);
+    append_raw(buffer, text, strlen(text));
+    append_raw(buffer, "\r\n", 2);
+}
+
+void resp_append_error(resp_buffer_t *buffer, const char *message) {
+    append_raw(buffer, "-", 1);
+    append_raw(buffer, message, strlen(message));
+    append_raw(buffer, "\r\n", 2);
+}
+
+void resp_append_integer(resp_buffer_t *buffer, int64_t value) {
+    append_header(buffer, ':', (long long) value);
+}
+
+void resp_append_bulk(resp_buffer_t *buffer, const char *data, size_t length) {
+    append_header(buffer, '$', (long long) length);
+    append_raw(buffer, data, length);
+    append_raw(buffer, "\r\n", 2);
+}
+
+void resp_append_null(resp_buffer_t *buffer) {
+    append_raw(buffer, "$-1\r\n", 5);
+}
+
+void resp_append_array(resp_buffer_t *buffer, size_t count) {
+    append_header(buffer, '*', (long long) count);
+}
+
+char* resp_buffer_finish(resp_buffer_t *buffer, size_t *length) {
+    if (buffer->failed || !buffer->data) {
+        free(buffer->data);
+        resp_buffer_init(buffer);
+        return NULL;
+    }
+    char *data = buffer->data;
+    *length = buffer->length;
+    resp_buffer_init(buffer);
+    return data;
+}
@@ -0,0 +1,68 @@
+#ifndef RESP_PROTOCOL_H
+#define RESP_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Redis序列化协议（RESP2）
+// 请求是批量字符串数组（*<参数数>\r\n，每个参数为$<长度>\r\n<内容>\r\n），
+// 也接受以换行结尾、参数以空白分隔的内联命令（便于telnet调试）。
+// resp_decode_command作为分帧格式的自定义解码函数，一帧是一条完整的命令；
+// 回复按RESP2编码写入resp_buffer_t。本文件不依赖其他模块。
+
+#define RESP_MAX_ARGS (1024 * 1024)
+#define RESP_INLINE_ARGS 16
+
+// 命令参数，指向帧数据，只在帧有效期间有效
+typedef struct {
+    const char *data;
+    size_t length;
+} resp_arg_t;
+
+// 解析出的命令
+typedef struct {
+    size_t argc;
+    resp_arg_t *argv;                       // 参数较少时指向inline_args
+    resp_arg_t inline_args[RESP_INLINE_ARGS];
+} resp_command_t;
+
+// 回复缓冲区
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+    int failed;                             // 曾经内存不足，内容不完整
+} resp_buffer_t;
+
+// 分帧解码函数（frame_decode_fn）：查找第一条完整的命令，payload为整条命令
+// 数据不完整返回0，格式错误返回-1。命令之前的空行一并跳过。
+// user_data不为NULL时指向单帧上限（size_t），声明的参数数或长度超过上限时立即返回-1，不等待数据到齐
+ssize_t resp_decode_command(const char *data, size_t length, const char **payload, size_t *payload_length,
+                            void *user_data);
+
+// 把resp_decode_command给出的一条命令拆成参数，成功返回0，之后调用resp_command_free
+int resp_command_parse(resp_command_t *command, const char *data, size_t length);
+void resp_command_free(resp_command_t *command);
+
+// 回复编码，内存不足时置failed，之后的追加不再生效
+void resp_buffer_init(resp_buffer_t *buffer);
+void resp_append_simple(resp_buffer_t *buffer, const char *text);             // +<text>
+void resp_append_error(resp_buffer_t *buffer, const char *message);           // -<message>
+void resp_append_integer(resp_buffer_t *buffer, int64_t value);               // :<value>
+void resp_append_bulk(resp_buffer_t *buffer, const char *data, size_t length); // $<length> <data>
+void resp_append_null(resp_buffer_t *buffer);                                 // $-1
+void resp_append_array(resp_buffer_t *buffer, size_t count);                  // *<count>，随后追加count个元素
+
+// 取出编码好的回复（malloc分配，所有权交给调用者），内存不足返回NULL并释放缓冲区
+char* resp_buffer_finish(resp_buffer_t *buffer, size_t *length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RESP_PROTOCOL_H
@@ -0,0 +1,216 @@
+#include "src/net/resp_server.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// 64位整数参数的最大长度
+#define MAX_INTEGER_ARG 20
+
+// 过期时间上限（毫秒），避免换算和相加时溢出
+#define MAX_EXPIRE_MS (INT64_MAX / 4)
+
+typedef void (*resp_handler_fn)(kv_store_t *store, const resp_command_t *command, uint64_t now,
+                                resp_buffer_t *reply);
+
+// 命令定义，arity为参数个数（含命令名），负数表示至少-arity个
+typedef struct {
+    const char *name;
+    int arity;
+    resp_handler_fn handler;
+} resp_command_def_t;
+
+// 解析整数参数（不允许空白），成功返回0
+static int parse_integer_arg(const resp_arg_t *arg, int64_t *value) {
+    if (arg->length == 0 || arg->length > MAX_INTEGER_ARG) {
+        return -1;
+    }
+    char text[MAX_INTEGER_ARG + 1];
+    memcpy(text, arg->data, arg->length);
+    text[arg->length] = '\0';
+    if (text[0] != '-' && (text[0] < '0' || text[0] > '9')) {
+        return -1;
+    }
+
+    char *end;
+    errno = 0;
+    long long number = strtoll(text, &end, 10);
+    if (errno != 0 || *end != '\0') {
+        return -1;
+    }
+    *value = (int64_t) number;
+    return 0;
+}
+
+static int arg_equals(const resp_arg_t *arg, const char *name) {
+    size_t length = strlen(name);
+    return arg->length == length && strncasecmp(arg->data, name, length) == 0;
+}
+
+// 值写入回复（在存储的分片锁内调用）
+static void append_value(const char *value, size_t length, void *arg) {
+    resp_append_bulk((resp_buffer_t*) arg, value, length);
+}
+
+static void command_ping(kv_store_t *store, const resp_command_t *command, uint64_t now, resp_buffer_t *reply) {
+    (void)store; // 避免未使用参数警告
+    (void)now; // 避免未使用参数警告
+    if (command->argc > 2) {
+        resp_append_error(reply, "ERR wrong number of arguments for 'ping' command");
+    } else if (command->argc == 2) {
+        resp_append_bulk(reply, command->argv[1].data, command->argv[1].length);
+    } else {
+        resp_append_simple(reply, "PONG");
+    }
+}
+
+static void command_get(kv_store_t *store, const resp_command_t *command, uint64_t now, resp_buffer_t *reply) {
+    const resp_arg_t *key = &command->argv[1];
+    if (!kv_store_get(store, key->data, key->length, now, append_value, reply)) {
+        resp_append_null(reply);
+    }
+}
+
+// SET key value [EX seconds|PX milliseconds] [NX|XX]
+static void command_set(kv_store_t *store, const resp_command_t *command, uint64_t now, resp_buffer_t *reply) {
+    int64_t ttl_ms = 0;
+    int flags = 0;
+    int has_expire = 0;
+    for (size_t i = 3; i < command->argc; i++) {
+        const resp_arg_t *option = &command->argv[i];
+        if ((arg_equals(option, "EX") || arg_equals(option, "PX")) && !has_expire && i + 1 < command->argc) {
+            int64_t value;
+            int64_t scale = arg_equals(option, "EX") ? 1000 : 1;
+            if (parse_integer_arg(&command->argv[++i], &value) != 0) {
+                resp_append_error(reply, "ERR value is not an integer or out of range");
+                return;
+            }
+            if (value <= 0 || value > MAX_EXPIRE_MS / scale) {
+                resp_append_error(reply, "ERR invalid expire time in 'set' command");
+                return;
+            }
+            ttl_ms = value * scale;
+            has_expire = 1;
+        } else if (arg_equals(option, "NX") && !(flags & KV_SET_XX)) {
+            flags |= KV_SET_NX;
+        } else if (arg_equals(option, "XX") && !(flags & KV_SET_NX)) {
+            flags |= KV_SET_XX;
+        } else {
+            resp_append_error(reply, "ERR syntax error");
+            return;
+        }
+    }
+
+    const resp_arg_t *key = &command->argv[1];
+    const resp_arg_t *value = &command->argv[2];
+    int result = kv_store_set(store, key->data, key->length, value->data, value->length, ttl_ms, flags, now);
+    if (result > 0) {
+        resp_append_simple(reply, "OK");
+    } else if (result == 0) {
+        resp_append_null(reply);
+    } else {
+        resp_append_error(reply, "OOM command not allowed when used memory > 'maxmemory'");
+    }
+}
+
+static void command_del(kv_store_t *store, const resp_command_t *command, uint64_t now, resp_buffer_t *reply) {
+    int64_t removed = 0;
+    for (size_t i = 1; i < command->argc; i++) {
+        removed += kv_store_del(store, command->argv[i].data, command->argv[i].length, now);
+    }
+    resp_append_integer(reply, removed);
+}
+
+static void command_expire(kv_store_t *store, const resp_command_t *command, uint64_t now, resp_buffer_t *reply) {
+    int64_t seconds;
+    if (parse_integer_arg(&command->argv[2], &seconds) != 0) {
+        resp_append_error(reply, "ERR value is not an integer or out of range");
+        return;
+    }
+    if (seconds > MAX_EXPIRE_MS / 1000) {
+        resp_append_error(reply, "ERR invalid expire time in 'expire' command");
+        return;
+    }
+    const resp_arg_t *key = &command->argv[1];
+    resp_append_integer(reply, kv_store_expire(store, key->data, key->length, seconds * 1000, now));
+}
+
+static void command_ttl(kv_store_t *store, const resp_command_t *command, uint64_t now, resp_buffer_t *reply) {
+    const resp_arg_t *key = &command->argv[1];
+    int64_t ttl = kv_store_ttl(store, key->data, key->length, now);
+    resp_append_integer(reply, ttl < 0 ? ttl : (ttl + 500) / 1000);
+}
+
+static void command_mget(kv_store_t *store, const resp_command_t *command, uint64_t now, resp_buffer_t *reply) {
+    resp_append_array(reply, command->argc - 1);
+    for (size_t i = 1; i < command->argc; i++) {
+        if (!kv_store_get(store, command->argv[i].data, command->argv[i].length, now, append_value, reply)) {
+            resp_append_null(reply);
+        }
+    }
+}
+
+static void command_incr(kv_store_t *store, const resp_command_t *command, uint64_t now, resp_buffer_t *reply) {
+    const resp_arg_t *key = &command->argv[1];
+    int64_t value;
+    int result = kv_store_incr(store, key->data, key->length, 1, now, &value);
+    if (result == 0) {
+        resp_append_integer(reply, value);
+    } else if (result == KV_ERROR_NOT_INTEGER) {
+        resp_append_error(reply, "ERR value is not an integer or out of range");
+    } else if (result == KV_ERROR_OVERFLOW) {
+        resp_append_error(reply, "ERR increment or decrement would overflow");
+    } else {
+        resp_append_error(reply, "OOM command not allowed when used memory > 'maxmemory'");
+    }
+}
+
+static const resp_command_def_t commands[] = {
+    { "ping", -1, command_ping },
+    { "get", 2, command_get },
+    { "set", -3, command_set },
+    { "del", -2, command_del },
+    { "expire", 3, command_expire },
+    { "ttl", 2, command_ttl },
+    { "mget", -2, command_mget },
+    { "incr", 2, command_incr }
+};
+
+static const resp_command_def_t* find_command(const resp_arg_t *name) {
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        if (arg_equals(name, commands[i].name)) {
+            return &commands[i];
+        }
+    }
+    return NULL;
+}
+
+char* resp_execute(kv_store_t *store, const char *data, size_t length, uint64_t now, size_t *reply_length) {
+    resp_buffer_t reply;
+    resp_buffer_init(&reply);
+
+    resp_command_t command;
+    if (resp_command_parse(&command, data, length) != 0) {
+        resp_append_error(&reply, "ERR Protocol error");
+        return resp_buffer_finish(&reply, reply_length);
+    }
+
+    const resp_arg_t *name = &command.argv[0];
+    const resp_command_def_t *def = find_command(name);
+    char message[128];
+    if (!def) {
+        snprintf(message, sizeof(message), "ERR unknown command '%.*s'",
+                 (int) (name->length > 64 ? 64 : name->length), name->data);
+        resp_append_error(&reply, message);
+    } else if ((def->arity > 0 && command.argc != (size_t) def->arity) ||
+               (def->arity < 0 && command.argc < (size_t) -def->arity)) {
+        snprintf(message, sizeof(message), "ERR wrong number of arguments for '%s' command", def->name);
+        resp_append_error(&reply, message);
+    } else {
+        def->handler(store, &command, now, &reply);
+    }
+
+    resp_command_free(&command);
+    return resp_buffer_finish(&reply, reply_length);
+}
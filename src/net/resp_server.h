@@ -0,0 +1,26 @@
+#ifndef RESP_SERVER_H
+#define RESP_SERVER_H
+
+#include "src/net/resp_protocol.h"
+#include "src/db/kv_store.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// RESP命令执行
+// 增强网络模块以RESP协议运行时（enhanced_network_protocol=resp），每条命令在事件循环线程对键值存储执行。
+// 支持的命令：PING、GET、SET（EX/PX/NX/XX选项）、DEL、EXPIRE、TTL、MGET、INCR，
+// 回复格式和错误信息与Redis一致，可以直接使用redis-cli、redis-benchmark等工具。
+
+// 执行一条命令（resp_decode_command给出的整条命令），now为当前时刻（毫秒，与存储使用同一时钟）
+// 返回编码好的回复（malloc分配），内存不足返回NULL
+char* resp_execute(kv_store_t *store, const char *data, size_t length, uint64_t now, size_t *reply_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RESP_SERVER_H
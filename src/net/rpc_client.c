@@ -0,0 +1,574 @@
+#include "src/net/rpc_client.h"
+#include "src/net/frame_codec.h"
+#include "src/log/logger_module.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RPC_CLIENT_BUFFER_SIZE (64 * 1024)
+#define RPC_CLIENT_INITIAL_BUCKETS 64
+
+// 连接状态
+typedef enum {
+    CONN_IDLE = 0,              // 没有连接
+    CONN_CONNECTING,
+    CONN_CONNECTED,
+    CONN_CLOSING                // 等待句柄关闭，期间提交的调用在重新连接后发送
+} conn_state_t;
+
+// 未完成的调用
+typedef struct rpc_client_call {
+    uint32_t id;
+    uint64_t deadline;                  // 超时时刻（uv_now，毫秒）
+    rpc_client_callback_t callback;
+    void *user_data;
+    char *frame;                        // 尚未发送的请求帧，发送后为NULL
+    size_t frame_length;
+    struct rpc_client_call *prev;       // 按超时时刻排列的链表
+    struct rpc_client_call *next;
+    struct rpc_client_call *hash_next;  // 按ID查找的哈希链
+} rpc_client_call_t;
+
+// 写入请求，持有请求帧
+typedef struct {
+    uv_write_t req;
+    char *frame;
+} rpc_write_t;
+
+// 客户端
+struct rpc_client {
+    uv_loop_t *loop;
+    rpc_client_config_t config;
+    char host[64];
+    int port;
+    struct sockaddr_storage addr;
+    uv_tcp_t tcp;
+    uv_connect_t connect_req;
+    uv_timer_t timer;                   // 调用超时和连接超时
+    conn_state_t state;
+    uint64_t connect_deadline;
+    int connect_failed;                 // 发起连接失败，由定时器通知等待中的调用
+    int protocol_error;
+    frame_decoder_t *decoder;
+    rpc_client_call_t *head;            // 未完成的调用，按超时时刻排列
+    rpc_client_call_t *tail;
+    rpc_client_call_t **buckets;
+    size_t bucket_count;
+    size_t call_count;
+    uint32_t next_id;
+    int handle_count;                   // 未关闭的句柄数
+    int destroyed;
+};
+
+// 默认配置
+static const rpc_client_config_t default_config = {
+    .connect_timeout_ms = 5000,
+    .default_timeout_ms = 5000,
+    .max_frame_size = 1024 * 1024
+};
+
+// 内部函数声明
+static void start_connect(rpc_client_t *client);
+static void arm_timer(rpc_client_t *client);
+
+// 扩大哈希表，失败时继续使用原表
+static void grow_buckets(rpc_client_t *client) {
+    size_t count = client->bucket_count * 2;
+    rpc_client_call_t **buckets = calloc(count, sizeof(rpc_client_call_t*));
+    if (!buckets) {
+        return;
+    }
+
+    for (size_t i = 0; i < client->bucket_count; i++) {
+        rpc_client_call_t *call = client->buckets[i];
+        while (call) {
+            rpc_client_call_t *next = call->hash_next;
+            size_t bucket = call->id & (count - 1);
+            call->hash_next = buckets[bucket];
+            buckets[bucket] = call;
+            call = next;
+        }
+    }
+    free(client->buckets);
+    client->buckets = buckets;
+    client->bucket_count = count;
+}
+
+// 有未完成的调用时连接保持事件循环运行，空闲连接不阻止事件循环退出
+static void update_ref(rpc_client_t *client) {
+    if (client->state == CONN_IDLE) {
+        return;
+    }
+    if (client->call_count > 0) {
+        uv_ref((uv_handle_t*) &client->tcp);
+    } else {
+        uv_unref((uv_handle_t*) &client->tcp);
+    }
+}
+
+// 加入未完成的调用，链表按超时时刻插入（通常直接追加到末尾）
+static void add_call(rpc_client_t *client, rpc_client_call_t *call) {
+    if (client->call_count >= client->bucket_count * 2) {
+        grow_buckets(client);
+    }
+    size_t bucket = call->id & (client->bucket_count - 1);
+    call->hash_next = client->buckets[bucket];
+    client->buckets[bucket] = call;
+
+    rpc_client_call_t *after = client->tail;
+    while (after && after->deadline > call->deadline) {
+        after = after->prev;
+    }
+    call->prev = after;
+    call->next = after ? after->next : client->head;
+    if (call->next) {
+        call->next->prev = call;
+    } else {
+        client->tail = call;
+    }
+    if (after) {
+        after->next = call;
+    } else {
+        client->head = call;
+    }
+
+    client->call_count++;
+    update_ref(client);
+}
+
+static rpc_client_call_t* find_call(rpc_client_t *client, uint32_t id) {
+    rpc_client_call_t *call = client->buckets[id & (client->bucket_count - 1)];
+    while (call && call->id != id) {
+        call = call->hash_next;
+    }
+    return call;
+}
+
+static void remove_call(rpc_client_t *client, rpc_client_call_t *call) {
+    rpc_client_call_t **link = &client->buckets[call->id & (client->bucket_count - 1)];
+    while (*link != call) {
+        link = &(*link)->hash_next;
+    }
+    *link = call->hash_next;
+
+    if (call->prev) {
+        call->prev->next = call->next;
+    } else {
+        client->head = call->next;
+    }
+    if (call->next) {
+        call->next->prev = call->prev;
+    } else {
+        client->tail = call->prev;
+    }
+
+    client->call_count--;
+    update_ref(client);
+}
+
+// 完成调用并释放，回调在释放之后执行，回调中可以发起新的调用
+static void complete_call(rpc_client_t *client, rpc_client_call_t *call, int status,
+                          const char *body, size_t body_length) {
+    remove_call(client, call);
+    rpc_client_callback_t callback = call->callback;
+    void *user_data = call->user_data;
+    free(call->frame);
+    free(call);
+
+    if (callback) {
+        callback(status, body, body_length, user_data);
+    }
+}
+
+// 以status结束调用。only_sent为1时只结束已发送的调用，未发送的在重新连接后发送。
+// 先全部摘下再回调，回调中发起的新调用不受影响
+static void fail_calls(rpc_client_t *client, int status, int only_sent) {
+    rpc_client_call_t *failed = NULL;
+    rpc_client_call_t *call = client->head;
+    while (call) {
+        rpc_client_call_t *next = call->next;
+        if (!only_sent || !call->frame) {
+            remove_call(client, call);
+            call->next = failed;
+            failed = call;
+        }
+        call = next;
+    }
+
+    while (failed) {
+        rpc_client_call_t *next = failed->next;
+        if (failed->callback) {
+            failed->callback(status, NULL, 0, failed->user_data);
+        }
+        free(failed->frame);
+        free(failed);
+        failed = next;
+    }
+}
+
+// 所有句柄关闭后释放客户端
+static void maybe_free_client(rpc_client_t *client) {
+    if (client->destroyed && client->handle_count == 0) {
+        free(client->buckets);
+        free(client);
+    }
+}
+
+// 定时器关闭回调
+static void on_timer_close(uv_handle_t *handle) {
+    rpc_client_t *client = (rpc_client_t*) handle->data;
+    client->handle_count--;
+    maybe_free_client(client);
+}
+
+// 连接关闭回调：在该连接上已发送的调用收不到响应，按断开结束；关闭期间提交的调用重新连接后发送
+static void on_tcp_close(uv_handle_t *handle) {
+    rpc_client_t *client = (rpc_client_t*) handle->data;
+    frame_decoder_destroy(client->decoder);
+    client->decoder = NULL;
+    client->state = CONN_IDLE;
+    client->handle_count--;
+
+    if (client->destroyed) {
+        maybe_free_client(client);
+        return;
+    }
+
+    fail_calls(client, RPC_STATUS_UNAVAILABLE, 1);
+    if (!client->destroyed && client->state == CONN_IDLE && client->head) {
+        start_connect(client);
+    }
+}
+
+// 关闭连接
+static void close_connection(rpc_client_t *client) {
+    if (client->state == CONN_IDLE || client->state == CONN_CLOSING) {
+        return;
+    }
+    client->state = CONN_CLOSING;
+    uv_close((uv_handle_t*) &client->tcp, on_tcp_close);
+}
+
+// 写入完成回调
+static void on_write(uv_write_t *req, int status) {
+    rpc_write_t *write = (rpc_write_t*) req;
+    if (status && status != UV_ECANCELED) {
+        log_warn("RPC客户端发送请求失败: %s", uv_strerror(status));
+    }
+    free(write->frame);
+    free(write);
+}
+
+// 发送调用的请求帧，失败时保留请求帧并关闭连接，重新连接后再发送
+static void send_call(rpc_client_t *client, rpc_client_call_t *call) {
+    rpc_write_t *write = malloc(sizeof(rpc_write_t));
+    if (!write) {
+        close_connection(client);
+        return;
+    }
+
+    uv_buf_t buf = uv_buf_init(call->frame, (unsigned int) call->frame_length);
+    write->frame = call->frame;
+    if (uv_write(&write->req, (uv_stream_t*) &client->tcp, &buf, 1, on_write) != 0) {
+        free(write);
+        close_connection(client);
+        return;
+    }
+    call->frame = NULL;
+}
+
+// 一批响应帧
+static int on_frames(const frame_t *frames, size_t count, void *arg) {
+    rpc_client_t *client = (rpc_client_t*) arg;
+
+    for (size_t i = 0; i < count; i++) {
+        // 回调中销毁了客户端
+        if (client->state != CONN_CONNECTED) {
+            return 1;
+        }
+
+        rpc_header_t header;
+        if (rpc_header_decode(frames[i].data, frames[i].length, &header) != 0 ||
+            header.type != RPC_TYPE_RESPONSE) {
+            client->protocol_error = 1;
+            return 1;
+        }
+
+        // 已超时的调用不再等待，迟到的响应直接丢弃
+        rpc_client_call_t *call = find_call(client, header.request_id);
+        if (call) {
+            complete_call(client, call, (int) header.value,
+                          frames[i].data + RPC_HEADER_SIZE, frames[i].length - RPC_HEADER_SIZE);
+        }
+    }
+    return 0;
+}
+
+// 读取缓冲区分配：直接读入分帧缓冲区
+static void on_alloc(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
+    rpc_client_t *client = (rpc_client_t*) handle->data;
+    (void)suggested_size; // 避免未使用参数警告
+
+    size_t length;
+    frame_decoder_get_write_buffer(client->decoder, &buf->base, &length);
+    buf->len = length;
+}
+
+// 读取回调
+static void on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+    rpc_client_t *client = (rpc_client_t*) stream->data;
+    (void)buf; // 数据已位于分帧缓冲区中
+
+    if (nread > 0) {
+        if (frame_decoder_commit(client->decoder, (size_t) nread, on_frames, client) < 0 ||
+            client->protocol_error) {
+            log_warn("RPC客户端收到格式错误的响应，关闭连接 %s:%d", client->host, client->port);
+            client->protocol_error = 0;
+            close_connection(client);
+        }
+    } else if (nread < 0) {
+        if (nread != UV_EOF) {
+            log_warn("RPC客户端读取错误: %s", uv_err_name(nread));
+        }
+        close_connection(client);
+    }
+}
+
+// 连接完成回调
+static void on_connect(uv_connect_t *req, int status) {
+    rpc_client_t *client = (rpc_client_t*) req->data;
+
+    // 连接超时或客户端销毁时句柄已被关闭
+    if (status == UV_ECANCELED || client->state != CONN_CONNECTING) {
+        return;
+    }
+
+    if (status != 0) {
+        log_warn("RPC客户端连接 %s:%d 失败: %s", client->host, client->port, uv_strerror(status));
+        close_connection(client);
+        fail_calls(client, RPC_STATUS_UNAVAILABLE, 0);
+        return;
+    }
+
+    client->state = CONN_CONNECTED;
+    uv_tcp_nodelay(&client->tcp, 1);
+    if (uv_read_start((uv_stream_t*) &client->tcp, on_alloc, on_read) != 0) {
+        close_connection(client);
+        return;
+    }
+
+    // 发送连接建立前提交的调用
+    for (rpc_client_call_t *call = client->head; call && client->state == CONN_CONNECTED; call = call->next) {
+        if (call->frame) {
+            send_call(client, call);
+        }
+    }
+    arm_timer(client);
+}
+
+// 发起连接
+static void start_connect(rpc_client_t *client) {
+    frame_codec_t codec = {
+        .type = FRAME_CODEC_LENGTH_PREFIXED,
+        .length_field_size = RPC_LENGTH_FIELD_SIZE,
+        .max_frame_size = client->config.max_frame_size
+    };
+    client->decoder = frame_decoder_create(&codec, RPC_CLIENT_BUFFER_SIZE);
+    if (!client->decoder || uv_tcp_init(client->loop, &client->tcp) != 0) {
+        frame_decoder_destroy(client->decoder);
+        client->decoder = NULL;
+        client->connect_failed = 1;
+        arm_timer(client);
+        return;
+    }
+    client->tcp.data = client;
+    client->handle_count++;
+    client->state = CONN_CONNECTING;
+    client->connect_deadline = uv_now(client->loop) + (uint64_t) client->config.connect_timeout_ms;
+    update_ref(client);
+
+    // 同步失败时由定时器在下一轮循环中通知调用，调用方不会在提交调用的过程中收到回调
+    client->connect_req.data = client;
+    if (uv_tcp_connect(&client->connect_req, &client->tcp, (const struct sockaddr*) &client->addr, on_connect) != 0) {
+        client->connect_failed = 1;
+    }
+    arm_timer(client);
+}
+
+// 超时检查：连接超时和调用超时
+static void on_timer(uv_timer_t *handle) {
+    rpc_client_t *client = (rpc_client_t*) handle->data;
+    uint64_t now = uv_now(client->loop);
+
+    if (client->connect_failed ||
+        (client->state == CONN_CONNECTING && now >= client->connect_deadline)) {
+        if (client->connect_failed) {
+            log_warn("RPC客户端无法连接 %s:%d", client->host, client->port);
+        } else {
+            log_warn("RPC客户端连接 %s:%d 超时", client->host, client->port);
+        }
+        client->connect_failed = 0;
+        close_connection(client);
+        fail_calls(client, RPC_STATUS_UNAVAILABLE, 0);
+    }
+
+    // 链表按超时时刻排列，先摘下全部超时的调用再回调
+    rpc_client_call_t *expired = NULL;
+    while (!client->destroyed && client->head && client->head->deadline <= now) {
+        rpc_client_call_t *call = client->head;
+        remove_call(client, call);
+        call->next = expired;
+        expired = call;
+    }
+    while (expired) {
+        rpc_client_call_t *next = expired->next;
+        if (expired->callback) {
+            expired->callback(RPC_STATUS_DEADLINE_EXCEEDED, NULL, 0, expired->user_data);
+        }
+        free(expired->frame);
+        free(expired);
+        expired = next;
+    }
+
+    arm_timer(client);
+}
+
+// 定时器跟踪最早的超时时刻
+static void arm_timer(rpc_client_t *client) {
+    if (client->destroyed) {
+        return;
+    }
+
+    uint64_t next = client->head ? client->head->deadline : UINT64_MAX;
+    if (client->connect_failed) {
+        next = 0;
+    } else if (client->state == CONN_CONNECTING && client->connect_deadline < next) {
+        next = client->connect_deadline;
+    }
+    if (next == UINT64_MAX) {
+        uv_timer_stop(&client->timer);
+        return;
+    }
+
+    uint64_t now = uv_now(client->loop);
+    uv_timer_start(&client->timer, on_timer, next > now ? next - now : 0, 0);
+}
+
+// 创建客户端
+rpc_client_t* rpc_client_create(uv_loop_t *loop, const char *host, int port, const rpc_client_config_t *config) {
+    if (!loop || !host || port <= 0 || port > 65535 || strlen(host) >= sizeof(((rpc_client_t*) 0)->host)) {
+        return NULL;
+    }
+
+    rpc_client_t *client = calloc(1, sizeof(rpc_client_t));
+    if (!client) {
+        log_error("RPC客户端内存分配失败");
+        return NULL;
+    }
+
+    if (uv_ip4_addr(host, port, (struct sockaddr_in*) &client->addr) != 0 &&
+        uv_ip6_addr(host, port, (struct sockaddr_in6*) &client->addr) != 0) {
+        log_error("RPC客户端地址无效: %s", host);
+        free(client);
+        return NULL;
+    }
+
+    client->buckets = calloc(RPC_CLIENT_INITIAL_BUCKETS, sizeof(rpc_client_call_t*));
+    if (!client->buckets) {
+        free(client);
+        return NULL;
+    }
+    client->bucket_count = RPC_CLIENT_INITIAL_BUCKETS;
+
+    client->loop = loop;
+    client->config = config ? *config : default_config;
+    if (client->config.connect_timeout_ms <= 0) {
+        client->config.connect_timeout_ms = default_config.connect_timeout_ms;
+    }
+    if (client->config.default_timeout_ms <= 0) {
+        client->config.default_timeout_ms = default_config.default_timeout_ms;
+    }
+    if (client->config.max_frame_size == 0) {
+        client->config.max_frame_size = default_config.max_frame_size;
+    }
+    snprintf(client->host, sizeof(client->host), "%s", host);
+    client->port = port;
+
+    // 超时检查定时器不阻止事件循环退出
+    uv_timer_init(loop, &client->timer);
+    client->timer.data = client;
+    uv_unref((uv_handle_t*) &client->timer);
+    client->handle_count = 1;
+
+    return client;
+}
+
+// 销毁客户端
+void rpc_client_destroy(rpc_client_t *client) {
+    if (!client || client->destroyed) {
+        return;
+    }
+    client->destroyed = 1;
+
+    fail_calls(client, RPC_STATUS_CANCELLED, 0);
+    if (client->state == CONN_CONNECTING || client->state == CONN_CONNECTED) {
+        client->state = CONN_CLOSING;
+        uv_close((uv_handle_t*) &client->tcp, on_tcp_close);
+    }
+    uv_close((uv_handle_t*) &client->timer, on_timer_close);
+}
+
+// 发起调用
+int rpc_client_call(rpc_client_t *client, uint16_t method, const char *body, size_t body_length,
+                    int timeout_ms, rpc_client_callback_t callback, void *user_data) {
+    if (!client || client->destroyed || timeout_ms < 0 || (body_length > 0 && !body)) {
+        return -1;
+    }
+    if (timeout_ms == 0) {
+        timeout_ms = client->config.default_timeout_ms;
+    }
+
+    rpc_client_call_t *call = calloc(1, sizeof(rpc_client_call_t));
+    if (!call) {
+        return -1;
+    }
+
+    // 请求ID回绕时跳过0
+    if (++client->next_id == 0) {
+        client->next_id = 1;
+    }
+    rpc_header_t header = {
+        .version = RPC_PROTOCOL_VERSION,
+        .type = RPC_TYPE_REQUEST,
+        .method = method,
+        .request_id = client->next_id,
+        .value = (uint32_t) timeout_ms
+    };
+    call->frame = rpc_message_encode(&header, body, body_length, &call->frame_length);
+    if (!call->frame) {
+        free(call);
+        return -1;
+    }
+    call->id = header.request_id;
+    call->deadline = uv_now(client->loop) + (uint64_t) timeout_ms;
+    call->callback = callback;
+    call->user_data = user_data;
+    add_call(client, call);
+
+    // 连接中或关闭中时排队，连接建立后发送
+    if (client->state == CONN_CONNECTED) {
+        send_call(client, call);
+    } else if (client->state == CONN_IDLE) {
+        start_connect(client);
+    }
+
+    if (call == client->head || !uv_is_active((uv_handle_t*) &client->timer)) {
+        arm_timer(client);
+    }
+    return 0;
+}
+
+// 未完成的调用数
+size_t rpc_client_pending(const rpc_client_t *client) {
+    return client ? client->call_count : 0;
+}
@@ -0,0 +1,50 @@
+#ifndef RPC_CLIENT_H
+#define RPC_CLIENT_H
+
+#include "src/net/rpc_protocol.h"
+#include <uv.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 异步RPC客户端
+// 客户端绑定到一个事件循环和一个服务器地址，所有函数必须在该循环所在线程调用，回调也在该循环上执行。
+// 全部调用复用同一个连接，请求发出后不等待响应即可继续发送，响应按request_id匹配，可以乱序到达。
+// 连接在第一次调用时建立，断开后由下一次调用重新建立。
+
+// 客户端配置
+typedef struct {
+    int connect_timeout_ms;         // 连接超时
+    int default_timeout_ms;         // 调用未指定超时时使用的超时
+    size_t max_frame_size;          // 响应帧的最大字节数
+} rpc_client_config_t;
+
+// 完成回调：status为服务器返回的状态码，或客户端判定的
+// RPC_STATUS_DEADLINE_EXCEEDED（超时）、RPC_STATUS_UNAVAILABLE（连接失败或断开）、RPC_STATUS_CANCELLED（客户端销毁）。
+// body只在回调期间有效
+typedef void (*rpc_client_callback_t)(int status, const char *body, size_t body_length, void *user_data);
+
+typedef struct rpc_client rpc_client_t;
+
+// 创建客户端，host为IPv4或IPv6地址，config为NULL时使用默认配置
+rpc_client_t* rpc_client_create(uv_loop_t *loop, const char *host, int port, const rpc_client_config_t *config);
+
+// 销毁客户端：未完成的调用以RPC_STATUS_CANCELLED回调，连接在循环中异步关闭
+void rpc_client_destroy(rpc_client_t *client);
+
+// 发起调用，timeout_ms为0时使用默认超时，超时预算随请求发给服务器。
+// 成功返回0（结果通过回调通知），参数错误或内存不足返回-1（不会调用回调）
+int rpc_client_call(rpc_client_t *client, uint16_t method, const char *body, size_t body_length,
+                    int timeout_ms, rpc_client_callback_t callback, void *user_data);
+
+// 未完成的调用数
+size_t rpc_client_pending(const rpc_client_t *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RPC_CLIENT_H
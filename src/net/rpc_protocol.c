@@ -0,0 +1,84 @@
+#include "src/net/rpc_protocol.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void put_u16(char *out, uint16_t value) {
+    out[0] = (char) (value >> 8);
+    out[1] = (char) value;
+}
+
+static void put_u32(char *out, uint32_t value) {
+    out[0] = (char) (value >> 24);
+    out[1] = (char) (value >> 16);
+    out[2] = (char) (value >> 8);
+    out[3] = (char) value;
+}
+
+static uint16_t get_u16(const char *in) {
+    const unsigned char *p = (const unsigned char*) in;
+    return (uint16_t) ((p[0] << 8) | p[1]);
+}
+
+static uint32_t get_u32(const char *in) {
+    const unsigned char *p = (const unsigned char*) in;
+    return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | p[3];
+}
+
+int rpc_header_decode(const char *data, size_t length, rpc_header_t *header) {
+    if (!data || !header || length < RPC_HEADER_SIZE) {
+        return -1;
+    }
+
+    header->version = (uint8_t) data[0];
+    header->type = (uint8_t) data[1];
+    header->method = get_u16(data + 2);
+    header->request_id = get_u32(data + 4);
+    header->value = get_u32(data + 8);
+
+    if (header->version != RPC_PROTOCOL_VERSION ||
+        (header->type != RPC_TYPE_REQUEST && header->type != RPC_TYPE_RESPONSE)) {
+        return -1;
+    }
+    return 0;
+}
+
+char* rpc_message_encode(const rpc_header_t *header, const char *body, size_t body_length, size_t *frame_length) {
+    if (!header || !frame_length || (body_length > 0 && !body) ||
+        body_length > UINT32_MAX - RPC_HEADER_SIZE) {
+        return NULL;
+    }
+
+    size_t payload_length = RPC_HEADER_SIZE + body_length;
+    char *frame = malloc(RPC_LENGTH_FIELD_SIZE + payload_length);
+    if (!frame) {
+        return NULL;
+    }
+
+    put_u32(frame, (uint32_t) payload_length);
+    char *p = frame + RPC_LENGTH_FIELD_SIZE;
+    p[0] = (char) header->version;
+    p[1] = (char) header->type;
+    put_u16(p + 2, header->method);
+    put_u32(p + 4, header->request_id);
+    put_u32(p + 8, header->value);
+    if (body_length > 0) {
+        memcpy(p + RPC_HEADER_SIZE, body, body_length);
+    }
+
+    *frame_length = RPC_LENGTH_FIELD_SIZE + payload_length;
+    return frame;
+}
+
+const char* rpc_status_name(int status) {
+    switch (status) {
+        case RPC_STATUS_OK: return "OK";
+        case RPC_STATUS_UNKNOWN_METHOD: return "UNKNOWN_METHOD";
+        case RPC_STATUS_DEADLINE_EXCEEDED: return "DEADLINE_EXCEEDED";
+        case RPC_STATUS_BAD_REQUEST: return "BAD_REQUEST";
+        case RPC_STATUS_INTERNAL: return "INTERNAL";
+        case RPC_STATUS_UNAVAILABLE: return "UNAVAILABLE";
+        case RPC_STATUS_CANCELLED: return "CANCELLED";
+        case RPC_STATUS_RESOURCE_EXHAUSTED: return "RESOURCE_EXHAUSTED";
+        default: return "UNKNOWN";
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef RPC_PROTOCOL_H
+#define RPC_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 二进制RPC协议
+// 每条消息是一个长度前缀帧：4字节大端长度（不含自身）+ 12字节消息头 + 消息体。
+// 消息头（多字节字段均为大端）：
+//   version(1) type(1) method(2) request_id(4) value(4)
+// 请求的value是客户端剩余的超时预算（毫秒，0表示不限），服务器据此计算截止时间；
+// 响应的value是状态码，method和request_id原样带回。
+// 同一连接上可以同时有多个未完成的请求，响应按处理完成的顺序返回，客户端按request_id匹配。
+// 本文件不依赖其他模块，可以单独编译进压测工具等外部程序。
+
+#define RPC_PROTOCOL_VERSION 1
+#define RPC_LENGTH_FIELD_SIZE 4
+#define RPC_HEADER_SIZE 12
+
+// 消息类型
+typedef enum {
+    RPC_TYPE_REQUEST = 0,
+    RPC_TYPE_RESPONSE = 1
+} rpc_message_type_t;
+
+// 状态码
+typedef enum {
+    RPC_STATUS_OK = 0,
+    RPC_STATUS_UNKNOWN_METHOD = 1,      // 方法未注册
+    RPC_STATUS_DEADLINE_EXCEEDED = 2,   // 超过截止时间（服务器或客户端判定）
+    RPC_STATUS_BAD_REQUEST = 3,         // 请求格式错误或处理函数拒绝参数
+    RPC_STATUS_INTERNAL = 4,            // 处理函数失败
+    RPC_STATUS_UNAVAILABLE = 5,         // 连接失败或在响应前断开（客户端判定）
+    RPC_STATUS_CANCELLED = 6,           // 客户端销毁时未完成的调用（客户端判定）
+    RPC_STATUS_RESOURCE_EXHAUSTED = 7   // 服务器线程池已满，拒绝处理
+} rpc_status_t;
+
+// 消息头
+typedef struct {
+    uint8_t version;
+    uint8_t type;
+    uint16_t method;
+    uint32_t request_id;
+    uint32_t value;             // 请求：超时预算（毫秒）；响应：状态码
+} rpc_header_t;
+
+// 解析消息头（data指向长度前缀之后的帧内容），格式或版本错误返回-1
+int rpc_header_decode(const char *data, size_t length, rpc_header_t *header);
+
+// 编码完整的帧（长度前缀 + 消息头 + 消息体），返回malloc分配的缓冲区，失败返回NULL
+char* rpc_message_encode(const rpc_header_t *header, const char *body, size_t body_length, size_t *frame_length);
+
+// 状态码名称
+const char* rpc_status_name(int status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RPC_PROTOCOL_H
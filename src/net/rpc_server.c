@@ -0,0 +1,208 @@
+#include "src/net/rpc_server.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <uv.h>
+
+// 按ID排序的方法表，二分查找
+static rpc_method_t *methods = NULL;
+static size_t method_count = 0;
+static size_t method_capacity = 0;
+
+// 查找ID应在的位置，*found表示是否已存在
+static size_t method_position(uint16_t id, int *found) {
+    size_t low = 0;
+    size_t high = method_count;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (methods[mid].id < id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    *found = low < method_count && methods[low].id == id;
+    return low;
+}
+
+int rpc_register_method(uint16_t id, const char *name, rpc_handler_fn handler,
+                        rpc_exec_mode_t mode, void *user_data) {
+    if (!handler || (mode != RPC_EXEC_INLINE && mode != RPC_EXEC_THREADPOOL)) {
+        return -1;
+    }
+
+    int found;
+    size_t position = method_position(id, &found);
+    if (found) {
+        return -1;
+    }
+
+    if (method_count == method_capacity) {
+        size_t capacity = method_capacity ? method_capacity * 2 : 16;
+        rpc_method_t *grown = realloc(methods, capacity * sizeof(rpc_method_t));
+        if (!grown) {
+            return -1;
+        }
+        methods = grown;
+        method_capacity = capacity;
+    }
+
+    memmove(&methods[position + 1], &methods[position], (method_count - position) * sizeof(rpc_method_t));
+    methods[position].id = id;
+    methods[position].name = name ? name : "";
+    methods[position].handler = handler;
+    methods[position].mode = mode;
+    methods[position].user_data = user_data;
+    method_count++;
+    return 0;
+}
+
+int rpc_unregister_method(uint16_t id) {
+    int found;
+    size_t position = method_position(id, &found);
+    if (!found) {
+        return -1;
+    }
+    memmove(&methods[position], &methods[position + 1], (method_count - position - 1) * sizeof(rpc_method_t));
+    method_count--;
+    return 0;
+}
+
+const rpc_method_t* rpc_find_method(uint16_t id) {
+    int found;
+    size_t position = method_position(id, &found);
+    return found ? &methods[position] : NULL;
+}
+
+size_t rpc_method_count(void) {
+    return method_count;
+}
+
+void rpc_clear_methods(void) {
+    free(methods);
+    methods = NULL;
+    method_count = 0;
+    method_capacity = 0;
+}
+
+int64_t rpc_call_remaining_ms(const rpc_call_t *call) {
+    if (!call || call->deadline == 0) {
+        return -1;
+    }
+    uint64_t now = uv_hrtime() / 1000000;
+    return now >= call->deadline ? 0 : (int64_t) (call->deadline - now);
+}
+
+int rpc_reply_set(rpc_reply_t *reply, const void *data, size_t length) {
+    if (!reply || (length > 0 && !data)) {
+        return -1;
+    }
+    char *body = NULL;
+    if (length > 0) {
+        body = malloc(length);
+        if (!body) {
+            return -1;
+        }
+        memcpy(body, data, length);
+    }
+    free(reply->body);
+    reply->body = body;
+    reply->body_length = length;
+    return 0;
+}
+
+char* rpc_error_response(uint16_t method, uint32_t request_id, int status, size_t *frame_length) {
+    rpc_header_t header = {
+        .version = RPC_PROTOCOL_VERSION,
+        .type = RPC_TYPE_RESPONSE,
+        .method = method,
+        .request_id = request_id,
+        .value = (uint32_t) status
+    };
+    return rpc_message_encode(&header, NULL, 0, frame_length);
+}
+
+char* rpc_invoke(const rpc_method_t *method, const rpc_call_t *call, size_t *frame_length) {
+    if (!method || !call) {
+        return NULL;
+    }
+
+    rpc_reply_t reply = { NULL, 0 };
+    int status = method->handler(call, &reply, method->user_data);
+    if (status < RPC_STATUS_OK || status > RPC_STATUS_RESOURCE_EXHAUSTED) {
+        status = RPC_STATUS_INTERNAL;
+    }
+
+    rpc_header_t header = {
+        .version = RPC_PROTOCOL_VERSION,
+        .type = RPC_TYPE_RESPONSE,
+        .method = call->method,
+        .request_id = call->request_id,
+        .value = (uint32_t) status
+    };
+    char *frame = rpc_message_encode(&header, reply.body, reply.body_length, frame_length);
+    free(reply.body);
+    return frame;
+}
+
+// 内置方法：ping
+static int handle_ping(const rpc_call_t *call, rpc_reply_t *reply, void *user_data) {
+    (void)call; // 避免未使用参数警告
+    (void)reply; // 避免未使用参数警告
+    (void)user_data; // 避免未使用参数警告
+    return RPC_STATUS_OK;
+}
+
+// 内置方法：echo
+static int handle_echo(const rpc_call_t *call, rpc_reply_t *reply, void *user_data) {
+    (void)user_data; // 避免未使用参数警告
+    return rpc_reply_set(reply, call->body, call->body_length) == 0 ? RPC_STATUS_OK : RPC_STATUS_INTERNAL;
+}
+
+// handle_work的随机种子，每个工作线程一份，rand()共享全局状态不是线程安全的
+static __thread unsigned int work_seed = 0;
+
+// 内置方法：模拟耗时处理，按截止时间提前放弃
+static int handle_work(const rpc_call_t *call, rpc_reply_t *reply, void *user_data) {
+    (void)user_data; // 避免未使用参数警告
+
+    if (work_seed == 0) {
+        // 线程首次调用时用时间和线程局部变量地址初始化，各线程的序列不同
+        work_seed = (unsigned int) (uv_hrtime() ^ (uintptr_t) &work_seed) | 1;
+    }
+    int duration = rand_r(&work_seed) % 100 + 10;
+    if (call->body_length > 0) {
+        char text[16];
+        if (call->body_length >= sizeof(text)) {
+            return RPC_STATUS_BAD_REQUEST;
+        }
+        memcpy(text, call->body, call->body_length);
+        text[call->body_length] = '\0';
+        duration = atoi(text);
+    }
+    if (duration < 0 || duration > 60000) {
+        return RPC_STATUS_BAD_REQUEST;
+    }
+
+    // 分段等待，期间检查截止时间，调用方已放弃的请求不再占用工作线程
+    int elapsed = 0;
+    while (elapsed < duration) {
+        if (rpc_call_remaining_ms(call) == 0) {
+            return RPC_STATUS_DEADLINE_EXCEEDED;
+        }
+        int step = duration - elapsed < 10 ? duration - elapsed : 10;
+        usleep((useconds_t) step * 1000);
+        elapsed += step;
+    }
+
+    char message[64];
+    int length = snprintf(message, sizeof(message), "处理完成，耗时 %d ms", duration);
+    return rpc_reply_set(reply, message, (size_t) length) == 0 ? RPC_STATUS_OK : RPC_STATUS_INTERNAL;
+}
+
+void rpc_register_builtin_methods(void) {
+    rpc_register_method(RPC_METHOD_PING, "ping", handle_ping, RPC_EXEC_INLINE, NULL);
+    rpc_register_method(RPC_METHOD_ECHO, "echo", handle_echo, RPC_EXEC_INLINE, NULL);
+    rpc_register_method(RPC_METHOD_WORK, "work", handle_work, RPC_EXEC_THREADPOOL, NULL);
+}
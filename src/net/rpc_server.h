@@ -0,0 +1,89 @@
+#ifndef RPC_SERVER_H
+#define RPC_SERVER_H
+
+#include "src/net/rpc_protocol.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// RPC方法注册表
+// 增强网络模块以RPC协议运行时（enhanced_network_protocol=rpc），按请求头中的方法ID查找处理函数。
+// 方法在模块启动前注册，运行期间只读，查找不加锁。
+
+// 方法的执行位置
+typedef enum {
+    RPC_EXEC_INLINE = 0,        // 在事件循环线程直接执行，处理函数不能阻塞
+    RPC_EXEC_THREADPOOL         // 提交到线程池执行，受并发上限和请求超时控制
+} rpc_exec_mode_t;
+
+// 一次调用
+typedef struct {
+    uint16_t method;
+    uint32_t request_id;
+    const char *body;           // 请求体（不保证以'\0'结尾），内联方法中指向接收缓冲区，只在调用期间有效
+    size_t body_length;
+    uint64_t deadline;          // 截止时刻（单调时钟毫秒，与uv_now同一时钟），0表示不限
+} rpc_call_t;
+
+// 处理结果，body由处理函数malloc分配，所有权交给框架
+typedef struct {
+    char *body;
+    size_t body_length;
+} rpc_reply_t;
+
+// 处理函数，返回状态码（rpc_status_t），非RPC_STATUS_OK时reply中的内容作为错误信息返回
+typedef int (*rpc_handler_fn)(const rpc_call_t *call, rpc_reply_t *reply, void *user_data);
+
+// 已注册的方法
+typedef struct {
+    uint16_t id;
+    const char *name;
+    rpc_handler_fn handler;
+    rpc_exec_mode_t mode;
+    void *user_data;
+} rpc_method_t;
+
+// 内置方法ID
+#define RPC_METHOD_PING 1       // 空响应（内联）
+#define RPC_METHOD_ECHO 2       // 原样返回请求体（内联）
+#define RPC_METHOD_WORK 3       // 模拟耗时处理，请求体为毫秒数（线程池）
+
+// 注册方法，ID已存在或参数错误返回-1。name须在注册期间保持有效
+int rpc_register_method(uint16_t id, const char *name, rpc_handler_fn handler,
+                        rpc_exec_mode_t mode, void *user_data);
+
+// 注销方法，不存在返回-1
+int rpc_unregister_method(uint16_t id);
+
+// 查找方法，不存在返回NULL
+const rpc_method_t* rpc_find_method(uint16_t id);
+
+// 已注册的方法数
+size_t rpc_method_count(void);
+
+// 注册内置方法（已注册相同ID的方法时跳过）
+void rpc_register_builtin_methods(void);
+
+// 清空注册表
+void rpc_clear_methods(void);
+
+// 执行调用，返回编码好的响应帧（含长度前缀），内存不足返回NULL
+char* rpc_invoke(const rpc_method_t *method, const rpc_call_t *call, size_t *frame_length);
+
+// 编码不带消息体的错误响应帧
+char* rpc_error_response(uint16_t method, uint32_t request_id, int status, size_t *frame_length);
+
+// 距截止时刻的剩余毫秒数，已超过返回0，不限时返回-1
+int64_t rpc_call_remaining_ms(const rpc_call_t *call);
+
+// 复制数据作为处理结果，成功返回0
+int rpc_reply_set(rpc_reply_t *reply, const void *data, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RPC_SERVER_H
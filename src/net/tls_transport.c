@@ -0,0 +1,500 @@
+#include "src/net/tls_transport.h"
+#include "src/log/logger_module.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_OPENSSL
+
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/bio.h>
+
+// 一次SSL_read读取的最大字节数（一个TLS记录的最大明文长度）
+#define TLS_READ_SIZE 16384
+
+// 会话ID上下文，会话缓存和票据只在同一上下文内恢复
+static const unsigned char tls_session_id_context[] = "NetServe";
+
+// 待发送的数据
+typedef struct tls_write {
+    char *buffer;
+    size_t length;
+    size_t offset;              // 已写入SSL的字节数
+    tls_write_cb cb;
+    void *arg;
+    struct tls_write *next;
+} tls_write_t;
+
+// TLS上下文
+struct tls_context {
+    SSL_CTX *ssl_ctx;
+    int refcount;               // 上下文自身加上未释放的连接数
+    tls_stats_t stats;
+};
+
+// 连接
+struct tls_conn {
+    tls_context_t *context;
+    uv_tcp_t tcp;               // 持有套接字，只用于接受连接和关闭
+    uv_poll_t poll;             // 驱动SSL读写
+    SSL *ssl;
+    int poll_events;            // 当前监听的事件
+    int handshake_done;
+    int want_write;             // 握手或读取需要等待套接字可写
+    int failed;                 // 发生了致命错误，关闭时不再发送close_notify
+    int closing;
+    int dispatching;            // 正在on_poll中处理，写入的数据在返回前统一写出
+    int open_handles;
+    tls_write_t *write_head;
+    tls_write_t *write_tail;
+    tls_callbacks_t callbacks;
+    void *data;
+};
+
+static void on_poll(uv_poll_t *handle, int status, int events);
+
+// 记录并清空OpenSSL错误队列
+static void log_ssl_error(const char *what) {
+    unsigned long err = ERR_get_error();
+    if (err) {
+        char message[256];
+        ERR_error_string_n(err, message, sizeof(message));
+        log_debug("%s: %s", what, message);
+    }
+    ERR_clear_error();
+}
+
+static void release_context(tls_context_t *context) {
+    if (--context->refcount == 0) {
+        SSL_CTX_free(context->ssl_ctx);
+        free(context);
+    }
+}
+
+int tls_available(void) {
+    return 1;
+}
+
+tls_context_t* tls_context_create(const tls_config_t *config) {
+    if (!config || !config->cert_file || !config->key_file) {
+        return NULL;
+    }
+
+    SSL_CTX *ssl_ctx = SSL_CTX_new(TLS_server_method());
+    if (!ssl_ctx) {
+        log_error("创建SSL上下文失败");
+        return NULL;
+    }
+
+    SSL_CTX_set_min_proto_version(ssl_ctx, TLS1_2_VERSION);
+    // 允许部分写入，待发送缓冲区在重试前可能被移动；空闲连接释放读写缓冲区
+    SSL_CTX_set_mode(ssl_ctx, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER |
+                              SSL_MODE_RELEASE_BUFFERS);
+
+    if (SSL_CTX_use_certificate_chain_file(ssl_ctx, config->cert_file) != 1) {
+        log_error("加载TLS证书失败: %s", config->cert_file);
+        ERR_clear_error();
+        SSL_CTX_free(ssl_ctx);
+        return NULL;
+    }
+    if (SSL_CTX_use_PrivateKey_file(ssl_ctx, config->key_file, SSL_FILETYPE_PEM) != 1 ||
+        SSL_CTX_check_private_key(ssl_ctx) != 1) {
+        log_error("加载TLS私钥失败或与证书不匹配: %s", config->key_file);
+        ERR_clear_error();
+        SSL_CTX_free(ssl_ctx);
+        return NULL;
+    }
+
+    // 会话恢复：票据由进程启动时随机生成的密钥加密，服务器端缓存用于不支持票据的客户端
+    SSL_CTX_set_session_id_context(ssl_ctx, tls_session_id_context, sizeof(tls_session_id_context) - 1);
+    if (!config->enable_session_tickets) {
+        SSL_CTX_set_options(ssl_ctx, SSL_OP_NO_TICKET);
+    }
+    if (config->session_cache_size > 0) {
+        SSL_CTX_set_session_cache_mode(ssl_ctx, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_sess_set_cache_size(ssl_ctx, config->session_cache_size);
+    } else {
+        SSL_CTX_set_session_cache_mode(ssl_ctx, SSL_SESS_CACHE_OFF);
+    }
+
+    if (config->enable_ktls) {
+#ifdef SSL_OP_ENABLE_KTLS
+        SSL_CTX_set_options(ssl_ctx, SSL_OP_ENABLE_KTLS);
+#else
+        log_warn("OpenSSL版本不支持kTLS，记录加密在用户态完成");
+#endif
+    }
+
+    tls_context_t *context = calloc(1, sizeof(tls_context_t));
+    if (!context) {
+        SSL_CTX_free(ssl_ctx);
+        return NULL;
+    }
+    context->ssl_ctx = ssl_ctx;
+    context->refcount = 1;
+    return context;
+}
+
+void tls_context_destroy(tls_context_t *context) {
+    if (context) {
+        release_context(context);
+    }
+}
+
+void tls_context_get_stats(const tls_context_t *context, tls_stats_t *stats) {
+    if (!context || !stats) {
+        return;
+    }
+    *stats = context->stats;
+}
+
+// 按当前状态更新监听的事件
+static void update_poll(tls_conn_t *conn) {
+    if (conn->closing) {
+        return;
+    }
+    int events = UV_READABLE;
+    if (conn->want_write || (conn->handshake_done && conn->write_head)) {
+        events |= UV_WRITABLE;
+    }
+    if (events != conn->poll_events) {
+        conn->poll_events = events;
+        uv_poll_start(&conn->poll, events, on_poll);
+    }
+}
+
+// 推进握手，出错返回-1
+static int do_handshake(tls_conn_t *conn) {
+    int result = SSL_do_handshake(conn->ssl);
+    if (result == 1) {
+        tls_stats_t *stats = &conn->context->stats;
+        conn->handshake_done = 1;
+        conn->want_write = 0;
+        stats->handshakes++;
+        int reused = SSL_session_reused(conn->ssl);
+        if (reused) {
+            stats->resumed++;
+        }
+        int ktls_send = 0;
+        int ktls_recv = 0;
+#ifndef OPENSSL_NO_KTLS
+        ktls_send = BIO_get_ktls_send(SSL_get_wbio(conn->ssl)) ? 1 : 0;
+        ktls_recv = BIO_get_ktls_recv(SSL_get_rbio(conn->ssl)) ? 1 : 0;
+#endif
+        stats->ktls_send += ktls_send;
+        stats->ktls_recv += ktls_recv;
+        log_debug("TLS握手完成: %s %s%s，kTLS发送:%s 接收:%s", SSL_get_version(conn->ssl),
+                  SSL_get_cipher_name(conn->ssl), reused ? "（会话恢复）" : "",
+                  ktls_send ? "是" : "否", ktls_recv ? "是" : "否");
+        return 0;
+    }
+
+    switch (SSL_get_error(conn->ssl, result)) {
+        case SSL_ERROR_WANT_READ:
+            conn->want_write = 0;
+            return 0;
+        case SSL_ERROR_WANT_WRITE:
+            conn->want_write = 1;
+            return 0;
+        default:
+            conn->failed = 1;
+            conn->context->stats.failed++;
+            log_ssl_error("TLS握手失败");
+            return -1;
+    }
+}
+
+// 读取并分发全部已解密的数据，连接需要关闭时返回-1
+static int pump_reads(tls_conn_t *conn) {
+    char buffer[TLS_READ_SIZE];
+
+    while (!conn->closing) {
+        int n = SSL_read(conn->ssl, buffer, sizeof(buffer));
+        if (n > 0) {
+            conn->callbacks.on_data(conn, buffer, (size_t) n);
+            continue;
+        }
+
+        switch (SSL_get_error(conn->ssl, n)) {
+            case SSL_ERROR_WANT_READ:
+                conn->want_write = 0;
+                return 0;
+            case SSL_ERROR_WANT_WRITE:
+                conn->want_write = 1;
+                return 0;
+            case SSL_ERROR_ZERO_RETURN:
+                // 对端发送了close_notify
+                return -1;
+            default:
+                conn->failed = 1;
+                log_ssl_error("TLS读取失败");
+                return -1;
+        }
+    }
+    return 0;
+}
+
+// 把待发送的数据写入SSL，连接需要关闭时返回-1
+static int flush_writes(tls_conn_t *conn) {
+    while (conn->write_head && !conn->closing) {
+        tls_write_t *write = conn->write_head;
+        int n = SSL_write(conn->ssl, write->buffer + write->offset, (int) (write->length - write->offset));
+        if (n > 0) {
+            write->offset += (size_t) n;
+            if (write->offset < write->length) {
+                continue;
+            }
+            conn->write_head = write->next;
+            if (!conn->write_head) {
+                conn->write_tail = NULL;
+            }
+            if (write->cb) {
+                write->cb(conn, 0, write->arg);
+            }
+            free(write->buffer);
+            free(write);
+            continue;
+        }
+
+        int error = SSL_get_error(conn->ssl, n);
+        if (error == SSL_ERROR_WANT_WRITE || error == SSL_ERROR_WANT_READ) {
+            return 0;
+        }
+        conn->failed = 1;
+        log_ssl_error("TLS写入失败");
+        return -1;
+    }
+    return 0;
+}
+
+static void on_poll(uv_poll_t *handle, int status, int events) {
+    tls_conn_t *conn = (tls_conn_t*) handle->data;
+    (void)events; // 避免未使用参数警告，SSL的读写状态以SSL_get_error为准
+
+    if (conn->closing) {
+        return;
+    }
+    if (status < 0) {
+        conn->failed = 1;
+        tls_conn_close(conn);
+        return;
+    }
+
+    if (!conn->handshake_done) {
+        if (do_handshake(conn) != 0) {
+            tls_conn_close(conn);
+            return;
+        }
+        if (!conn->handshake_done) {
+            update_poll(conn);
+            return;
+        }
+    }
+
+    // 先读取：回调中产生的响应在本次事件中一并写出
+    conn->dispatching = 1;
+    int result = pump_reads(conn);
+    if (result == 0) {
+        result = flush_writes(conn);
+    }
+    conn->dispatching = 0;
+    if (result != 0) {
+        tls_conn_close(conn);
+        return;
+    }
+    update_poll(conn);
+}
+
+static void on_handle_closed(uv_handle_t *handle) {
+    tls_conn_t *conn = (tls_conn_t*) handle->data;
+    if (--conn->open_handles > 0) {
+        return;
+    }
+
+    if (conn->ssl) {
+        if (conn->callbacks.on_close) {
+            conn->callbacks.on_close(conn);
+        }
+        SSL_free(conn->ssl);
+    }
+    release_context(conn->context);
+    free(conn);
+}
+
+tls_conn_t* tls_conn_accept(tls_context_t *context, uv_stream_t *server,
+                            const tls_callbacks_t *callbacks, void *data) {
+    if (!context || !server || !callbacks || !callbacks->on_data) {
+        return NULL;
+    }
+
+    tls_conn_t *conn = calloc(1, sizeof(tls_conn_t));
+    if (!conn) {
+        return NULL;
+    }
+    conn->context = context;
+    context->refcount++;
+    conn->callbacks = *callbacks;
+    conn->data = data;
+    conn->closing = 1;
+    conn->open_handles = 1;
+
+    uv_tcp_init(server->loop, &conn->tcp);
+    conn->tcp.data = conn;
+    conn->poll.data = conn;
+
+    uv_os_fd_t fd;
+    if (uv_accept(server, (uv_stream_t*) &conn->tcp) != 0 ||
+        uv_fileno((uv_handle_t*) &conn->tcp, &fd) != 0) {
+        uv_close((uv_handle_t*) &conn->tcp, on_handle_closed);
+        return NULL;
+    }
+    uv_tcp_nodelay(&conn->tcp, 1);
+
+    // 套接字由SSL直接读写（kTLS要求SSL绑定套接字而不是内存BIO），uv_tcp_t不启动读写
+    conn->ssl = SSL_new(context->ssl_ctx);
+    if (!conn->ssl || SSL_set_fd(conn->ssl, fd) != 1) {
+        log_error("创建TLS连接失败");
+        ERR_clear_error();
+        if (conn->ssl) {
+            SSL_free(conn->ssl);
+            conn->ssl = NULL;
+        }
+        uv_close((uv_handle_t*) &conn->tcp, on_handle_closed);
+        return NULL;
+    }
+    SSL_set_accept_state(conn->ssl);
+
+    if (uv_poll_init_socket(server->loop, &conn->poll, fd) != 0) {
+        SSL_free(conn->ssl);
+        conn->ssl = NULL;
+        uv_close((uv_handle_t*) &conn->tcp, on_handle_closed);
+        return NULL;
+    }
+    conn->open_handles = 2;
+    conn->closing = 0;
+
+    // 等待ClientHello
+    conn->poll_events = UV_READABLE;
+    uv_poll_start(&conn->poll, UV_READABLE, on_poll);
+    return conn;
+}
+
+int tls_conn_write(tls_conn_t *conn, char *buffer, size_t length, tls_write_cb cb, void *arg) {
+    if (!conn || !buffer || conn->closing) {
+        free(buffer);
+        return -1;
+    }
+
+    tls_write_t *write = malloc(sizeof(tls_write_t));
+    if (!write) {
+        free(buffer);
+        return -1;
+    }
+    write->buffer = buffer;
+    write->length = length;
+    write->offset = 0;
+    write->cb = cb;
+    write->arg = arg;
+    write->next = NULL;
+
+    if (conn->write_tail) {
+        conn->write_tail->next = write;
+    } else {
+        conn->write_head = write;
+    }
+    conn->write_tail = write;
+
+    // 在读回调中写入时由on_poll随后写出，否则等待套接字可写
+    if (!conn->dispatching) {
+        update_poll(conn);
+    }
+    return 0;
+}
+
+void tls_conn_close(tls_conn_t *conn) {
+    if (!conn || conn->closing) {
+        return;
+    }
+    conn->closing = 1;
+
+    // 尽力发送close_notify，不等待对端回应
+    if (conn->handshake_done && !conn->failed) {
+        SSL_shutdown(conn->ssl);
+    }
+    ERR_clear_error();
+
+    while (conn->write_head) {
+        tls_write_t *write = conn->write_head;
+        conn->write_head = write->next;
+        if (write->cb) {
+            write->cb(conn, UV_ECANCELED, write->arg);
+        }
+        free(write->buffer);
+        free(write);
+    }
+    conn->write_tail = NULL;
+
+    // 先停止轮询再关闭套接字
+    uv_close((uv_handle_t*) &conn->poll, on_handle_closed);
+    uv_close((uv_handle_t*) &conn->tcp, on_handle_closed);
+}
+
+void tls_conn_set_data(tls_conn_t *conn, void *data) {
+    if (conn) {
+        conn->data = data;
+    }
+}
+
+void* tls_conn_get_data(const tls_conn_t *conn) {
+    return conn ? conn->data : NULL;
+}
+
+#else // !HAVE_OPENSSL
+
+int tls_available(void) {
+    return 0;
+}
+
+tls_context_t* tls_context_create(const tls_config_t *config) {
+    (void)config; // 避免未使用参数警告
+    log_error("未编译TLS支持（需要OpenSSL）");
+    return NULL;
+}
+
+void tls_context_destroy(tls_context_t *context) {
+    (void)context; // 避免未使用参数警告
+}
+
+void tls_context_get_stats(const tls_context_t *context, tls_stats_t *stats) {
+    (void)context; // 避免未使用参数警告
+    if (stats) {
+        memset(stats, 0, sizeof(tls_stats_t));
+    }
+}
+
+tls_conn_t* tls_conn_accept(tls_context_t *context, uv_stream_t *server,
+                            const tls_callbacks_t *callbacks, void *data) {
+    (void)context; (void)server; (void)callbacks; (void)data; // 避免未使用参数警告
+    return NULL;
+}
+
+int tls_conn_write(tls_conn_t *conn, char *buffer, size_t length, tls_write_cb cb, void *arg) {
+    (void)conn; (void)length; (void)cb; (void)arg; // 避免未使用参数警告
+    free(buffer);
+    return -1;
+}
+
+void tls_conn_close(tls_conn_t *conn) {
+    (void)conn; // 避免未使用参数警告
+}
+
+void tls_conn_set_data(tls_conn_t *conn, void *data) {
+    (void)conn; (void)data; // 避免未使用参数警告
+}
+
+void* tls_conn_get_data(const tls_conn_t *conn) {
+    (void)conn; // 避免未使用参数警告
+    return NULL;
+}
+
+#endif // HAVE_OPENSSL
@@ -0,0 +1,76 @@
+#ifndef TLS_TRANSPORT_H
+#define TLS_TRANSPORT_H
+
+#include <uv.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// TLS传输层（OpenSSL）
+// 连接由libuv监听器接受后交给本层，SSL直接绑定套接字，握手和读写由事件循环上的uv_poll驱动。
+// 支持会话票据和服务器端会话缓存（会话恢复跳过完整握手）；内核支持kTLS时，握手完成后记录加密由内核完成，
+// 套接字上的sendfile等零拷贝发送仍然可用。所有函数和回调都在事件循环线程执行。
+
+typedef struct tls_context tls_context_t;
+typedef struct tls_conn tls_conn_t;
+
+// TLS配置
+typedef struct {
+    const char *cert_file;          // PEM证书（可包含证书链）
+    const char *key_file;           // PEM私钥
+    int enable_session_tickets;     // 启用会话票据（无状态恢复）
+    long session_cache_size;        // 服务器端会话缓存条目数，0表示不使用会话缓存
+    int enable_ktls;                // 握手后尝试启用内核TLS
+} tls_config_t;
+
+// 统计信息
+typedef struct {
+    unsigned long handshakes;       // 完成的握手数
+    unsigned long resumed;          // 其中通过会话恢复完成的握手数
+    unsigned long failed;           // 失败的握手数
+    unsigned long ktls_send;        // 发送方向启用了kTLS的连接数
+    unsigned long ktls_recv;        // 接收方向启用了kTLS的连接数
+} tls_stats_t;
+
+// 回调函数
+typedef struct {
+    void (*on_data)(tls_conn_t *conn, const char *data, size_t length);    // 解密后的数据，仅在回调期间有效
+    void (*on_close)(tls_conn_t *conn);                                     // 连接句柄全部关闭后调用
+} tls_callbacks_t;
+
+// 写入完成回调，status为0或libuv错误码
+typedef void (*tls_write_cb)(tls_conn_t *conn, int status, void *arg);
+
+// 是否编译了TLS支持
+int tls_available(void);
+
+// 创建TLS上下文（加载证书和私钥），失败返回NULL
+tls_context_t* tls_context_create(const tls_config_t *config);
+
+// 释放TLS上下文，仍在使用该上下文的连接关闭后才真正释放
+void tls_context_destroy(tls_context_t *context);
+
+// 获取统计信息
+void tls_context_get_stats(const tls_context_t *context, tls_stats_t *stats);
+
+// 从监听器接受一个连接并开始握手，失败返回NULL
+tls_conn_t* tls_conn_accept(tls_context_t *context, uv_stream_t *server,
+                            const tls_callbacks_t *callbacks, void *data);
+
+// 发送数据，buffer的所有权转移给传输层，完成后free
+int tls_conn_write(tls_conn_t *conn, char *buffer, size_t length, tls_write_cb cb, void *arg);
+
+// 关闭连接：发送close_notify，未发送的数据以UV_ECANCELED回调，句柄关闭后调用on_close
+void tls_conn_close(tls_conn_t *conn);
+
+// 连接用户数据
+void tls_conn_set_data(tls_conn_t *conn, void *data);
+void* tls_conn_get_data(const tls_conn_t *conn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TLS_TRANSPORT_H
@@ -0,0 +1,553 @@
+#include "src/net/udp_transport.h"
+#include "src/log/logger_module.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/udp.h>
+#include <unistd.h>
+#include <errno.h>
+
+// 旧版本头文件中没有的选项（Linux 4.18/5.0）
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+// 一次GSO发送的最大分段数（较新的内核允许128），GRO合并的数据报按128段准备空间
+#define UDP_MAX_SEGMENTS 64
+#define UDP_GRO_MAX_SEGMENTS 128
+
+// GRO合并后的数据报最大可达64KB，GSO发送的总长度不超过IPv4单个数据报的上限
+#define UDP_GRO_BUFFER_SIZE 65536
+#define UDP_GSO_MAX_BYTES 65507
+
+// 一次可读事件中最多调用recvmmsg的次数，避免持续到达的数据报独占事件循环
+#define UDP_RECV_ROUNDS 8
+
+// 控制消息缓冲区（GRO分段大小或GSO分段大小）
+typedef union {
+    char buffer[CMSG_SPACE(sizeof(int))];
+    struct cmsghdr align;
+} udp_control_t;
+
+// 待发送的数据报
+typedef struct {
+    udp_peer_t peer;
+    char *buffer;
+    size_t length;
+} udp_send_entry_t;
+
+struct udp_endpoint {
+    uv_loop_t *loop;
+    uv_poll_t poll;
+    uv_prepare_t prepare;
+    int fd;
+    udp_endpoint_config_t config;
+    udp_batch_cb on_batch;
+    udp_close_cb on_close;
+    void *data;
+    int poll_events;                // 当前关注的事件
+    int receiving;                  // 未永久停止接收
+    int paused;
+    int send_blocked;               // 发送缓冲区已满，等待可写
+    int closing;
+    int open_handles;
+    int gro;
+    int gso;
+
+    // 接收：batch_size个槽位，每个槽位一个数据报（GRO时为合并后的多个数据报）
+    size_t slot_size;
+    char *recv_buffer;
+    struct mmsghdr *recv_msgs;
+    struct iovec *recv_iovs;
+    udp_peer_t *recv_peers;
+    udp_control_t *recv_controls;
+    udp_datagram_t *datagrams;      // 交给回调的数据报，GRO拆分后可能多于batch_size
+    size_t datagram_capacity;
+
+    // 发送队列，待发送的数据报位于queue[queue_head, queue_head + queue_count)
+    udp_send_entry_t *queue;
+    size_t queue_head;
+    size_t queue_count;
+    size_t queue_capacity;
+    struct mmsghdr *send_msgs;
+    struct iovec *send_iovs;
+    udp_control_t *send_controls;
+
+    udp_endpoint_stats_t stats;
+};
+
+// 按当前状态更新关注的事件
+static void update_poll(udp_endpoint_t *endpoint);
+
+// 释放端点持有的缓冲区
+static void free_endpoint(udp_endpoint_t *endpoint) {
+    for (size_t i = 0; i < endpoint->queue_count; i++) {
+        free(endpoint->queue[endpoint->queue_head + i].buffer);
+    }
+    free(endpoint->queue);
+    free(endpoint->recv_buffer);
+    free(endpoint->recv_msgs);
+    free(endpoint->recv_iovs);
+    free(endpoint->recv_peers);
+    free(endpoint->recv_controls);
+    free(endpoint->datagrams);
+    free(endpoint->send_msgs);
+    free(endpoint->send_iovs);
+    free(endpoint->send_controls);
+    free(endpoint);
+}
+
+// 读取GRO控制消息中的分段大小，没有合并时返回0
+static size_t gro_segment_size(struct msghdr *msg) {
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(msg); cmsg; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+            int size;
+            memcpy(&size, CMSG_DATA(cmsg), sizeof(size));
+            return size > 0 ? (size_t) size : 0;
+        }
+    }
+    return 0;
+}
+
+// 队首起可以用一次GSO发送的数据报数：同一地址，除最后一个外长度相同，最后一个不长于前面的
+static size_t gso_run(const udp_endpoint_t *endpoint, size_t first, size_t iov_available) {
+    const udp_send_entry_t *pending = endpoint->queue + endpoint->queue_head;
+    const udp_send_entry_t *head = &pending[first];
+    size_t limit = iov_available < UDP_MAX_SEGMENTS ? iov_available : UDP_MAX_SEGMENTS;
+    size_t total = head->length;
+    size_t count = 1;
+
+    if (head->length == 0) {
+        return 1;
+    }
+    while (count < limit && first + count < endpoint->queue_count) {
+        const udp_send_entry_t *entry = &pending[first + count];
+        if (entry->peer.length != head->peer.length ||
+            memcmp(&entry->peer.addr, &head->peer.addr, head->peer.length) != 0 ||
+            entry->length == 0 || entry->length > head->length ||
+            total + entry->length > UDP_GSO_MAX_BYTES) {
+            break;
+        }
+        total += entry->length;
+        count++;
+        // 较短的数据报只能作为最后一段
+        if (entry->length < head->length) {
+            break;
+        }
+    }
+    return count;
+}
+
+// 批量发出队列中的数据报，发送缓冲区满时等待可写后继续
+static void flush_sends(udp_endpoint_t *endpoint) {
+    size_t batch = endpoint->config.batch_size;
+    size_t iov_capacity = endpoint->gso ? batch * UDP_MAX_SEGMENTS : batch;
+
+    while (endpoint->queue_count > 0) {
+        // 组装一批消息，GSO时一个消息包含多个数据报
+        udp_send_entry_t *pending = endpoint->queue + endpoint->queue_head;
+        size_t entries = 0;
+        size_t messages = 0;
+        while (entries < endpoint->queue_count && messages < batch) {
+            udp_send_entry_t *entry = &pending[entries];
+            size_t segments = endpoint->gso ? gso_run(endpoint, entries, iov_capacity - entries) : 1;
+
+            struct msghdr *msg = &endpoint->send_msgs[messages].msg_hdr;
+            memset(msg, 0, sizeof(struct msghdr));
+            msg->msg_name = &entry->peer.addr;
+            msg->msg_namelen = entry->peer.length;
+            msg->msg_iov = &endpoint->send_iovs[entries];
+            msg->msg_iovlen = segments;
+            for (size_t i = 0; i < segments; i++) {
+                endpoint->send_iovs[entries + i].iov_base = pending[entries + i].buffer;
+                endpoint->send_iovs[entries + i].iov_len = pending[entries + i].length;
+            }
+            if (segments > 1) {
+                msg->msg_control = endpoint->send_controls[messages].buffer;
+                msg->msg_controllen = sizeof(endpoint->send_controls[messages].buffer);
+                struct cmsghdr *cmsg = CMSG_FIRSTHDR(msg);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                uint16_t segment_size = (uint16_t) entry->length;
+                memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+                msg->msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+            }
+            entries += segments;
+            messages++;
+        }
+
+        int sent = sendmmsg(endpoint->fd, endpoint->send_msgs, (unsigned int) messages, MSG_DONTWAIT);
+        endpoint->stats.send_calls++;
+        size_t done = 0;
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+                endpoint->send_blocked = 1;
+                break;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            // 网卡不支持校验和卸载或分段超过路径MTU时GSO发送失败，之后逐个发送
+            if (endpoint->gso && (errno == EIO || errno == EINVAL) && endpoint->send_msgs[0].msg_hdr.msg_iovlen > 1) {
+                log_warn("UDP GSO发送失败（%s），改为逐个发送", strerror(errno));
+                endpoint->gso = 0;
+                endpoint->stats.gso = 0;
+                continue;
+            }
+            // 其他错误只影响第一个消息（如地址不可达），丢弃后继续发送其余的
+            log_warn("UDP发送失败: %s", strerror(errno));
+            done = endpoint->send_msgs[0].msg_hdr.msg_iovlen;
+            endpoint->stats.dropped += done;
+        } else {
+            for (int i = 0; i < sent; i++) {
+                done += endpoint->send_msgs[i].msg_hdr.msg_iovlen;
+                endpoint->stats.gso_messages += endpoint->send_msgs[i].msg_hdr.msg_iovlen > 1;
+            }
+            endpoint->stats.datagrams_sent += done;
+        }
+
+        for (size_t i = 0; i < done; i++) {
+            free(pending[i].buffer);
+        }
+        endpoint->queue_head += done;
+        endpoint->queue_count -= done;
+        endpoint->send_blocked = 0;
+    }
+    if (endpoint->queue_count == 0) {
+        endpoint->queue_head = 0;
+    }
+    update_poll(endpoint);
+}
+
+// 接收数据报并按批交给回调
+static void receive_batches(udp_endpoint_t *endpoint) {
+    size_t batch = endpoint->config.batch_size;
+
+    for (int round = 0; round < UDP_RECV_ROUNDS; round++) {
+        if (!endpoint->receiving || endpoint->paused || endpoint->closing) {
+            return;
+        }
+
+        for (size_t i = 0; i < batch; i++) {
+            struct msghdr *msg = &endpoint->recv_msgs[i].msg_hdr;
+            msg->msg_namelen = sizeof(endpoint->recv_peers[i].addr);
+            msg->msg_controllen = endpoint->gro ? sizeof(endpoint->recv_controls[i].buffer) : 0;
+            msg->msg_flags = 0;
+        }
+
+        int received = recvmmsg(endpoint->fd, endpoint->recv_msgs, (unsigned int) batch, MSG_DONTWAIT, NULL);
+        if (received < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                log_error("UDP接收失败: %s", strerror(errno));
+            }
+            return;
+        }
+        endpoint->stats.receive_calls++;
+
+        // GRO合并的数据报按分段大小拆开，每段是发送方的一个数据报
+        size_t count = 0;
+        for (int i = 0; i < received; i++) {
+            struct msghdr *msg = &endpoint->recv_msgs[i].msg_hdr;
+            const char *data = endpoint->recv_buffer + (size_t) i * endpoint->slot_size;
+            size_t length = endpoint->recv_msgs[i].msg_len;
+            endpoint->recv_peers[i].length = msg->msg_namelen;
+
+            if (msg->msg_flags & MSG_TRUNC) {
+                endpoint->stats.dropped++;
+                continue;
+            }
+            size_t segment = endpoint->gro ? gro_segment_size(msg) : 0;
+            if (segment == 0 || segment >= length) {
+                segment = length;
+            } else {
+                endpoint->stats.gro_messages++;
+            }
+            size_t offset = 0;
+            do {
+                size_t size = length - offset < segment ? length - offset : segment;
+                if (size > endpoint->config.max_datagram_size || count == endpoint->datagram_capacity) {
+                    endpoint->stats.dropped++;
+                } else {
+                    endpoint->datagrams[count].data = data + offset;
+                    endpoint->datagrams[count].length = size;
+                    endpoint->datagrams[count].peer = &endpoint->recv_peers[i];
+                    count++;
+                }
+                offset += size;
+            } while (offset < length);
+        }
+        endpoint->stats.datagrams_received += count;
+
+        if (count > 0) {
+            endpoint->on_batch(endpoint, endpoint->datagrams, count, endpoint->data);
+        }
+        // 本批同步产生的响应一起发出
+        if (!endpoint->closing) {
+            flush_sends(endpoint);
+        }
+        if ((size_t) received < batch) {
+            return;
+        }
+    }
+}
+
+// 套接字事件
+static void on_poll(uv_poll_t *handle, int status, int events) {
+    udp_endpoint_t *endpoint = (udp_endpoint_t*) handle->data;
+
+    if (status < 0) {
+        log_error("UDP轮询错误: %s", uv_strerror(status));
+        return;
+    }
+    if (events & UV_WRITABLE) {
+        endpoint->send_blocked = 0;
+        flush_sends(endpoint);
+    }
+    if (events & UV_READABLE) {
+        receive_batches(endpoint);
+    }
+}
+
+// 事件循环阻塞前发出本轮排队的数据报（线程池处理完成的响应）
+static void on_prepare(uv_prepare_t *handle) {
+    udp_endpoint_t *endpoint = (udp_endpoint_t*) handle->data;
+    if (endpoint->queue_count > 0 && !endpoint->send_blocked) {
+        flush_sends(endpoint);
+    }
+}
+
+static void update_poll(udp_endpoint_t *endpoint) {
+    if (endpoint->closing) {
+        return;
+    }
+
+    int events = 0;
+    if (endpoint->receiving && !endpoint->paused) {
+        events |= UV_READABLE;
+    }
+    if (endpoint->send_blocked && endpoint->queue_count > 0) {
+        events |= UV_WRITABLE;
+    }
+    if (events == endpoint->poll_events) {
+        return;
+    }
+
+    endpoint->poll_events = events;
+    if (events) {
+        uv_poll_start(&endpoint->poll, events, on_poll);
+    } else {
+        uv_poll_stop(&endpoint->poll);
+    }
+}
+
+// 分配接收和发送用的数组
+static int allocate_buffers(udp_endpoint_t *endpoint) {
+    size_t batch = endpoint->config.batch_size;
+    size_t segments = endpoint->gro ? UDP_GRO_MAX_SEGMENTS : 1;
+    size_t iovs = endpoint->gso ? batch * UDP_MAX_SEGMENTS : batch;
+
+    endpoint->slot_size = endpoint->gro ? UDP_GRO_BUFFER_SIZE : endpoint->config.max_datagram_size;
+    endpoint->recv_buffer = malloc(batch * endpoint->slot_size);
+    endpoint->recv_msgs = calloc(batch, sizeof(struct mmsghdr));
+    endpoint->recv_iovs = calloc(batch, sizeof(struct iovec));
+    endpoint->recv_peers = calloc(batch, sizeof(udp_peer_t));
+    endpoint->recv_controls = calloc(batch, sizeof(udp_control_t));
+    endpoint->datagram_capacity = batch * segments;
+    endpoint->datagrams = calloc(endpoint->datagram_capacity, sizeof(udp_datagram_t));
+    endpoint->send_msgs = calloc(batch, sizeof(struct mmsghdr));
+    endpoint->send_iovs = calloc(iovs, sizeof(struct iovec));
+    endpoint->send_controls = calloc(batch, sizeof(udp_control_t));
+    endpoint->queue_capacity = endpoint->config.max_queued;
+    endpoint->queue = calloc(endpoint->queue_capacity, sizeof(udp_send_entry_t));
+    if (!endpoint->recv_buffer || !endpoint->recv_msgs || !endpoint->recv_iovs || !endpoint->recv_peers ||
+        !endpoint->recv_controls || !endpoint->datagrams || !endpoint->send_msgs || !endpoint->send_iovs ||
+        !endpoint->send_controls || !endpoint->queue) {
+        return -1;
+    }
+
+    // 接收消息头固定指向各自的槽位，每次接收前只重置长度
+    for (size_t i = 0; i < batch; i++) {
+        endpoint->recv_iovs[i].iov_base = endpoint->recv_buffer + i * endpoint->slot_size;
+        endpoint->recv_iovs[i].iov_len = endpoint->slot_size;
+        struct msghdr *msg = &endpoint->recv_msgs[i].msg_hdr;
+        msg->msg_name = &endpoint->recv_peers[i].addr;
+        msg->msg_iov = &endpoint->recv_iovs[i];
+        msg->msg_iovlen = 1;
+        msg->msg_control = endpoint->recv_controls[i].buffer;
+    }
+    return 0;
+}
+
+// 创建端点
+udp_endpoint_t* udp_endpoint_start(uv_loop_t *loop, const struct sockaddr *addr, const udp_endpoint_config_t *config,
+                                   udp_batch_cb on_batch, void *data) {
+    if (!loop || !addr || !config || !on_batch || config->batch_size == 0 ||
+        config->max_datagram_size == 0 || config->max_queued == 0) {
+        return NULL;
+    }
+
+    udp_endpoint_t *endpoint = calloc(1, sizeof(udp_endpoint_t));
+    if (!endpoint) {
+        return NULL;
+    }
+    endpoint->loop = loop;
+    endpoint->config = *config;
+    endpoint->on_batch = on_batch;
+    endpoint->data = data;
+    endpoint->receiving = 1;
+
+    socklen_t addr_length = addr->sa_family == AF_INET6 ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+    int reuse = 1;
+    endpoint->fd = socket(addr->sa_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (endpoint->fd < 0 ||
+        setsockopt(endpoint->fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+        bind(endpoint->fd, addr, addr_length) != 0) {
+        log_error("UDP套接字创建失败: %s", strerror(errno));
+        if (endpoint->fd >= 0) {
+            close(endpoint->fd);
+        }
+        free(endpoint);
+        return NULL;
+    }
+
+    // 突发流量在事件循环处理前先进入内核缓冲区，缓冲区满后内核直接丢弃
+    if (config->socket_buffer_size > 0) {
+        setsockopt(endpoint->fd, SOL_SOCKET, SO_RCVBUF, &config->socket_buffer_size, sizeof(int));
+        setsockopt(endpoint->fd, SOL_SOCKET, SO_SNDBUF, &config->socket_buffer_size, sizeof(int));
+    }
+
+    // 探测GRO/GSO：旧内核不认识这两个选项时返回错误
+    if (config->offload) {
+        int one = 1;
+        int segment = 0;
+        socklen_t segment_length = sizeof(segment);
+        endpoint->gro = setsockopt(endpoint->fd, SOL_UDP, UDP_GRO, &one, sizeof(one)) == 0;
+        endpoint->gso = getsockopt(endpoint->fd, SOL_UDP, UDP_SEGMENT, &segment, &segment_length) == 0;
+    }
+    endpoint->stats.gro = endpoint->gro;
+    endpoint->stats.gso = endpoint->gso;
+
+    if (allocate_buffers(endpoint) != 0) {
+        log_error("UDP端点内存分配失败");
+        close(endpoint->fd);
+        free_endpoint(endpoint);
+        return NULL;
+    }
+
+    uv_poll_init(loop, &endpoint->poll, endpoint->fd);
+    endpoint->poll.data = endpoint;
+    uv_prepare_init(loop, &endpoint->prepare);
+    endpoint->prepare.data = endpoint;
+    uv_prepare_start(&endpoint->prepare, on_prepare);
+    endpoint->open_handles = 2;
+    update_poll(endpoint);
+
+    return endpoint;
+}
+
+// 发送数据报
+int udp_endpoint_send(udp_endpoint_t *endpoint, const udp_peer_t *peer, char *buffer, size_t length) {
+    if (!endpoint || !peer || endpoint->closing || (!buffer && length > 0) ||
+        peer->length > sizeof(peer->addr)) {
+        free(buffer);
+        return -1;
+    }
+    if (endpoint->queue_count == endpoint->queue_capacity) {
+        endpoint->stats.dropped++;
+        free(buffer);
+        return -1;
+    }
+
+    // 队尾到达数组末尾时把剩余的数据报移到开头
+    if (endpoint->queue_head + endpoint->queue_count == endpoint->queue_capacity) {
+        memmove(endpoint->queue, endpoint->queue + endpoint->queue_head,
+                endpoint->queue_count * sizeof(udp_send_entry_t));
+        endpoint->queue_head = 0;
+    }
+    udp_send_entry_t *entry = &endpoint->queue[endpoint->queue_head + endpoint->queue_count++];
+    memcpy(&entry->peer, peer, sizeof(udp_peer_t));
+    entry->buffer = buffer;
+    entry->length = length;
+
+    // 攒满一批立即发送，否则留到本批接收处理完或事件循环阻塞前
+    if (endpoint->queue_count >= endpoint->config.batch_size && !endpoint->send_blocked) {
+        flush_sends(endpoint);
+    }
+    return 0;
+}
+
+// 暂停接收
+void udp_endpoint_pause(udp_endpoint_t *endpoint) {
+    if (!endpoint || endpoint->paused) {
+        return;
+    }
+    endpoint->paused = 1;
+    update_poll(endpoint);
+}
+
+// 恢复接收
+void udp_endpoint_resume(udp_endpoint_t *endpoint) {
+    if (!endpoint || !endpoint->paused) {
+        return;
+    }
+    endpoint->paused = 0;
+    update_poll(endpoint);
+}
+
+// 永久停止接收
+void udp_endpoint_stop_receiving(udp_endpoint_t *endpoint) {
+    if (!endpoint || !endpoint->receiving) {
+        return;
+    }
+    endpoint->receiving = 0;
+    update_poll(endpoint);
+}
+
+// 句柄关闭回调，两个句柄都关闭后关闭套接字并释放端点
+static void on_handle_close(uv_handle_t *handle) {
+    udp_endpoint_t *endpoint = (udp_endpoint_t*) handle->data;
+    if (--endpoint->open_handles > 0) {
+        return;
+    }
+
+    close(endpoint->fd);
+    if (endpoint->on_close) {
+        endpoint->on_close(endpoint, endpoint->data);
+    }
+    free_endpoint(endpoint);
+}
+
+// 关闭端点
+void udp_endpoint_close(udp_endpoint_t *endpoint, udp_close_cb on_close) {
+    if (!endpoint || endpoint->closing) {
+        return;
+    }
+
+    // 套接字仍然可用，尽量发出已排队的数据报
+    if (!endpoint->send_blocked) {
+        flush_sends(endpoint);
+    }
+    endpoint->stats.dropped += endpoint->queue_count;
+
+    endpoint->closing = 1;
+    endpoint->on_close = on_close;
+    uv_close((uv_handle_t*) &endpoint->poll, on_handle_close);
+    uv_close((uv_handle_t*) &endpoint->prepare, on_handle_close);
+}
+
+// 端点是否正在关闭
+int udp_endpoint_is_closing(const udp_endpoint_t *endpoint) {
+    return !endpoint || endpoint->closing;
+}
+
+// 获取统计
+void udp_endpoint_get_stats(const udp_endpoint_t *endpoint, udp_endpoint_stats_t *stats) {
+    if (!endpoint || !stats) {
+        return;
+    }
+    *stats = endpoint->stats;
+}
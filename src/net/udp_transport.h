@@ -0,0 +1,93 @@
+#ifndef UDP_TRANSPORT_H
+#define UDP_TRANSPORT_H
+
+#include <uv.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <netinet/in.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// UDP端点（Linux）
+// 套接字可读时用recvmmsg一次接收一批数据报到预分配的缓冲区，整批交给回调；
+// 发送的数据报先排队，在每批接收处理完和事件循环阻塞前用sendmmsg批量发出。
+// 内核支持时接收启用GRO（一次收到合并的多个数据报），发给同一地址的等长数据报用GSO合并发送。
+// 所有函数和回调都在事件循环线程执行。
+
+// 数据报的对端地址
+typedef struct {
+    union {
+        struct sockaddr sa;
+        struct sockaddr_in in4;
+        struct sockaddr_in6 in6;
+    } addr;
+    socklen_t length;
+} udp_peer_t;
+
+// 收到的数据报，data和peer只在回调期间有效
+typedef struct {
+    const char *data;
+    size_t length;
+    const udp_peer_t *peer;
+} udp_datagram_t;
+
+// 端点配置
+typedef struct {
+    size_t batch_size;              // 每次recvmmsg/sendmmsg的最大消息数
+    size_t max_datagram_size;       // 单个数据报的最大字节数，超过的数据报被丢弃
+    size_t max_queued;              // 发送队列上限，队列满时新的数据报被丢弃
+    int socket_buffer_size;         // 套接字收发缓冲区大小（受net.core.rmem_max/wmem_max限制），0表示系统默认
+    int offload;                    // 内核支持时启用GRO/GSO
+} udp_endpoint_config_t;
+
+// 统计
+typedef struct {
+    uint64_t datagrams_received;
+    uint64_t receive_calls;         // recvmmsg调用次数
+    uint64_t datagrams_sent;
+    uint64_t send_calls;            // sendmmsg调用次数
+    uint64_t dropped;               // 超长、发送失败或发送队列满而丢弃的数据报
+    uint64_t gro_messages;          // 收到的GRO合并消息数（每个包含多个数据报）
+    uint64_t gso_messages;          // 以GSO合并发出的消息数
+    int gro;                        // 是否已启用GRO
+    int gso;                        // 是否已启用GSO
+} udp_endpoint_stats_t;
+
+typedef struct udp_endpoint udp_endpoint_t;
+
+// 一批数据报
+typedef void (*udp_batch_cb)(udp_endpoint_t *endpoint, const udp_datagram_t *datagrams, size_t count, void *data);
+
+// 端点关闭完成
+typedef void (*udp_close_cb)(udp_endpoint_t *endpoint, void *data);
+
+// 绑定地址并开始接收，失败返回NULL
+udp_endpoint_t* udp_endpoint_start(uv_loop_t *loop, const struct sockaddr *addr, const udp_endpoint_config_t *config,
+                                   udp_batch_cb on_batch, void *data);
+
+// 发送数据报，buffer的所有权转移给端点，发出后free；队列满或参数错误时释放buffer并返回-1
+int udp_endpoint_send(udp_endpoint_t *endpoint, const udp_peer_t *peer, char *buffer, size_t length);
+
+// 暂停/恢复接收（用于背压），暂停期间数据报留在内核接收缓冲区，缓冲区满后由内核丢弃
+void udp_endpoint_pause(udp_endpoint_t *endpoint);
+void udp_endpoint_resume(udp_endpoint_t *endpoint);
+
+// 永久停止接收，已排队的数据报继续发送
+void udp_endpoint_stop_receiving(udp_endpoint_t *endpoint);
+
+// 关闭端点：尽量发出已排队的数据报，其余丢弃，句柄关闭后调用on_close并释放端点
+void udp_endpoint_close(udp_endpoint_t *endpoint, udp_close_cb on_close);
+
+// 端点是否正在关闭
+int udp_endpoint_is_closing(const udp_endpoint_t *endpoint);
+
+// 获取统计
+void udp_endpoint_get_stats(const udp_endpoint_t *endpoint, udp_endpoint_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UDP_TRANSPORT_H
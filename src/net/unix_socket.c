@@ -0,0 +1,83 @@
+#include "src/net/unix_socket.h"
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// 检查路径上已有的文件，可以绑定返回0（旧的套接字文件已删除），否则返回libuv错误码
+static int remove_stale_socket(const char *path) {
+    struct stat st;
+    if (lstat(path, &st) != 0) {
+        return errno == ENOENT ? 0 : uv_translate_sys_error(errno);
+    }
+    if (!S_ISSOCK(st.st_mode)) {
+        return UV_EADDRINUSE;
+    }
+
+    // 连接被拒绝说明没有进程在监听
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path, strlen(path));
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return uv_translate_sys_error(errno);
+    }
+    int result = connect(fd, (struct sockaddr*) &addr, sizeof(addr));
+    int error = errno;
+    close(fd);
+    if (result == 0) {
+        return UV_EADDRINUSE;
+    }
+    if (error != ECONNREFUSED) {
+        return uv_translate_sys_error(error);
+    }
+    return unlink(path) == 0 || errno == ENOENT ? 0 : uv_translate_sys_error(errno);
+}
+
+int unix_socket_listen(uv_loop_t *loop, uv_pipe_t *server, const char *path, int backlog,
+                       uv_connection_cb on_connection, void *data) {
+    if (!path || path[0] == '\0') {
+        return UV_EINVAL;
+    }
+    if (strlen(path) >= sizeof(((struct sockaddr_un*) 0)->sun_path)) {
+        return UV_ENAMETOOLONG;
+    }
+
+    int result = remove_stale_socket(path);
+    if (result != 0) {
+        return result;
+    }
+
+    result = uv_pipe_init(loop, server, 0);
+    if (result != 0) {
+        return result;
+    }
+    server->data = data;
+
+    result = uv_pipe_bind(server, path);
+    if (result == 0) {
+        result = uv_listen((uv_stream_t*) server, backlog, on_connection);
+        if (result != 0) {
+            unlink(path);
+        }
+    }
+    if (result != 0) {
+        uv_close((uv_handle_t*) server, NULL);
+    }
+    return result;
+}
+
+void unix_socket_close(uv_pipe_t *server, const char *path) {
+    // 未初始化的句柄loop为NULL；监听失败时句柄已关闭，路径上的文件不是本进程创建的
+    if (!server->loop || uv_is_closing((uv_handle_t*) server)) {
+        return;
+    }
+    uv_close((uv_handle_t*) server, NULL);
+    if (path) {
+        unlink(path);
+    }
+}
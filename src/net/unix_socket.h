@@ -0,0 +1,28 @@
+#ifndef UNIX_SOCKET_H
+#define UNIX_SOCKET_H
+
+#include <uv.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Unix域套接字监听
+// 供HTTP和增强网络模块在TCP之外（或代替TCP）监听本地套接字文件，接受的连接是uv_pipe_t，
+// 和uv_tcp_t一样按uv_stream_t读写。绑定前检查路径上已有的文件：没有进程监听的旧套接字文件
+// （上次异常退出留下）删除后重新绑定；仍有进程监听或不是套接字时不覆盖，返回UV_EADDRINUSE。
+// 关闭时删除套接字文件。
+
+// 在path上初始化并监听server，连接到达时以on_connection回调，server->data设为data
+// 成功返回0，失败返回libuv错误码（server已初始化时随之关闭）
+int unix_socket_listen(uv_loop_t *loop, uv_pipe_t *server, const char *path, int backlog,
+                       uv_connection_cb on_connection, void *data);
+
+// 关闭监听并删除套接字文件，server未初始化或已关闭时不做任何事（可以重复调用）
+void unix_socket_close(uv_pipe_t *server, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UNIX_SOCKET_H
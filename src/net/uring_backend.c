@@ -0,0 +1,989 @@
+#include "src/net/uring_backend.h"
+#include "src/log/logger_module.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/utsname.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <errno.h>
+
+// 提交队列大小，完成队列为其4倍（multishot请求会产生多个完成事件）
+#define URING_ENTRIES 256
+#define URING_CQ_ENTRIES (URING_ENTRIES * 4)
+
+// 提供缓冲区环：数量必须是2的幂，每个连接的一次接收最多占用一个缓冲区
+#define URING_BUFFER_COUNT 512
+#define URING_BUFFER_SIZE 4096
+#define URING_BUFFER_GROUP 0
+
+// 一次sendmsg最多合并的待发送缓冲区数
+#define URING_MAX_IOV 16
+
+// user_data低3位标记操作类型，其余位为监听器或连接指针
+#define URING_TAG_IGNORE 0
+#define URING_TAG_ACCEPT 1
+#define URING_TAG_RECV 2
+#define URING_TAG_SEND 3
+#define URING_TAG_MASK 7ULL
+
+// 待发送的数据
+typedef struct uring_write {
+    char *buffer;
+    size_t length;
+    size_t offset;              // 已发送的字节数
+    uring_write_cb cb;
+    void *arg;
+    struct uring_write *next;
+} uring_write_t;
+
+// 映射到用户态的提交/完成队列
+typedef struct {
+    int fd;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned sq_entries;
+    struct io_uring_sqe *sqes;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+    void *sq_map;
+    void *cq_map;
+    size_t sq_map_size;
+    size_t cq_map_size;
+    size_t sqes_size;
+    unsigned sq_local_tail;     // 已填写、尚未发布给内核的位置
+    unsigned to_submit;
+} uring_ring_t;
+
+// 连接
+struct uring_conn {
+    uring_listener_t *listener;
+    int fd;
+    int closing;
+    int recv_armed;             // multishot recv仍在内核中
+    int read_paused;            // 暂停读取，recv结束后不再重新提交
+    int send_inflight;          // sendmsg仍在内核中
+    int send_queued;            // 有待发送的数据，位于监听器的发送队列中
+    int busy;                   // 正在处理完成事件或执行用户回调，不能释放
+    uring_write_t *write_head;
+    uring_write_t *write_tail;
+    struct msghdr msg;
+    struct iovec iov[URING_MAX_IOV];
+    void *data;
+    struct uring_conn *prev;
+    struct uring_conn *next;
+    struct uring_conn *send_next;
+};
+
+// 监听器
+struct uring_listener {
+    uv_loop_t *loop;
+    uring_ring_t ring;
+    int listen_fd;
+    int accepting;              // 是否继续接收连接
+    int accept_armed;           // multishot accept仍在内核中
+    int closed;
+    uring_callbacks_t callbacks;
+    void *data;
+
+    struct io_uring_buf_ring *buf_ring;
+    size_t buf_ring_size;
+    unsigned short buf_tail;
+    char *buffers;
+
+    uring_conn_t *conns;
+    uring_conn_t *send_queue;   // 本轮写入过数据、等待提交sendmsg的连接
+    uv_poll_t poll;
+    uv_prepare_t prepare;
+    int open_handles;
+};
+
+// 系统调用封装（不依赖liburing）
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params *params) {
+    return (int) syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int) syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int sys_io_uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args) {
+    return (int) syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+// 释放队列映射
+static void ring_destroy(uring_ring_t *ring) {
+    if (ring->sqes && ring->sqes != MAP_FAILED) {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_map && ring->cq_map != MAP_FAILED && ring->cq_map != ring->sq_map) {
+        munmap(ring->cq_map, ring->cq_map_size);
+    }
+    if (ring->sq_map && ring->sq_map != MAP_FAILED) {
+        munmap(ring->sq_map, ring->sq_map_size);
+    }
+    if (ring->fd >= 0) {
+        close(ring->fd);
+    }
+    memset(ring, 0, sizeof(uring_ring_t));
+    ring->fd = -1;
+}
+
+// 创建环并映射提交/完成队列
+static int ring_init(uring_ring_t *ring, unsigned entries, unsigned cq_entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    memset(ring, 0, sizeof(uring_ring_t));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = cq_entries;
+
+    ring->fd = sys_io_uring_setup(entries, &params);
+    if (ring->fd < 0) {
+        return -errno;
+    }
+
+    ring->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cq_map_size > ring->sq_map_size) {
+            ring->sq_map_size = ring->cq_map_size;
+        }
+        ring->cq_map_size = ring->sq_map_size;
+    }
+
+    ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_map == MAP_FAILED) {
+        int err = -errno;
+        ring_destroy(ring);
+        return err;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_map = ring->sq_map;
+    } else {
+        ring->cq_map = mmap(NULL, ring->cq_map_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cq_map == MAP_FAILED) {
+            int err = -errno;
+            ring_destroy(ring);
+            return err;
+        }
+    }
+
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        int err = -errno;
+        ring_destroy(ring);
+        return err;
+    }
+
+    char *sq = (char*) ring->sq_map;
+    char *cq = (char*) ring->cq_map;
+    ring->sq_head = (unsigned*) (sq + params.sq_off.head);
+    ring->sq_tail = (unsigned*) (sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned*) (sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*) (sq + params.sq_off.array);
+    ring->sq_entries = params.sq_entries;
+    ring->cq_head = (unsigned*) (cq + params.cq_off.head);
+    ring->cq_tail = (unsigned*) (cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned*) (cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*) (cq + params.cq_off.cqes);
+    ring->sq_local_tail = *ring->sq_tail;
+    return 0;
+}
+
+// 把已填写的提交项一次性交给内核
+static int ring_submit(uring_ring_t *ring) {
+    if (ring->to_submit == 0) {
+        return 0;
+    }
+
+    __atomic_store_n(ring->sq_tail, ring->sq_local_tail, __ATOMIC_RELEASE);
+    int submitted = sys_io_uring_enter(ring->fd, ring->to_submit, 0, 0);
+    if (submitted < 0) {
+        // 完成队列暂时满或被信号打断，下一轮再提交
+        if (errno == EAGAIN || errno == EBUSY || errno == EINTR) {
+            return 0;
+        }
+        return -errno;
+    }
+
+    ring->to_submit -= (unsigned) submitted;
+    return submitted;
+}
+
+// 获取一个空闲的提交项，队列满时先提交
+static struct io_uring_sqe* ring_get_sqe(uring_ring_t *ring) {
+    unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    if (ring->sq_local_tail - head >= ring->sq_entries) {
+        ring_submit(ring);
+        head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+        if (ring->sq_local_tail - head >= ring->sq_entries) {
+            return NULL;
+        }
+    }
+
+    unsigned index = ring->sq_local_tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    ring->sq_array[index] = index;
+    ring->sq_local_tail++;
+    ring->to_submit++;
+    return sqe;
+}
+
+// 归还缓冲区到提供缓冲区环
+static void recycle_buffer(uring_listener_t *listener, unsigned short bid) {
+    struct io_uring_buf *buf = &listener->buf_ring->bufs[listener->buf_tail & (URING_BUFFER_COUNT - 1)];
+    buf->addr = (uint64_t) (uintptr_t) (listener->buffers + (size_t) bid * URING_BUFFER_SIZE);
+    buf->len = URING_BUFFER_SIZE;
+    buf->bid = bid;
+    listener->buf_tail++;
+    __atomic_store_n(&listener->buf_ring->tail, listener->buf_tail, __ATOMIC_RELEASE);
+}
+
+// 注册提供缓冲区环并放入全部缓冲区
+static int setup_buffer_ring(uring_listener_t *listener) {
+    listener->buf_ring_size = URING_BUFFER_COUNT * sizeof(struct io_uring_buf);
+    void *ring = mmap(NULL, listener->buf_ring_size, PROT_READ | PROT_WRITE,
+                      MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (ring == MAP_FAILED) {
+        return -errno;
+    }
+    listener->buf_ring = (struct io_uring_buf_ring*) ring;
+
+    listener->buffers = malloc((size_t) URING_BUFFER_COUNT * URING_BUFFER_SIZE);
+    if (!listener->buffers) {
+        return -ENOMEM;
+    }
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t) (uintptr_t) ring;
+    reg.ring_entries = URING_BUFFER_COUNT;
+    reg.bgid = URING_BUFFER_GROUP;
+    if (sys_io_uring_register(listener->ring.fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        return -errno;
+    }
+
+    for (unsigned short i = 0; i < URING_BUFFER_COUNT; i++) {
+        recycle_buffer(listener, i);
+    }
+    return 0;
+}
+
+// 提交multishot accept
+static int arm_accept(uring_listener_t *listener) {
+    struct io_uring_sqe *sqe = ring_get_sqe(&listener->ring);
+    if (!sqe) {
+        return -1;
+    }
+
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listener->listen_fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = (uint64_t) (uintptr_t) listener | URING_TAG_ACCEPT;
+    listener->accept_armed = 1;
+    return 0;
+}
+
+// 提交multishot recv，数据写入内核从缓冲区环中选出的缓冲区
+static int arm_recv(uring_conn_t *conn) {
+    struct io_uring_sqe *sqe = ring_get_sqe(&conn->listener->ring);
+    if (!sqe) {
+        return -1;
+    }
+
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conn->fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = (uint64_t) (uintptr_t) conn | URING_TAG_RECV;
+    conn->recv_armed = 1;
+    return 0;
+}
+
+// 取消仍在内核中的请求，取消本身的完成事件忽略
+static void cancel_request(uring_ring_t *ring, uint64_t user_data) {
+    struct io_uring_sqe *sqe = ring_get_sqe(ring);
+    if (!sqe) {
+        return;
+    }
+
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = user_data;
+    sqe->user_data = URING_TAG_IGNORE;
+}
+
+// 把队列中的待发送数据合并为一次sendmsg提交（同一连接同时只有一个发送请求，保证顺序）
+static int submit_send(uring_conn_t *conn) {
+    int count = 0;
+    for (uring_write_t *write = conn->write_head; write && count < URING_MAX_IOV; write = write->next) {
+        conn->iov[count].iov_base = write->buffer + write->offset;
+        conn->iov[count].iov_len = write->length - write->offset;
+        count++;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    struct io_uring_sqe *sqe = ring_get_sqe(&conn->listener->ring);
+    if (!sqe) {
+        return -1;
+    }
+
+    memset(&conn->msg, 0, sizeof(conn->msg));
+    conn->msg.msg_iov = conn->iov;
+    conn->msg.msg_iovlen = count;
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = conn->fd;
+    sqe->addr = (uint64_t) (uintptr_t) &conn->msg;
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = (uint64_t) (uintptr_t) conn | URING_TAG_SEND;
+    conn->send_inflight = 1;
+    return 0;
+}
+
+// 以status完成一串写入
+static void complete_writes(uring_conn_t *conn, uring_write_t *write, int status) {
+    while (write) {
+        uring_write_t *next = write->next;
+        if (write->cb) {
+            write->cb(conn, status, write->arg);
+        }
+        free(write->buffer);
+        free(write);
+        write = next;
+    }
+}
+
+// 连接的全部操作完成后释放连接
+static void maybe_finish_conn(uring_conn_t *conn) {
+    if (!conn->closing || conn->recv_armed || conn->send_inflight || conn->send_queued || conn->busy) {
+        return;
+    }
+
+    uring_listener_t *listener = conn->listener;
+    close(conn->fd);
+
+    if (conn->prev) {
+        conn->prev->next = conn->next;
+    } else {
+        listener->conns = conn->next;
+    }
+    if (conn->next) {
+        conn->next->prev = conn->prev;
+    }
+
+    if (listener->callbacks.on_close) {
+        listener->callbacks.on_close(conn);
+    }
+    free(conn);
+}
+
+// 处理accept完成事件
+static void handle_accept(uring_listener_t *listener, const struct io_uring_cqe *cqe) {
+    if (!(cqe->flags & IORING_CQE_F_MORE)) {
+        listener->accept_armed = 0;
+    }
+
+    if (cqe->res >= 0) {
+        int fd = cqe->res;
+        uring_conn_t *conn = listener->accepting ? calloc(1, sizeof(uring_conn_t)) : NULL;
+        if (!conn) {
+            close(fd);
+        } else {
+            int nodelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+            conn->listener = listener;
+            conn->fd = fd;
+            if (arm_recv(conn) != 0) {
+                log_error("io_uring提交队列已满，拒绝新连接");
+                close(fd);
+                free(conn);
+            } else {
+                conn->next = listener->conns;
+                if (listener->conns) {
+                    listener->conns->prev = conn;
+                }
+                listener->conns = conn;
+                if (listener->callbacks.on_connection) {
+                    listener->callbacks.on_connection(listener, conn);
+                }
+            }
+        }
+    } else if (cqe->res != -ECANCELED) {
+        log_error("io_uring接收连接失败: %s", strerror(-cqe->res));
+    }
+
+    if (listener->accept_armed || listener->closed) {
+        return;
+    }
+    if (listener->accepting) {
+        if (arm_accept(listener) != 0) {
+            log_error("io_uring重新提交accept失败");
+        }
+    } else if (listener->listen_fd >= 0) {
+        close(listener->listen_fd);
+        listener->listen_fd = -1;
+    }
+}
+
+// 处理recv完成事件
+static void handle_recv(uring_conn_t *conn, const struct io_uring_cqe *cqe) {
+    uring_listener_t *listener = conn->listener;
+
+    if (!(cqe->flags & IORING_CQE_F_MORE)) {
+        conn->recv_armed = 0;
+    }
+
+    // 处理期间连接可能被关闭，处理完成后再决定是否释放
+    conn->busy++;
+
+    if (cqe->res > 0 && (cqe->flags & IORING_CQE_F_BUFFER)) {
+        unsigned short bid = (unsigned short) (cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+        if (!conn->closing && listener->callbacks.on_data) {
+            listener->callbacks.on_data(conn, listener->buffers + (size_t) bid * URING_BUFFER_SIZE,
+                                        (size_t) cqe->res);
+        }
+        recycle_buffer(listener, bid);
+    } else if (cqe->res == 0) {
+        uring_conn_close(conn);
+    } else if (cqe->res == -ENOBUFS) {
+        // 缓冲区暂时用尽，数据仍在套接字中，重新提交即可
+    } else if (cqe->res == -ECANCELED && !conn->closing) {
+        // 暂停读取时取消，数据留在套接字中
+    } else if (cqe->res < 0) {
+        if (cqe->res != -ECANCELED && cqe->res != -ECONNRESET) {
+            log_error("io_uring读取错误: %s", strerror(-cqe->res));
+        }
+        uring_conn_close(conn);
+    }
+
+    if (!conn->recv_armed && !conn->closing && !conn->read_paused && arm_recv(conn) != 0) {
+        uring_conn_close(conn);
+    }
+
+    conn->busy--;
+    maybe_finish_conn(conn);
+}
+
+// 处理sendmsg完成事件
+static void handle_send(uring_conn_t *conn, const struct io_uring_cqe *cqe) {
+    conn->send_inflight = 0;
+
+    // 摘下已完整发送的数据，部分发送的记录偏移
+    uring_write_t *done = NULL;
+    uring_write_t **done_tail = &done;
+    int status = 0;
+
+    if (cqe->res >= 0) {
+        size_t sent = (size_t) cqe->res;
+        while (conn->write_head && sent >= conn->write_head->length - conn->write_head->offset) {
+            uring_write_t *write = conn->write_head;
+            sent -= write->length - write->offset;
+            conn->write_head = write->next;
+            write->next = NULL;
+            *done_tail = write;
+            done_tail = &write->next;
+        }
+        if (conn->write_head) {
+            conn->write_head->offset += sent;
+        } else {
+            conn->write_tail = NULL;
+        }
+    } else {
+        status = cqe->res;
+        if (status != -EPIPE && status != -ECONNRESET) {
+            log_error("io_uring写入错误: %s", strerror(-status));
+        }
+    }
+
+    // 出错或正在关闭时，剩余数据不再发送
+    uring_write_t *failed = NULL;
+    if (status < 0 || conn->closing) {
+        failed = conn->write_head;
+        conn->write_head = NULL;
+        conn->write_tail = NULL;
+    } else if (conn->write_head && submit_send(conn) != 0) {
+        status = UV_ENOBUFS;
+        failed = conn->write_head;
+        conn->write_head = NULL;
+        conn->write_tail = NULL;
+    }
+
+    conn->busy++;
+    complete_writes(conn, done, 0);
+    complete_writes(conn, failed, status < 0 ? status : UV_ECANCELED);
+    if (status < 0) {
+        uring_conn_close(conn);
+    }
+    conn->busy--;
+
+    maybe_finish_conn(conn);
+}
+
+// 为发送队列中的连接各提交一次sendmsg，本轮多次写入的数据合并发送
+static void flush_sends(uring_listener_t *listener) {
+    while (listener->send_queue) {
+        uring_conn_t *conn = listener->send_queue;
+        listener->send_queue = conn->send_next;
+        conn->send_next = NULL;
+        conn->send_queued = 0;
+
+        if (!conn->closing && !conn->send_inflight && conn->write_head && submit_send(conn) != 0) {
+            uring_write_t *failed = conn->write_head;
+            conn->write_head = NULL;
+            conn->write_tail = NULL;
+            conn->busy++;
+            complete_writes(conn, failed, UV_ENOBUFS);
+            uring_conn_close(conn);
+            conn->busy--;
+        }
+        maybe_finish_conn(conn);
+    }
+}
+
+// 处理全部已完成的事件
+static void reap_completions(uring_listener_t *listener) {
+    uring_ring_t *ring = &listener->ring;
+    unsigned head = *ring->cq_head;
+
+    for (;;) {
+        unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            break;
+        }
+
+        // 先复制并推进队头，回调中提交的新请求可以立即使用完成队列空间
+        struct io_uring_cqe cqe = ring->cqes[head & *ring->cq_mask];
+        head++;
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+        void *target = (void*) (uintptr_t) (cqe.user_data & ~URING_TAG_MASK);
+        switch (cqe.user_data & URING_TAG_MASK) {
+            case URING_TAG_ACCEPT:
+                handle_accept((uring_listener_t*) target, &cqe);
+                break;
+            case URING_TAG_RECV:
+                handle_recv((uring_conn_t*) target, &cqe);
+                break;
+            case URING_TAG_SEND:
+                handle_send((uring_conn_t*) target, &cqe);
+                break;
+            default:
+                break;
+        }
+
+        // 回调中关闭了监听器，环已释放
+        if (listener->closed) {
+            return;
+        }
+    }
+}
+
+// 环上有完成事件
+static void on_ring_poll(uv_poll_t *handle, int status, int events) {
+    uring_listener_t *listener = (uring_listener_t*) handle->data;
+    (void)events; // 避免未使用参数警告
+
+    if (status < 0) {
+        log_error("io_uring轮询错误: %s", uv_strerror(status));
+        return;
+    }
+
+    reap_completions(listener);
+    if (!listener->closed) {
+        flush_sends(listener);
+        ring_submit(&listener->ring);
+    }
+}
+
+// 事件循环阻塞前批量提交本轮产生的请求
+static void on_ring_prepare(uv_prepare_t *handle) {
+    uring_listener_t *listener = (uring_listener_t*) handle->data;
+    flush_sends(listener);
+    int result = ring_submit(&listener->ring);
+    if (result < 0) {
+        log_error("io_uring提交失败: %s", strerror(-result));
+    }
+}
+
+// 释放监听器持有的内核资源
+static void release_listener_resources(uring_listener_t *listener) {
+    if (listener->listen_fd >= 0) {
+        close(listener->listen_fd);
+        listener->listen_fd = -1;
+    }
+    // 关闭环会取消其中的全部请求
+    ring_destroy(&listener->ring);
+    if (listener->buf_ring) {
+        munmap(listener->buf_ring, listener->buf_ring_size);
+        listener->buf_ring = NULL;
+    }
+    free(listener->buffers);
+    listener->buffers = NULL;
+}
+
+// 句柄关闭回调，两个句柄都关闭后释放环，再释放内核可能仍在读取的写入缓冲区和连接
+static void on_listener_handle_close(uv_handle_t *handle) {
+    uring_listener_t *listener = (uring_listener_t*) handle->data;
+    if (--listener->open_handles > 0) {
+        return;
+    }
+
+    release_listener_resources(listener);
+    uring_conn_t *conn = listener->conns;
+    while (conn) {
+        uring_conn_t *next = conn->next;
+        complete_writes(conn, conn->write_head, UV_ECANCELED);
+        free(conn);
+        conn = next;
+    }
+    free(listener);
+}
+
+// 检测内核支持
+int uring_backend_available(void) {
+    static int available = -1;
+    if (available >= 0) {
+        return available;
+    }
+    available = 0;
+
+    // multishot recv需要6.0及以上内核
+    struct utsname uts;
+    int major = 0, minor = 0;
+    if (uname(&uts) != 0 || sscanf(uts.release, "%d.%d", &major, &minor) != 2 || major < 6) {
+        return available;
+    }
+
+    uring_ring_t ring;
+    if (ring_init(&ring, 8, 16) != 0) {
+        return available;
+    }
+
+    size_t probe_size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe *probe = calloc(1, probe_size);
+    if (probe && sys_io_uring_register(ring.fd, IORING_REGISTER_PROBE, probe, 256) == 0) {
+        const int required[] = { IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SENDMSG, IORING_OP_ASYNC_CANCEL };
+        available = 1;
+        for (size_t i = 0; i < sizeof(required) / sizeof(required[0]); i++) {
+            if (required[i] > probe->last_op || !(probe->ops[required[i]].flags & IO_URING_OP_SUPPORTED)) {
+                available = 0;
+            }
+        }
+    }
+
+    free(probe);
+    ring_destroy(&ring);
+    return available;
+}
+
+// 创建监听器
+uring_listener_t* uring_listener_start(uv_loop_t *loop, const struct sockaddr *addr, int backlog,
+                                       const uring_callbacks_t *callbacks, void *data) {
+    if (!loop || !addr || !callbacks) {
+        return NULL;
+    }
+
+    uring_listener_t *listener = calloc(1, sizeof(uring_listener_t));
+    if (!listener) {
+        return NULL;
+    }
+    listener->loop = loop;
+    listener->callbacks = *callbacks;
+    listener->data = data;
+    listener->listen_fd = -1;
+    listener->ring.fd = -1;
+
+    int result = ring_init(&listener->ring, URING_ENTRIES, URING_CQ_ENTRIES);
+    if (result != 0) {
+        log_error("io_uring初始化失败: %s", strerror(-result));
+        free(listener);
+        return NULL;
+    }
+
+    result = setup_buffer_ring(listener);
+    if (result != 0) {
+        log_error("io_uring注册缓冲区环失败: %s", strerror(-result));
+        release_listener_resources(listener);
+        free(listener);
+        return NULL;
+    }
+
+    // 创建监听套接字
+    socklen_t addr_length = addr->sa_family == AF_INET6 ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+    int reuse = 1;
+    listener->listen_fd = socket(addr->sa_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listener->listen_fd < 0 ||
+        setsockopt(listener->listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+        bind(listener->listen_fd, addr, addr_length) != 0 ||
+        listen(listener->listen_fd, backlog) != 0) {
+        log_error("io_uring监听套接字创建失败: %s", strerror(errno));
+        release_listener_resources(listener);
+        free(listener);
+        return NULL;
+    }
+
+    listener->accepting = 1;
+    if (arm_accept(listener) != 0 || ring_submit(&listener->ring) < 0) {
+        log_error("io_uring提交accept失败");
+        release_listener_resources(listener);
+        free(listener);
+        return NULL;
+    }
+
+    // 挂到事件循环：环描述符可读表示有完成事件，prepare阶段批量提交
+    uv_poll_init(loop, &listener->poll, listener->ring.fd);
+    listener->poll.data = listener;
+    uv_poll_start(&listener->poll, UV_READABLE, on_ring_poll);
+    uv_prepare_init(loop, &listener->prepare);
+    listener->prepare.data = listener;
+    uv_prepare_start(&listener->prepare, on_ring_prepare);
+    listener->open_handles = 2;
+
+    return listener;
+}
+
+// 停止接收新连接
+void uring_listener_stop_accepting(uring_listener_t *listener) {
+    if (!listener || listener->closed || !listener->accepting) {
+        return;
+    }
+
+    listener->accepting = 0;
+    if (listener->accept_armed) {
+        // 取消完成后在handle_accept中关闭监听套接字
+        cancel_request(&listener->ring, (uint64_t) (uintptr_t) listener | URING_TAG_ACCEPT);
+    } else if (listener->listen_fd >= 0) {
+        close(listener->listen_fd);
+        listener->listen_fd = -1;
+    }
+}
+
+// 关闭监听器
+void uring_listener_close(uring_listener_t *listener) {
+    if (!listener || listener->closed) {
+        return;
+    }
+    listener->closed = 1;
+    listener->accepting = 0;
+
+    // 先停止并关闭轮询句柄，事件循环不再监视环描述符，之后在句柄关闭回调中释放环
+    uv_poll_stop(&listener->poll);
+    uv_prepare_stop(&listener->prepare);
+    uv_close((uv_handle_t*) &listener->poll, on_listener_handle_close);
+    uv_close((uv_handle_t*) &listener->prepare, on_listener_handle_close);
+    if (listener->listen_fd >= 0) {
+        close(listener->listen_fd);
+        listener->listen_fd = -1;
+    }
+
+    // 立即通知未完成的写入和连接关闭；内核中的发送可能仍引用写入缓冲区，
+    // 缓冲区和连接结构保留到环释放之后
+    listener->send_queue = NULL;
+    for (uring_conn_t *conn = listener->conns; conn; conn = conn->next) {
+        conn->closing = 1;
+        for (uring_write_t *write = conn->write_head; write; write = write->next) {
+            if (write->cb) {
+                write->cb(conn, UV_ECANCELED, write->arg);
+                write->cb = NULL;
+            }
+        }
+        close(conn->fd);
+        if (listener->callbacks.on_close) {
+            listener->callbacks.on_close(conn);
+        }
+    }
+}
+
+// 获取监听器用户数据
+void* uring_listener_get_data(const uring_listener_t *listener) {
+    return listener ? listener->data : NULL;
+}
+
+// 发送数据
+int uring_conn_write(uring_conn_t *conn, char *buffer, size_t length, uring_write_cb cb, void *arg) {
+    if (!conn || !buffer || conn->closing) {
+        free(buffer);
+        return -1;
+    }
+
+    uring_write_t *write = malloc(sizeof(uring_write_t));
+    if (!write) {
+        free(buffer);
+        return -1;
+    }
+    write->buffer = buffer;
+    write->length = length;
+    write->offset = 0;
+    write->cb = cb;
+    write->arg = arg;
+    write->next = NULL;
+
+    if (conn->write_tail) {
+        conn->write_tail->next = write;
+    } else {
+        conn->write_head = write;
+    }
+    conn->write_tail = write;
+
+    // 发送请求在完成事件处理完或事件循环阻塞前提交，本轮的多次写入合并为一次sendmsg；
+    // 已有发送请求在内核中时，数据在其完成后合并发送
+    if (!conn->send_inflight && !conn->send_queued) {
+        conn->send_queued = 1;
+        conn->send_next = conn->listener->send_queue;
+        conn->listener->send_queue = conn;
+    }
+    return 0;
+}
+
+// 关闭连接
+void uring_conn_close(uring_conn_t *conn) {
+    if (!conn || conn->closing) {
+        return;
+    }
+    conn->closing = 1;
+
+    // 关闭读写方向，内核中的recv随即以EOF结束，发送中的请求以错误结束
+    shutdown(conn->fd, SHUT_RDWR);
+    if (conn->recv_armed) {
+        cancel_request(&conn->listener->ring, (uint64_t) (uintptr_t) conn | URING_TAG_RECV);
+    }
+
+    // 尚未提交的数据不再发送
+    if (!conn->send_inflight && conn->write_head) {
+        uring_write_t *pending = conn->write_head;
+        conn->write_head = NULL;
+        conn->write_tail = NULL;
+        conn->busy++;
+        complete_writes(conn, pending, UV_ECANCELED);
+        conn->busy--;
+    }
+
+    maybe_finish_conn(conn);
+}
+
+// 暂停读取
+void uring_conn_pause_reading(uring_conn_t *conn) {
+    if (!conn || conn->closing || conn->read_paused) {
+        return;
+    }
+    conn->read_paused = 1;
+    if (conn->recv_armed) {
+        cancel_request(&conn->listener->ring, (uint64_t) (uintptr_t) conn | URING_TAG_RECV);
+    }
+}
+
+// 恢复读取
+void uring_conn_resume_reading(uring_conn_t *conn) {
+    if (!conn || conn->closing || !conn->read_paused) {
+        return;
+    }
+    conn->read_paused = 0;
+
+    // recv仍在内核中（取消尚未完成）时，由其完成事件重新提交
+    if (!conn->recv_armed && arm_recv(conn) != 0) {
+        uring_conn_close(conn);
+    }
+}
+
+// 连接是否正在关闭
+int uring_conn_is_closing(const uring_conn_t *conn) {
+    return !conn || conn->closing;
+}
+
+// 设置连接用户数据
+void uring_conn_set_data(uring_conn_t *conn, void *data) {
+    if (conn) {
+        conn->data = data;
+    }
+}
+
+// 获取连接用户数据
+void* uring_conn_get_data(const uring_conn_t *conn) {
+    return conn ? conn->data : NULL;
+}
+
+#else // HAVE_IO_URING
+
+// 未编译io_uring支持时，调用者回退到libuv
+
+int uring_backend_available(void) {
+    return 0;
+}
+
+uring_listener_t* uring_listener_start(uv_loop_t *loop, const struct sockaddr *addr, int backlog,
+                                       const uring_callbacks_t *callbacks, void *data) {
+    (void)loop; (void)addr; (void)backlog; (void)callbacks; (void)data; // 避免未使用参数警告
+    return NULL;
+}
+
+void uring_listener_stop_accepting(uring_listener_t *listener) {
+    (void)listener; // 避免未使用参数警告
+}
+
+void uring_listener_close(uring_listener_t *listener) {
+    (void)listener; // 避免未使用参数警告
+}
+
+void* uring_listener_get_data(const uring_listener_t *listener) {
+    (void)listener; // 避免未使用参数警告
+    return NULL;
+}
+
+int uring_conn_write(uring_conn_t *conn, char *buffer, size_t length, uring_write_cb cb, void *arg) {
+    (void)conn; (void)length; (void)cb; (void)arg; // 避免未使用参数警告
+    free(buffer);
+    return -1;
+}
+
+void uring_conn_close(uring_conn_t *conn) {
+    (void)conn; // 避免未使用参数警告
+}
+
+void uring_conn_pause_reading(uring_conn_t *conn) {
+    (void)conn; // 避免未使用参数警告
+}
+
+void uring_conn_resume_reading(uring_conn_t *conn) {
+    (void)conn; // 避免未使用参数警告
+}
+
+int uring_conn_is_closing(const uring_conn_t *conn) {
+    (void)conn; // 避免未使用参数警告
+    return 1;
+}
+
+void uring_conn_set_data(uring_conn_t *conn, void *data) {
+    (void)conn; (void)data; // 避免未使用参数警告
+}
+
+void* uring_conn_get_data(const uring_conn_t *conn) {
+    (void)conn; // 避免未使用参数警告
+    return NULL;
+}
+
+#endif // HAVE_IO_URING
@@ -0,0 +1,66 @@
+#ifndef URING_BACKEND_H
+#define URING_BACKEND_H
+
+#include <uv.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// io_uring网络后端（Linux）
+// 监听套接字使用multishot accept，连接使用multishot recv + 提供缓冲区环（provided buffer ring）接收数据，
+// 发送请求在事件循环每轮迭代结束前批量提交，一次io_uring_enter完成本轮全部提交。
+// 环的完成事件通过uv_poll挂到libuv事件循环上，所有函数和回调都在事件循环线程执行。
+
+typedef struct uring_listener uring_listener_t;
+typedef struct uring_conn uring_conn_t;
+
+// 回调函数
+typedef struct {
+    void (*on_connection)(uring_listener_t *listener, uring_conn_t *conn);
+    void (*on_data)(uring_conn_t *conn, const char *data, size_t length);   // data在回调返回后归还缓冲区环
+    void (*on_close)(uring_conn_t *conn);                                   // 连接的全部操作完成后调用
+} uring_callbacks_t;
+
+// 写入完成回调，status为0或libuv错误码
+typedef void (*uring_write_cb)(uring_conn_t *conn, int status, void *arg);
+
+// 检测内核是否支持本后端需要的特性（multishot accept/recv、提供缓冲区环）
+int uring_backend_available(void);
+
+// 创建监听器并开始接收连接，失败返回NULL
+uring_listener_t* uring_listener_start(uv_loop_t *loop, const struct sockaddr *addr, int backlog,
+                                       const uring_callbacks_t *callbacks, void *data);
+
+// 停止接收新连接，已建立的连接不受影响
+void uring_listener_stop_accepting(uring_listener_t *listener);
+
+// 关闭监听器：立即关闭全部连接（未完成的写入以UV_ECANCELED回调），环和内存在句柄关闭后释放
+void uring_listener_close(uring_listener_t *listener);
+
+// 获取监听器的用户数据
+void* uring_listener_get_data(const uring_listener_t *listener);
+
+// 发送数据，buffer的所有权转移给后端，完成后free。同一轮事件循环中的写入合并为一次sendmsg提交
+int uring_conn_write(uring_conn_t *conn, char *buffer, size_t length, uring_write_cb cb, void *arg);
+
+// 关闭连接：停止接收，未发送的数据以UV_ECANCELED回调，操作全部完成后调用on_close
+void uring_conn_close(uring_conn_t *conn);
+
+// 暂停/恢复读取（用于背压），暂停前已在内核中完成的数据仍会回调on_data
+void uring_conn_pause_reading(uring_conn_t *conn);
+void uring_conn_resume_reading(uring_conn_t *conn);
+
+// 连接是否正在关闭
+int uring_conn_is_closing(const uring_conn_t *conn);
+
+// 连接用户数据
+void uring_conn_set_data(uring_conn_t *conn, void *data);
+void* uring_conn_get_data(const uring_conn_t *conn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // URING_BACKEND_H
@@ -0,0 +1,244 @@
+#include "src/thread/future.h"
+#include "src/thread/loop_queue.h"
+#include "src/thread/threadpool_module.h"
+#include <stdlib.h>
+
+struct future_loop {
+    loop_queue_t *queue;
+};
+
+struct future {
+    loop_queue_node_t node;             // 完成回调的队列节点
+    future_loop_t *loop;
+    int refs;
+    uv_mutex_t mutex;
+    uv_cond_t completed;
+    int status;                         // future_status_t，在锁内修改，可以不加锁读取
+    int claimed;                        // 开始执行、取消或失败时置1，只有置1的一方完成future
+    void *result;
+    future_work_fn work;                // future_submit的工作，future_then时为NULL
+    future_then_fn then_fn;
+    void *arg;
+    void *input;                        // 前一步的结果（future_then）
+    future_done_fn done;
+    void *done_arg;
+    struct future *continuations;       // 等待本future完成的后续future
+    struct future *next_continuation;
+};
+
+static void start_continuation(future_t *future, int status, void *result);
+
+// 在事件循环线程执行完成回调，释放完成队列持有的引用
+static void on_delivered(loop_queue_node_t *node, void *arg) {
+    (void)arg; // 避免未使用参数警告
+    future_t *future = (future_t*) node;
+    future->done(future, future->done_arg);
+    future_release(future);
+}
+
+future_loop_t* future_loop_create(uv_loop_t *loop) {
+    future_loop_t *future_loop = malloc(sizeof(future_loop_t));
+    if (!future_loop) {
+        return NULL;
+    }
+    future_loop->queue = loop_queue_create(loop, on_delivered, NULL);
+    if (!future_loop->queue) {
+        free(future_loop);
+        return NULL;
+    }
+    return future_loop;
+}
+
+void future_loop_destroy(future_loop_t *loop) {
+    if (!loop) {
+        return;
+    }
+    loop_queue_destroy(loop->queue);
+    free(loop);
+}
+
+// 创建future，引用归调用者
+static future_t* future_create(future_loop_t *loop, future_done_fn done, void *done_arg) {
+    if (done && !loop) {
+        return NULL;
+    }
+
+    future_t *future = calloc(1, sizeof(future_t));
+    if (!future) {
+        return NULL;
+    }
+    if (uv_mutex_init(&future->mutex) != 0) {
+        free(future);
+        return NULL;
+    }
+    if (uv_cond_init(&future->completed) != 0) {
+        uv_mutex_destroy(&future->mutex);
+        free(future);
+        return NULL;
+    }
+    future->loop = loop;
+    future->refs = 1;
+    future->status = FUTURE_PENDING;
+    future->done = done;
+    future->done_arg = done_arg;
+    return future;
+}
+
+// 设置结果，唤醒等待者，启动后续future，并把完成回调交给事件循环
+static void complete(future_t *future, int status, void *result) {
+    uv_mutex_lock(&future->mutex);
+    future->result = result;
+    __atomic_store_n(&future->status, status, __ATOMIC_RELEASE);
+    future_t *continuations = future->continuations;
+    future->continuations = NULL;
+    uv_cond_broadcast(&future->completed);
+    uv_mutex_unlock(&future->mutex);
+
+    while (continuations) {
+        future_t *next = continuations->next_continuation;
+        start_continuation(continuations, status, result);
+        continuations = next;
+    }
+
+    // 完成队列持有一个引用，回调后释放
+    if (future->done) {
+        future_retain(future);
+        if (loop_queue_post(future->loop->queue, &future->node) != 0) {
+            future_release(future);
+        }
+    }
+}
+
+// 抢占完成future的权利，工作执行、取消和失败三者只有一个成功，成功返回1
+static int claim(future_t *future) {
+    int expected = 0;
+    return __atomic_compare_exchange_n(&future->claimed, &expected, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+// 线程池中执行工作，完成后释放线程池持有的引用。已取消的future直接释放
+static void run_future(void *arg) {
+    future_t *future = (future_t*) arg;
+    if (!claim(future)) {
+        future_release(future);
+        return;
+    }
+    void *result = future->work ? future->work(future->arg) : future->then_fn(future->input, future->arg);
+    complete(future, FUTURE_DONE, result);
+    future_release(future);
+}
+
+// 提交到线程池，future的一个引用交给线程池。工作线程中提交的后续工作进入本线程的队列
+static void submit_future(future_t *future) {
+    if (threadpool_try_submit(run_future, future) != 0) {
+        if (claim(future)) {
+            complete(future, FUTURE_FAILED, NULL);
+        }
+        future_release(future);
+    }
+}
+
+// 前一步完成后启动后续future，后续future已取消时只释放前一步持有的引用
+static void start_continuation(future_t *future, int status, void *result) {
+    if (status != FUTURE_DONE || __atomic_load_n(&future->claimed, __ATOMIC_ACQUIRE)) {
+        if (claim(future)) {
+            complete(future, FUTURE_FAILED, NULL);
+        }
+        future_release(future);
+        return;
+    }
+    future->input = result;
+    submit_future(future);
+}
+
+future_t* future_submit(future_loop_t *loop, future_work_fn work, void *arg, future_done_fn done, void *done_arg) {
+    if (!work) {
+        return NULL;
+    }
+    future_t *future = future_create(loop, done, done_arg);
+    if (!future) {
+        return NULL;
+    }
+    future->work = work;
+    future->arg = arg;
+
+    future_retain(future);
+    submit_future(future);
+    return future;
+}
+
+future_t* future_then(future_t *future, future_then_fn fn, void *arg, future_done_fn done, void *done_arg) {
+    if (!future || !fn) {
+        return NULL;
+    }
+    future_t *next = future_create(future->loop, done, done_arg);
+    if (!next) {
+        return NULL;
+    }
+    next->then_fn = fn;
+    next->arg = arg;
+
+    // 后续future的一个引用由前一步持有，直到前一步完成时启动它
+    future_retain(next);
+    uv_mutex_lock(&future->mutex);
+    int status = future->status;
+    if (status == FUTURE_PENDING) {
+        next->next_continuation = future->continuations;
+        future->continuations = next;
+    }
+    uv_mutex_unlock(&future->mutex);
+
+    if (status != FUTURE_PENDING) {
+        start_continuation(next, status, future->result);
+    }
+    return next;
+}
+
+int future_cancel(future_t *future) {
+    if (!future || !claim(future)) {
+        return -1;
+    }
+    complete(future, FUTURE_CANCELLED, NULL);
+    return 0;
+}
+
+int future_wait(future_t *future, int64_t timeout_ms) {
+    uint64_t deadline = timeout_ms >= 0 ? uv_hrtime() + (uint64_t) timeout_ms * 1000000 : 0;
+    int result = 0;
+
+    uv_mutex_lock(&future->mutex);
+    while (future->status == FUTURE_PENDING && result == 0) {
+        if (timeout_ms < 0) {
+            uv_cond_wait(&future->completed, &future->mutex);
+            continue;
+        }
+        uint64_t now = uv_hrtime();
+        if (now >= deadline) {
+            result = UV_ETIMEDOUT;
+        } else {
+            uv_cond_timedwait(&future->completed, &future->mutex, deadline - now);
+        }
+    }
+    uv_mutex_unlock(&future->mutex);
+    return result;
+}
+
+int future_status(future_t *future) {
+    return __atomic_load_n(&future->status, __ATOMIC_ACQUIRE);
+}
+
+void* future_result(future_t *future) {
+    return future_status(future) == FUTURE_DONE ? future->result : NULL;
+}
+
+void future_retain(future_t *future) {
+    __atomic_add_fetch(&future->refs, 1, __ATOMIC_RELAXED);
+}
+
+void future_release(future_t *future) {
+    if (!future || __atomic_sub_fetch(&future->refs, 1, __ATOMIC_ACQ_REL) != 0) {
+        return;
+    }
+    uv_cond_destroy(&future->completed);
+    uv_mutex_destroy(&future->mutex);
+    free(future);
+}
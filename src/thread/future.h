@@ -0,0 +1,70 @@
+#ifndef FUTURE_H
+#define FUTURE_H
+
+#include <stdint.h>
+#include <uv.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 线程池任务的future
+// future_submit把工作提交到线程池（非阻塞，按线程池的拒绝策略处理），工作函数的返回值作为结果；
+// future_then在前一步成功后以其结果在线程池中执行下一步。完成回调通过future_loop_t的完成队列
+// 在指定的事件循环线程执行，同一次唤醒批量处理期间完成的全部future。
+// 其他线程可以用future_wait等待完成（不要在事件循环线程或工作线程中无限期等待）。
+// future带引用计数：提交和then返回的future归调用者所有，用完后调用future_release；
+// 线程池和完成队列各自持有引用，调用者提前释放不影响工作执行和回调。结果指针的所有权由调用者约定。
+
+typedef enum {
+    FUTURE_PENDING = 0,
+    FUTURE_DONE = 1,                // 工作已执行，结果可用
+    FUTURE_FAILED = 2,              // 线程池拒绝或未运行、内存不足，或前一步失败
+    FUTURE_CANCELLED = 3            // 开始执行前被future_cancel取消
+} future_status_t;
+
+typedef struct future future_t;
+typedef struct future_loop future_loop_t;
+
+// 工作函数，在工作线程执行（线程池拒绝策略为caller_runs时可能在提交者线程执行）
+typedef void* (*future_work_fn)(void *arg);
+
+// 后续工作，以前一步的结果为输入
+typedef void* (*future_then_fn)(void *result, void *arg);
+
+// 完成回调，在事件循环线程执行，future只在回调期间有效（需要保留时先future_retain）
+typedef void (*future_done_fn)(future_t *future, void *arg);
+
+// 创建事件循环的完成队列（在事件循环线程调用），失败返回NULL
+future_loop_t* future_loop_create(uv_loop_t *loop);
+
+// 执行已完成future的回调并释放完成队列，调用前线程池已停止或关联的future均已完成
+void future_loop_destroy(future_loop_t *loop);
+
+// 提交工作，完成后在loop的事件循环中调用done（done为NULL时不回调，loop可以为NULL）
+// 内存不足返回NULL；线程池拒绝时返回的future为FUTURE_FAILED，回调照常执行
+future_t* future_submit(future_loop_t *loop, future_work_fn work, void *arg, future_done_fn done, void *done_arg);
+
+// 在future成功完成后以其结果执行fn，返回代表fn结果的future，完成回调在future所属的事件循环执行。
+// future失败时返回的future以FUTURE_FAILED完成，不执行fn。内存不足返回NULL
+future_t* future_then(future_t *future, future_then_fn fn, void *arg, future_done_fn done, void *done_arg);
+
+// 取消尚未开始执行的future，它以FUTURE_CANCELLED完成（完成回调照常执行），后续future随之失败。
+// 成功返回0，工作已开始执行或future已完成返回-1
+int future_cancel(future_t *future);
+
+// 等待完成，timeout_ms小于0时不限时。完成返回0，超时返回UV_ETIMEDOUT
+int future_wait(future_t *future, int64_t timeout_ms);
+
+// 当前状态（future_status_t）和结果（FUTURE_DONE时有效）
+int future_status(future_t *future);
+void* future_result(future_t *future);
+
+void future_retain(future_t *future);
+void future_release(future_t *future);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FUTURE_H
@@ -0,0 +1,95 @@
+#include "src/thread/loop_queue.h"
+#include <stdlib.h>
+
+struct loop_queue {
+    uv_async_t async;
+    loop_queue_node_t *head;    // 生产者压入的链表（后投递的在前）
+    loop_queue_cb cb;
+    void *arg;
+};
+
+// 异步句柄关闭后释放队列
+static void on_async_close(uv_handle_t *handle) {
+    free(handle->data);
+}
+
+int loop_queue_drain(loop_queue_t *queue) {
+    // 一次取走全部节点，生产者随后压入的节点会重新唤醒事件循环
+    loop_queue_node_t *node = __atomic_exchange_n(&queue->head, NULL, __ATOMIC_ACQUIRE);
+
+    // 反转链表，按投递顺序回调
+    loop_queue_node_t *ordered = NULL;
+    while (node) {
+        loop_queue_node_t *next = node->next;
+        node->next = ordered;
+        ordered = node;
+        node = next;
+    }
+
+    int count = 0;
+    while (ordered) {
+        loop_queue_node_t *next = ordered->next;
+        queue->cb(ordered, queue->arg);
+        ordered = next;
+        count++;
+    }
+    return count;
+}
+
+// 事件循环被唤醒
+static void on_async(uv_async_t *handle) {
+    loop_queue_drain((loop_queue_t*) handle->data);
+}
+
+loop_queue_t* loop_queue_create(uv_loop_t *loop, loop_queue_cb cb, void *arg) {
+    if (!loop || !cb) {
+        return NULL;
+    }
+
+    loop_queue_t *queue = calloc(1, sizeof(loop_queue_t));
+    if (!queue) {
+        return NULL;
+    }
+    if (uv_async_init(loop, &queue->async, on_async) != 0) {
+        free(queue);
+        return NULL;
+    }
+    queue->async.data = queue;
+    queue->cb = cb;
+    queue->arg = arg;
+
+    // 队列本身不阻止事件循环退出，由持有连接、定时器等句柄的模块决定事件循环的生命周期
+    uv_unref((uv_handle_t*) &queue->async);
+    return queue;
+}
+
+int loop_queue_post(loop_queue_t *queue, loop_queue_node_t *node) {
+    if (!queue || !node) {
+        return -1;
+    }
+
+    loop_queue_node_t *head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    do {
+        node->next = head;
+    } while (!__atomic_compare_exchange_n(&queue->head, &head, node, 1,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    // 队列原本非空时，先投递的生产者已经（或即将）唤醒事件循环
+    if (head == NULL) {
+        uv_async_send(&queue->async);
+    }
+    return 0;
+}
+
+void loop_queue_destroy(loop_queue_t *queue) {
+    if (!queue) {
+        return;
+    }
+
+    loop_queue_drain(queue);
+    if (uv_is_closing((uv_handle_t*) &queue->async)) {
+        free(queue);
+    } else {
+        uv_close((uv_handle_t*) &queue->async, on_async_close);
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef LOOP_QUEUE_H
+#define LOOP_QUEUE_H
+
+#include <uv.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 事件循环完成队列（多生产者/单消费者）
+// 任意线程把节点投递到队列，事件循环线程通过uv_async_t批量取出并按投递顺序回调。
+// 投递是无锁的（原子交换链表头），只有队列由空变为非空时才唤醒事件循环，
+// 一次唤醒处理期间到达的全部节点。libuv句柄不是线程安全的，工作线程的结果必须经由此类队列回到事件循环。
+
+// 侵入式节点，嵌入到投递的结构体中
+typedef struct loop_queue_node {
+    struct loop_queue_node *next;
+} loop_queue_node_t;
+
+// 在事件循环线程中对每个节点调用，节点的所有权交给回调
+typedef void (*loop_queue_cb)(loop_queue_node_t *node, void *arg);
+
+typedef struct loop_queue loop_queue_t;
+
+// 创建队列（在事件循环线程调用）。异步句柄不保持事件循环运行，失败返回NULL
+loop_queue_t* loop_queue_create(uv_loop_t *loop, loop_queue_cb cb, void *arg);
+
+// 投递一个节点，可在任意线程调用，成功返回0
+int loop_queue_post(loop_queue_t *queue, loop_queue_node_t *node);
+
+// 在事件循环线程中立即处理队列中的全部节点，返回处理的节点数
+int loop_queue_drain(loop_queue_t *queue);
+
+// 处理剩余节点并释放队列，调用前所有生产者必须已经停止。
+// 异步句柄已被关闭（例如退出前遍历关闭全部句柄）时立即释放，否则在句柄关闭后释放
+void loop_queue_destroy(loop_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOOP_QUEUE_H
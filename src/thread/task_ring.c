@@ -0,0 +1,111 @@
+#include "src/thread/task_ring.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+#define TASK_RING_CACHE_LINE 64
+
+typedef struct {
+    size_t sequence;
+    work_task_t task;
+} ring_slot_t;
+
+// 入队和出队位置分别被生产者和消费者修改，放在不同的缓存行
+struct task_ring {
+    ring_slot_t *slots;
+    size_t mask;
+    char pad0[TASK_RING_CACHE_LINE - sizeof(ring_slot_t*) - sizeof(size_t)];
+    size_t enqueue_pos;
+    char pad1[TASK_RING_CACHE_LINE - sizeof(size_t)];
+    size_t dequeue_pos;
+    char pad2[TASK_RING_CACHE_LINE - sizeof(size_t)];
+};
+
+task_ring_t* task_ring_create(size_t capacity) {
+    size_t rounded = 2;
+    while (rounded < capacity) {
+        rounded *= 2;
+    }
+
+    task_ring_t *ring = calloc(1, sizeof(task_ring_t));
+    if (!ring) {
+        return NULL;
+    }
+    ring->slots = malloc(rounded * sizeof(ring_slot_t));
+    if (!ring->slots) {
+        free(ring);
+        return NULL;
+    }
+    for (size_t i = 0; i < rounded; i++) {
+        ring->slots[i].sequence = i;
+    }
+    ring->mask = rounded - 1;
+    return ring;
+}
+
+void task_ring_destroy(task_ring_t *ring) {
+    if (!ring) {
+        return;
+    }
+    free(ring->slots);
+    free(ring);
+}
+
+int task_ring_push(task_ring_t *ring, const work_task_t *task) {
+    size_t pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+    ring_slot_t *slot;
+    for (;;) {
+        slot = &ring->slots[pos & ring->mask];
+        size_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t) sequence - (intptr_t) pos;
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->enqueue_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // 槽位上一轮的任务尚未被取走，环已满
+            return -1;
+        } else {
+            pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->task = *task;
+    __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+int task_ring_pop(task_ring_t *ring, work_task_t *task) {
+    size_t pos = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_RELAXED);
+    ring_slot_t *slot;
+    for (;;) {
+        slot = &ring->slots[pos & ring->mask];
+        size_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t) sequence - (intptr_t) (pos + 1);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->dequeue_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // 槽位还没有写入任务，环为空
+            return 0;
+        } else {
+            pos = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    *task = slot->task;
+    __atomic_store_n(&slot->sequence, pos + ring->mask + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+size_t task_ring_capacity(const task_ring_t *ring) {
+    return ring->mask + 1;
+}
+
+size_t task_ring_size(const task_ring_t *ring) {
+    size_t dequeue = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_RELAXED);
+    size_t enqueue = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+    return enqueue > dequeue ? enqueue - dequeue : 0;
+}
@@ -0,0 +1,40 @@
+#ifndef TASK_RING_H
+#define TASK_RING_H
+
+#include "src/thread/work_deque.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 有界多生产者/多消费者任务环（Vyukov）
+// 每个槽位带一个序号：序号等于入队位置时槽位空闲，等于入队位置+1时槽位有任务。
+// 生产者和消费者各自用CAS推进入队和出队位置，抢到位置后独占对应槽位读写任务，
+// 再发布新的序号。没有锁，任务按值存放在槽位中，不分配内存；环满时入队失败，由调用者决定等待还是放弃。
+
+typedef struct task_ring task_ring_t;
+
+// 创建任务环，capacity向上取整为2的幂，失败返回NULL
+task_ring_t* task_ring_create(size_t capacity);
+
+// 销毁任务环，调用前所有线程都不再访问它
+void task_ring_destroy(task_ring_t *ring);
+
+// 入队，成功返回0，环已满返回-1
+int task_ring_push(task_ring_t *ring, const work_task_t *task);
+
+// 出队，成功返回1，环为空返回0
+int task_ring_pop(task_ring_t *ring, work_task_t *task);
+
+// 容量
+size_t task_ring_capacity(const task_ring_t *ring);
+
+// 当前任务数（并发修改时只是近似值）
+size_t task_ring_size(const task_ring_t *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_RING_H
@@ -1,16 +1,34 @@
 #include "src/thread/threadpool_module.h"
+#include "src/thread/work_deque.h"
+#include "src/thread/task_ring.h"
 #include "src/log/logger_module.h"
+#include "src/config/config_module.h"
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <uv.h>
 
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 // 默认配置
 static threadpool_config_t default_config = {
-    .thread_count = 4,
+    .thread_count = 0,
     .max_queue_size = 1000,
     .enable_work_stealing = 1,
-    .enable_priority_queue = 1
+    .enable_priority_queue = 1,
+    .rejection_policy = THREADPOOL_REJECT,
+    .min_threads = 0,
+    .max_threads = 0,
+    .target_wait_ms = 10,
+    .adapt_interval_ms = 100
 };
 
 // 线程池模块接口定义
@@ -21,82 +39,445 @@ module_interface_t threadpool_module = {
     .start = threadpool_module_start,
     .stop = threadpool_module_stop,
     .cleanup = threadpool_module_cleanup,
+    .quiesce = NULL,
+    .pending = threadpool_module_pending,
     .state = MODULE_STATE_UNINITIALIZED,
     .private_data = NULL,
     .dependencies = NULL,
     .dependency_count = 0
 };
 
+// 工作线程队列的初始容量，写满时自动扩容
+#define WORKER_DEQUE_CAPACITY 256
+
+// 空闲线程进入内核等待前检查工作的次数
+#define IDLE_SPIN_ROUNDS 128
+
+#if defined(__x86_64__) || defined(__i386__)
+#define cpu_relax() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define cpu_relax() __asm__ __volatile__("yield")
+#else
+#define cpu_relax() ((void) 0)
+#endif
+
+// 工作线程
+typedef struct threadpool_worker {
+    threadpool_private_data_t *pool;
+    work_deque_t *deque;            // 本线程提交的工作，未启用工作窃取时为NULL
+    uint32_t random;                // 选择窃取对象的随机数状态
+    uint64_t executed;              // 执行的工作数
+    uint64_t stolen;                // 从其他线程窃取的工作数
+    unsigned schedule_position;     // 在level_schedule中的位置
+    uint64_t dequeued[THREADPOOL_PRIORITY_LEVELS];      // 各级别出队的工作数
+    uint64_t wait_ns[THREADPOOL_PRIORITY_LEVELS];       // 各级别出队工作的排队时间之和
+    uint64_t max_wait_ns[THREADPOOL_PRIORITY_LEVELS];
+    int index;
+} threadpool_worker_t;
+
+// 各级别按权重4:2:1平滑交错的出队顺序：各级别都有工作时，高、普通、低优先级分别得到4/7、2/7、1/7的出队机会
+static const unsigned char level_schedule[] = {
+    THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL, THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_LOW,
+    THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL, THREADPOOL_PRIORITY_HIGH
+};
+
+static const char *const level_names[THREADPOOL_PRIORITY_LEVELS] = { "高", "普通", "低" };
+
+// 溢出链表节点，只在注入队列已满时分配
+typedef struct overflow_work {
+    work_task_t task;
+    struct overflow_work *next;
+} overflow_work_t;
+
+// 拒绝策略的配置名称，下标为threadpool_rejection_policy_t
+static const char *const rejection_policy_names[] = {
+    "reject", "caller_runs", "drop_oldest", "overflow"
+};
+
 // 全局线程池数据
 static threadpool_private_data_t *global_threadpool_data = NULL;
 
+// 当前线程对应的工作线程，非工作线程为NULL
+static __thread threadpool_worker_t *current_worker = NULL;
+
+#ifdef __linux__
+// 序号（wake_epoch或park_epoch）仍为epoch时睡眠
+static void idle_sleep(threadpool_private_data_t *pool, int *word, int epoch) {
+    (void)pool; // 避免未使用参数警告
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, epoch, NULL, NULL, 0);
+}
+
+// 唤醒count个在word上睡眠的线程，调用前已增加序号
+static void idle_wake(threadpool_private_data_t *pool, int *word, int count) {
+    (void)pool; // 避免未使用参数警告
+    syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+#else
+// 其他平台用条件变量代替futex，序号在锁内检查。两个序号共用条件变量，唤醒时全部唤醒
+static void idle_sleep(threadpool_private_data_t *pool, int *word, int epoch) {
+    uv_mutex_lock(&pool->queue_mutex);
+    while (__atomic_load_n(word, __ATOMIC_SEQ_CST) == epoch) {
+        uv_cond_wait(&pool->work_available, &pool->queue_mutex);
+    }
+    uv_mutex_unlock(&pool->queue_mutex);
+}
+
+static void idle_wake(threadpool_private_data_t *pool, int *word, int count) {
+    (void)word; // 避免未使用参数警告
+    (void)count; // 避免未使用参数警告
+    uv_mutex_lock(&pool->queue_mutex);
+    uv_cond_broadcast(&pool->work_available);
+    uv_mutex_unlock(&pool->queue_mutex);
+}
+#endif
+
+// 新工作已计入queued_work，有空闲线程时唤醒一个
+static void wake_idle_worker(threadpool_private_data_t *pool) {
+    // 与wait_for_work配对：先增加工作数再检查空闲数
+    if (__atomic_load_n(&pool->idle_workers, __ATOMIC_SEQ_CST) > 0) {
+        __atomic_add_fetch(&pool->wake_epoch, 1, __ATOMIC_SEQ_CST);
+        idle_wake(pool, &pool->wake_epoch, 1);
+    }
+}
+
+// 唤醒全部工作线程：关闭时，或目标线程数改变后让休眠的线程重新检查
+static void wake_all_workers(threadpool_private_data_t *pool) {
+    __atomic_add_fetch(&pool->wake_epoch, 1, __ATOMIC_SEQ_CST);
+    idle_wake(pool, &pool->wake_epoch, INT_MAX);
+    __atomic_add_fetch(&pool->park_epoch, 1, __ATOMIC_SEQ_CST);
+    idle_wake(pool, &pool->park_epoch, INT_MAX);
+}
+
+// xorshift32
+static uint32_t next_random(threadpool_worker_t *worker) {
+    uint32_t x = worker->random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    worker->random = x;
+    return x;
+}
+
+// 从随机选择的其他线程开始依次尝试窃取，与其他线程争抢失败时再扫描一遍
+static int steal_work(threadpool_worker_t *worker, work_task_t *task) {
+    threadpool_private_data_t *pool = worker->pool;
+    int count = __atomic_load_n(&pool->started_threads, __ATOMIC_ACQUIRE);
+    if (count < 2) {
+        return 0;
+    }
+    
+    int contended;
+    do {
+        contended = 0;
+        int start = (int) (next_random(worker) % (uint32_t) count);
+        for (int i = 0; i < count; i++) {
+            threadpool_worker_t *victim = &pool->workers[(start + i) % count];
+            if (victim == worker) {
+                continue;
+            }
+            int result = work_deque_steal(victim->deque, task);
+            if (result > 0) {
+                __atomic_store_n(&worker->stolen, worker->stolen + 1, __ATOMIC_RELAXED);
+                return 1;
+            }
+            if (result < 0) {
+                contended = 1;
+            }
+        }
+    } while (contended);
+    return 0;
+}
+
+// 从溢出链表头部取出一个工作，链表为空返回0
+static int take_overflow_work(threadpool_private_data_t *pool, work_task_t *task) {
+    if (__atomic_load_n(&pool->overflow_work, __ATOMIC_ACQUIRE) == 0) {
+        return 0;
+    }
+    
+    uv_mutex_lock(&pool->overflow_mutex);
+    overflow_work_t *work = pool->overflow_head;
+    if (work) {
+        pool->overflow_head = work->next;
+        if (!pool->overflow_head) {
+            pool->overflow_tail = NULL;
+        }
+        __atomic_sub_fetch(&pool->overflow_work, 1, __ATOMIC_RELEASE);
+    }
+    uv_mutex_unlock(&pool->overflow_mutex);
+    
+    if (!work) {
+        return 0;
+    }
+    *task = work->task;
+    free(work);
+    return 1;
+}
+
+// 从一个级别的注入队列（普通级别还包括溢出链表）取出工作并记录排队时间，没有工作返回0
+static int pop_level(threadpool_worker_t *worker, int level, work_task_t *task) {
+    threadpool_private_data_t *pool = worker->pool;
+    if (!task_ring_pop(pool->queues[level], task) &&
+        !(level == THREADPOOL_PRIORITY_NORMAL && take_overflow_work(pool, task))) {
+        return 0;
+    }
+    
+    // 有提交者等待该级别的队列空间时唤醒一个（取出任务后的屏障与提交者登记后的重试配对）
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pool->waiting_submitters[level], __ATOMIC_SEQ_CST) > 0) {
+        uv_mutex_lock(&pool->queue_mutex);
+        uv_cond_signal(&pool->queue_not_full[level]);
+        uv_mutex_unlock(&pool->queue_mutex);
+    }
+    
+    uint64_t wait = uv_hrtime() - task->enqueue_time;
+    __atomic_store_n(&worker->dequeued[level], worker->dequeued[level] + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&worker->wait_ns[level], worker->wait_ns[level] + wait, __ATOMIC_RELAXED);
+    if (wait > worker->max_wait_ns[level]) {
+        __atomic_store_n(&worker->max_wait_ns[level], wait, __ATOMIC_RELAXED);
+    }
+    return 1;
+}
+
+// 查找下一个工作：按权重轮到的级别、自己的队列、其余级别（从高到低），最后窃取。找到返回1
+static int find_work(threadpool_worker_t *worker, work_task_t *task) {
+    size_t position = worker->schedule_position++ % (sizeof(level_schedule) / sizeof(level_schedule[0]));
+    int preferred = level_schedule[position];
+    
+    if (pop_level(worker, preferred, task) || (worker->deque && work_deque_pop(worker->deque, task))) {
+        return 1;
+    }
+    for (int level = 0; level < THREADPOOL_PRIORITY_LEVELS; level++) {
+        if (level != preferred && pop_level(worker, level, task)) {
+            return 1;
+        }
+    }
+    return worker->deque ? steal_work(worker, task) : 0;
+}
+
+// 没有可取的工作时先自旋等待，仍然没有时睡眠。收到关闭信号且全部工作已取走时返回-1
+static int wait_for_work(threadpool_private_data_t *pool) {
+    for (int i = 0; i < IDLE_SPIN_ROUNDS; i++) {
+        if (__atomic_load_n(&pool->queued_work, __ATOMIC_RELAXED) > 0) {
+            return 0;
+        }
+        cpu_relax();
+    }
+    
+    // 先取唤醒序号并登记为空闲，再检查工作数：提交者随后看到空闲线程时会改变序号，睡眠立即返回
+    int epoch = __atomic_load_n(&pool->wake_epoch, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&pool->idle_workers, 1, __ATOMIC_SEQ_CST);
+    int result = 0;
+    if (__atomic_load_n(&pool->queued_work, __ATOMIC_SEQ_CST) == 0) {
+        if (__atomic_load_n(&pool->shutdown, __ATOMIC_SEQ_CST)) {
+            result = -1;
+        } else {
+            idle_sleep(pool, &pool->wake_epoch, epoch);
+        }
+    }
+    __atomic_sub_fetch(&pool->idle_workers, 1, __ATOMIC_SEQ_CST);
+    
+    return result;
+}
+
+// 序号不小于目标线程数时返回1（关闭时所有线程都继续执行剩余的工作）
+static int is_surplus(threadpool_worker_t *worker) {
+    threadpool_private_data_t *pool = worker->pool;
+    return worker->index >= __atomic_load_n(&pool->target_threads, __ATOMIC_SEQ_CST) &&
+           !__atomic_load_n(&pool->shutdown, __ATOMIC_SEQ_CST);
+}
+
+// 超出目标线程数的线程休眠，直到目标线程数改变或关闭。
+// 先取休眠序号再检查目标线程数：调整者先修改目标线程数再改变序号，睡眠立即返回
+static void park_worker(threadpool_worker_t *worker) {
+    threadpool_private_data_t *pool = worker->pool;
+    
+    // 本线程可能是刚被提交者唤醒的空闲线程，把唤醒转给其他空闲线程
+    if (__atomic_load_n(&pool->queued_work, __ATOMIC_SEQ_CST) > 0) {
+        wake_idle_worker(pool);
+    }
+    
+    int epoch = __atomic_load_n(&pool->park_epoch, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&pool->parked_workers, 1, __ATOMIC_SEQ_CST);
+    if (is_surplus(worker)) {
+        idle_sleep(pool, &pool->park_epoch, epoch);
+    }
+    __atomic_sub_fetch(&pool->parked_workers, 1, __ATOMIC_SEQ_CST);
+}
+
+// 执行一个工作
+static void run_work(threadpool_worker_t *worker, const work_task_t *task) {
+    threadpool_private_data_t *pool = worker->pool;
+    
+    // 先计入执行中再从排队数中减去，pending()不会在两者之间看到0
+    __atomic_add_fetch(&pool->active_threads, 1, __ATOMIC_SEQ_CST);
+    __atomic_sub_fetch(&pool->queued_work, 1, __ATOMIC_SEQ_CST);
+    
+    task->func(task->data);
+    __atomic_store_n(&worker->executed, worker->executed + 1, __ATOMIC_RELAXED);
+    
+    __atomic_sub_fetch(&pool->active_threads, 1, __ATOMIC_RELAXED);
+}
+
 // 工作线程函数
 static void worker_thread(void *arg) {
-    threadpool_private_data_t *pool = (threadpool_private_data_t*) arg;
+    threadpool_worker_t *worker = (threadpool_worker_t*) arg;
+    threadpool_private_data_t *pool = worker->pool;
+    current_worker = worker;
     
+    // 收到关闭信号后先把已排队的工作执行完再退出。超出目标线程数时执行完当前工作后休眠，
+    // 自己队列中剩余的工作由其他线程窃取
     while (1) {
-        uv_mutex_lock(&pool->queue_mutex);
-        
-        // 等待工作或关闭信号
-        while (pool->work_queue == NULL && pool->priority_queue == NULL && !pool->shutdown) {
-            uv_cond_wait(&pool->work_available, &pool->queue_mutex);
-        }
-        
-        // 检查是否应该关闭
-        if (pool->shutdown) {
-            uv_mutex_unlock(&pool->queue_mutex);
+        work_task_t task;
+        if (is_surplus(worker)) {
+            park_worker(worker);
+        } else if (find_work(worker, &task)) {
+            run_work(worker, &task);
+        } else if (wait_for_work(pool) != 0) {
             break;
         }
-        
-        // 获取工作项（优先处理优先级队列）
-        work_item_t *work = NULL;
-        if (pool->priority_queue != NULL) {
-            work = pool->priority_queue;
-            pool->priority_queue = work->next;
-        } else if (pool->work_queue != NULL) {
-            work = pool->work_queue;
-            pool->work_queue = work->next;
+    }
+    
+    current_worker = NULL;
+}
+
+// 可用的CPU数
+static int available_cpus(void) {
+#if UV_VERSION_HEX >= 0x012c00
+    return (int) uv_available_parallelism();
+#else
+    uv_cpu_info_t *cpus;
+    int count;
+    if (uv_cpu_info(&cpus, &count) != 0) {
+        return 1;
+    }
+    uv_free_cpu_info(cpus, count);
+    return count > 0 ? count : 1;
+#endif
+}
+
+// 已创建线程的CPU时间之和（纳秒），无法取得时返回0
+static uint64_t workers_cpu_time(threadpool_private_data_t *pool) {
+    uint64_t total = 0;
+#ifdef __linux__
+    for (int i = 0; i < pool->started_threads; i++) {
+        clockid_t clock;
+        struct timespec ts;
+        if (pthread_getcpuclockid(pool->threads[i], &clock) == 0 && clock_gettime(clock, &ts) == 0) {
+            total += (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
         }
-        
-        if (work != NULL) {
-            pool->queued_work--;
-            pool->active_threads++;
-            uv_mutex_unlock(&pool->queue_mutex);
-            
-            // 执行工作
-            work->func(work->data);
-            
-            // 释放工作项
-            free(work);
-            
-            uv_mutex_lock(&pool->queue_mutex);
-            pool->active_threads--;
-            uv_cond_signal(&pool->queue_not_full);
-            uv_mutex_unlock(&pool->queue_mutex);
-        } else {
-            uv_mutex_unlock(&pool->queue_mutex);
+    }
+#else
+    (void)pool; // 避免未使用参数警告
+#endif
+    return total;
+}
+
+// 创建工作线程直到started_threads达到count，失败返回-1
+static int start_workers(threadpool_private_data_t *pool, int count) {
+    while (pool->started_threads < count) {
+        int i = pool->started_threads;
+        if (uv_thread_create(&pool->threads[i], worker_thread, &pool->workers[i]) != 0) {
+            log_error("创建工作线程 %d 失败", i);
+            return -1;
         }
+        // 发布后其他线程才从它的队列窃取
+        __atomic_store_n(&pool->started_threads, i + 1, __ATOMIC_RELEASE);
     }
+    return 0;
 }
 
-// 创建新的工作项
-static work_item_t* create_work_item(work_function_t func, void *data) {
-    work_item_t *item = malloc(sizeof(work_item_t));
-    if (!item) {
-        return NULL;
+// 修改目标线程数（不超过线程槽位数），需要时创建线程，并唤醒休眠的线程重新检查
+static void set_target_threads(threadpool_private_data_t *pool, int target) {
+    if (target > pool->thread_count) {
+        target = pool->thread_count;
     }
+    if (start_workers(pool, target) != 0) {
+        target = pool->started_threads;
+    }
+    __atomic_store_n(&pool->target_threads, target, __ATOMIC_SEQ_CST);
+    wake_all_workers(pool);
+}
+
+// 按上一周期的排队时间和工作线程的CPU时间调整目标线程数（事件循环线程）。
+// 有工作排队、排队时间超过目标（或一个工作都没有出队）且CPU有空闲时，说明线程阻塞在I/O或锁上，
+// 按空闲的CPU数增加线程；没有排队工作且有空闲线程，或线程数多于CPU数且CPU已用满时每周期减少一个
+static void on_adapt_timer(uv_timer_t *handle) {
+    threadpool_private_data_t *pool = (threadpool_private_data_t*) handle->data;
     
-    item->func = func;
-    item->data = data;
-    item->next = NULL;
+    uint64_t now = uv_hrtime();
+    uint64_t dequeued = 0;
+    uint64_t wait_ns = 0;
+    for (int i = 0; i < pool->started_threads; i++) {
+        threadpool_worker_t *worker = &pool->workers[i];
+        for (int level = 0; level < THREADPOOL_PRIORITY_LEVELS; level++) {
+            dequeued += __atomic_load_n(&worker->dequeued[level], __ATOMIC_RELAXED);
+            wait_ns += __atomic_load_n(&worker->wait_ns[level], __ATOMIC_RELAXED);
+        }
+    }
+    uint64_t cpu_ns = workers_cpu_time(pool);
+    
+    uint64_t elapsed = now - pool->adapt_time;
+    uint64_t window_dequeued = dequeued - pool->adapt_dequeued;
+    uint64_t window_wait_ns = wait_ns - pool->adapt_wait_ns;
+    double busy = elapsed > 0 && cpu_ns > pool->adapt_cpu_ns ? (double) (cpu_ns - pool->adapt_cpu_ns) / (double) elapsed : 0;
+    pool->adapt_time = now;
+    pool->adapt_dequeued = dequeued;
+    pool->adapt_wait_ns = wait_ns;
+    pool->adapt_cpu_ns = cpu_ns;
+    
+    int queued = __atomic_load_n(&pool->queued_work, __ATOMIC_RELAXED);
+    int idle = __atomic_load_n(&pool->idle_workers, __ATOMIC_RELAXED);
+    int target = pool->target_threads;
+    uint64_t target_wait_ns = (uint64_t) pool->config.target_wait_ms * 1000000;
+    double cpus = (double) pool->cpu_count;
+    
+    int next = target;
+    if (queued > 0 && target < pool->config.max_threads && busy < cpus - 0.5 &&
+        (window_dequeued == 0 || window_wait_ns / window_dequeued > target_wait_ns)) {
+        int extra = (int) (cpus - busy + 0.5);
+        next = target + (extra > 1 ? extra : 1);
+        if (next > pool->config.max_threads) {
+            next = pool->config.max_threads;
+        }
+    } else if (target > pool->config.min_threads &&
+               ((queued == 0 && idle > 0) || (target > pool->cpu_count && busy >= cpus - 0.5))) {
+        next = target - 1;
+    }
     
-    return item;
+    if (next != target) {
+        set_target_threads(pool, next);
+        log_debug("线程池目标线程数 %d -> %d（排队 %d，平均等待 %llu us，CPU占用 %.2f）", target, pool->target_threads,
+                  queued, (unsigned long long) (window_dequeued ? window_wait_ns / window_dequeued / 1000 : 0), busy);
+    }
+}
+
+// 把配置中表示自动的0换算为实际的线程数和调整范围，写回config。会调整线程数时返回1
+static int resolve_thread_limits(threadpool_private_data_t *pool, threadpool_config_t *config) {
+    int base = config->thread_count > 0 ? config->thread_count : pool->cpu_count;
+    if (config->min_threads <= 0) {
+        config->min_threads = base;
+    }
+    if (config->max_threads <= 0) {
+        config->max_threads = base * 4;
+    }
+    if (config->max_threads < config->min_threads) {
+        config->max_threads = config->min_threads;
+    }
+    if (base < config->min_threads) {
+        base = config->min_threads;
+    } else if (base > config->max_threads) {
+        base = config->max_threads;
+    }
+    config->thread_count = base;
+    int adaptive = pool->loop && config->adapt_interval_ms > 0 && config->max_threads > config->min_threads;
+    if (!adaptive) {
+        config->min_threads = config->max_threads = base;
+    }
+    return adaptive;
 }
 
 // 线程池模块初始化
 int threadpool_module_init(module_interface_t *self, uv_loop_t *loop) {
-    (void)loop; // 避免未使用参数警告
-    
     if (!self) {
         return -1;
     }
@@ -110,28 +491,34 @@ int threadpool_module_init(module_interface_t *self, uv_loop_t *loop) {
     // 初始化私有数据
     memset(data, 0, sizeof(threadpool_private_data_t));
     data->config = default_config;
-    data->threads = malloc(sizeof(uv_thread_t) * data->config.thread_count);
-    if (!data->threads) {
-        free(data);
-        return -1;
-    }
     
     // 初始化同步原语
     if (uv_mutex_init(&data->queue_mutex) != 0 ||
         uv_cond_init(&data->work_available) != 0 ||
-        uv_cond_init(&data->queue_not_full) != 0) {
-        free(data->threads);
+        uv_mutex_init(&data->overflow_mutex) != 0) {
         free(data);
         return -1;
     }
+    for (int level = 0; level < THREADPOOL_PRIORITY_LEVELS; level++) {
+        if (uv_cond_init(&data->queue_not_full[level]) != 0) {
+            free(data);
+            return -1;
+        }
+    }
     
-    data->work_queue = NULL;
-    data->priority_queue = NULL;
     data->shutdown = 0;
     data->active_threads = 0;
     data->queued_work = 0;
     data->max_queue_size = data->config.max_queue_size;
     
+    // 没有事件循环时不调整线程数
+    data->cpu_count = available_cpus();
+    data->loop = loop;
+    if (loop) {
+        uv_timer_init(loop, &data->adapt_timer);
+        data->adapt_timer.data = data;
+    }
+    
     self->private_data = data;
     global_threadpool_data = data;
     
@@ -146,16 +533,91 @@ int threadpool_module_start(module_interface_t *self) {
     }
     
     threadpool_private_data_t *data = (threadpool_private_data_t*) self->private_data;
+    threadpool_config_t *config = &data->config;
     
-    // 创建工作线程
-    for (int i = 0; i < data->config.thread_count; i++) {
-        if (uv_thread_create(&data->threads[i], worker_thread, data) != 0) {
-            log_error("创建工作线程 %d 失败", i);
+    config->thread_count = config_get_int("threadpool_thread_count", config->thread_count);
+    config->min_threads = config_get_int("threadpool_min_threads", config->min_threads);
+    config->max_threads = config_get_int("threadpool_max_threads", config->max_threads);
+    config->max_queue_size = config_get_int("threadpool_max_queue_size", config->max_queue_size);
+    config->enable_work_stealing = config_get_bool("threadpool_enable_work_stealing", config->enable_work_stealing);
+    config->enable_priority_queue = config_get_bool("threadpool_enable_priority_queue", config->enable_priority_queue);
+    config->target_wait_ms = config_get_int("threadpool_target_wait_ms", config->target_wait_ms);
+    config->adapt_interval_ms = config_get_int("threadpool_adapt_interval_ms", config->adapt_interval_ms);
+    data->max_queue_size = config->max_queue_size;
+    
+    const char *policy = config_get_string("threadpool_rejection_policy",
+                                           rejection_policy_names[data->config.rejection_policy]);
+    int found = 0;
+    for (size_t i = 0; i < sizeof(rejection_policy_names) / sizeof(rejection_policy_names[0]); i++) {
+        if (strcmp(policy, rejection_policy_names[i]) == 0) {
+            data->config.rejection_policy = (int) i;
+            found = 1;
+        }
+    }
+    if (!found) {
+        log_warn("未知的线程池拒绝策略: %s，使用 %s", policy, rejection_policy_names[data->config.rejection_policy]);
+    }
+    
+    // 注入队列按启动时的队列上限创建
+    size_t capacity = data->max_queue_size > 0 ? (size_t) data->max_queue_size : 1;
+    for (int level = 0; level < THREADPOOL_PRIORITY_LEVELS; level++) {
+        data->queues[level] = task_ring_create(capacity);
+        if (!data->queues[level]) {
+            log_error("线程池内存分配失败");
             return -1;
         }
     }
     
-    log_info("线程池模块启动成功，创建了 %d 个工作线程", data->config.thread_count);
+    // 启动时的线程数默认等于可用CPU数，并确定自适应调整的范围（写回配置）
+    int adaptive = resolve_thread_limits(data, config);
+    int base = config->thread_count;
+    
+    // 线程槽位和各线程的队列按上限创建，线程按需创建
+    int count = config->max_threads;
+    data->threads = calloc((size_t) count, sizeof(uv_thread_t));
+    data->workers = calloc((size_t) count, sizeof(threadpool_worker_t));
+    if (!data->threads || !data->workers) {
+        log_error("线程池内存分配失败");
+        return -1;
+    }
+    data->thread_count = count;
+    for (int i = 0; i < count; i++) {
+        threadpool_worker_t *worker = &data->workers[i];
+        worker->pool = data;
+        worker->index = i;
+        worker->random = 2654435761u * (uint32_t) (i + 1);
+        if (config->enable_work_stealing) {
+            worker->deque = work_deque_create(WORKER_DEQUE_CAPACITY);
+            if (!worker->deque) {
+                log_error("线程池内存分配失败");
+                return -1;
+            }
+        }
+    }
+    
+    data->target_threads = base;
+    if (start_workers(data, base) != 0) {
+        // 结束已创建的线程，stop时不再等待
+        __atomic_store_n(&data->shutdown, 1, __ATOMIC_SEQ_CST);
+        wake_all_workers(data);
+        for (int j = 0; j < data->started_threads; j++) {
+            uv_thread_join(&data->threads[j]);
+        }
+        data->started_threads = 0;
+        return -1;
+    }
+    
+    if (adaptive) {
+        data->adapt_time = uv_hrtime();
+        data->adapt_cpu_ns = workers_cpu_time(data);
+        uv_timer_start(&data->adapt_timer, on_adapt_timer, (uint64_t) config->adapt_interval_ms,
+                       (uint64_t) config->adapt_interval_ms);
+    }
+    
+    log_info("线程池模块启动成功，创建了 %d 个工作线程（%d 个CPU，自适应范围 %d-%d），队列容量 %zu，工作窃取: %s，拒绝策略: %s",
+             base, data->cpu_count, config->min_threads, config->max_threads,
+             task_ring_capacity(data->queues[THREADPOOL_PRIORITY_NORMAL]),
+             config->enable_work_stealing ? "启用" : "禁用", rejection_policy_names[config->rejection_policy]);
     return 0;
 }
 
@@ -167,16 +629,29 @@ int threadpool_module_stop(module_interface_t *self) {
     
     threadpool_private_data_t *data = (threadpool_private_data_t*) self->private_data;
     
-    // 设置关闭标志
+    if (data->loop) {
+        uv_timer_stop(&data->adapt_timer);
+    }
+    
+    // 设置关闭标志，不再接受新的工作，休眠的线程也一起执行剩余的工作
+    int queued = __atomic_load_n(&data->queued_work, __ATOMIC_RELAXED);
+    if (queued > 0) {
+        log_info("线程池正在执行剩余的 %d 个工作...", queued);
+    }
+    __atomic_store_n(&data->shutdown, 1, __ATOMIC_SEQ_CST);
+    wake_all_workers(data);
+    
     uv_mutex_lock(&data->queue_mutex);
-    data->shutdown = 1;
-    uv_cond_broadcast(&data->work_available);
+    for (int level = 0; level < THREADPOOL_PRIORITY_LEVELS; level++) {
+        uv_cond_broadcast(&data->queue_not_full[level]);
+    }
     uv_mutex_unlock(&data->queue_mutex);
     
     // 等待所有线程结束
-    for (int i = 0; i < data->config.thread_count; i++) {
+    for (int i = 0; i < data->started_threads; i++) {
         uv_thread_join(&data->threads[i]);
     }
+    data->started_threads = 0;
     
     log_info("线程池模块已停止");
     return 0;
@@ -190,25 +665,31 @@ int threadpool_module_cleanup(module_interface_t *self) {
     
     threadpool_private_data_t *data = (threadpool_private_data_t*) self->private_data;
     
-    // 清理剩余的工作项
-    work_item_t *item = data->work_queue;
-    while (item) {
-        work_item_t *next = item->next;
-        free(item);
-        item = next;
+    // 释放队列（线程均已退出，任务按值存放，没有需要单独释放的工作项）
+    for (int level = 0; level < THREADPOOL_PRIORITY_LEVELS; level++) {
+        task_ring_destroy(data->queues[level]);
+    }
+    if (data->workers) {
+        for (int i = 0; i < data->thread_count; i++) {
+            work_deque_destroy(data->workers[i].deque);
+        }
+        free(data->workers);
     }
     
-    item = data->priority_queue;
-    while (item) {
-        work_item_t *next = item->next;
-        free(item);
-        item = next;
+    // 线程退出前已执行完全部工作，溢出链表正常为空
+    while (data->overflow_head) {
+        overflow_work_t *next = data->overflow_head->next;
+        free(data->overflow_head);
+        data->overflow_head = next;
     }
     
     // 销毁同步原语
     uv_mutex_destroy(&data->queue_mutex);
+    uv_mutex_destroy(&data->overflow_mutex);
     uv_cond_destroy(&data->work_available);
-    uv_cond_destroy(&data->queue_not_full);
+    for (int level = 0; level < THREADPOOL_PRIORITY_LEVELS; level++) {
+        uv_cond_destroy(&data->queue_not_full[level]);
+    }
     
     // 释放线程数组
     if (data->threads) {
@@ -224,113 +705,268 @@ int threadpool_module_cleanup(module_interface_t *self) {
     return 0;
 }
 
-// 提交工作到线程池
-int threadpool_submit_work(work_function_t func, void *data) {
-    if (!global_threadpool_data || !func) {
-        return -1;
+// 获取尚未完成的工作数（排队中 + 执行中）
+int threadpool_module_pending(module_interface_t *self) {
+    if (!self || !self->private_data) {
+        return 0;
     }
     
-    threadpool_private_data_t *pool = global_threadpool_data;
+    threadpool_private_data_t *data = (threadpool_private_data_t*) self->private_data;
     
-    uv_mutex_lock(&pool->queue_mutex);
+    // 先读排队数：工作先计入执行中再从排队数中减去，读到减去之后的排队数时一定能读到执行中的计数
+    int queued = __atomic_load_n(&data->queued_work, __ATOMIC_SEQ_CST);
+    return queued + __atomic_load_n(&data->active_threads, __ATOMIC_SEQ_CST);
+}
+
+// 工作线程提交的工作压入自己的队列，有空闲线程时唤醒一个来窃取。失败返回-1
+// 不受队列上限限制：工作线程阻塞等待自己所在线程池的队列空间可能导致死锁
+static int push_local_work(threadpool_worker_t *worker, const work_task_t *task) {
+    threadpool_private_data_t *pool = worker->pool;
     
-    // 检查队列是否已满
-    while (pool->queued_work >= pool->max_queue_size && !pool->shutdown) {
-        uv_cond_wait(&pool->queue_not_full, &pool->queue_mutex);
+    __atomic_add_fetch(&pool->queued_work, 1, __ATOMIC_SEQ_CST);
+    if (work_deque_push(worker->deque, task) != 0) {
+        __atomic_sub_fetch(&pool->queued_work, 1, __ATOMIC_SEQ_CST);
+        return -1;
+    }
+    wake_idle_worker(pool);
+    return 0;
+}
+
+// 尝试把工作放入一个级别的注入队列，队列已满返回-1
+// 入队前计入工作数，工作线程取出任务后减去时不会出现负数；失败立即撤销，
+// 等待队列空间的工作不会被空闲线程当作待处理工作
+static int try_push_level(threadpool_private_data_t *pool, int level, work_task_t *task) {
+    __atomic_add_fetch(&pool->queued_work, 1, __ATOMIC_SEQ_CST);
+    if (task_ring_push(pool->queues[level], task) != 0) {
+        __atomic_sub_fetch(&pool->queued_work, 1, __ATOMIC_SEQ_CST);
+        return -1;
     }
+    return 0;
+}
+
+// 把工作加入注入队列，队列已满时等待工作线程从该级别取走任务，线程池已关闭返回-1
+// 本线程池的工作线程不等待，直接在当前线程执行，避免所有线程都在等待队列空间
+static int push_injected_work(threadpool_private_data_t *pool, int level, work_task_t *task) {
+    task->enqueue_time = uv_hrtime();
     
-    if (pool->shutdown) {
+    if (try_push_level(pool, level, task) != 0) {
+        threadpool_worker_t *worker = current_worker;
+        if (worker && worker->pool == pool) {
+            task->func(task->data);
+            __atomic_store_n(&worker->executed, worker->executed + 1, __ATOMIC_RELAXED);
+            return 0;
+        }
+        
+        // 每个级别使用独立的条件变量，取走任务的工作线程只唤醒等待同一级别的提交者
+        uv_mutex_lock(&pool->queue_mutex);
+        __atomic_add_fetch(&pool->waiting_submitters[level], 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        int result;
+        while ((result = try_push_level(pool, level, task)) != 0 &&
+               !__atomic_load_n(&pool->shutdown, __ATOMIC_SEQ_CST)) {
+            uv_cond_wait(&pool->queue_not_full[level], &pool->queue_mutex);
+        }
+        __atomic_sub_fetch(&pool->waiting_submitters[level], 1, __ATOMIC_SEQ_CST);
         uv_mutex_unlock(&pool->queue_mutex);
+        
+        if (result != 0) {
+            return -1;
+        }
+    }
+    wake_idle_worker(pool);
+    return 0;
+}
+
+// 线程池已启动且未关闭时返回线程池
+static threadpool_private_data_t* running_pool(void) {
+    threadpool_private_data_t *pool = global_threadpool_data;
+    if (!pool || !pool->queues[THREADPOOL_PRIORITY_NORMAL] || __atomic_load_n(&pool->shutdown, __ATOMIC_RELAXED)) {
+        return NULL;
+    }
+    return pool;
+}
+
+// 按优先级提交：工作线程提交的普通工作进入自己的队列，其他工作进入对应级别的注入队列
+int threadpool_submit_work_with_priority(work_function_t func, void *data, int priority) {
+    threadpool_private_data_t *pool = running_pool();
+    if (!pool || !func || priority < 0 || priority >= THREADPOOL_PRIORITY_LEVELS) {
         return -1;
     }
+    if (!pool->config.enable_priority_queue) {
+        priority = THREADPOOL_PRIORITY_NORMAL;
+    }
+    
+    work_task_t task = { func, data, 0 };
     
-    // 创建工作项
-    work_item_t *work = create_work_item(func, data);
+    // 队列扩容失败时退回注入队列
+    threadpool_worker_t *worker = current_worker;
+    if (priority == THREADPOOL_PRIORITY_NORMAL && worker && worker->pool == pool && worker->deque &&
+        push_local_work(worker, &task) == 0) {
+        return 0;
+    }
+    return push_injected_work(pool, priority, &task);
+}
+
+// 提交工作到线程池
+int threadpool_submit_work(work_function_t func, void *data) {
+    return threadpool_submit_work_with_priority(func, data, THREADPOOL_PRIORITY_NORMAL);
+}
+
+// 把工作追加到溢出链表，内存不足时拒绝
+static int push_overflow_work(threadpool_private_data_t *pool, const work_task_t *task) {
+    overflow_work_t *work = malloc(sizeof(overflow_work_t));
     if (!work) {
-        uv_mutex_unlock(&pool->queue_mutex);
+        __atomic_add_fetch(&pool->rejected_work, 1, __ATOMIC_RELAXED);
         return -1;
     }
+    work->task = *task;
+    work->next = NULL;
     
-    // 添加到工作队列末尾
-    if (pool->work_queue == NULL) {
-        pool->work_queue = work;
+    __atomic_add_fetch(&pool->queued_work, 1, __ATOMIC_SEQ_CST);
+    uv_mutex_lock(&pool->overflow_mutex);
+    if (pool->overflow_tail) {
+        pool->overflow_tail->next = work;
     } else {
-        work_item_t *current = pool->work_queue;
-        while (current->next) {
-            current = current->next;
-        }
-        current->next = work;
+        pool->overflow_head = work;
     }
+    pool->overflow_tail = work;
+    __atomic_add_fetch(&pool->overflow_work, 1, __ATOMIC_RELEASE);
+    uv_mutex_unlock(&pool->overflow_mutex);
     
-    pool->queued_work++;
-    
-    // 通知工作线程
-    uv_cond_signal(&pool->work_available);
-    uv_mutex_unlock(&pool->queue_mutex);
-    
+    __atomic_add_fetch(&pool->overflowed_work, 1, __ATOMIC_RELAXED);
+    wake_idle_worker(pool);
     return 0;
 }
 
-// 提交优先级工作
-int threadpool_submit_priority_work(work_function_t func, void *data) {
-    if (!global_threadpool_data || !func) {
+// 丢弃注入队列中最早的工作直到新工作入队，入队后与普通提交一样唤醒空闲线程
+static void push_dropping_oldest(threadpool_private_data_t *pool, work_task_t *task) {
+    task_ring_t *ring = pool->queues[THREADPOOL_PRIORITY_NORMAL];
+    while (try_push_level(pool, THREADPOOL_PRIORITY_NORMAL, task) != 0) {
+        work_task_t oldest;
+        if (task_ring_pop(ring, &oldest)) {
+            __atomic_sub_fetch(&pool->queued_work, 1, __ATOMIC_SEQ_CST);
+            __atomic_add_fetch(&pool->dropped_work, 1, __ATOMIC_RELAXED);
+            threadpool_discard_fn handler = __atomic_load_n(&pool->discard_handler, __ATOMIC_ACQUIRE);
+            if (handler) {
+                handler(oldest.func, oldest.data);
+            }
+        }
+    }
+    wake_idle_worker(pool);
+}
+
+// 非阻塞提交，注入队列已满时按配置的拒绝策略处理
+int threadpool_try_submit(work_function_t func, void *data) {
+    return threadpool_try_submit_with_policy(func, data, threadpool_get_rejection_policy());
+}
+
+// 非阻塞提交，注入队列已满时按policy处理
+int threadpool_try_submit_with_policy(work_function_t func, void *data, int policy) {
+    threadpool_private_data_t *pool = running_pool();
+    if (!pool || !func || policy < THREADPOOL_REJECT || policy > THREADPOOL_OVERFLOW) {
         return -1;
     }
     
-    threadpool_private_data_t *pool = global_threadpool_data;
-    
-    uv_mutex_lock(&pool->queue_mutex);
+    work_task_t task = { func, data, 0 };
     
-    // 检查队列是否已满
-    while (pool->queued_work >= pool->max_queue_size && !pool->shutdown) {
-        uv_cond_wait(&pool->queue_not_full, &pool->queue_mutex);
+    threadpool_worker_t *worker = current_worker;
+    if (worker && worker->pool == pool && worker->deque && push_local_work(worker, &task) == 0) {
+        return 0;
     }
+    task.enqueue_time = uv_hrtime();
     
-    if (pool->shutdown) {
-        uv_mutex_unlock(&pool->queue_mutex);
-        return -1;
+    // 溢出链表中还有工作时新工作排在其后，保持提交顺序
+    if (policy == THREADPOOL_OVERFLOW && __atomic_load_n(&pool->overflow_work, __ATOMIC_ACQUIRE) > 0) {
+        return push_overflow_work(pool, &task);
     }
     
-    // 创建工作项
-    work_item_t *work = create_work_item(func, data);
-    if (!work) {
-        uv_mutex_unlock(&pool->queue_mutex);
-        return -1;
+    if (try_push_level(pool, THREADPOOL_PRIORITY_NORMAL, &task) == 0) {
+        wake_idle_worker(pool);
+        return 0;
     }
     
-    // 添加到优先级队列头部
-    work->next = pool->priority_queue;
-    pool->priority_queue = work;
-    
-    pool->queued_work++;
-    
-    // 通知工作线程
-    uv_cond_signal(&pool->work_available);
-    uv_mutex_unlock(&pool->queue_mutex);
-    
-    return 0;
+    switch (policy) {
+        case THREADPOOL_CALLER_RUNS:
+            __atomic_add_fetch(&pool->caller_runs, 1, __ATOMIC_RELAXED);
+            func(data);
+            return 0;
+        case THREADPOOL_DROP_OLDEST:
+            push_dropping_oldest(pool, &task);
+            return 0;
+        case THREADPOOL_OVERFLOW:
+            return push_overflow_work(pool, &task);
+        default:
+            __atomic_add_fetch(&pool->rejected_work, 1, __ATOMIC_RELAXED);
+            return -1;
+    }
+}
+
+// 提交高优先级工作
+int threadpool_submit_priority_work(work_function_t func, void *data) {
+    return threadpool_submit_work_with_priority(func, data, THREADPOOL_PRIORITY_HIGH);
+}
+
+// 带回调的工作
+typedef struct {
+    work_function_t func;
+    void *data;
+    void (*callback)(void *result);
+} async_work_t;
+
+static void run_async_work(void *arg) {
+    async_work_t work = *(async_work_t*) arg;
+    free(arg);
+    work.func(work.data);
+    work.callback(work.data);
 }
 
-// 异步提交工作（带回调）
+// 异步提交工作（带回调），回调在执行工作的线程中调用。需要在事件循环中回调时使用future_submit
 int threadpool_submit_work_async(work_function_t func, void *data, 
                                  void (*callback)(void *result)) {
-    (void)callback; // 抑制未使用参数警告
-    // 这里可以实现异步提交逻辑
-    // 为了简化，暂时直接提交到普通队列
-    return threadpool_submit_work(func, data);
+    if (!callback) {
+        return threadpool_submit_work(func, data);
+    }
+    if (!func) {
+        return -1;
+    }
+    
+    async_work_t *work = malloc(sizeof(async_work_t));
+    if (!work) {
+        return -1;
+    }
+    work->func = func;
+    work->data = data;
+    work->callback = callback;
+    if (threadpool_submit_work(run_async_work, work) != 0) {
+        free(work);
+        return -1;
+    }
+    return 0;
 }
 
 // 设置线程池配置
 int threadpool_module_set_config(module_interface_t *self, threadpool_config_t *config) {
-    if (!self || !self->private_data || !config) {
+    if (!self || !self->private_data || !config ||
+        config->rejection_policy < THREADPOOL_REJECT || config->rejection_policy > THREADPOOL_OVERFLOW) {
         return -1;
     }
     
     threadpool_private_data_t *data = (threadpool_private_data_t*) self->private_data;
     
-    // 更新配置
-    data->config = *config;
-    data->max_queue_size = config->max_queue_size;
+    // 启动后线程槽位已按上限分配，不能再改变线程数及其范围
+    if (data->threads) {
+        threadpool_config_t resolved = *config;
+        resolve_thread_limits(data, &resolved);
+        if (resolved.thread_count != data->config.thread_count || resolved.min_threads != data->config.min_threads ||
+            resolved.max_threads != data->config.max_threads) {
+            log_warn("线程池已启动，不能修改线程数范围");
+            return -1;
+        }
+        data->config = resolved;
+    } else {
+        data->config = *config;
+    }
+    data->max_queue_size = data->config.max_queue_size;
     
     log_info("线程池模块配置已更新");
     return 0;
@@ -346,17 +982,25 @@ threadpool_config_t* threadpool_module_get_config(module_interface_t *self) {
     return &data->config;
 }
 
+// 获取配置的拒绝策略
+int threadpool_get_rejection_policy(void) {
+    return global_threadpool_data ? global_threadpool_data->config.rejection_policy : THREADPOOL_REJECT;
+}
+
+// 设置丢弃回调（THREADPOOL_DROP_OLDEST），NULL表示直接丢弃
+void threadpool_set_discard_handler(threadpool_discard_fn handler) {
+    if (global_threadpool_data) {
+        __atomic_store_n(&global_threadpool_data->discard_handler, handler, __ATOMIC_RELEASE);
+    }
+}
+
 // 获取活跃线程数
 int threadpool_get_active_thread_count(void) {
     if (!global_threadpool_data) {
         return 0;
     }
     
-    uv_mutex_lock(&global_threadpool_data->queue_mutex);
-    int count = global_threadpool_data->active_threads;
-    uv_mutex_unlock(&global_threadpool_data->queue_mutex);
-    
-    return count;
+    return __atomic_load_n(&global_threadpool_data->active_threads, __ATOMIC_RELAXED);
 }
 
 // 获取队列中的工作数
@@ -365,11 +1009,52 @@ int threadpool_get_queued_work_count(void) {
         return 0;
     }
     
-    uv_mutex_lock(&global_threadpool_data->queue_mutex);
-    int count = global_threadpool_data->queued_work;
-    uv_mutex_unlock(&global_threadpool_data->queue_mutex);
+    return __atomic_load_n(&global_threadpool_data->queued_work, __ATOMIC_RELAXED);
+}
+
+// 获取拒绝策略统计
+void threadpool_get_rejection_stats(threadpool_rejection_stats_t *stats) {
+    memset(stats, 0, sizeof(threadpool_rejection_stats_t));
+    threadpool_private_data_t *pool = global_threadpool_data;
+    if (!pool) {
+        return;
+    }
     
-    return count;
+    stats->rejected = __atomic_load_n(&pool->rejected_work, __ATOMIC_RELAXED);
+    stats->caller_runs = __atomic_load_n(&pool->caller_runs, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&pool->dropped_work, __ATOMIC_RELAXED);
+    stats->overflowed = __atomic_load_n(&pool->overflowed_work, __ATOMIC_RELAXED);
+    stats->overflow_depth = __atomic_load_n(&pool->overflow_work, __ATOMIC_RELAXED);
+}
+
+// 获取各优先级的统计
+void threadpool_get_level_stats(threadpool_level_stats_t stats[THREADPOOL_PRIORITY_LEVELS]) {
+    memset(stats, 0, THREADPOOL_PRIORITY_LEVELS * sizeof(threadpool_level_stats_t));
+    threadpool_private_data_t *pool = global_threadpool_data;
+    if (!pool || !pool->queues[THREADPOOL_PRIORITY_NORMAL]) {
+        return;
+    }
+    
+    // 各线程的计数只由本线程修改，这里读到的是近似值
+    uint64_t wait_ns[THREADPOOL_PRIORITY_LEVELS] = { 0 };
+    uint64_t max_wait_ns[THREADPOOL_PRIORITY_LEVELS] = { 0 };
+    for (int i = 0; i < pool->thread_count; i++) {
+        threadpool_worker_t *worker = &pool->workers[i];
+        for (int level = 0; level < THREADPOOL_PRIORITY_LEVELS; level++) {
+            stats[level].dequeued += __atomic_load_n(&worker->dequeued[level], __ATOMIC_RELAXED);
+            wait_ns[level] += __atomic_load_n(&worker->wait_ns[level], __ATOMIC_RELAXED);
+            uint64_t max_wait = __atomic_load_n(&worker->max_wait_ns[level], __ATOMIC_RELAXED);
+            if (max_wait > max_wait_ns[level]) {
+                max_wait_ns[level] = max_wait;
+            }
+        }
+    }
+    for (int level = 0; level < THREADPOOL_PRIORITY_LEVELS; level++) {
+        stats[level].depth = (int) task_ring_size(pool->queues[level]);
+        stats[level].total_wait_us = wait_ns[level] / 1000;
+        stats[level].max_wait_us = max_wait_ns[level] / 1000;
+    }
+    stats[THREADPOOL_PRIORITY_NORMAL].depth += __atomic_load_n(&pool->overflow_work, __ATOMIC_RELAXED);
 }
 
 // 打印线程池统计信息
@@ -381,14 +1066,39 @@ void threadpool_print_stats(void) {
     
     threadpool_private_data_t *pool = global_threadpool_data;
     
-    uv_mutex_lock(&pool->queue_mutex);
+    // 各线程的计数只由本线程修改，这里读到的是近似值
+    uint64_t executed = 0;
+    uint64_t stolen = 0;
+    for (int i = 0; i < pool->thread_count; i++) {
+        executed += __atomic_load_n(&pool->workers[i].executed, __ATOMIC_RELAXED);
+        stolen += __atomic_load_n(&pool->workers[i].stolen, __ATOMIC_RELAXED);
+    }
+    
     log_info("\n=== 线程池统计 ===");
-    log_info("总线程数: %d", pool->config.thread_count);
-    log_info("活跃线程数: %d", pool->active_threads);
-    log_info("队列中工作数: %d", pool->queued_work);
+    log_info("总线程数: %d（目标 %d，休眠 %d，范围 %d-%d，CPU数 %d）",
+             __atomic_load_n(&pool->started_threads, __ATOMIC_RELAXED),
+             __atomic_load_n(&pool->target_threads, __ATOMIC_RELAXED),
+             __atomic_load_n(&pool->parked_workers, __ATOMIC_RELAXED),
+             pool->config.min_threads, pool->config.max_threads, pool->cpu_count);
+    log_info("活跃线程数: %d", threadpool_get_active_thread_count());
+    log_info("队列中工作数: %d", threadpool_get_queued_work_count());
     log_info("最大队列大小: %d", pool->max_queue_size);
-    log_info("工作窃取: %s", pool->config.enable_priority_queue ? "启用" : "禁用");
+    log_info("工作窃取: %s", pool->config.enable_work_stealing ? "启用" : "禁用");
     log_info("优先级队列: %s", pool->config.enable_priority_queue ? "启用" : "禁用");
+    log_info("已执行工作数: %llu，其中窃取 %llu 个", (unsigned long long) executed, (unsigned long long) stolen);
+    threadpool_level_stats_t levels[THREADPOOL_PRIORITY_LEVELS];
+    threadpool_get_level_stats(levels);
+    for (int level = 0; level < THREADPOOL_PRIORITY_LEVELS; level++) {
+        log_info("%s优先级: 排队 %d，出队 %llu，平均等待 %llu us，最长等待 %llu us", level_names[level],
+                 levels[level].depth, (unsigned long long) levels[level].dequeued,
+                 (unsigned long long) (levels[level].dequeued ? levels[level].total_wait_us / levels[level].dequeued : 0),
+                 (unsigned long long) levels[level].max_wait_us);
+    }
+    threadpool_rejection_stats_t rejection;
+    threadpool_get_rejection_stats(&rejection);
+    log_info("拒绝策略: %s，拒绝 %llu，提交者执行 %llu，丢弃 %llu，溢出 %llu（当前 %d）",
+             rejection_policy_names[pool->config.rejection_policy], (unsigned long long) rejection.rejected,
+             (unsigned long long) rejection.caller_runs, (unsigned long long) rejection.dropped,
+             (unsigned long long) rejection.overflowed, rejection.overflow_depth);
     log_info("==================\n\n");
-    uv_mutex_unlock(&pool->queue_mutex);
 }
@@ -4,37 +4,107 @@
 #include "module_manager.h"
 #include <uv.h>
 #include <stddef.h>
+#include <stdint.h>
 
 // 工作函数类型
 typedef void (*work_function_t)(void *data);
 
-// 工作项结构
-typedef struct work_item {
-    work_function_t func;
-    void *data;
-    struct work_item *next;
-} work_item_t;
+// 优先级，数值越小越优先。同一级别内先进先出，各级别按权重轮流出队（默认4:2:1），低优先级的工作不会被饿死
+typedef enum {
+    THREADPOOL_PRIORITY_HIGH = 0,
+    THREADPOOL_PRIORITY_NORMAL = 1,         // threadpool_submit_work和threadpool_try_submit使用的级别
+    THREADPOOL_PRIORITY_LOW = 2,
+    THREADPOOL_PRIORITY_LEVELS
+} threadpool_priority_t;
+
+// 注入队列已满时threadpool_try_submit的处理方式
+typedef enum {
+    THREADPOOL_REJECT = 0,                  // 拒绝，返回-1
+    THREADPOOL_CALLER_RUNS = 1,             // 在提交者线程直接执行
+    THREADPOOL_DROP_OLDEST = 2,             // 丢弃注入队列中最早的工作（交给丢弃回调），再加入新工作
+    THREADPOOL_OVERFLOW = 3                 // 放入不限长度的溢出链表
+} threadpool_rejection_policy_t;
+
+// 被THREADPOOL_DROP_OLDEST丢弃的工作，在提交者线程调用，用于释放data或通知其所有者
+typedef void (*threadpool_discard_fn)(work_function_t func, void *data);
 
 // 线程池配置
 typedef struct {
-    int thread_count;
+    int thread_count;                       // 启动时运行的线程数，0表示按可用CPU数
     int max_queue_size;
     int enable_work_stealing;
     int enable_priority_queue;
+    int rejection_policy;                   // threadpool_rejection_policy_t
+    int min_threads;                        // 自适应调整的下限，0表示等于thread_count
+    int max_threads;                        // 自适应调整的上限，0表示thread_count的4倍
+    int target_wait_ms;                     // 排队时间超过该值且CPU未用满时增加线程
+    int adapt_interval_ms;                  // 调整周期，0表示不调整
 } threadpool_config_t;
 
+// 拒绝策略统计
+typedef struct {
+    uint64_t rejected;                      // 拒绝的工作数
+    uint64_t caller_runs;                   // 在提交者线程执行的工作数
+    uint64_t dropped;                       // 丢弃的最早工作数
+    uint64_t overflowed;                    // 放入溢出链表的工作数
+    int overflow_depth;                     // 溢出链表中当前的工作数
+} threadpool_rejection_stats_t;
+
+// 单个优先级的统计（工作线程自己队列中的工作不计入）
+typedef struct {
+    int depth;                              // 排队中的工作数（近似值）
+    uint64_t dequeued;                      // 已出队的工作数
+    uint64_t total_wait_us;                 // 出队工作的排队时间之和（微秒）
+    uint64_t max_wait_us;                   // 最长排队时间（微秒）
+} threadpool_level_stats_t;
+
+struct threadpool_worker;
+struct task_ring;
+struct overflow_work;
+
 // 线程池私有数据
+// 工作线程提交的普通工作压入该线程自己的工作窃取队列，其他工作按优先级进入共享的注入队列
+// （queues，每级一个无锁的有界环形队列，任务按值存放，提交时不分配内存）。
+// 空闲的工作线程先查找按权重轮到的级别，再依次查找自己的队列和其余级别，最后从随机选择的其他线程窃取，
+// 都没有工作时先自旋一段时间，再在wake_epoch上睡眠（Linux上为futex）。
+// 计数器用原子操作访问，只有注入队列已满、提交者需要等待或工作溢出到溢出链表时才加锁。
+// 线程数在min_threads和max_threads之间自适应：事件循环中的定时器按周期统计排队时间和工作线程的CPU时间，
+// 工作在排队且CPU有空闲（线程阻塞或线程数少于CPU数）时提高target_threads并按需创建线程；
+// 没有排队工作或线程数多于CPU数且CPU已用满时逐步降低。序号不小于target_threads的线程空闲时在park_epoch上休眠。
 typedef struct {
     uv_thread_t *threads;
-    int thread_count;
-    work_item_t *work_queue;
-    work_item_t *priority_queue;
+    struct threadpool_worker *workers;      // 启动时按max_threads创建
+    int thread_count;                       // 工作线程槽位数（max_threads）
+    int started_threads;                    // 已创建、停止时需要等待的线程数，只在事件循环线程增加
+    int target_threads;                     // 允许运行的线程数
+    int cpu_count;
+    int parked_workers;                     // 超出目标线程数而休眠的线程数
+    int park_epoch;                         // 休眠序号，调整目标线程数或关闭时递增
+    uv_loop_t *loop;                        // 运行调整定时器的事件循环，为NULL时不调整线程数
+    uv_timer_t adapt_timer;
+    uint64_t adapt_time;                    // 上次调整的时刻（uv_hrtime）
+    uint64_t adapt_dequeued;                // 上次调整时各级别累计的出队数和排队时间
+    uint64_t adapt_wait_ns;
+    uint64_t adapt_cpu_ns;                  // 上次调整时工作线程累计的CPU时间
+    struct task_ring *queues[THREADPOOL_PRIORITY_LEVELS];   // 启动时按max_queue_size创建
     uv_mutex_t queue_mutex;
-    uv_cond_t work_available;
-    uv_cond_t queue_not_full;
+    uv_cond_t work_available;               // 没有futex的平台上代替wake_epoch睡眠
+    uv_cond_t queue_not_full[THREADPOOL_PRIORITY_LEVELS];  // 各级别的注入队列有空位
+    uv_mutex_t overflow_mutex;              // 保护溢出链表
+    struct overflow_work *overflow_head;    // 注入队列已满时溢出的工作（THREADPOOL_OVERFLOW）
+    struct overflow_work *overflow_tail;
+    int overflow_work;                      // 溢出链表中的工作数，为0时不加锁查找
+    threadpool_discard_fn discard_handler;
+    uint64_t rejected_work;
+    uint64_t caller_runs;
+    uint64_t dropped_work;
+    uint64_t overflowed_work;
     int shutdown;
     int active_threads;
-    int queued_work;
+    int queued_work;                        // 注入队列和各线程队列中的工作总数
+    int idle_workers;                       // 准备睡眠或正在睡眠的线程数
+    int wake_epoch;                         // 唤醒序号，唤醒空闲线程前递增
+    int waiting_submitters[THREADPOOL_PRIORITY_LEVELS];    // 因队列已满在queue_not_full上等待的提交者数
     int max_queue_size;
     threadpool_config_t config;
 } threadpool_private_data_t;
@@ -47,20 +117,37 @@ int threadpool_module_init(module_interface_t *self, uv_loop_t *loop);
 int threadpool_module_start(module_interface_t *self);
 int threadpool_module_stop(module_interface_t *self);
 int threadpool_module_cleanup(module_interface_t *self);
+int threadpool_module_pending(module_interface_t *self);
 
 // 线程池工作提交函数
 int threadpool_submit_work(work_function_t func, void *data);
-int threadpool_submit_priority_work(work_function_t func, void *data);
+
+// 非阻塞提交：注入队列已满时按配置的拒绝策略处理，不等待队列空间，可以在事件循环线程调用。
+// 加入队列、放入溢出链表或在当前线程执行完毕返回0，被拒绝或线程池未运行返回-1
+int threadpool_try_submit(work_function_t func, void *data);
+
+// 按指定的拒绝策略非阻塞提交（threadpool_rejection_policy_t），不使用配置的策略。
+// 事件循环线程不能执行耗时的工作，可以用它把caller_runs换成其他策略
+int threadpool_try_submit_with_policy(work_function_t func, void *data, int policy);
+int threadpool_submit_priority_work(work_function_t func, void *data);     // THREADPOOL_PRIORITY_HIGH
+
+// 按指定优先级提交，注入队列已满时等待。未启用优先级队列时全部按普通级别处理
+int threadpool_submit_work_with_priority(work_function_t func, void *data, int priority);
+// 执行func(data)后在同一工作线程调用callback(data)；回调需要在事件循环中执行时使用future.h
 int threadpool_submit_work_async(work_function_t func, void *data, 
                                  void (*callback)(void *result));
 
 // 线程池配置函数
 int threadpool_module_set_config(module_interface_t *self, threadpool_config_t *config);
 threadpool_config_t* threadpool_module_get_config(module_interface_t *self);
+void threadpool_set_discard_handler(threadpool_discard_fn handler);
+int threadpool_get_rejection_policy(void);     // threadpool_rejection_policy_t
 
 // 线程池统计函数
 int threadpool_get_active_thread_count(void);
 int threadpool_get_queued_work_count(void);
+void threadpool_get_rejection_stats(threadpool_rejection_stats_t *stats);
+void threadpool_get_level_stats(threadpool_level_stats_t stats[THREADPOOL_PRIORITY_LEVELS]);
 void threadpool_print_stats(void);
 
 #endif // THREADPOOL_MODULE_H
@@ -0,0 +1,157 @@
+#include "src/thread/work_deque.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+#define WORK_DEQUE_CACHE_LINE 64
+#define WORK_DEQUE_MIN_CAPACITY 16
+
+// 环形数组，下标按capacity取模
+typedef struct deque_array {
+    size_t capacity;
+    struct deque_array *retired;    // 扩容前的数组，销毁队列时一并释放
+    work_task_t tasks[];
+} deque_array_t;
+
+// top由窃取者修改，bottom由所有者修改，分开放在不同的缓存行
+struct work_deque {
+    int64_t top;
+    char pad0[WORK_DEQUE_CACHE_LINE - sizeof(int64_t)];
+    int64_t bottom;
+    deque_array_t *array;
+    char pad1[WORK_DEQUE_CACHE_LINE - sizeof(int64_t) - sizeof(deque_array_t*)];
+};
+
+static deque_array_t* array_create(size_t capacity) {
+    deque_array_t *array = malloc(sizeof(deque_array_t) + capacity * sizeof(work_task_t));
+    if (array) {
+        array->capacity = capacity;
+        array->retired = NULL;
+    }
+    return array;
+}
+
+// 任务的各个字段分别原子读写。窃取者可能读到所有者正在改写的槽位，这时它对top的CAS必然失败，读到的值被丢弃
+static void array_get(deque_array_t *array, int64_t index, work_task_t *task) {
+    work_task_t *slot = &array->tasks[(size_t) index & (array->capacity - 1)];
+    task->func = __atomic_load_n(&slot->func, __ATOMIC_RELAXED);
+    task->data = __atomic_load_n(&slot->data, __ATOMIC_RELAXED);
+    task->enqueue_time = __atomic_load_n(&slot->enqueue_time, __ATOMIC_RELAXED);
+}
+
+static void array_put(deque_array_t *array, int64_t index, const work_task_t *task) {
+    work_task_t *slot = &array->tasks[(size_t) index & (array->capacity - 1)];
+    __atomic_store_n(&slot->func, task->func, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->data, task->data, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->enqueue_time, task->enqueue_time, __ATOMIC_RELAXED);
+}
+
+work_deque_t* work_deque_create(size_t capacity) {
+    size_t rounded = WORK_DEQUE_MIN_CAPACITY;
+    while (rounded < capacity) {
+        rounded *= 2;
+    }
+
+    work_deque_t *deque = calloc(1, sizeof(work_deque_t));
+    if (!deque) {
+        return NULL;
+    }
+    deque->array = array_create(rounded);
+    if (!deque->array) {
+        free(deque);
+        return NULL;
+    }
+    return deque;
+}
+
+void work_deque_destroy(work_deque_t *deque) {
+    if (!deque) {
+        return;
+    }
+    deque_array_t *array = deque->array;
+    while (array) {
+        deque_array_t *retired = array->retired;
+        free(array);
+        array = retired;
+    }
+    free(deque);
+}
+
+// 扩容为两倍，复制[top, bottom)的元素（只由所有者调用）
+static deque_array_t* grow(work_deque_t *deque, deque_array_t *array, int64_t top, int64_t bottom) {
+    deque_array_t *bigger = array_create(array->capacity * 2);
+    if (!bigger) {
+        return NULL;
+    }
+    for (int64_t i = top; i < bottom; i++) {
+        work_task_t task;
+        array_get(array, i, &task);
+        array_put(bigger, i, &task);
+    }
+    bigger->retired = array;
+    __atomic_store_n(&deque->array, bigger, __ATOMIC_RELEASE);
+    return bigger;
+}
+
+int work_deque_push(work_deque_t *deque, const work_task_t *task) {
+    int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    deque_array_t *array = __atomic_load_n(&deque->array, __ATOMIC_RELAXED);
+
+    if (bottom - top > (int64_t) array->capacity - 1) {
+        array = grow(deque, array, top, bottom);
+        if (!array) {
+            return -1;
+        }
+    }
+    array_put(array, bottom, task);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+int work_deque_pop(work_deque_t *deque, work_task_t *task) {
+    int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    deque_array_t *array = __atomic_load_n(&deque->array, __ATOMIC_RELAXED);
+    __atomic_store_n(&deque->bottom, bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+    if (top > bottom) {
+        // 队列为空，恢复bottom
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    array_get(array, bottom, task);
+    if (top == bottom) {
+        // 最后一个元素，与窃取者争抢
+        int won = __atomic_compare_exchange_n(&deque->top, &top, top + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return won;
+    }
+    return 1;
+}
+
+int work_deque_steal(work_deque_t *deque, work_task_t *task) {
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+    if (top >= bottom) {
+        return 0;
+    }
+
+    deque_array_t *array = __atomic_load_n(&deque->array, __ATOMIC_ACQUIRE);
+    work_task_t stolen;
+    array_get(array, top, &stolen);
+    if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return -1;
+    }
+    *task = stolen;
+    return 1;
+}
+
+size_t work_deque_size(const work_deque_t *deque) {
+    int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+    return bottom > top ? (size_t) (bottom - top) : 0;
+}
@@ -0,0 +1,49 @@
+#ifndef WORK_DEQUE_H
+#define WORK_DEQUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 工作窃取双端队列（Chase-Lev）
+// 每个队列属于一个线程：所有者在底部压入和弹出（后进先出，刚提交的工作数据还在缓存中），
+// 其他线程从顶部窃取（先进先出，先拿走最早提交的工作）。所有者的操作通常不需要原子读改写，
+// 只有与窃取者争抢最后一个元素时才用CAS；窃取者之间用CAS争抢顶部元素。
+// 数组写满时由所有者扩容为两倍，旧数组可能仍在被窃取者读取，保留到销毁队列时释放。
+// 任务按值存放在数组中，压入和弹出都不分配内存。
+
+// 任务：函数和参数
+typedef struct {
+    void (*func)(void *data);
+    void *data;
+    uint64_t enqueue_time;          // 入队时刻（uv_hrtime纳秒），用于统计排队时间，不统计时为0
+} work_task_t;
+
+typedef struct work_deque work_deque_t;
+
+// 创建队列，capacity向上取整为2的幂，失败返回NULL
+work_deque_t* work_deque_create(size_t capacity);
+
+// 销毁队列，调用前所有线程都不再访问它
+void work_deque_destroy(work_deque_t *deque);
+
+// 所有者压入任务，扩容失败返回-1
+int work_deque_push(work_deque_t *deque, const work_task_t *task);
+
+// 所有者弹出最近压入的任务：成功返回1，队列为空返回0
+int work_deque_pop(work_deque_t *deque, work_task_t *task);
+
+// 窃取最早压入的任务：成功返回1，队列为空返回0，与其他线程争抢失败返回-1（可以重试）
+int work_deque_steal(work_deque_t *deque, work_task_t *task);
+
+// 当前元素数（其他线程调用时只是近似值）
+size_t work_deque_size(const work_deque_t *deque);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WORK_DEQUE_H
@@ -0,0 +1,264 @@
+// RPC与HTTP请求开销对比
+// 编译: gcc -O2 -I. test/bench_rpc.c src/net/rpc_protocol.c -o bench_rpc -lpthread
+// 运行: ./bench_rpc [http|rpc] [线程数] [每线程请求数] [流水线深度]
+// HTTP: GET /api/health（keep-alive，端口8080）
+// RPC:  echo方法（端口8082，需配置 enhanced_network_protocol=rpc），每个连接同时发出"流水线深度"个请求
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "src/net/rpc_protocol.h"
+
+#define SERVER_HOST "127.0.0.1"
+#define HTTP_PORT 8080
+#define RPC_PORT 8082
+#define MAX_DEPTH 256
+
+typedef struct {
+    int use_rpc;
+    int requests;
+    int depth;
+    double *latencies;          // 每个请求的延迟（微秒）
+    int completed;
+    int failed;
+} bench_context_t;
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static int connect_server(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = inet_addr(SERVER_HOST);
+    if (connect(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+static int send_all(int fd, const char *data, size_t length) {
+    while (length > 0) {
+        ssize_t n = send(fd, data, length, 0);
+        if (n <= 0) {
+            return -1;
+        }
+        data += n;
+        length -= (size_t) n;
+    }
+    return 0;
+}
+
+static int recv_all(int fd, char *data, size_t length) {
+    while (length > 0) {
+        ssize_t n = recv(fd, data, length, 0);
+        if (n <= 0) {
+            return -1;
+        }
+        data += n;
+        length -= (size_t) n;
+    }
+    return 0;
+}
+
+// 读取一个HTTP响应（按Content-Length），buffer中可能残留下一个响应的开头
+static int read_http_response(int fd, char *buffer, size_t size, size_t *buffered) {
+    for (;;) {
+        buffer[*buffered] = '\0';
+        char *end = strstr(buffer, "\r\n\r\n");
+        if (end) {
+            char *field = strstr(buffer, "Content-Length:");
+            size_t body = field && field < end ? (size_t) atol(field + 15) : 0;
+            size_t total = (size_t) (end + 4 - buffer) + body;
+            if (*buffered >= total) {
+                memmove(buffer, buffer + total, *buffered - total);
+                *buffered -= total;
+                return 0;
+            }
+        }
+        if (*buffered + 1 >= size) {
+            return -1;
+        }
+        ssize_t n = recv(fd, buffer + *buffered, size - *buffered - 1, 0);
+        if (n <= 0) {
+            return -1;
+        }
+        *buffered += (size_t) n;
+    }
+}
+
+static void run_http(bench_context_t *ctx, int fd) {
+    static const char request[] =
+        "GET /api/health HTTP/1.1\r\nHost: " SERVER_HOST "\r\nConnection: keep-alive\r\n\r\n";
+    char buffer[16384];
+    size_t buffered = 0;
+
+    for (int i = 0; i < ctx->requests; i++) {
+        double start = now_us();
+        if (send_all(fd, request, sizeof(request) - 1) < 0 ||
+            read_http_response(fd, buffer, sizeof(buffer), &buffered) < 0) {
+            ctx->failed += ctx->requests - i;
+            return;
+        }
+        ctx->latencies[ctx->completed++] = now_us() - start;
+    }
+}
+
+static void run_rpc(bench_context_t *ctx, int fd) {
+    static const char body[] = "benchmark payload";
+    char out[MAX_DEPTH * (RPC_LENGTH_FIELD_SIZE + RPC_HEADER_SIZE + sizeof(body))];
+    double sent[MAX_DEPTH];
+    uint32_t next_id = 1;
+
+    for (int done = 0; done < ctx->requests; ) {
+        int batch = ctx->requests - done < ctx->depth ? ctx->requests - done : ctx->depth;
+        size_t total = 0;
+        uint32_t first_id = next_id;
+
+        // 一次发出整批请求，不等待响应
+        for (int i = 0; i < batch; i++) {
+            rpc_header_t header = { RPC_PROTOCOL_VERSION, RPC_TYPE_REQUEST, 2, next_id++, 0 };
+            size_t length;
+            char *frame = rpc_message_encode(&header, body, sizeof(body) - 1, &length);
+            if (!frame) {
+                ctx->failed += ctx->requests - done;
+                return;
+            }
+            memcpy(out + total, frame, length);
+            total += length;
+            free(frame);
+        }
+        double start = now_us();
+        for (int i = 0; i < batch; i++) {
+            sent[i] = start;
+        }
+        if (send_all(fd, out, total) < 0) {
+            ctx->failed += ctx->requests - done;
+            return;
+        }
+
+        // 响应可以乱序到达，按request_id记录延迟
+        for (int i = 0; i < batch; i++) {
+            char prefix[RPC_LENGTH_FIELD_SIZE];
+            char payload[RPC_HEADER_SIZE + 256];
+            if (recv_all(fd, prefix, sizeof(prefix)) < 0) {
+                ctx->failed += ctx->requests - done;
+                return;
+            }
+            uint32_t length = ((uint32_t) (unsigned char) prefix[0] << 24) | ((uint32_t) (unsigned char) prefix[1] << 16) |
+                              ((uint32_t) (unsigned char) prefix[2] << 8) | (unsigned char) prefix[3];
+            rpc_header_t header;
+            if (length > sizeof(payload) || recv_all(fd, payload, length) < 0 ||
+                rpc_header_decode(payload, length, &header) < 0 ||
+                header.request_id < first_id || header.request_id - first_id >= (uint32_t) batch) {
+                ctx->failed += ctx->requests - done;
+                return;
+            }
+            if (header.value != RPC_STATUS_OK) {
+                ctx->failed++;
+            } else {
+                ctx->latencies[ctx->completed++] = now_us() - sent[header.request_id - first_id];
+            }
+        }
+        done += batch;
+    }
+}
+
+static void* bench_thread(void *arg) {
+    bench_context_t *ctx = (bench_context_t*) arg;
+    int fd = connect_server(ctx->use_rpc ? RPC_PORT : HTTP_PORT);
+    if (fd < 0) {
+        fprintf(stderr, "连接服务器失败\n");
+        ctx->failed = ctx->requests;
+        return NULL;
+    }
+    if (ctx->use_rpc) {
+        run_rpc(ctx, fd);
+    } else {
+        run_http(ctx, fd);
+    }
+    close(fd);
+    return NULL;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return x < y ? -1 : x > y;
+}
+
+int main(int argc, char *argv[]) {
+    int use_rpc = argc > 1 && strcmp(argv[1], "rpc") == 0;
+    int threads = argc > 2 ? atoi(argv[2]) : 4;
+    int requests = argc > 3 ? atoi(argv[3]) : 10000;
+    int depth = argc > 4 ? atoi(argv[4]) : 1;
+    if (threads <= 0 || requests <= 0 || depth <= 0 || depth > MAX_DEPTH) {
+        fprintf(stderr, "用法: %s [http|rpc] [线程数] [每线程请求数] [流水线深度(1-%d)]\n", argv[0], MAX_DEPTH);
+        return 1;
+    }
+    if (!use_rpc) {
+        depth = 1;
+    }
+
+    pthread_t *ids = calloc((size_t) threads, sizeof(pthread_t));
+    bench_context_t *contexts = calloc((size_t) threads, sizeof(bench_context_t));
+    double *latencies = calloc((size_t) threads * (size_t) requests, sizeof(double));
+    if (!ids || !contexts || !latencies) {
+        fprintf(stderr, "内存分配失败\n");
+        return 1;
+    }
+
+    double start = now_us();
+    for (int i = 0; i < threads; i++) {
+        contexts[i].use_rpc = use_rpc;
+        contexts[i].requests = requests;
+        contexts[i].depth = depth;
+        contexts[i].latencies = latencies + (size_t) i * (size_t) requests;
+        pthread_create(&ids[i], NULL, bench_thread, &contexts[i]);
+    }
+
+    // 汇总各线程的延迟
+    size_t completed = 0;
+    int failed = 0;
+    for (int i = 0; i < threads; i++) {
+        pthread_join(ids[i], NULL);
+        memmove(latencies + completed, contexts[i].latencies, (size_t) contexts[i].completed * sizeof(double));
+        completed += (size_t) contexts[i].completed;
+        failed += contexts[i].failed;
+    }
+    double elapsed = (now_us() - start) / 1e6;
+
+    printf("协议: %s，线程: %d，每线程请求: %d，流水线深度: %d\n", use_rpc ? "RPC" : "HTTP", threads, requests, depth);
+    printf("完成: %zu，失败: %d，耗时: %.2f 秒\n", completed, failed, elapsed);
+    if (completed > 0) {
+        qsort(latencies, completed, sizeof(double), compare_double);
+        double sum = 0;
+        for (size_t i = 0; i < completed; i++) {
+            sum += latencies[i];
+        }
+        printf("吞吐: %.0f 请求/秒，平均延迟: %.1f 微秒，p99延迟: %.1f 微秒\n",
+               completed / elapsed, sum / completed, latencies[completed * 99 / 100]);
+    }
+
+    free(latencies);
+    free(contexts);
+    free(ids);
+    return failed > 0;
+}
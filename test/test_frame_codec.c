@@ -0,0 +1,427 @@
+// 分帧编解码测试：跨读取拆分的帧、一次读取中的流水线帧、行格式去除CRLF、长度头和行格式的单帧上限边界、
+// 镜像环形缓冲区的回绕、线性缓冲区搬回开头、停止分发期间缓冲区写满后扩大与恢复
+// 编译: gcc -O2 -D_GNU_SOURCE -I. test/test_frame_codec.c src/net/frame_codec.c -o test_frame_codec
+// 运行: ./test_frame_codec，全部通过时返回0
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "src/net/frame_codec.h"
+
+// 收集的最大帧数
+#define MAX_FRAMES 1024
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (cond) { \
+        printf("✓ %s\n", msg); \
+    } else { \
+        printf("✗ %s\n", msg); \
+        failures++; \
+    } \
+} while (0)
+
+// 回调收集的帧（复制内容，帧本身只在回调期间有效）
+typedef struct {
+    char *frames[MAX_FRAMES];
+    size_t lengths[MAX_FRAMES];
+    int count;
+    int batches;
+    int stop_after;                 // 分发到第几批后要求停止，0表示不停止
+    const char *ring_start;         // 第一次读取的写入位置，用于判断帧是否跨越缓冲区结尾
+    size_t ring_capacity;
+    int straddled;                  // 跨越缓冲区结尾的帧数
+} collector_t;
+
+static int on_frames(const frame_t *frames, size_t count, void *arg) {
+    collector_t *collector = (collector_t*) arg;
+    for (size_t i = 0; i < count && collector->count < MAX_FRAMES; i++) {
+        char *copy = malloc(frames[i].length + 1);
+        memcpy(copy, frames[i].data, frames[i].length);
+        copy[frames[i].length] = '\0';
+        collector->frames[collector->count] = copy;
+        collector->lengths[collector->count] = frames[i].length;
+        collector->count++;
+        if (collector->ring_start && frames[i].data < collector->ring_start + collector->ring_capacity &&
+            frames[i].data + frames[i].length > collector->ring_start + collector->ring_capacity) {
+            collector->straddled++;
+        }
+    }
+    collector->batches++;
+    return collector->stop_after > 0 && collector->batches >= collector->stop_after;
+}
+
+static void collector_reset(collector_t *collector) {
+    for (int i = 0; i < collector->count; i++) {
+        free(collector->frames[i]);
+    }
+    memset(collector, 0, sizeof(collector_t));
+}
+
+// 模拟一次读取：写入解码器的空闲区域并提交，数据超过空闲区域时分多次
+static int read_into(frame_decoder_t *decoder, const char *data, size_t length, collector_t *collector) {
+    int dispatched = 0;
+    while (length > 0) {
+        char *buffer;
+        size_t available;
+        frame_decoder_get_write_buffer(decoder, &buffer, &available);
+        if (available == 0) {
+            return -1;
+        }
+        size_t chunk = length < available ? length : available;
+        memcpy(buffer, data, chunk);
+        int result = frame_decoder_commit(decoder, chunk, on_frames, collector);
+        if (result < 0) {
+            return -1;
+        }
+        dispatched += result;
+        data += chunk;
+        length -= chunk;
+    }
+    return dispatched;
+}
+
+// 生成长度头帧，payload为NULL时内容按序号填充
+static size_t build_length_frame(char *out, int header, const char *payload, size_t length, int seq) {
+    if (header == 2) {
+        out[0] = (char) (length >> 8);
+        out[1] = (char) length;
+    } else {
+        out[0] = (char) (length >> 24);
+        out[1] = (char) (length >> 16);
+        out[2] = (char) (length >> 8);
+        out[3] = (char) length;
+    }
+    for (size_t i = 0; i < length; i++) {
+        out[header + i] = payload ? payload[i] : (char) ('a' + (seq + i) % 26);
+    }
+    return (size_t) header + length;
+}
+
+// 检查内容是否为build_length_frame按序号填充的结果
+static int pattern_matches(const char *data, size_t length, int seq) {
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] != (char) ('a' + (seq + i) % 26)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// 测试帧格式解析和编码
+static void test_encode(void) {
+    printf("=== 测试编码 ===\n");
+    frame_codec_type_t type;
+    CHECK(frame_codec_parse_type("LINE", &type) == 0 && type == FRAME_CODEC_LINE &&
+          frame_codec_parse_type("length", &type) == 0 && type == FRAME_CODEC_LENGTH_PREFIXED &&
+          frame_codec_parse_type("json", &type) == -1, "解析帧格式名称");
+
+    frame_codec_t line = { FRAME_CODEC_LINE, 0, 1024, NULL, NULL, NULL };
+    size_t length = 0;
+    char *frame = frame_encode(&line, "hi", 2, &length);
+    CHECK(frame && length == 3 && memcmp(frame, "hi\n", 3) == 0, "行格式追加换行");
+    free(frame);
+
+    frame_codec_t short_header = { FRAME_CODEC_LENGTH_PREFIXED, 2, 1 << 20, NULL, NULL, NULL };
+    frame = frame_encode(&short_header, "abc", 3, &length);
+    CHECK(frame && length == 5 && frame[0] == 0 && frame[1] == 3 && memcmp(frame + 2, "abc", 3) == 0,
+          "2字节长度头为大端");
+    free(frame);
+    char *big = calloc(1, 0x10000);
+    CHECK(frame_encode(&short_header, big, 0x10000, &length) == NULL, "2字节长度头放不下的内容编码失败");
+    free(big);
+
+    CHECK(frame_decoder_create(&(frame_codec_t) { FRAME_CODEC_LENGTH_PREFIXED, 3, 1024, NULL, NULL, NULL }, 0) == NULL,
+          "长度头只能是2或4字节");
+    printf("\n");
+}
+
+// 测试跨读取拆分的帧：逐字节提交，行格式的CR和LF分在两次读取中
+static void test_split(void) {
+    printf("=== 测试跨读取拆分 ===\n");
+    collector_t collector;
+    memset(&collector, 0, sizeof(collector));
+
+    frame_codec_t length_codec = { FRAME_CODEC_LENGTH_PREFIXED, 4, 1024, NULL, NULL, NULL };
+    frame_decoder_t *decoder = frame_decoder_create(&length_codec, 0);
+    char data[64];
+    size_t total = build_length_frame(data, 4, "hello world", 11, 0);
+    total += build_length_frame(data + total, 4, "", 0, 0);
+    int incomplete = 0;
+    for (size_t i = 0; i < total; i++) {
+        int result = read_into(decoder, data + i, 1, &collector);
+        if (i < 14 && result != 0) {
+            incomplete++;
+        }
+    }
+    CHECK(incomplete == 0, "长度头或内容不完整时不分发");
+    CHECK(collector.count == 2 && collector.lengths[0] == 11 && strcmp(collector.frames[0], "hello world") == 0 &&
+          collector.lengths[1] == 0, "逐字节提交后得到完整的帧和空帧");
+    frame_decoder_destroy(decoder);
+    collector_reset(&collector);
+
+    frame_codec_t line_codec = { FRAME_CODEC_LINE, 0, 1024, NULL, NULL, NULL };
+    decoder = frame_decoder_create(&line_codec, 0);
+    read_into(decoder, "PING\r", 5, &collector);
+    CHECK(collector.count == 0, "只收到CR时行不完整");
+    read_into(decoder, "\nECHO a", 7, &collector);
+    read_into(decoder, "b\n\r\n", 4, &collector);
+    CHECK(collector.count == 3 && strcmp(collector.frames[0], "PING") == 0 &&
+          strcmp(collector.frames[1], "ECHO ab") == 0 && collector.lengths[2] == 0,
+          "去除结尾的CRLF或LF，空行为空帧");
+    frame_decoder_destroy(decoder);
+    collector_reset(&collector);
+    printf("\n");
+}
+
+// 测试一次读取中的多个帧：超过单批上限时分多批分发，顺序不变
+static void test_pipelined(void) {
+    printf("=== 测试流水线帧 ===\n");
+    collector_t collector;
+    memset(&collector, 0, sizeof(collector));
+
+    frame_codec_t line_codec = { FRAME_CODEC_LINE, 0, 1024, NULL, NULL, NULL };
+    frame_decoder_t *decoder = frame_decoder_create(&line_codec, 0);
+    char data[2048];
+    size_t length = 0;
+    for (int i = 0; i < 150; i++) {
+        length += (size_t) sprintf(data + length, "cmd %d\r\n", i);
+    }
+    int dispatched = read_into(decoder, data, length, &collector);
+    int ordered = collector.count == 150;
+    for (int i = 0; ordered && i < 150; i++) {
+        char expected[16];
+        sprintf(expected, "cmd %d", i);
+        ordered = strcmp(collector.frames[i], expected) == 0;
+    }
+    CHECK(dispatched == 150 && ordered, "一次读取中的150帧按顺序分发");
+    CHECK(collector.batches >= 3, "超过单批上限时分多批回调");
+    frame_decoder_destroy(decoder);
+    collector_reset(&collector);
+    printf("\n");
+}
+
+// 测试单帧上限的边界：恰好等于上限的帧可以解码，超过1字节即为错误
+static void test_max_frame_size(void) {
+    printf("=== 测试单帧上限 ===\n");
+    collector_t collector;
+    memset(&collector, 0, sizeof(collector));
+    char data[512];
+
+    // 长度头格式：上限包含帧头
+    frame_codec_t length_codec = { FRAME_CODEC_LENGTH_PREFIXED, 4, 100, NULL, NULL, NULL };
+    frame_decoder_t *decoder = frame_decoder_create(&length_codec, 0);
+    size_t length = build_length_frame(data, 4, NULL, 96, 0);
+    CHECK(read_into(decoder, data, length, &collector) == 1 && collector.lengths[0] == 96,
+          "长度头格式：帧头加内容恰好等于上限时解码成功");
+    frame_decoder_destroy(decoder);
+    collector_reset(&collector);
+
+    decoder = frame_decoder_create(&length_codec, 0);
+    build_length_frame(data, 4, NULL, 97, 0);
+    CHECK(read_into(decoder, data, 4, &collector) == -1, "长度头格式：声明的长度超过上限时收到帧头即报错");
+    frame_decoder_destroy(decoder);
+    collector_reset(&collector);
+
+    // 行格式：上限包含行结尾
+    frame_codec_t line_codec = { FRAME_CODEC_LINE, 0, 100, NULL, NULL, NULL };
+    decoder = frame_decoder_create(&line_codec, 0);
+    memset(data, 'x', 99);
+    data[99] = '\n';
+    CHECK(read_into(decoder, data, 100, &collector) == 1 && collector.lengths[0] == 99,
+          "行格式：含换行恰好等于上限时解码成功");
+    memset(data, 'x', 98);
+    data[98] = '\r';
+    data[99] = '\n';
+    CHECK(read_into(decoder, data, 100, &collector) == 1 && collector.lengths[1] == 98,
+          "行格式：含CRLF恰好等于上限时解码成功");
+    frame_decoder_destroy(decoder);
+    collector_reset(&collector);
+
+    decoder = frame_decoder_create(&line_codec, 0);
+    memset(data, 'x', 100);
+    data[100] = '\n';
+    CHECK(read_into(decoder, data, 101, &collector) == -1 && collector.count == 0, "行格式：超过上限1字节时报错");
+    frame_decoder_destroy(decoder);
+
+    decoder = frame_decoder_create(&line_codec, 0);
+    CHECK(read_into(decoder, data, 99, &collector) == 0, "行格式：没有换行且未达上限时等待");
+    CHECK(read_into(decoder, data, 1, &collector) == -1, "行格式：没有换行的数据达到上限时不等换行即报错");
+    frame_decoder_destroy(decoder);
+    collector_reset(&collector);
+    printf("\n");
+}
+
+// 按半帧加整帧的大小分次读取200个互质大小的帧，半帧留在缓冲区中跨过结尾，返回读取是否全部成功
+static int read_wrapping_stream(frame_decoder_t *decoder, collector_t *collector, int frames, size_t payload) {
+    char *stream = malloc((payload + 2) * frames);
+    size_t length = 0;
+    for (int i = 0; i < frames; i++) {
+        length += build_length_frame(stream + length, 2, NULL, payload, i);
+    }
+    size_t offset = 0;
+    int ok = 1;
+    while (offset < length) {
+        size_t chunk = (payload + 2) * 3 / 2;
+        if (chunk > length - offset) {
+            chunk = length - offset;
+        }
+        if (read_into(decoder, stream + offset, chunk, collector) < 0) {
+            ok = 0;
+            break;
+        }
+        offset += chunk;
+    }
+    free(stream);
+
+    for (int i = 0; ok && i < frames; i++) {
+        ok = collector->count == frames && collector->lengths[i] == payload &&
+             pattern_matches(collector->frames[i], payload, i);
+    }
+    return ok;
+}
+
+// 测试镜像环形缓冲区的回绕：帧大小与缓冲区大小互质，多次回绕后帧跨越缓冲区结尾，内容仍然连续
+static void test_wrap_around(void) {
+    printf("=== 测试环形缓冲区回绕 ===\n");
+    collector_t collector;
+    memset(&collector, 0, sizeof(collector));
+
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    frame_codec_t codec = { FRAME_CODEC_LENGTH_PREFIXED, 2, page, NULL, NULL, NULL };
+    frame_decoder_t *decoder = frame_decoder_create(&codec, page);
+    char *first;
+    size_t available;
+    frame_decoder_get_write_buffer(decoder, &first, &available);
+    collector.ring_start = first;
+    collector.ring_capacity = available;
+
+    CHECK(read_wrapping_stream(decoder, &collector, 200, 997), "多次回绕后每帧内容完整且按顺序");
+    frame_decoder_get_write_buffer(decoder, &first, &available);
+    CHECK(available == page, "全部分发后缓冲区没有扩大");
+#ifdef __linux__
+    CHECK(collector.straddled > 0, "镜像映射中跨越缓冲区结尾的帧直接连续分发");
+#endif
+    frame_decoder_destroy(decoder);
+    collector_reset(&collector);
+    printf("\n");
+}
+
+// 测试线性缓冲区：镜像缓冲区数达到上限后新的解码器改用线性缓冲区，写到结尾时把半帧搬回开头
+static void test_linear_fallback(void) {
+    printf("=== 测试线性缓冲区 ===\n");
+    collector_t collector;
+    memset(&collector, 0, sizeof(collector));
+
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    frame_codec_t codec = { FRAME_CODEC_LENGTH_PREFIXED, 2, page, NULL, NULL, NULL };
+    // 占满镜像缓冲区的名额（上限为8192个）
+    const int holders = 8192;
+    frame_decoder_t **held = calloc(holders, sizeof(frame_decoder_t*));
+    for (int i = 0; i < holders; i++) {
+        held[i] = frame_decoder_create(&codec, page);
+    }
+
+    frame_decoder_t *decoder = frame_decoder_create(&codec, page);
+    char *first;
+    size_t available;
+    frame_decoder_get_write_buffer(decoder, &first, &available);
+    collector.ring_start = first;
+    collector.ring_capacity = available;
+
+    CHECK(read_wrapping_stream(decoder, &collector, 200, 997), "搬回开头后每帧内容完整且按顺序");
+    CHECK(collector.straddled == 0, "线性缓冲区中的帧不跨越缓冲区结尾");
+    frame_decoder_destroy(decoder);
+    collector_reset(&collector);
+
+    for (int i = 0; i < holders; i++) {
+        frame_decoder_destroy(held[i]);
+    }
+    free(held);
+    printf("\n");
+}
+
+// 测试停止分发：停止后继续缓存数据，缓冲区写满时扩大，恢复后按顺序分发；缓存超过上限时报错
+static void test_stop_and_grow(void) {
+    printf("=== 测试停止分发与扩大 ===\n");
+    collector_t collector;
+    memset(&collector, 0, sizeof(collector));
+
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    frame_codec_t codec = { FRAME_CODEC_LENGTH_PREFIXED, 4, page, NULL, NULL, NULL };
+    frame_decoder_t *decoder = frame_decoder_create(&codec, page);
+    collector.stop_after = 1;
+
+    // 3页数据：第一批分发后停止，剩余的数据超过初始缓冲区
+    const size_t payload = 96;
+    const int frames = (int) (page * 3 / (payload + 4));
+    char *stream = malloc((payload + 4) * frames);
+    size_t length = 0;
+    for (int i = 0; i < frames; i++) {
+        length += build_length_frame(stream + length, 4, NULL, payload, i);
+    }
+    int result = frame_decoder_feed(decoder, stream, length, on_frames, &collector);
+    int first_batch = collector.count;
+    CHECK(result == first_batch && first_batch > 0 && frame_decoder_is_stopped(decoder), "第一批分发后停止");
+
+    char *buffer;
+    size_t available;
+    frame_decoder_get_write_buffer(decoder, &buffer, &available);
+    CHECK(collector.count == first_batch, "停止期间不再分发");
+    // 镜像缓冲区的空闲区域加上已缓存的数据即为缓冲区大小
+    size_t buffered = length - (size_t) first_batch * (payload + 4);
+    CHECK(available > 0 && available + buffered > page, "停止期间缓冲区写满后扩大");
+
+    collector.stop_after = 0;
+    result = frame_decoder_resume(decoder, on_frames, &collector);
+    int intact = collector.count == frames && !frame_decoder_is_stopped(decoder);
+    for (int i = 0; intact && i < frames; i++) {
+        intact = collector.lengths[i] == payload && pattern_matches(collector.frames[i], payload, i);
+    }
+    CHECK(result == frames - first_batch && intact, "恢复后按顺序分发缓存的全部帧");
+    frame_decoder_destroy(decoder);
+    collector_reset(&collector);
+
+    // 停止后缓存超过单帧上限的4倍时报错
+    decoder = frame_decoder_create(&codec, page);
+    collector.stop_after = 1;
+    char *flood = malloc((payload + 4) * frames * 2);
+    length = 0;
+    for (int i = 0; i < frames * 2; i++) {
+        length += build_length_frame(flood + length, 4, NULL, payload, i);
+    }
+    CHECK(frame_decoder_feed(decoder, flood, length, on_frames, &collector) == -1, "停止期间缓存超过上限时报错");
+    free(flood);
+    frame_decoder_destroy(decoder);
+    collector_reset(&collector);
+
+    // 单帧超过缓冲区时提交路径扩大到单帧上限
+    frame_codec_t large = { FRAME_CODEC_LENGTH_PREFIXED, 4, page * 4, NULL, NULL, NULL };
+    decoder = frame_decoder_create(&large, page);
+    char *big = malloc(page * 4);
+    length = build_length_frame(big, 4, NULL, page * 3, 7);
+    result = read_into(decoder, big, length, &collector);
+    CHECK(result == 1 && collector.lengths[0] == page * 3 && pattern_matches(collector.frames[0], page * 3, 7),
+          "超过缓冲区的单帧在扩大后完整分发");
+    free(big);
+    free(stream);
+    frame_decoder_destroy(decoder);
+    collector_reset(&collector);
+    printf("\n");
+}
+
+int main(void) {
+    printf("=== 分帧编解码测试程序 ===\n\n");
+
+    test_encode();
+    test_split();
+    test_pipelined();
+    test_max_frame_size();
+    test_wrap_around();
+    test_linear_fallback();
+    test_stop_and_grow();
+
+    printf("=== 分帧编解码测试完成，失败 %d 项 ===\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+// 线程池future测试：完成与后续工作、完成回调所在线程、限时等待、取消和线程池拒绝
+// 编译: gcc -O2 -I. -Isrc/modules test/test_future.c src/thread/future.c src/thread/loop_queue.c src/thread/threadpool_module.c src/thread/work_deque.c src/thread/task_ring.c src/log/logger_module.c src/config/config_module.c -o test_future -luv -lpthread
+// 运行: ./test_future [future数]，全部通过时返回0
+#include <stdio.h>
+#include <stdlib.h>
+#include <uv.h>
+#include "src/thread/future.h"
+#include "src/thread/threadpool_module.h"
+#include "src/config/config_module.h"
+
+static uv_loop_t *loop;
+static uv_thread_t loop_thread;
+static uv_timer_t keepalive;        // 完成队列的异步句柄不保持事件循环运行，等待回调期间由定时器保持
+static int failures = 0;
+static int delivered = 0;           // 已执行的完成回调数，只在事件循环线程修改
+static int wrong_thread = 0;
+static int gate_open = 0;           // 阻塞工作等待的开关
+static int blocker_started = 0;
+static int cancelled_runs = 0;      // 已取消的工作被执行的次数，应为0
+
+#define CHECK(cond, msg) do { \
+    if (cond) { \
+        printf("✓ %s\n", msg); \
+    } else { \
+        printf("✗ %s\n", msg); \
+        failures++; \
+    } \
+} while (0)
+
+static void on_keepalive(uv_timer_t *timer) {
+    (void)timer; // 避免未使用参数警告
+}
+
+// 运行事件循环直到执行了target个完成回调
+static void run_until_delivered(int target) {
+    while (delivered < target) {
+        uv_run(loop, UV_RUN_ONCE);
+    }
+}
+
+static void* add_one(void *arg) {
+    return (void*) ((long) arg + 1);
+}
+
+static void* double_it(void *result, void *arg) {
+    (void)arg; // 避免未使用参数警告
+    return (void*) ((long) result * 2);
+}
+
+static void* sleep_and_return(void *arg) {
+    uv_sleep(200);
+    return arg;
+}
+
+static void* wait_for_gate(void *arg) {
+    __atomic_store_n(&blocker_started, 1, __ATOMIC_RELEASE);
+    while (!__atomic_load_n(&gate_open, __ATOMIC_ACQUIRE)) {
+        uv_sleep(1);
+    }
+    return arg;
+}
+
+static void* must_not_run(void *arg) {
+    __atomic_add_fetch(&cancelled_runs, 1, __ATOMIC_SEQ_CST);
+    return arg;
+}
+
+static void* then_must_not_run(void *result, void *arg) {
+    (void)arg; // 避免未使用参数警告
+    __atomic_add_fetch(&cancelled_runs, 1, __ATOMIC_SEQ_CST);
+    return result;
+}
+
+// 检查回调线程并计数，arg指向保存状态的位置
+static void on_done(future_t *future, void *arg) {
+    uv_thread_t self = uv_thread_self();
+    if (!uv_thread_equal(&self, &loop_thread)) {
+        wrong_thread++;
+    }
+    if (arg) {
+        *(int*) arg = future_status(future);
+    }
+    delivered++;
+}
+
+static int chain_correct = 0;
+
+// 链式future的回调，arg为输入值
+static void on_chain_done(future_t *future, void *arg) {
+    if (future_status(future) == FUTURE_DONE && (long) future_result(future) == ((long) arg + 1) * 2) {
+        chain_correct++;
+    }
+    on_done(future, NULL);
+}
+
+// 测试完成、后续工作和完成回调所在线程
+static void test_completion(int count) {
+    printf("=== 测试完成与后续工作 ===\n");
+    delivered = 0;
+    wrong_thread = 0;
+    chain_correct = 0;
+
+    future_loop_t *completions = future_loop_create(loop);
+    for (long i = 0; i < count; i++) {
+        future_t *first = future_submit(completions, add_one, (void*) i, NULL, NULL);
+        future_t *second = future_then(first, double_it, NULL, on_chain_done, (void*) i);
+        future_release(first);
+        future_release(second);
+    }
+    run_until_delivered(count);
+
+    CHECK(chain_correct == count, "所有链式future的结果正确");
+    CHECK(wrong_thread == 0, "完成回调都在事件循环线程执行");
+    future_loop_destroy(completions);
+    printf("\n");
+}
+
+// 测试限时等待和已完成future上的后续工作
+static void test_wait(void) {
+    printf("=== 测试等待 ===\n");
+    future_t *slow = future_submit(NULL, sleep_and_return, (void*) 7, NULL, NULL);
+    CHECK(future_wait(slow, 20) == UV_ETIMEDOUT, "未完成时限时等待超时");
+    CHECK(future_wait(slow, -1) == 0 && (long) future_result(slow) == 7, "不限时等待得到结果");
+
+    future_t *next = future_then(slow, double_it, NULL, NULL, NULL);
+    CHECK(future_wait(next, 1000) == 0 && (long) future_result(next) == 14, "已完成future上的后续工作立即提交");
+    future_release(next);
+    future_release(slow);
+    printf("\n");
+}
+
+// 测试取消：唯一的工作线程被阻塞时，排队的future和等待前一步的后续future都可以取消
+static void test_cancel(void) {
+    printf("=== 测试取消 ===\n");
+    delivered = 0;
+    wrong_thread = 0;
+    int queued_status = FUTURE_PENDING;
+    int after_queued_status = FUTURE_PENDING;
+    int continuation_status = FUTURE_PENDING;
+    int blocker_status = FUTURE_PENDING;
+
+    future_loop_t *completions = future_loop_create(loop);
+    future_t *blocker = future_submit(completions, wait_for_gate, (void*) 3, on_done, &blocker_status);
+    while (!__atomic_load_n(&blocker_started, __ATOMIC_ACQUIRE)) {
+        uv_sleep(1);
+    }
+    future_t *queued = future_submit(completions, must_not_run, NULL, on_done, &queued_status);
+    future_t *after_queued = future_then(queued, then_must_not_run, NULL, on_done, &after_queued_status);
+    future_t *continuation = future_then(blocker, then_must_not_run, NULL, on_done, &continuation_status);
+
+    CHECK(future_cancel(blocker) == -1, "已开始执行的future不能取消");
+    CHECK(future_cancel(queued) == 0, "排队中的future可以取消");
+    CHECK(future_cancel(queued) == -1, "重复取消返回-1");
+    CHECK(future_cancel(continuation) == 0, "等待前一步的后续future可以取消");
+    CHECK(future_status(queued) == FUTURE_CANCELLED, "取消后状态立即变为FUTURE_CANCELLED");
+
+    __atomic_store_n(&gate_open, 1, __ATOMIC_RELEASE);
+    run_until_delivered(4);
+    // 线程池仍持有已取消的future，等唯一的工作线程执行完之后提交的工作，再确认它没有执行
+    future_t *sentinel = future_submit(NULL, add_one, NULL, NULL, NULL);
+    future_wait(sentinel, -1);
+    future_release(sentinel);
+
+    CHECK(blocker_status == FUTURE_DONE && (long) future_result(blocker) == 3, "正在执行的future正常完成");
+    CHECK(queued_status == FUTURE_CANCELLED && continuation_status == FUTURE_CANCELLED, "已取消future的完成回调照常执行");
+    CHECK(after_queued_status == FUTURE_FAILED, "已取消future的后续future失败");
+    CHECK(cancelled_runs == 0, "已取消的工作没有执行");
+    CHECK(wrong_thread == 0, "完成回调都在事件循环线程执行");
+
+    future_release(blocker);
+    future_release(queued);
+    future_release(after_queued);
+    future_release(continuation);
+    future_loop_destroy(completions);
+    printf("\n");
+}
+
+// 测试线程池停止后提交的future失败，回调照常执行
+static void test_rejected(void) {
+    printf("=== 测试线程池拒绝 ===\n");
+    delivered = 0;
+    int status = FUTURE_PENDING;
+    int then_status = FUTURE_PENDING;
+
+    future_loop_t *completions = future_loop_create(loop);
+    future_t *first = future_submit(completions, add_one, NULL, on_done, &status);
+    future_t *second = future_then(first, double_it, NULL, on_done, &then_status);
+    CHECK(future_status(first) == FUTURE_FAILED && future_status(second) == FUTURE_FAILED, "线程池停止后提交立即失败");
+    CHECK(future_cancel(first) == -1, "已完成的future不能取消");
+    run_until_delivered(2);
+    CHECK(status == FUTURE_FAILED && then_status == FUTURE_FAILED, "失败的future执行完成回调");
+
+    future_release(first);
+    future_release(second);
+    future_loop_destroy(completions);
+    printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 10000;
+    printf("=== 线程池future测试程序 ===\n\n");
+
+    loop = uv_default_loop();
+    loop_thread = uv_thread_self();
+    uv_timer_init(loop, &keepalive);
+    uv_timer_start(&keepalive, on_keepalive, 10, 10);
+
+    // 只初始化配置模块、不加载配置文件，线程池使用下面的配置
+    config_module.init(&config_module, loop);
+
+    // 单个工作线程，取消测试依赖排队中的工作不会被其他线程取走
+    threadpool_config_t config = { 1, 65536, 1, 1, THREADPOOL_REJECT, 1, 1, 0, 0 };
+    threadpool_module.init(&threadpool_module, loop);
+    threadpool_module_set_config(&threadpool_module, &config);
+    if (threadpool_module.start(&threadpool_module) != 0) {
+        printf("✗ 线程池启动失败\n");
+        return 1;
+    }
+
+    test_completion(count);
+    test_wait();
+    test_cancel();
+
+    threadpool_module.stop(&threadpool_module);
+    test_rejected();
+    threadpool_module.cleanup(&threadpool_module);
+
+    uv_close((uv_handle_t*) &keepalive, NULL);
+    uv_run(loop, UV_RUN_DEFAULT);
+    uv_loop_close(loop);
+
+    printf("=== future测试完成，失败 %d 项 ===\n", failures);
+    return failures == 0 ? 0 : 1;
+}
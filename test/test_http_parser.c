@@ -0,0 +1,244 @@
+// HTTP报文解析测试：头部块切分与已知头部标签、NUL和不跟LF的CR、上游响应头部、
+// 查询/表单参数的切分与延迟解码、chunked请求体解码
+// 编译: gcc -O2 -D_GNU_SOURCE -I. -Isrc/modules test/test_http_parser.c src/http/http_parser.c src/http/http_headers.c -o test_http_parser
+// 运行: ./test_http_parser，全部通过时返回0
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "src/http/http_parser.h"
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (cond) { \
+        printf("✓ %s\n", msg); \
+    } else { \
+        printf("✗ %s\n", msg); \
+        failures++; \
+    } \
+} while (0)
+
+// 一次头部块解析的结果
+typedef struct {
+    char *block;
+    http_header_t *headers;
+    int header_count;
+    const char *known_headers[HTTP_HEADER_KNOWN_COUNT];
+} header_result_t;
+
+static int parse_headers(const char *data, size_t length, header_result_t *result) {
+    memset(result, 0, sizeof(header_result_t));
+    return http_parse_header_block(data, length, &result->block, &result->headers,
+                                   &result->header_count, result->known_headers);
+}
+
+static void free_headers(header_result_t *result) {
+    free(result->block);
+    free(result->headers);
+}
+
+// 测试头部切分、空白去除和已知头部标签
+static void test_header_block(void) {
+    printf("=== 测试头部块解析 ===\n");
+    header_result_t result;
+    const char block[] = "Host: example.com\r\nContent-Length:  12 \r\nX-Custom:\tv\r\nhost: second\r\nbad line\r\n";
+    CHECK(parse_headers(block, sizeof(block) - 1, &result) == 0, "解析成功");
+    CHECK(result.header_count == 4, "没有冒号的行被跳过");
+    CHECK(result.header_count == 4 && strcmp(result.headers[1].name, "Content-Length") == 0 &&
+          strcmp(result.headers[1].value, "12") == 0, "去除值两端的空白");
+    CHECK(result.header_count == 4 && strcmp(result.headers[2].value, "v") == 0 &&
+          result.headers[2].id == HTTP_HEADER_UNKNOWN, "未知头部ID为HTTP_HEADER_UNKNOWN");
+    CHECK(result.known_headers[HTTP_HEADER_HOST] && strcmp(result.known_headers[HTTP_HEADER_HOST], "example.com") == 0,
+          "重复的已知头部以第一次出现的为准");
+    CHECK(result.known_headers[HTTP_HEADER_CONTENT_LENGTH] == result.headers[1].value, "已知头部按ID索引");
+    free_headers(&result);
+
+    const char last[] = "A: 1\r\nB: 2";
+    CHECK(parse_headers(last, sizeof(last) - 1, &result) == 0 && result.header_count == 2 &&
+          strcmp(result.headers[1].value, "2") == 0, "最后一行没有CRLF时仍被解析");
+    free_headers(&result);
+
+    CHECK(parse_headers("", 0, &result) == 0 && result.header_count == 0 && !result.headers, "空头部块");
+    printf("\n");
+}
+
+// 测试含NUL或不跟LF的CR的头部块被拒绝（此前按NUL前的行数分配数组，切分时越界写入）
+static void test_header_block_invalid(void) {
+    printf("=== 测试非法头部块 ===\n");
+    header_result_t result;
+    const char nul[] = "A: b\r\nC: d\0x\r\n";
+    CHECK(parse_headers(nul, sizeof(nul) - 1, &result) == -1 && result.header_count == 0, "含NUL的头部块被拒绝");
+    free_headers(&result);
+
+    const char nul_lines[] = "A: b\r\n\0\r\nC: d\r\nE: f\r\n";
+    CHECK(parse_headers(nul_lines, sizeof(nul_lines) - 1, &result) == -1, "NUL后还有多行时被拒绝");
+    free_headers(&result);
+
+    const char bare_cr[] = "A: b\rC: d\r\n";
+    CHECK(parse_headers(bare_cr, sizeof(bare_cr) - 1, &result) == -1, "不跟LF的CR被拒绝");
+    free_headers(&result);
+
+    const char trailing_cr[] = "A: b\r\nC: d\r";
+    CHECK(parse_headers(trailing_cr, sizeof(trailing_cr) - 1, &result) == -1, "结尾单独的CR被拒绝");
+    free_headers(&result);
+    printf("\n");
+}
+
+// 测试上游响应头部：按HTTP客户端的方式切出状态行之后的头部块，含NUL时解析失败（客户端以UV_EPROTO回调）
+static void test_response_head(void) {
+    printf("=== 测试上游响应头部 ===\n");
+    header_result_t result;
+    const char ok[] = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: close\r\n\r\nok";
+    const char *headers_end = http_find_header_end(ok, sizeof(ok) - 1);
+    const char *headers_start = memmem(ok, sizeof(ok) - 1, "\r\n", 2) + 2;
+    CHECK(parse_headers(headers_start, headers_end + 2 - headers_start, &result) == 0 && result.header_count == 2 &&
+          strcmp(result.known_headers[HTTP_HEADER_CONTENT_LENGTH], "2") == 0, "正常响应头部解析成功");
+    free_headers(&result);
+
+    const char hostile[] = "HTTP/1.1 200 OK\r\nA: b\r\nC: d\0x\r\nE: f\r\n\r\n";
+    headers_end = http_find_header_end(hostile, sizeof(hostile) - 1);
+    headers_start = memmem(hostile, sizeof(hostile) - 1, "\r\n", 2) + 2;
+    CHECK(headers_end != NULL, "含NUL的响应仍能找到头部结束");
+    CHECK(parse_headers(headers_start, headers_end + 2 - headers_start, &result) == -1, "含NUL的响应头部解析失败");
+    free_headers(&result);
+    printf("\n");
+}
+
+// 测试头部结束标记查找不受NUL影响
+static void test_header_end(void) {
+    printf("=== 测试头部结束查找 ===\n");
+    const char data[] = "GET / HTTP/1.1\r\nA: \0\r\n\r\nbody";
+    const char *end = http_find_header_end(data, sizeof(data) - 1);
+    CHECK(end == data + 20, "跨过NUL找到空行");
+    CHECK(http_find_header_end(data, 3) == NULL, "数据不足4字节返回NULL");
+    CHECK(http_find_header_end("A: b\r\n", 6) == NULL, "没有空行返回NULL");
+    printf("\n");
+}
+
+// 测试URL编码字符解码
+static void test_decode_char(void) {
+    printf("=== 测试URL解码 ===\n");
+    char c = 0;
+    const char encoded[] = "%41";
+    CHECK(http_decode_char(encoded, encoded + 3, &c) == 3 && c == 'A', "%XX解码为一个字节");
+    CHECK(http_decode_char("+", "+" + 1, &c) == 1 && c == ' ', "'+'解码为空格");
+    CHECK(http_decode_char("%2", "%2" + 2, &c) == 1 && c == '%', "结尾不足两位的%原样保留");
+    CHECK(http_decode_char("%g1", "%g1" + 3, &c) == 1 && c == '%', "非十六进制的%原样保留");
+    printf("\n");
+}
+
+// 测试参数切分：编码后的分隔符不被误切，值在首次访问时解码并缓存
+static void test_params(void) {
+    printf("=== 测试参数切分 ===\n");
+    http_param_list_t list;
+    memset(&list, 0, sizeof(list));
+    const char query[] = "a=1&&b=hello+world&c=%26%3D&flag&x%3Dy=5&a=2&";
+    CHECK(http_parse_params(query, sizeof(query) - 1, &list) == 0 && list.count == 6, "切分参数并跳过空项");
+    CHECK(list.inline_params[2].decoded_value == NULL, "切分时不解码");
+
+    const char *value = http_find_param(&list, "a");
+    CHECK(value && strcmp(value, "1") == 0, "重复的参数以第一次出现的为准");
+    CHECK(strcmp(http_find_param(&list, "b"), "hello world") == 0, "值中的'+'解码为空格");
+    value = http_find_param(&list, "c");
+    CHECK(value && strcmp(value, "&=") == 0, "编码后的&和=属于值");
+    CHECK(http_find_param(&list, "c") == value, "解码结果被缓存");
+    CHECK(http_find_param(&list, "flag") && strcmp(http_find_param(&list, "flag"), "") == 0, "没有=的参数值为空");
+    CHECK(http_find_param(&list, "x=y") && strcmp(http_find_param(&list, "x=y"), "5") == 0 &&
+          http_find_param(&list, "x") == NULL, "名称按解码后比较，编码后的=属于名称");
+    CHECK(http_find_param(&list, "missing") == NULL && http_find_param(&list, "") == NULL, "不存在的参数返回NULL");
+    http_free_params(&list);
+    CHECK(list.count == 0 && list.overflow == NULL, "释放后列表为空");
+
+    const char bad[] = "p=%zz&q=%4&r=100%&s=%%41";
+    CHECK(http_parse_params(bad, sizeof(bad) - 1, &list) == 0 && list.count == 4, "非法转义不影响切分");
+    CHECK(strcmp(http_find_param(&list, "p"), "%zz") == 0 && strcmp(http_find_param(&list, "q"), "%4") == 0 &&
+          strcmp(http_find_param(&list, "r"), "100%") == 0, "非法的%转义原样保留");
+    CHECK(strcmp(http_find_param(&list, "s"), "%A") == 0, "非法的%之后的转义照常解码");
+    http_free_params(&list);
+
+    // 表单请求体不以NUL结尾，只按长度切分
+    const char body[] = "k=v&tail=end";
+    CHECK(http_parse_params(body, 10, &list) == 0 && list.count == 2 &&
+          strcmp(http_find_param(&list, "tail"), "e") == 0, "按长度切分，不越过结尾");
+    http_free_params(&list);
+    printf("\n");
+}
+
+// 测试超过内联数量的参数转为堆上数组，已缓存的解码结果随数组一起转移
+static void test_params_overflow(void) {
+    printf("=== 测试参数溢出 ===\n");
+    http_param_list_t list;
+    memset(&list, 0, sizeof(list));
+    const int count = HTTP_INLINE_PARAMS * 3 + 1;
+    char query[2048];
+    size_t length = 0;
+    size_t inline_length = 0;       // 前HTTP_INLINE_PARAMS个参数的长度
+    for (int i = 0; i < count; i++) {
+        length += (size_t) sprintf(query + length, "%sk%d=v%%20%d", i > 0 ? "&" : "", i, i);
+        if (i == HTTP_INLINE_PARAMS - 1) {
+            inline_length = length;
+        }
+    }
+
+    CHECK(http_parse_params(query, inline_length, &list) == 0 && list.count == HTTP_INLINE_PARAMS &&
+          list.overflow == NULL, "未超过内联数量时不分配");
+    const char *first = http_find_param(&list, "k0");
+
+    // 继续向同一列表追加剩余参数
+    CHECK(http_parse_params(query + inline_length, length - inline_length, &list) == 0 && list.count == count &&
+          list.overflow != NULL && list.capacity >= count, "超过内联数量后全部参数转为堆上数组");
+    CHECK(first && http_find_param(&list, "k0") == first, "已缓存的解码结果随数组一起转移");
+
+    int found = 1;
+    for (int i = 0; i < count; i++) {
+        char name[16];
+        char expected[16];
+        sprintf(name, "k%d", i);
+        sprintf(expected, "v %d", i);
+        const char *value = http_find_param(&list, name);
+        if (!value || strcmp(value, expected) != 0) {
+            found = 0;
+        }
+    }
+    CHECK(found, "内联部分和堆上部分的参数都能查找并解码");
+    http_free_params(&list);
+    CHECK(list.count == 0 && list.overflow == NULL && list.capacity == 0, "释放堆上数组");
+    printf("\n");
+}
+
+// 测试chunked请求体解码
+static void test_chunked(void) {
+    printf("=== 测试chunked解码 ===\n");
+    char *body = NULL;
+    size_t body_length = 0;
+    size_t consumed = 0;
+    const char data[] = "5\r\nhello\r\n6;ext=1\r\n world\r\n0\r\nTrailer: x\r\n\r\nNEXT";
+    CHECK(http_decode_chunked(data, sizeof(data) - 1, &body, &body_length, &consumed) == 1 &&
+          body_length == 11 && memcmp(body, "hello world", 11) == 0, "解码多个chunk并跳过扩展参数");
+    CHECK(consumed == sizeof(data) - 1 - 4, "消耗到尾部头部后的空行");
+    free(body);
+
+    CHECK(http_decode_chunked(data, 12, &body, &body_length, &consumed) == 0, "数据不完整返回0");
+    CHECK(http_decode_chunked("z\r\n", 3, &body, &body_length, &consumed) == -1, "非法大小返回-1");
+    CHECK(http_decode_chunked("3\r\nabcX\r\n", 9, &body, &body_length, &consumed) == -1, "chunk后缺少CRLF返回-1");
+    CHECK(http_decode_chunked("1000000000000000\r\n", 18, &body, &body_length, &consumed) == -1, "大小位数过多返回-1");
+    CHECK(http_is_chunked("gzip, chunked") && !http_is_chunked("chunked, gzip") && !http_is_chunked(NULL),
+          "chunked必须是最后一个编码");
+    printf("\n");
+}
+
+int main(void) {
+    printf("=== HTTP报文解析测试程序 ===\n\n");
+
+    test_header_block();
+    test_header_block_invalid();
+    test_header_end();
+    test_response_head();
+    test_decode_char();
+    test_params();
+    test_params_overflow();
+    test_chunked();
+
+    printf("=== HTTP报文解析测试完成，失败 %d 项 ===\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+// 事件循环完成队列测试：多个生产者线程同时投递，事件循环线程按投递顺序批量回调
+// 编译: gcc -O2 -I. test/test_loop_queue.c src/thread/loop_queue.c -o test_loop_queue -luv -lpthread
+// 运行: ./test_loop_queue [生产者数] [每个生产者的节点数]，全部通过时返回0
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <uv.h>
+#include "src/thread/loop_queue.h"
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (cond) { \
+        printf("✓ %s\n", msg); \
+    } else { \
+        printf("✗ %s\n", msg); \
+        failures++; \
+    } \
+} while (0)
+
+typedef struct {
+    loop_queue_node_t node;
+    int producer;
+    long seq;
+} test_node_t;
+
+typedef struct {
+    loop_queue_t *queue;
+    test_node_t *nodes;
+    long count;
+} producer_params_t;
+
+// 回调中统计，只在事件循环线程访问
+typedef struct {
+    uv_thread_t loop_thread;
+    long delivered;
+    long *last;                     // 每个生产者最近回调的序号
+    int bad_order;
+    int wrong_thread;
+} delivery_state_t;
+
+static void on_node(loop_queue_node_t *node, void *arg) {
+    delivery_state_t *state = (delivery_state_t*) arg;
+    test_node_t *item = (test_node_t*) node;
+    uv_thread_t self = uv_thread_self();
+    if (!uv_thread_equal(&self, &state->loop_thread)) {
+        state->wrong_thread++;
+    }
+    // 同一生产者的节点按投递顺序回调
+    if (item->seq != state->last[item->producer] + 1) {
+        state->bad_order++;
+    }
+    state->last[item->producer] = item->seq;
+    state->delivered++;
+}
+
+static void* producer_thread(void *arg) {
+    producer_params_t *params = (producer_params_t*) arg;
+    for (long i = 0; i < params->count; i++) {
+        if (loop_queue_post(params->queue, &params->nodes[i].node) != 0) {
+            printf("✗ 投递失败\n");
+        }
+        // 偶尔让出CPU，使事件循环在生产者投递期间多次被唤醒
+        if ((i & 1023) == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void on_keepalive(uv_timer_t *timer) {
+    (void)timer; // 避免未使用参数警告
+}
+
+// 多个生产者同时投递，事件循环线程处理直到全部回调
+static void test_multi_producer(int producers, long count) {
+    printf("=== 测试多生产者投递（%d生产者 每个%ld节点）===\n", producers, count);
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+    // 完成队列的异步句柄不保持事件循环运行，等待期间由定时器保持
+    uv_timer_t keepalive;
+    uv_timer_init(&loop, &keepalive);
+    uv_timer_start(&keepalive, on_keepalive, 10, 10);
+
+    delivery_state_t state = { uv_thread_self(), 0, calloc(producers, sizeof(long)), 0, 0 };
+    for (int i = 0; i < producers; i++) {
+        state.last[i] = -1;
+    }
+    loop_queue_t *queue = loop_queue_create(&loop, on_node, &state);
+
+    test_node_t *nodes = calloc(producers * count, sizeof(test_node_t));
+    pthread_t *threads = malloc(sizeof(pthread_t) * producers);
+    producer_params_t *params = malloc(sizeof(producer_params_t) * producers);
+    for (int i = 0; i < producers; i++) {
+        params[i].queue = queue;
+        params[i].nodes = nodes + i * count;
+        params[i].count = count;
+        for (long j = 0; j < count; j++) {
+            params[i].nodes[j].producer = i;
+            params[i].nodes[j].seq = j;
+        }
+        pthread_create(&threads[i], NULL, producer_thread, &params[i]);
+    }
+
+    long total = producers * count;
+    int wakeups = 0;
+    while (state.delivered < total) {
+        uv_run(&loop, UV_RUN_ONCE);
+        wakeups++;
+    }
+    for (int i = 0; i < producers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    printf("  回调 %ld 个节点，事件循环迭代 %d 次\n", state.delivered, wakeups);
+    CHECK(state.delivered == total, "全部节点都被回调");
+    CHECK(state.bad_order == 0, "同一生产者的节点按投递顺序回调");
+    CHECK(state.wrong_thread == 0, "回调都在事件循环线程执行");
+    CHECK(loop_queue_drain(queue) == 0, "处理完成后队列为空");
+
+    loop_queue_destroy(queue);
+    uv_close((uv_handle_t*) &keepalive, NULL);
+    uv_run(&loop, UV_RUN_DEFAULT);
+    uv_loop_close(&loop);
+    free(params);
+    free(threads);
+    free(nodes);
+    free(state.last);
+    printf("\n");
+}
+
+// 事件循环未运行时投递的节点由drain和destroy同步处理
+static void test_drain_and_destroy(void) {
+    printf("=== 测试同步处理与销毁 ===\n");
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+
+    long last = -1;
+    delivery_state_t state = { uv_thread_self(), 0, &last, 0, 0 };
+    loop_queue_t *queue = loop_queue_create(&loop, on_node, &state);
+    test_node_t nodes[10];
+    for (int i = 0; i < 10; i++) {
+        nodes[i].producer = 0;
+        nodes[i].seq = i;
+    }
+
+    for (int i = 0; i < 5; i++) {
+        loop_queue_post(queue, &nodes[i].node);
+    }
+    CHECK(loop_queue_drain(queue) == 5 && state.delivered == 5, "drain处理已投递的全部节点");
+    for (int i = 5; i < 10; i++) {
+        loop_queue_post(queue, &nodes[i].node);
+    }
+    loop_queue_destroy(queue);
+    CHECK(state.delivered == 10 && state.bad_order == 0, "destroy按顺序处理剩余节点");
+
+    uv_run(&loop, UV_RUN_DEFAULT);
+    CHECK(uv_loop_close(&loop) == 0, "销毁后异步句柄已关闭");
+    printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    int producers = argc > 1 ? atoi(argv[1]) : 4;
+    long count = argc > 2 ? atol(argv[2]) : 200000;
+    printf("=== 事件循环完成队列测试程序 ===\n\n");
+
+    test_drain_and_destroy();
+    test_multi_producer(producers, count);
+
+    printf("=== 完成队列测试完成，失败 %d 项 ===\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,239 @@
+// RESP协议与键值存储测试：分帧解码（不完整、格式错误、超长声明）、命令执行（SET的EX/PX/NX/XX、INCR溢出）、
+// 时间轮过期
+// 编译: gcc -O2 -D_GNU_SOURCE -I. test/test_resp.c src/net/resp_protocol.c src/net/resp_server.c src/net/frame_codec.c src/db/kv_store.c -o test_resp -lpthread
+// 运行: ./test_resp，全部通过时返回0
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "src/net/resp_protocol.h"
+#include "src/net/resp_server.h"
+#include "src/net/frame_codec.h"
+#include "src/db/kv_store.h"
+
+#define TICK_MS 10
+#define MAX_FRAME_SIZE (1024 * 1024)
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (cond) { \
+        printf("✓ %s\n", msg); \
+    } else { \
+        printf("✗ %s\n", msg); \
+        failures++; \
+    } \
+} while (0)
+
+static ssize_t decode(const char *text, size_t limit) {
+    const char *payload;
+    size_t payload_length;
+    return resp_decode_command(text, strlen(text), &payload, &payload_length, limit ? &limit : NULL);
+}
+
+// 执行一条命令并与期望的回复比较，不一致时打印实际回复
+static int execute_is(kv_store_t *store, const char *command, uint64_t now, const char *expected) {
+    size_t reply_length;
+    char *reply = resp_execute(store, command, strlen(command), now, &reply_length);
+    int same = reply && reply_length == strlen(expected) && memcmp(reply, expected, reply_length) == 0;
+    if (!same) {
+        printf("  %s 的回复为 %.*s\n", command, reply ? (int) reply_length : 0, reply ? reply : "");
+    }
+    free(reply);
+    return same;
+}
+
+static int frames_seen = 0;
+
+static int count_frames(const frame_t *frames, size_t count, void *arg) {
+    (void)frames; // 避免未使用参数警告
+    (void)arg; // 避免未使用参数警告
+    frames_seen += (int) count;
+    return 0;
+}
+
+// 测试分帧解码
+static void test_decode(void) {
+    printf("=== 测试分帧解码 ===\n");
+    const char *command = "*3\r\n$3\r\nSET\r\n$3\r\nkey\r\n$5\r\nvalue\r\n";
+    size_t length = strlen(command);
+    CHECK(decode(command, 0) == (ssize_t) length, "完整命令返回整帧长度");
+
+    // 任意位置截断都视为不完整
+    int partial_ok = 1;
+    for (size_t i = 0; i < length; i++) {
+        const char *payload;
+        size_t payload_length;
+        if (resp_decode_command(command, i, &payload, &payload_length, NULL) != 0) {
+            partial_ok = 0;
+        }
+    }
+    CHECK(partial_ok, "任意位置截断的命令返回0");
+
+    const char *payload;
+    size_t payload_length;
+    const char *blank_lines = "\r\n\r\n*1\r\n$4\r\nPING\r\n";
+    CHECK(resp_decode_command(blank_lines, strlen(blank_lines), &payload, &payload_length, NULL) ==
+          (ssize_t) strlen(blank_lines) && payload == blank_lines + 4, "跳过命令之前的空行");
+    CHECK(decode("PING\r\n", 0) == 6 && decode("PING", 0) == 0, "内联命令以换行结尾");
+
+    CHECK(decode("*0\r\n", 0) == -1, "参数数为0是格式错误");
+    CHECK(decode("*1\r\n+PING\r\n", 0) == -1, "参数不是批量字符串是格式错误");
+    CHECK(decode("*1\r\n$-1\r\n", 0) == -1, "负长度是格式错误");
+    CHECK(decode("*1\r\n$4\r\nPINGxx", 0) == -1, "内容后缺少\\r\\n是格式错误");
+    CHECK(decode("*1\r\n$4x\r\n", 0) == -1, "长度中有非数字是格式错误");
+    CHECK(decode("*1\r\n$4\n", 0) == -1, "长度后缺少\\r是格式错误");
+    CHECK(decode("*1\r\n$1234567890123456789\r\n", 0) == -1, "超过18位的长度是格式错误");
+
+    // 声明的长度超过单帧上限时立即拒绝，不等待数据到齐
+    CHECK(decode("*1\r\n$99999999999\r\n", 0) == 0, "不限上限时超长声明视为不完整");
+    CHECK(decode("*1\r\n$99999999999\r\n", MAX_FRAME_SIZE) == -1, "超长声明超过单帧上限时立即拒绝");
+    CHECK(decode("*1000000\r\n", MAX_FRAME_SIZE) == -1, "参数数超过单帧上限能容纳的数量时立即拒绝");
+    CHECK(decode(command, strlen(command)) == (ssize_t) length, "恰好等于上限的命令可以解码");
+    CHECK(decode(command, strlen(command) - 1) == -1, "超过上限一个字节的命令被拒绝");
+
+    // 经由分帧解码器：超长声明在第一个数据块就返回错误
+    size_t limit = MAX_FRAME_SIZE;
+    frame_codec_t codec = { FRAME_CODEC_CUSTOM, 0, MAX_FRAME_SIZE, resp_decode_command, NULL, &limit };
+    frame_decoder_t *decoder = frame_decoder_create(&codec, 4096);
+    const char *pipelined = "*1\r\n$4\r\nPING\r\n*2\r\n$3\r\nGET\r\n$1\r\na\r\n*1\r\n$4\r\nPI";
+    CHECK(frame_decoder_feed(decoder, pipelined, strlen(pipelined), count_frames, NULL) == 2 && frames_seen == 2,
+          "解码器分发完整命令并保留不完整的命令");
+    CHECK(frame_decoder_feed(decoder, "NG\r\n", 4, count_frames, NULL) == 1 && frames_seen == 3,
+          "补齐后分发剩余的命令");
+    const char *oversized = "*1\r\n$99999999999\r\n";
+    CHECK(frame_decoder_feed(decoder, oversized, strlen(oversized), count_frames, NULL) == -1,
+          "解码器立即拒绝超长声明");
+    frame_decoder_destroy(decoder);
+    printf("\n");
+}
+
+// 测试SET的选项
+static void test_set_options(void) {
+    printf("=== 测试SET选项 ===\n");
+    kv_store_t *store = kv_store_create(4, TICK_MS, 0);
+
+    CHECK(execute_is(store, "*3\r\n$3\r\nSET\r\n$1\r\na\r\n$1\r\n1\r\n", 0, "+OK\r\n"), "SET写入");
+    CHECK(execute_is(store, "*2\r\n$3\r\nGET\r\n$1\r\na\r\n", 0, "$1\r\n1\r\n"), "GET读取");
+    CHECK(execute_is(store, "SET a 2 NX\r\n", 0, "$-1\r\n"), "键存在时SET NX不写入");
+    CHECK(execute_is(store, "SET b 2 NX\r\n", 0, "+OK\r\n"), "键不存在时SET NX写入");
+    CHECK(execute_is(store, "SET c 3 XX\r\n", 0, "$-1\r\n"), "键不存在时SET XX不写入");
+    CHECK(execute_is(store, "SET a 3 XX\r\n", 0, "+OK\r\n") && execute_is(store, "GET a\r\n", 0, "$1\r\n3\r\n"),
+          "键存在时SET XX覆盖");
+
+    CHECK(execute_is(store, "SET e 1 EX 10\r\n", 0, "+OK\r\n") && execute_is(store, "TTL e\r\n", 0, ":10\r\n"),
+          "SET EX设置秒级过期时间");
+    CHECK(execute_is(store, "SET p 1 PX 1500\r\n", 0, "+OK\r\n") && execute_is(store, "TTL p\r\n", 1000, ":1\r\n"),
+          "SET PX设置毫秒级过期时间");
+    CHECK(execute_is(store, "GET p\r\n", 1499, "$1\r\n1\r\n") && execute_is(store, "GET p\r\n", 1500, "$-1\r\n"),
+          "到期后读取不到（时间轮尚未推进）");
+    CHECK(execute_is(store, "SET e 2\r\n", 0, "+OK\r\n") && execute_is(store, "TTL e\r\n", 0, ":-1\r\n"),
+          "不带EX/PX的SET清除过期时间");
+    CHECK(execute_is(store, "SET n 1 NX PX 100\r\n", 0, "+OK\r\n") && execute_is(store, "TTL n\r\n", 0, ":0\r\n"),
+          "NX与PX可以组合");
+
+    CHECK(execute_is(store, "SET a 1 EX 0\r\n", 0, "-ERR invalid expire time in 'set' command\r\n"), "EX 0被拒绝");
+    CHECK(execute_is(store, "SET a 1 PX -5\r\n", 0, "-ERR invalid expire time in 'set' command\r\n"), "负的PX被拒绝");
+    CHECK(execute_is(store, "SET a 1 EX ten\r\n", 0, "-ERR value is not an integer or out of range\r\n"),
+          "非整数的EX被拒绝");
+    CHECK(execute_is(store, "SET a 1 EX 9223372036854775807\r\n", 0,
+                     "-ERR invalid expire time in 'set' command\r\n"), "换算为毫秒会溢出的EX被拒绝");
+    CHECK(execute_is(store, "SET a 1 NX XX\r\n", 0, "-ERR syntax error\r\n"), "NX与XX同时使用是语法错误");
+    CHECK(execute_is(store, "SET a 1 EX 1 PX 1\r\n", 0, "-ERR syntax error\r\n"), "EX与PX同时使用是语法错误");
+    CHECK(execute_is(store, "SET a 1 EX\r\n", 0, "-ERR syntax error\r\n"), "EX缺少参数是语法错误");
+    CHECK(execute_is(store, "SET a\r\n", 0, "-ERR wrong number of arguments for 'set' command\r\n"), "参数不足");
+    CHECK(execute_is(store, "FOO\r\n", 0, "-ERR unknown command 'FOO'\r\n"), "未知命令");
+
+    kv_store_destroy(store);
+    printf("\n");
+}
+
+// 测试INCR
+static void test_incr(void) {
+    printf("=== 测试INCR ===\n");
+    kv_store_t *store = kv_store_create(4, TICK_MS, 0);
+
+    CHECK(execute_is(store, "INCR counter\r\n", 0, ":1\r\n") && execute_is(store, "INCR counter\r\n", 0, ":2\r\n"),
+          "不存在的键从0开始自增");
+    CHECK(execute_is(store, "SET big 9223372036854775806\r\n", 0, "+OK\r\n") &&
+          execute_is(store, "INCR big\r\n", 0, ":9223372036854775807\r\n"), "自增到INT64_MAX");
+    CHECK(execute_is(store, "INCR big\r\n", 0, "-ERR increment or decrement would overflow\r\n"), "超过INT64_MAX时报告溢出");
+    CHECK(execute_is(store, "GET big\r\n", 0, "$19\r\n9223372036854775807\r\n"), "溢出时原值不变");
+
+    CHECK(execute_is(store, "SET text abc\r\n", 0, "+OK\r\n") &&
+          execute_is(store, "INCR text\r\n", 0, "-ERR value is not an integer or out of range\r\n"), "非整数值不能自增");
+    CHECK(execute_is(store, "*3\r\n$3\r\nSET\r\n$6\r\nspaced\r\n$2\r\n 1\r\n", 0, "+OK\r\n") &&
+          execute_is(store, "INCR spaced\r\n", 0, "-ERR value is not an integer or out of range\r\n"),
+          "带空白的值不能自增");
+
+    CHECK(execute_is(store, "SET ttl 5 EX 100\r\n", 0, "+OK\r\n") && execute_is(store, "INCR ttl\r\n", 0, ":6\r\n") &&
+          execute_is(store, "TTL ttl\r\n", 0, ":100\r\n"), "自增保留过期时间");
+
+    int64_t value;
+    kv_store_set(store, "min", 3, "-9223372036854775808", 20, 0, 0, 0);
+    CHECK(kv_store_incr(store, "min", 3, -1, 0, &value) == KV_ERROR_OVERFLOW, "低于INT64_MIN时报告溢出");
+    CHECK(kv_store_incr(store, "min", 3, 1, 0, &value) == 0 && value == INT64_MIN + 1, "INT64_MIN可以加1");
+
+    kv_store_destroy(store);
+    printf("\n");
+}
+
+// 测试时间轮过期：推进时间轮时删除到期的键，不需要访问
+static void test_expiry(void) {
+    printf("=== 测试时间轮过期 ===\n");
+    kv_store_t *store = kv_store_create(4, TICK_MS, 0);
+    char key[32];
+    for (int i = 0; i < 100; i++) {
+        int length = snprintf(key, sizeof(key), "short:%d", i);
+        kv_store_set(store, key, (size_t) length, "v", 1, 100 + i, 0, 0);
+    }
+    // 超过时间轮一圈（1024个刻度）的过期时间，取刻度的整数倍
+    long long long_ttl = 1024LL * TICK_MS * 3 + 5 * TICK_MS;
+    kv_store_set(store, "long", 4, "v", 1, long_ttl, 0, 0);
+    kv_store_set(store, "forever", 7, "v", 1, 0, 0, 0);
+
+    kv_store_stats_t stats;
+    kv_store_get_stats(store, &stats);
+    CHECK(stats.keys == 102 && stats.expiring_keys == 101, "带过期时间的键挂在时间轮上");
+
+    CHECK(kv_store_advance(store, 99) == 0, "到期之前推进不删除键");
+    CHECK(kv_store_advance(store, 150) == 51, "推进到150毫秒删除已到期的51个键");
+    // 过期时刻按刻度向上取整挂到槽上，191~199毫秒到期的键在推进到200毫秒时删除
+    CHECK(kv_store_advance(store, 199) == 40 && kv_store_advance(store, 200) == 9, "其余短期键在各自的刻度到期");
+    CHECK(kv_store_advance(store, 1000) == 0, "短期键全部删除后推进不再删除");
+
+    // 按刻度逐步推进多圈，长期键在经过自己的槽位时保留，直到过期
+    size_t removed = 0;
+    uint64_t now = 1000;
+    for (; now < (uint64_t) long_ttl - TICK_MS; now += TICK_MS) {
+        removed += kv_store_advance(store, now);
+    }
+    CHECK(removed == 0 && kv_store_ttl(store, "long", 4, now) > 0, "超过一圈的过期时间在之前的圈次中保留");
+    CHECK(kv_store_advance(store, (uint64_t) long_ttl) == 1 && kv_store_ttl(store, "long", 4, (uint64_t) long_ttl) == -2,
+          "超过一圈的键在到期时删除");
+
+    // 一次跳过多圈
+    kv_store_set(store, "jump", 4, "v", 1, 50, 0, now);
+    CHECK(kv_store_advance(store, now + 1024 * TICK_MS * 5) == 1, "落后多圈时一次推进删除到期的键");
+
+    kv_store_get_stats(store, &stats);
+    CHECK(stats.keys == 1 && stats.expiring_keys == 0 && stats.expired == 102, "只剩没有过期时间的键");
+    CHECK(kv_store_ttl(store, "forever", 7, now) == -1, "没有过期时间的键TTL为-1");
+
+    // EXPIRE不大于0时立即删除
+    CHECK(execute_is(store, "EXPIRE forever 0\r\n", now, ":1\r\n") && execute_is(store, "GET forever\r\n", now, "$-1\r\n"),
+          "EXPIRE 0立即删除键");
+    kv_store_destroy(store);
+    printf("\n");
+}
+
+int main(void) {
+    printf("=== RESP协议与键值存储测试程序 ===\n\n");
+
+    test_decode();
+    test_set_options();
+    test_incr();
+    test_expiry();
+
+    printf("=== RESP测试完成，失败 %d 项 ===\n", failures);
+    return failures == 0 ? 0 : 1;
+}
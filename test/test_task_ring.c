@@ -0,0 +1,192 @@
+// 任务环测试：容量取整、环满与先进先出、多生产者/多消费者压力（小容量反复回绕）
+// 编译: gcc -O2 -I. test/test_task_ring.c src/thread/task_ring.c -o test_task_ring -lpthread
+// 运行: ./test_task_ring [生产者数] [消费者数] [每个生产者的任务数] [容量]，全部通过时返回0
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include "src/thread/task_ring.h"
+
+// 任务的data编码为 生产者序号 * SEQ_LIMIT + 序号
+#define SEQ_LIMIT 100000000L
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (cond) { \
+        printf("✓ %s\n", msg); \
+    } else { \
+        printf("✗ %s\n", msg); \
+        failures++; \
+    } \
+} while (0)
+
+typedef struct {
+    task_ring_t *ring;
+    int producer_id;
+    int producer_count;
+    long count;
+    long *consumed;                 // 所有消费者已取出的任务总数
+    long total;
+    unsigned char *seen;            // 每个任务被取出的次数，按data编号
+    int out_of_order;               // 同一消费者看到的同一生产者任务序号倒退的次数
+} ring_params_t;
+
+static void dummy(void *data) {
+    (void)data; // 避免未使用参数警告
+}
+
+static void* producer_thread(void *arg) {
+    ring_params_t *params = (ring_params_t*) arg;
+    for (long seq = 0; seq < params->count; seq++) {
+        work_task_t task = { dummy, (void*) (params->producer_id * SEQ_LIMIT + seq), 0 };
+        while (task_ring_push(params->ring, &task) != 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* consumer_thread(void *arg) {
+    ring_params_t *params = (ring_params_t*) arg;
+    long *last = malloc(sizeof(long) * params->producer_count);
+    for (int i = 0; i < params->producer_count; i++) {
+        last[i] = -1;
+    }
+
+    while (__atomic_load_n(params->consumed, __ATOMIC_ACQUIRE) < params->total) {
+        work_task_t task;
+        if (!task_ring_pop(params->ring, &task)) {
+            sched_yield();
+            continue;
+        }
+        long value = (long) task.data;
+        int producer = (int) (value / SEQ_LIMIT);
+        long seq = value % SEQ_LIMIT;
+        if (task.func != dummy || producer >= params->producer_count || seq >= params->count) {
+            params->out_of_order++;
+        } else {
+            // 环是先进先出的，同一消费者取出的同一生产者的任务序号递增
+            if (seq <= last[producer]) {
+                params->out_of_order++;
+            }
+            last[producer] = seq;
+            __atomic_add_fetch(&params->seen[producer * params->count + seq], 1, __ATOMIC_RELAXED);
+        }
+        __atomic_add_fetch(params->consumed, 1, __ATOMIC_RELEASE);
+    }
+    free(last);
+    return NULL;
+}
+
+// 测试容量、环满和先进先出
+static void test_basic(void) {
+    printf("=== 测试基本功能 ===\n");
+    task_ring_t *ring = task_ring_create(5);
+    CHECK(ring && task_ring_capacity(ring) == 8, "容量向上取整为2的幂");
+
+    work_task_t task = { dummy, NULL, 0 };
+    work_task_t out;
+    CHECK(task_ring_pop(ring, &out) == 0, "空环出队返回0");
+
+    int pushed = 0;
+    for (long i = 0; i < 20; i++) {
+        task.data = (void*) i;
+        if (task_ring_push(ring, &task) == 0) {
+            pushed++;
+        }
+    }
+    CHECK(pushed == 8 && task_ring_size(ring) == 8, "环满后入队失败");
+
+    int ordered = 1;
+    for (long i = 0; i < 8; i++) {
+        if (!task_ring_pop(ring, &out) || (long) out.data != i) {
+            ordered = 0;
+        }
+    }
+    CHECK(ordered && task_ring_pop(ring, &out) == 0, "按入队顺序出队");
+
+    // 反复回绕
+    int wrapped = 1;
+    for (long i = 0; i < 1000; i++) {
+        task.data = (void*) i;
+        if (task_ring_push(ring, &task) != 0 || !task_ring_pop(ring, &out) || (long) out.data != i) {
+            wrapped = 0;
+        }
+    }
+    CHECK(wrapped, "位置回绕后仍按顺序出入队");
+    task_ring_destroy(ring);
+    printf("\n");
+}
+
+// 多生产者/多消费者压力：每个任务恰好被取出一次，同一生产者的任务在每个消费者看来保持顺序
+static void test_mpmc(int producers, int consumers, long count, size_t capacity) {
+    printf("=== 测试多生产者/多消费者（%d生产者 %d消费者 每个%ld任务 容量%zu）===\n",
+           producers, consumers, count, capacity);
+    task_ring_t *ring = task_ring_create(capacity);
+    long total = producers * count;
+    long consumed = 0;
+    unsigned char *seen = calloc(total, 1);
+
+    pthread_t *threads = malloc(sizeof(pthread_t) * (producers + consumers));
+    ring_params_t *params = calloc(producers + consumers, sizeof(ring_params_t));
+    for (int i = 0; i < producers + consumers; i++) {
+        params[i].ring = ring;
+        params[i].producer_id = i;
+        params[i].producer_count = producers;
+        params[i].count = count;
+        params[i].consumed = &consumed;
+        params[i].total = total;
+        params[i].seen = seen;
+    }
+    for (int i = 0; i < consumers; i++) {
+        pthread_create(&threads[producers + i], NULL, consumer_thread, &params[producers + i]);
+    }
+    for (int i = 0; i < producers; i++) {
+        pthread_create(&threads[i], NULL, producer_thread, &params[i]);
+    }
+    for (int i = 0; i < producers + consumers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    long missing = 0;
+    long duplicated = 0;
+    for (long i = 0; i < total; i++) {
+        if (seen[i] == 0) {
+            missing++;
+        } else if (seen[i] > 1) {
+            duplicated++;
+        }
+    }
+    int out_of_order = 0;
+    for (int i = producers; i < producers + consumers; i++) {
+        out_of_order += params[i].out_of_order;
+    }
+    work_task_t out;
+    printf("  取出 %ld 个任务，丢失 %ld，重复 %ld，乱序 %d\n", consumed, missing, duplicated, out_of_order);
+    CHECK(missing == 0 && duplicated == 0, "每个任务恰好被取出一次");
+    CHECK(out_of_order == 0, "同一生产者的任务按顺序取出");
+    CHECK(task_ring_pop(ring, &out) == 0 && task_ring_size(ring) == 0, "结束后环为空");
+
+    free(params);
+    free(threads);
+    free(seen);
+    task_ring_destroy(ring);
+    printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    int producers = argc > 1 ? atoi(argv[1]) : 4;
+    int consumers = argc > 2 ? atoi(argv[2]) : 4;
+    long count = argc > 3 ? atol(argv[3]) : 200000;
+    size_t capacity = argc > 4 ? (size_t) atol(argv[4]) : 64;
+    printf("=== 任务环测试程序 ===\n\n");
+
+    test_basic();
+    test_mpmc(producers, consumers, count, capacity);
+    // 容量为1时每次入队都与出队争抢同一个槽位
+    test_mpmc(producers, consumers, count / 10, 1);
+
+    printf("=== 任务环测试完成，失败 %d 项 ===\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+// 工作窃取队列测试：所有者后进先出、窃取先进先出、扩容，以及所有者弹出与多个窃取者的争抢
+// 编译: gcc -O2 -I. test/test_work_deque.c src/thread/work_deque.c -o test_work_deque -lpthread
+// 运行: ./test_work_deque [窃取者数] [任务数]，全部通过时返回0
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include "src/thread/work_deque.h"
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (cond) { \
+        printf("✓ %s\n", msg); \
+    } else { \
+        printf("✗ %s\n", msg); \
+        failures++; \
+    } \
+} while (0)
+
+typedef struct {
+    work_deque_t *deque;
+    long total;
+    long *taken;                    // 所有者和窃取者已取得的任务总数
+    unsigned char *seen;            // 每个任务被取得的次数，按data编号
+    long stolen;
+    int bad_order;                  // 同一窃取者取得的任务序号倒退的次数
+} race_params_t;
+
+static void dummy(void *data) {
+    (void)data; // 避免未使用参数警告
+}
+
+static void take(race_params_t *params, const work_task_t *task) {
+    long value = (long) task->data;
+    if (task->func == dummy && value >= 0 && value < params->total) {
+        __atomic_add_fetch(&params->seen[value], 1, __ATOMIC_RELAXED);
+    }
+    __atomic_add_fetch(params->taken, 1, __ATOMIC_RELEASE);
+}
+
+static void* thief_thread(void *arg) {
+    race_params_t *params = (race_params_t*) arg;
+    long last = -1;
+    while (__atomic_load_n(params->taken, __ATOMIC_ACQUIRE) < params->total) {
+        work_task_t task;
+        int result = work_deque_steal(params->deque, &task);
+        if (result == 1) {
+            // 所有者按序号递增压入，窃取从顶部取最早的任务，同一窃取者看到的序号递增
+            if ((long) task.data <= last) {
+                params->bad_order++;
+            }
+            last = (long) task.data;
+            params->stolen++;
+            take(params, &task);
+        } else if (result == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// 测试所有者和窃取者两端的顺序以及扩容
+static void test_basic(void) {
+    printf("=== 测试基本功能 ===\n");
+    work_deque_t *deque = work_deque_create(2);
+    work_task_t task = { dummy, NULL, 0 };
+    work_task_t out;
+    CHECK(deque && work_deque_pop(deque, &out) == 0 && work_deque_steal(deque, &out) == 0, "空队列弹出和窃取返回0");
+
+    int pushed = 1;
+    for (long i = 0; i < 1000; i++) {
+        task.data = (void*) i;
+        if (work_deque_push(deque, &task) != 0) {
+            pushed = 0;
+        }
+    }
+    CHECK(pushed && work_deque_size(deque) == 1000, "压入超过初始容量时扩容");
+
+    CHECK(work_deque_pop(deque, &out) == 1 && (long) out.data == 999, "所有者弹出最近压入的任务");
+    CHECK(work_deque_steal(deque, &out) == 1 && (long) out.data == 0, "窃取最早压入的任务");
+
+    int ordered = 1;
+    for (long i = 998; i >= 500; i--) {
+        if (work_deque_pop(deque, &out) != 1 || (long) out.data != i) {
+            ordered = 0;
+        }
+    }
+    for (long i = 1; i < 500; i++) {
+        if (work_deque_steal(deque, &out) != 1 || (long) out.data != i) {
+            ordered = 0;
+        }
+    }
+    CHECK(ordered && work_deque_size(deque) == 0, "两端交替取出时顺序正确");
+    work_deque_destroy(deque);
+    printf("\n");
+}
+
+// 所有者不断压入和弹出，多个窃取者同时窃取，争抢最后一个元素和扩容期间的窃取。
+// batch为每轮压入的任务数，所有者每轮弹出一半，其余留给窃取者；batch为1时每个任务都与窃取者争抢
+static void test_steal_race(int thieves, long total, int batch) {
+    printf("=== 测试弹出与窃取的争抢（%d窃取者 %ld任务 每轮%d个）===\n", thieves, total, batch);
+    work_deque_t *deque = work_deque_create(2);
+    long taken = 0;
+    unsigned char *seen = calloc(total, 1);
+
+    pthread_t *threads = malloc(sizeof(pthread_t) * thieves);
+    race_params_t *params = calloc(thieves + 1, sizeof(race_params_t));
+    for (int i = 0; i <= thieves; i++) {
+        params[i].deque = deque;
+        params[i].total = total;
+        params[i].taken = &taken;
+        params[i].seen = seen;
+    }
+    for (int i = 0; i < thieves; i++) {
+        pthread_create(&threads[i], NULL, thief_thread, &params[i + 1]);
+    }
+
+    // 所有者（本线程）
+    race_params_t *owner = &params[0];
+    long next = 0;
+    long popped = 0;
+    work_task_t task = { dummy, NULL, 0 };
+    while (next < total) {
+        for (int i = 0; i < batch && next < total; i++) {
+            task.data = (void*) next++;
+            if (work_deque_push(deque, &task) != 0) {
+                printf("✗ 压入失败\n");
+                failures++;
+            }
+        }
+        // 队列中只有一个任务时稍等再弹出，让窃取者有机会同时争抢它
+        for (volatile int spin = 0; batch == 1 && spin < 200; spin++) {
+        }
+        for (int i = 0; i < (batch + 1) / 2; i++) {
+            work_task_t out;
+            if (!work_deque_pop(deque, &out)) {
+                break;
+            }
+            popped++;
+            take(owner, &out);
+        }
+    }
+    work_task_t out;
+    while (work_deque_pop(deque, &out)) {
+        popped++;
+        take(owner, &out);
+    }
+    for (int i = 0; i < thieves; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    long missing = 0;
+    long duplicated = 0;
+    for (long i = 0; i < total; i++) {
+        if (seen[i] == 0) {
+            missing++;
+        } else if (seen[i] > 1) {
+            duplicated++;
+        }
+    }
+    long stolen = 0;
+    int bad_order = 0;
+    for (int i = 1; i <= thieves; i++) {
+        stolen += params[i].stolen;
+        bad_order += params[i].bad_order;
+    }
+    printf("  所有者弹出 %ld，窃取 %ld，丢失 %ld，重复 %ld\n", popped, stolen, missing, duplicated);
+    CHECK(missing == 0 && duplicated == 0, "每个任务恰好被取得一次");
+    CHECK(bad_order == 0, "每个窃取者按压入顺序取得任务");
+    CHECK(work_deque_size(deque) == 0, "结束后队列为空");
+
+    free(params);
+    free(threads);
+    free(seen);
+    work_deque_destroy(deque);
+    printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    int thieves = argc > 1 ? atoi(argv[1]) : 3;
+    long total = argc > 2 ? atol(argv[2]) : 1000000;
+    printf("=== 工作窃取队列测试程序 ===\n\n");
+
+    test_basic();
+    test_steal_race(thieves, total, 1);
+    test_steal_race(thieves, total, 64);
+    // 每轮压入的任务多于弹出的，队列持续增长，窃取与扩容交错
+    test_steal_race(thieves, total, 4096);
+
+    printf("=== 工作窃取队列测试完成，失败 %d 项 ===\n", failures);
+    return failures == 0 ? 0 : 1;
+}